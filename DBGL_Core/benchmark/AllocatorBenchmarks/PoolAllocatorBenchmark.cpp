@@ -0,0 +1,90 @@
+//////////////////////////////////////////////////////////////////////
+/// Dragon Blaze Game Library
+///
+/// Copyright (c) 2015 by Jan Moeller
+///
+/// This software is provided "as-is" and does not claim to be
+/// complete or free of bugs in any way. It should work, but
+/// it might also begin to hurt your kittens.
+//////////////////////////////////////////////////////////////////////
+
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include <vector>
+#include "DBGL/Core/Memory/PoolAllocator.h"
+#include "../Benchmark.h"
+
+using namespace dbgl;
+using namespace std;
+
+namespace dbgl_benchmark
+{
+    struct Entity
+    {
+	    float m_transform[16] = {};
+	    unsigned int m_id = 0;
+    };
+
+    const unsigned int s_threads = 8;
+    const unsigned int s_pairs = 200000;
+    const unsigned int s_live = 64;
+
+    /**
+     * @brief Runs s_pairs alloc/free pairs on s_threads threads, keeping s_live objects alive per thread
+     * @param alloc Allocation function
+     * @param dealloc Deallocation function
+     * @return Duration in milliseconds
+     */
+    template<typename Alloc, typename Dealloc> double run(Alloc alloc, Dealloc dealloc)
+    {
+	auto start = chrono::high_resolution_clock::now();
+	vector<thread> threads;
+	for (unsigned int t = 0; t < s_threads; t++)
+	{
+	    threads.emplace_back([&]()
+	    {
+		Entity* live[s_live] = {};
+		for (unsigned int i = 0; i < s_pairs; i++)
+		{
+		    auto& slot = live[i % s_live];
+		    if (slot)
+			dealloc(slot);
+		    slot = alloc();
+		    slot->m_id = i;
+		}
+		for (auto& slot : live)
+		    dealloc(slot);
+	    });
+	}
+	for (auto& t : threads)
+	    t.join();
+	auto end = chrono::high_resolution_clock::now();
+	return chrono::duration<double, milli>(end - start).count();
+    }
+
+    void poolAllocatorContention()
+    {
+	double heapTime = run([]()
+	{
+	    return new Entity {};
+	}, [](Entity*& e)
+	{
+	    delete e;
+	    e = nullptr;
+	});
+
+	PoolAllocator<Entity> pool { s_threads * s_live };
+	double poolTime = run([&]()
+	{
+	    return pool.allocate();
+	}, [&](Entity*& e)
+	{
+	    pool.deallocate(e);
+	});
+
+	cout << "  " << s_threads << " threads x " << s_pairs << " alloc/free pairs" << endl;
+	cout << "  operator new: " << heapTime << " ms" << endl;
+	cout << "  PoolAllocator: " << poolTime << " ms" << endl;
+    }
+}
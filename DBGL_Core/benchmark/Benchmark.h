@@ -0,0 +1,38 @@
+//////////////////////////////////////////////////////////////////////
+/// Dragon Blaze Game Library
+///
+/// Copyright (c) 2015 by Jan Moeller
+///
+/// This software is provided "as-is" and does not claim to be
+/// complete or free of bugs in any way. It should work, but
+/// it might also begin to hurt your kittens.
+//////////////////////////////////////////////////////////////////////
+
+#ifndef DBGL_CORE_BENCHMARK_BENCHMARK_H_
+#define DBGL_CORE_BENCHMARK_BENCHMARK_H_
+
+namespace dbgl_benchmark
+{
+	/**
+	 * @brief Compares the SIMD math kernels to the scalar ones
+	 */
+	void simdKernels();
+	/**
+	 * @brief Compares PoolAllocator to operator new with many threads allocating at once
+	 */
+	void poolAllocatorContention();
+	/**
+	 * @brief Times inserting, building, updating and querying a BoundingVolumeHierarchy of 100k spheres
+	 */
+	void boundingVolumeHierarchy();
+	/**
+	 * @brief Compares building and nearest neighbor queries of KdTree and StaticKdTree
+	 */
+	void staticKdTree();
+	/**
+	 * @brief Times the parallel StaticKdTree build and compares k-nearest neighbor queries one by one to batched ones
+	 */
+	void staticKdTreeBatched();
+}
+
+#endif /* DBGL_CORE_BENCHMARK_BENCHMARK_H_ */
@@ -0,0 +1,99 @@
+//////////////////////////////////////////////////////////////////////
+/// Dragon Blaze Game Library
+///
+/// Copyright (c) 2015 by Jan Moeller
+///
+/// This software is provided "as-is" and does not claim to be
+/// complete or free of bugs in any way. It should work, but
+/// it might also begin to hurt your kittens.
+//////////////////////////////////////////////////////////////////////
+
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <vector>
+#include "DBGL/Core/Collection/Tree/BoundingVolumeHierarchy.h"
+#include "DBGL/Core/Shape/Shapes.h"
+#include "DBGL/Core/Math/Vector3.h"
+#include "../Benchmark.h"
+
+using namespace dbgl;
+using namespace std;
+
+namespace dbgl_benchmark
+{
+	namespace
+	{
+		using BVH = BoundingVolumeHierarchy<int, Sphere<float>>;
+
+		std::vector<BVH::Aggregate> randomSpheres(unsigned int amount, unsigned int seed)
+		{
+			std::mt19937 rng { seed };
+			std::uniform_real_distribution<float> pos { -100, 100 };
+			std::uniform_real_distribution<float> rad { 0.1f, 2 };
+			std::vector<BVH::Aggregate> spheres;
+			for (unsigned int i = 0; i < amount; i++)
+				spheres.push_back( { Sphere<float> { Vec3f { pos(rng), pos(rng), pos(rng) }, rad(rng) },
+						static_cast<int>(i) });
+			return spheres;
+		}
+	}
+
+	void boundingVolumeHierarchy()
+	{
+		auto elements = randomSpheres(100000, 7);
+		auto start = chrono::high_resolution_clock::now();
+		BVH incremental { };
+		for (auto const& e : elements)
+			incremental.insert(e.m_volume, e.m_data);
+		auto end = chrono::high_resolution_clock::now();
+		double insertTime = chrono::duration<double, milli>(end - start).count();
+
+		start = chrono::high_resolution_clock::now();
+		BVH built { elements.begin(), elements.end() };
+		end = chrono::high_resolution_clock::now();
+		double buildTime = chrono::duration<double, milli>(end - start).count();
+
+		start = chrono::high_resolution_clock::now();
+		for (unsigned int i = 0; i < elements.size(); i++)
+		{
+			auto volume = elements[i].m_volume;
+			volume.center() += Vec3f { 1, 0, 0 };
+			built.update(i, volume);
+		}
+		end = chrono::high_resolution_clock::now();
+		double updateTime = chrono::duration<double, milli>(end - start).count();
+
+		std::vector<Plane<float>> planes;
+		for (auto const& normal : { Vec3f { 1, 0, 0 }, Vec3f { -1, 0, 0 }, Vec3f { 0, 1, 0 }, Vec3f { 0, -1, 0 },
+				Vec3f { 0, 0, 1 }, Vec3f { 0, 0, -1 } })
+			planes.emplace_back(normal * -20, normal);
+		AABB<float> range { Vec3f { -20, -20, -20 }, Vec3f { 40, 40, 40 } };
+		std::vector<int*> found;
+		found.reserve(elements.size());
+		start = chrono::high_resolution_clock::now();
+		for (unsigned int i = 0; i < 100; i++)
+		{
+			found.clear();
+			built.get(range, found);
+		}
+		end = chrono::high_resolution_clock::now();
+		double getTime = chrono::duration<double, milli>(end - start).count();
+		start = chrono::high_resolution_clock::now();
+		unsigned int visited = 0;
+		for (unsigned int i = 0; i < 100; i++)
+			built.queryPlanes(planes.data(), 6, [&visited](BVH::Handle, BVH::Aggregate const&)
+			{
+				visited++;
+				return true;
+			});
+		end = chrono::high_resolution_clock::now();
+		double planesTime = chrono::duration<double, milli>(end - start).count();
+
+		cout << "  100k spheres, insert: " << insertTime << " ms (cost " << incremental.getCost() << ")" << endl;
+		cout << "  100k spheres, SAH build: " << buildTime << " ms (cost " << built.getCost() << ")" << endl;
+		cout << "  update all: " << updateTime << " ms" << endl;
+		cout << "  100 box queries: " << getTime << " ms" << endl;
+		cout << "  100 plane queries: " << planesTime << " ms (" << visited << " hits)" << endl;
+	}
+}
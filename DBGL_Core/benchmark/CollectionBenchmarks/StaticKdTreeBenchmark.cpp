@@ -0,0 +1,116 @@
+//////////////////////////////////////////////////////////////////////
+/// Dragon Blaze Game Library
+///
+/// Copyright (c) 2015 by Jan Moeller
+///
+/// This software is provided "as-is" and does not claim to be
+/// complete or free of bugs in any way. It should work, but
+/// it might also begin to hurt your kittens.
+//////////////////////////////////////////////////////////////////////
+
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <vector>
+#include "DBGL/Core/Math/Vector3.h"
+#include "DBGL/Core/Collection/Tree/KdTree.h"
+#include "DBGL/Core/Collection/Tree/StaticKdTree.h"
+#include "DBGL/Core/Utility/Parallel.h"
+#include "../Benchmark.h"
+
+using namespace dbgl;
+using namespace std;
+
+namespace dbgl_benchmark
+{
+	namespace
+	{
+		using Container3 = StaticKdTree<unsigned int, Vec3f>::Container;
+
+		std::vector<Container3> randomPoints(unsigned int amount, unsigned int seed)
+		{
+			std::mt19937 rng { seed };
+			std::uniform_real_distribution<float> dist { -100, 100 };
+			std::vector<Container3> points;
+			points.reserve(amount);
+			for (unsigned int i = 0; i < amount; i++)
+				points.push_back( { Vec3f { dist(rng), dist(rng), dist(rng) }, i });
+			return points;
+		}
+	}
+
+	void staticKdTree()
+	{
+		auto points = randomPoints(200000, 1);
+		auto queries = randomPoints(200000, 2);
+
+		auto start = chrono::high_resolution_clock::now();
+		KdTree<unsigned int, Vec3f> dynamicTree(points.begin(), points.end());
+		auto end = chrono::high_resolution_clock::now();
+		double dynamicBuild = chrono::duration<double, milli>(end - start).count();
+
+		start = chrono::high_resolution_clock::now();
+		StaticKdTree<unsigned int, Vec3f> staticTree(points.begin(), points.end());
+		end = chrono::high_resolution_clock::now();
+		double staticBuild = chrono::duration<double, milli>(end - start).count();
+
+		Vec3f nearest;
+		unsigned int data = 0;
+		volatile unsigned int dynamicSum = 0, staticSum = 0;
+		start = chrono::high_resolution_clock::now();
+		for (auto const& query : queries)
+		{
+			dynamicTree.findNearestNeighbor(query.point, nearest, data);
+			dynamicSum += data;
+		}
+		end = chrono::high_resolution_clock::now();
+		double dynamicQuery = chrono::duration<double, milli>(end - start).count();
+
+		start = chrono::high_resolution_clock::now();
+		for (auto const& query : queries)
+		{
+			staticTree.findNearestNeighbor(query.point, nearest, data);
+			staticSum += data;
+		}
+		end = chrono::high_resolution_clock::now();
+		double staticQuery = chrono::duration<double, milli>(end - start).count();
+
+		cout << "  build 200k points: KdTree " << dynamicBuild << " ms, StaticKdTree " << staticBuild << " ms"
+				<< endl;
+		cout << "  200k nearest neighbor queries: KdTree " << dynamicQuery << " ms, StaticKdTree " << staticQuery
+				<< " ms" << endl;
+	}
+
+	void staticKdTreeBatched()
+	{
+		auto points = randomPoints(200000, 1);
+		auto queries = randomPoints(200000, 2);
+
+		auto start = chrono::high_resolution_clock::now();
+		StaticKdTree<unsigned int, Vec3f> staticTree(points.begin(), points.end());
+		auto end = chrono::high_resolution_clock::now();
+		double build = chrono::duration<double, milli>(end - start).count();
+
+		std::vector<Vec3f> queryPoints;
+		for (auto const& query : queries)
+			queryPoints.push_back(query.point);
+		std::vector<std::vector<Container3>> results(queryPoints.size());
+		start = chrono::high_resolution_clock::now();
+		for (unsigned int i = 0; i < queryPoints.size(); i++)
+			staticTree.findKNearestNeighbors(queryPoints[i], 8, results[i]);
+		end = chrono::high_resolution_clock::now();
+		double singleKnn = chrono::duration<double, milli>(end - start).count();
+
+		for (auto& result : results)
+			result.clear();
+		start = chrono::high_resolution_clock::now();
+		staticTree.findKNearestNeighbors(queryPoints.data(), queryPoints.size(), 8, results.data());
+		end = chrono::high_resolution_clock::now();
+		double batchedKnn = chrono::duration<double, milli>(end - start).count();
+
+		cout << "  hardware threads: " << Parallel::getThreadCount() << endl;
+		cout << "  parallel build of 200k points: " << build << " ms" << endl;
+		cout << "  200k 8-nearest neighbor queries: one by one " << singleKnn << " ms, batched " << batchedKnn
+				<< " ms" << endl;
+	}
+}
@@ -0,0 +1,89 @@
+//////////////////////////////////////////////////////////////////////
+/// Dragon Blaze Game Library
+///
+/// Copyright (c) 2015 by Jan Moeller
+///
+/// This software is provided "as-is" and does not claim to be
+/// complete or free of bugs in any way. It should work, but
+/// it might also begin to hurt your kittens.
+//////////////////////////////////////////////////////////////////////
+
+#include <chrono>
+#include <iostream>
+#include "DBGL/Core/Math/SIMD.h"
+#include "../Benchmark.h"
+
+using namespace dbgl;
+using namespace std;
+
+namespace dbgl_benchmark
+{
+	const float numbers[] = { -1.5f, 1.0f, 0.256f, 25.0f, -100.38585f, 0.00001f, 42.1337f, 571, 43.495f };
+	const unsigned int s_iterations = 1000000;
+	volatile float s_sink = 0;
+
+	/**
+	 * @brief Runs an operation s_iterations times
+	 * @return Duration in milliseconds
+	 */
+	template<class Op> double measure(Op op)
+	{
+		auto start = chrono::high_resolution_clock::now();
+		for (unsigned int i = 0; i < s_iterations; i++)
+			op(i);
+		auto end = chrono::high_resolution_clock::now();
+		return chrono::duration<double, milli>(end - start).count();
+	}
+
+	/**
+	 * @brief Runs all kernel operations s_iterations times on the test numbers
+	 * @param times Durations in milliseconds for matrix multiply, transform, invert and quaternion multiply/rotate
+	 */
+	template<class Kernel> void run(double (&times)[4])
+	{
+		float mats[9][16];
+		for (unsigned int m = 0; m < 9; m++)
+			for (unsigned int i = 0; i < 16; i++)
+				mats[m][i] = numbers[(i + m) % 9] + (i % 5 == 0 ? 1000 : 0);
+		float out[16] = {};
+		float det = 0;
+		times[0] = measure([&](unsigned int i)
+		{
+			Kernel::multiplyMat4(mats[i % 9], mats[(i + 1) % 9], out);
+		});
+		times[1] = measure([&](unsigned int i)
+		{
+			Kernel::transformVec4(mats[i % 9], &numbers[i % 5], out);
+			Kernel::transformPoint3(mats[i % 9], &numbers[i % 6], out + 4);
+		});
+		times[2] = measure([&](unsigned int i)
+		{
+			det += Kernel::invertMat4(mats[i % 9], out);
+		});
+		times[3] = measure([&](unsigned int i)
+		{
+			Kernel::multiplyQuat(&numbers[i % 5], &numbers[(i + 1) % 5], out);
+			Kernel::rotateVec3(out, &numbers[i % 6], out + 4);
+		});
+		s_sink = out[0] + out[4] + det;
+	}
+
+	void simdKernels()
+	{
+		double scalar[4], simd[4];
+		run<ScalarMathKernel>(scalar);
+		run<MathKernel>(simd);
+		const char* names[] = { "mat4 * mat4", "mat4 * vec", "invert", "quaternion" };
+		cout << "  " << s_iterations << " iterations, scalar vs. "
+#if defined(DBGL_MATH_AVX)
+				<< "AVX"
+#elif defined(DBGL_MATH_SIMD)
+				<< "SSE"
+#else
+				<< "scalar"
+#endif
+				<< endl;
+		for (unsigned int i = 0; i < 4; i++)
+			cout << "  " << names[i] << ": " << scalar[i] << " ms vs. " << simd[i] << " ms" << endl;
+	}
+}
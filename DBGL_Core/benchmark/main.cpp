@@ -0,0 +1,31 @@
+//////////////////////////////////////////////////////////////////////
+/// Dragon Blaze Game Library
+///
+/// Copyright (c) 2015 by Jan Moeller
+///
+/// This software is provided "as-is" and does not claim to be
+/// complete or free of bugs in any way. It should work, but
+/// it might also begin to hurt your kittens.
+//////////////////////////////////////////////////////////////////////
+
+#include <iostream>
+#include "Benchmark.h"
+
+/**
+ * @brief Runs all core benchmarks and prints their timings
+ * @details Kept apart from the unit tests, so test runs stay fast and quiet.
+ */
+int main()
+{
+	std::cout << "SIMD kernels..." << std::endl;
+	dbgl_benchmark::simdKernels();
+	std::cout << "PoolAllocator contention..." << std::endl;
+	dbgl_benchmark::poolAllocatorContention();
+	std::cout << "BoundingVolumeHierarchy..." << std::endl;
+	dbgl_benchmark::boundingVolumeHierarchy();
+	std::cout << "StaticKdTree..." << std::endl;
+	dbgl_benchmark::staticKdTree();
+	std::cout << "StaticKdTree batched queries..." << std::endl;
+	dbgl_benchmark::staticKdTreeBatched();
+	return 0;
+}
@@ -0,0 +1,129 @@
+//////////////////////////////////////////////////////////////////////
+/// Dragon Blaze Game Library
+///
+/// Copyright (c) 2015 by Jan Moeller
+///
+/// This software is provided "as-is" and does not claim to be
+/// complete or free of bugs in any way. It should work, but
+/// it might also begin to hurt your kittens.
+//////////////////////////////////////////////////////////////////////
+
+#ifndef INCLUDE_DBGL_CORE_COLLECTION_FLATHASHMAP_H_
+#define INCLUDE_DBGL_CORE_COLLECTION_FLATHASHMAP_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <utility>
+#include <vector>
+
+namespace dbgl
+{
+	/**
+	 * @brief Hash map that stores all entries in a single array
+	 * @details Collisions are resolved by linear probing, thus a lookup usually touches a single cache line and
+	 * 			inserting doesn't allocate unless the map has to grow. The capacity is always a power of two and the
+	 * 			map grows once it is three quarters full. Erasing shifts the following entries back instead of
+	 * 			leaving tombstones, so lookups don't degrade over time.
+	 * 			The hash returned by \p Hash is mixed before use, thus identity hashes (like std::hash for integers)
+	 * 			work fine. Pointers to values are invalidated by any insertion or erasure.
+	 * @note Key and Value have to be default constructible.
+	 */
+	template<typename Key, typename Value, typename Hash = std::hash<Key>, typename KeyEqual = std::equal_to<Key>>
+	class FlatHashMap
+	{
+	public:
+		/**
+		 * @brief Constructs an empty map
+		 * @param capacity Amount of entries the map should hold without growing
+		 */
+		explicit FlatHashMap(std::size_t capacity = 0);
+		/**
+		 * @brief Looks up a key
+		 * @param key Key to look for
+		 * @return Pointer to the value stored for \p key or nullptr if there is none
+		 */
+		Value* find(Key const& key);
+		/**
+		 * @copydoc find(Key const&)
+		 */
+		Value const* find(Key const& key) const;
+		/**
+		 * @brief Inserts a value unless the key is already present
+		 * @param key Key to insert
+		 * @param value Value to insert
+		 * @return Pointer to the value stored for \p key and true if it was inserted, false if it was present before
+		 */
+		std::pair<Value*, bool> insert(Key const& key, Value const& value);
+		/**
+		 * @brief Retrieves the value of a key, inserting a default constructed value if the key isn't present
+		 * @param key Key to look for
+		 * @return Reference to the value stored for \p key
+		 */
+		Value& operator[](Key const& key);
+		/**
+		 * @brief Removes a key
+		 * @param key Key to remove
+		 * @return True if the key was removed, false if it wasn't present
+		 */
+		bool erase(Key const& key);
+		/**
+		 * @brief Removes all entries, but keeps the memory
+		 */
+		void clear();
+		/**
+		 * @brief Makes sure the map can hold a certain amount of entries without growing
+		 * @param count Amount of entries
+		 */
+		void reserve(std::size_t count);
+		/**
+		 * @return Amount of stored entries
+		 */
+		std::size_t size() const;
+		/**
+		 * @return True if no entries are stored, otherwise false
+		 */
+		bool empty() const;
+		/**
+		 * @brief Calls a function on all entries, in no particular order
+		 * @param func Function with signature void(Key const&, Value&). May not insert or erase.
+		 */
+		template<typename Func> void forEach(Func const& func);
+	private:
+		struct Slot
+		{
+			Key m_key { };
+			Value m_value { };
+		};
+		/**
+		 * @brief Computes the slot a key would ideally be stored at
+		 */
+		std::size_t home(Key const& key) const;
+		/**
+		 * @brief Finds the slot of a key
+		 * @return Index of the slot or the capacity if the key isn't present
+		 */
+		std::size_t locate(Key const& key) const;
+		/**
+		 * @brief Stores a key that isn't present yet, growing if needed
+		 * @return Index of the slot
+		 */
+		std::size_t place(Key const& key);
+		/**
+		 * @brief Changes the capacity and reinserts all entries
+		 * @param capacity New capacity, has to be a power of two
+		 */
+		void rehash(std::size_t capacity);
+
+		std::vector<Slot> m_slots;
+		std::vector<std::uint8_t> m_used;
+		std::size_t m_size = 0;
+		Hash m_hash { };
+		KeyEqual m_equal { };
+		static constexpr std::size_t s_minCapacity = 8;
+	};
+}
+
+#include "FlatHashMap.imp"
+
+#endif /* INCLUDE_DBGL_CORE_COLLECTION_FLATHASHMAP_H_ */
@@ -12,7 +12,12 @@
 #define INCLUDE_DBGL_CORE_COLLECTION_TREE_BOUNDINGVOLUMEHIERARCHY_H_
 
 #include "AbstractTree.h"
-#include "DBGL/Core/Shape/IShape.h"
+#include "DBGL/Core/Shape/Shapes.h"
+#include "DBGL/Core/Math/Vector.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
 #include <vector>
 
 namespace dbgl
@@ -20,6 +25,13 @@ namespace dbgl
 	/**
 	 * @brief This class implements a bounding volume hierarchy. It tries to sort volumetric objects into a tree
 	 *        in a way that accelerates range searches.
+	 * @details Every element is stored in a leaf of its own. All nodes live in one contiguous array and refer
+	 *          to each other by index. The tree can be built at once from a list of elements using the surface
+	 *          area heuristic, or grown one element at a time. Elements that move can be updated in place,
+	 *          which only adjusts the bounds of their ancestors. If rotations are enabled, the tree is
+	 *          locally restructured while adjusting bounds, which keeps its quality high under motion.
+	 *          All queries traverse the tree with a fixed-size stack and don't allocate any memory except
+	 *          for the returned results.
 	 */
 	template<typename Data, typename Volume> class BoundingVolumeHierarchy: public AbstractTree
 	{
@@ -39,15 +51,42 @@ namespace dbgl
 			 */
 			Data m_data;
 		};
+		/**
+		 * @brief Identifies an element within the tree. Stays valid until the element is removed.
+		 */
+		using Handle = unsigned int;
+		/**
+		 * @brief Identifies a subtree, see split(). Stays valid until the tree is modified.
+		 */
+		using Subtree = unsigned int;
+		/**
+		 * @brief Scalar type of the volumes
+		 */
+		using PrecisionType = typename Volume::PrecisionType;
+		/**
+		 * @brief Point type matching the dimension of the volumes
+		 */
+		using PointType = Vector<PrecisionType, Volume::getDimension()>;
+		/**
+		 * @brief Plane type matching the dimension of the volumes
+		 */
+		using PlaneType = HyperPlane<PrecisionType, Volume::getDimension()>;
 		/**
 		 * @brief Default constructor
 		 */
 		BoundingVolumeHierarchy() = default;
+		/**
+		 * @brief Constructs a tree from the passed elements
+		 * @details See build().
+		 * @param begin Iterator pointing to the first Aggregate to add
+		 * @param end Iterator pointing behind the last Aggregate to add
+		 */
+		template<class InputIterator> BoundingVolumeHierarchy(InputIterator begin, InputIterator end);
 		/**
 		 * @brief Copy constructor
 		 * @param other BVH to copy
 		 */
-		BoundingVolumeHierarchy(BoundingVolumeHierarchy<Data, Volume> const& other);
+		BoundingVolumeHierarchy(BoundingVolumeHierarchy<Data, Volume> const& other) = default;
 		/**
 		 * @brief Move constructor
 		 * @param other BVH to move
@@ -56,33 +95,70 @@ namespace dbgl
 		/**
 		 * @brief Destructor
 		 */
-		~BoundingVolumeHierarchy();
+		~BoundingVolumeHierarchy() = default;
 		/**
 		 * @brief Copy-assignment operator
 		 * @param other BVH to copy-assign
 		 * @return Reference to this
 		 */
-		BoundingVolumeHierarchy<Data, Volume>& operator=(BoundingVolumeHierarchy<Data, Volume> const& other);
+		BoundingVolumeHierarchy<Data, Volume>& operator=(BoundingVolumeHierarchy<Data, Volume> const& other) = default;
 		/**
 		 * @brief Move-assignment operator
 		 * @param other BVH to move-assign
 		 * @return Reference to this
 		 */
 		BoundingVolumeHierarchy<Data, Volume>& operator=(BoundingVolumeHierarchy<Data, Volume> && other);
+		/**
+		 * @brief Replaces the contents of the tree with the passed elements
+		 * @details Builds the tree top-down, splitting every node where the surface area heuristic estimates
+		 *          the lowest traversal cost. The split candidates are found by sorting the element centers
+		 *          into a fixed amount of bins. This produces considerably better trees than inserting the
+		 *          elements one by one.
+		 * @param elements Elements to build the tree from. The element at index i gets handle i.
+		 */
+		void build(std::vector<Aggregate> const& elements);
 		/**
 		 * @brief Inserts an element into the tree
 		 * @param volume Volumetric data of the element to add
 		 * @param data Data to store with the volume
+		 * @return Handle of the inserted element
 		 */
-		void insert(Volume const& volume, Data const& data);
+		Handle insert(Volume const& volume, Data const& data);
 		/**
-		 * @brief Completely removes an element from the tree
+		 * @brief Completely removes all elements from the tree that intersect \p volume and hold \p data
 		 * @param volume Volumetric data of the element to remove
 		 * @param data Data stored with the volume
 		 * @return Amount of removed elements
-		 * @note Generally this is an expensive operation and shouldn't be done frequently
 		 */
 		unsigned int remove(Volume const& volume, Data const& data);
+		/**
+		 * @brief Removes an element from the tree
+		 * @param handle Handle of the element to remove
+		 * @throws std::invalid_argument if \p handle doesn't refer to an element of this tree
+		 */
+		void remove(Handle handle);
+		/**
+		 * @brief Changes the volume of an element
+		 * @param handle Handle of the element to update
+		 * @param volume New volume
+		 * @param refit If true, the bounds of all ancestors are adjusted right away. Pass false when updating
+		 *              many elements at once and call refit() afterwards. Different elements may then be
+		 *              updated concurrently.
+		 * @throws std::invalid_argument if \p handle doesn't refer to an element of this tree
+		 */
+		void update(Handle handle, Volume const& volume, bool refit = true);
+		/**
+		 * @brief Recomputes the bounds of all inner nodes bottom-up
+		 * @details Needs to be called after elements have been updated without refitting.
+		 */
+		void refit();
+		/**
+		 * @brief Retrieves an element
+		 * @param handle Handle of the element
+		 * @return The element
+		 * @throws std::invalid_argument if \p handle doesn't refer to an element of this tree
+		 */
+		Aggregate const& getAggregate(Handle handle) const;
 		/**
 		 * @brief Finds all points within \p range
 		 * @param range Range to find all points in
@@ -106,6 +182,115 @@ namespace dbgl
 		 */
 		void get(IShape<typename Volume::PrecisionType, Volume::getDimension()> const& range,
 				std::vector<Data>& result) const;
+		/**
+		 * @brief Calls \p visitor for all elements that intersect with \p range
+		 * @details The intersection tests are resolved at compile time for the static type of \p range, so
+		 *          passing a concrete shape such as a HyperSphere or HyperRectangle avoids virtual calls.
+		 * @param range Range to find all elements in
+		 * @param visitor Function with signature bool(Handle, Aggregate const&). Returning false stops the
+		 *                query.
+		 */
+		template<typename Shape, typename Visitor> void query(Shape const& range, Visitor&& visitor) const;
+		/**
+		 * @brief Calls \p visitor for all elements that are not completely behind any of the passed planes
+		 * @details This is meant for convex volumes such as a view frustum, whose planes all point inwards.
+		 *          Every plane is tested directly. Once a node lies completely in front of a plane, that plane
+		 *          isn't tested again for any of its descendants.
+		 * @param planes Array of planes
+		 * @param amount Amount of planes, at most 32
+		 * @param visitor Function with signature bool(Handle, Aggregate const&). Returning false stops the
+		 *                query.
+		 * @throws std::invalid_argument if \p amount is larger than 32
+		 */
+		template<typename Visitor> void queryPlanes(PlaneType const* planes, unsigned int amount,
+				Visitor&& visitor) const;
+		/**
+		 * @brief Calls \p visitor for all elements of a subtree that are not completely behind any of the
+		 *        passed planes
+		 * @details See queryPlanes(). Different subtrees can be queried concurrently.
+		 * @param subtree Subtree to query
+		 * @param planes Array of planes
+		 * @param amount Amount of planes, at most 32
+		 * @param visitor Function with signature bool(Handle, Aggregate const&). Returning false stops the
+		 *                query.
+		 * @throws std::invalid_argument if \p amount is larger than 32 or \p subtree is invalid
+		 */
+		template<typename Visitor> void queryPlanes(Subtree subtree, PlaneType const* planes, unsigned int amount,
+				Visitor&& visitor) const;
+		/**
+		 * @brief Finds the first element hit by a ray
+		 * @param origin Ray origin
+		 * @param direction Ray direction, doesn't need to be normalized
+		 * @param maxDistance Elements further away than this aren't considered
+		 * @param[out] hit Handle of the first hit element
+		 * @param[out] distance Ray parameter of the hit, i.e. the hit point is origin + direction * distance
+		 * @return True if an element was hit, otherwise false. The output parameters are only modified if an
+		 *         element was hit.
+		 */
+		bool castRay(PointType const& origin, PointType const& direction, PrecisionType maxDistance, Handle& hit,
+				PrecisionType& distance) const;
+		/**
+		 * @brief Finds the first element hit by a ray that is accepted by \p filter
+		 * @details Subtrees that are further away than the closest accepted hit so far are skipped.
+		 * @param origin Ray origin
+		 * @param direction Ray direction, doesn't need to be normalized
+		 * @param maxDistance Elements further away than this aren't considered
+		 * @param filter Function with signature bool(Handle, Aggregate const&, PrecisionType& distance). Gets
+		 *               passed the distance at which the ray enters the volume of an element. May do a more
+		 *               exact test and increase the distance accordingly. Returns false to reject the element.
+		 * @param[out] hit Handle of the first hit element
+		 * @param[out] distance Ray parameter of the hit, i.e. the hit point is origin + direction * distance
+		 * @return True if an element was hit, otherwise false. The output parameters are only modified if an
+		 *         element was hit.
+		 */
+		template<typename Filter> bool castRay(PointType const& origin, PointType const& direction,
+				PrecisionType maxDistance, Filter&& filter, Handle& hit, PrecisionType& distance) const;
+		/**
+		 * @brief Finds the first element hit by a line segment
+		 * @param from Start point of the segment
+		 * @param to End point of the segment
+		 * @param[out] hit Handle of the element closest to \p from
+		 * @param[out] fraction Position of the hit along the segment, between 0 and 1
+		 * @return True if an element was hit, otherwise false
+		 */
+		bool castSegment(PointType const& from, PointType const& to, Handle& hit, PrecisionType& fraction) const;
+		/**
+		 * @brief Finds the first element hit by a line segment that is accepted by \p filter
+		 * @param from Start point of the segment
+		 * @param to End point of the segment
+		 * @param filter See castRay()
+		 * @param[out] hit Handle of the element closest to \p from
+		 * @param[out] fraction Position of the hit along the segment, between 0 and 1
+		 * @return True if an element was hit, otherwise false
+		 */
+		template<typename Filter> bool castSegment(PointType const& from, PointType const& to, Filter&& filter,
+				Handle& hit, PrecisionType& fraction) const;
+		/**
+		 * @brief Splits the tree into disjoint subtrees
+		 * @details Descends level by level until there are at least \p amount subtrees or only leaves are left.
+		 *          Together the subtrees hold all elements, so work on the whole tree can be partitioned by
+		 *          them, e.g. to run queries on multiple threads.
+		 * @param amount Desired amount of subtrees
+		 * @param[out] subtrees Will be filled with the subtrees. Empty if the tree is empty.
+		 */
+		void split(unsigned int amount, std::vector<Subtree>& subtrees) const;
+		/**
+		 * @brief Enables or disables tree rotations
+		 * @details Rotations are done while adjusting bounds after insert(), remove(), update() and refit().
+		 *          They are enabled by default.
+		 * @param enable True to enable rotations, otherwise false
+		 */
+		void setRotations(bool enable);
+		/**
+		 * @return True if rotations are enabled, otherwise false
+		 */
+		bool getRotations() const;
+		/**
+		 * @brief Estimates the cost of a query by the surface area heuristic
+		 * @return Sum of the surface areas of all inner nodes relative to the surface area of the root. Lower is
+		 *         better.
+		 */
+		double getCost() const;
 		/**
 		 * @brief Clears the tree.
 		 */
@@ -116,31 +301,108 @@ namespace dbgl
 		unsigned int size() const;
 
 	private:
-		class Node: public AbstractTree::Node
+		/**
+		 * @brief Node of the tree. Leaves refer to exactly one element, inner nodes have exactly two children.
+		 */
+		struct Node
 		{
-		public:
-			Aggregate m_info;
 			Volume m_bounds;
-			Node* m_pParent = nullptr;
-			Node* m_pLeftChild = nullptr;
-			Node* m_pRightChild = nullptr;
-			unsigned int m_children = 0;
+			unsigned int m_parent;
+			unsigned int m_left;
+			unsigned int m_right;
+			Handle m_element;
+			bool isLeaf() const
+			{
+				return m_left == s_invalid;
+			}
+		};
+		/**
+		 * @brief Axis-aligned bounds of an element, used while building
+		 */
+		struct BuildEntry
+		{
+			PointType m_lower;
+			PointType m_upper;
+			PointType m_center;
+		};
+		/**
+		 * @brief Bin used to find the best split while building
+		 */
+		struct Bin
+		{
+			PointType m_lower;
+			PointType m_upper;
+			unsigned int m_count;
 		};
 
-		Node* copyNode(Node* node) const;
-		void free(Node* node);
-		void insert(Volume const& volume, Data const& data, Node* node);
-		float rateNode(Node* node, Node* parent, Volume const& volume) const;
-		unsigned int remove(Volume const& volume, Data const& data, Node* node);
-		Node* findReplacement(Node* node);
-		void get(IShape<typename Volume::PrecisionType, Volume::getDimension()> const& range,
-				std::vector<Aggregate*>& result, Node* node) const;
-		void get(IShape<typename Volume::PrecisionType, Volume::getDimension()> const& range,
-				std::vector<Data*>& result, Node* node) const;
-		void get(IShape<typename Volume::PrecisionType, Volume::getDimension()> const& range, std::vector<Data>& result,
-				Node* node) const;
+		/**
+		 * @brief Node on the traversal stack of queryPlanes(), along with the planes that still need testing
+		 */
+		struct PlaneEntry
+		{
+			unsigned int m_node;
+			unsigned int m_mask;
+		};
+		/**
+		 * @brief Node on the traversal stack of castRay(), along with the distance at which the ray enters it
+		 */
+		struct RayEntry
+		{
+			unsigned int m_node;
+			PrecisionType m_distance;
+		};
+
+		/**
+		 * @brief Marks invalid node indices and handles
+		 */
+		static constexpr unsigned int s_invalid = std::numeric_limits<unsigned int>::max();
+		/**
+		 * @brief Amount of bins per axis used to find splits during build()
+		 */
+		static constexpr unsigned int s_bins = 16;
+		/**
+		 * @brief Size of the traversal stack. Deeper trees continue on a fresh stack.
+		 */
+		static constexpr unsigned int s_stackSize = 64;
+		/**
+		 * @brief Maximum amount of planes passed to queryPlanes()
+		 */
+		static constexpr unsigned int s_maxPlanes = 32;
+
+		unsigned int allocateNode();
+		void freeNode(unsigned int node);
+		void checkHandle(Handle handle) const;
+		unsigned int build(std::vector<Handle>& handles, std::vector<BuildEntry> const& entries, std::size_t begin,
+				std::size_t end);
+		void insertLeaf(unsigned int leaf);
+		void removeLeaf(unsigned int leaf);
+		void refitFrom(unsigned int node);
+		void refit(unsigned int node);
+		void updateBounds(unsigned int node);
+		void rotate(unsigned int node);
+		void swap(unsigned int node, unsigned int grandChild);
+		template<typename Shape, typename Visitor> bool traverse(unsigned int root, Shape const& range,
+				Visitor& visitor) const;
+		template<typename Visitor> bool traversePlanes(PlaneEntry root, PlaneType const* planes,
+				PrecisionType const* offsets, unsigned int amount, Visitor& visitor) const;
+		template<typename Filter> void traverseRay(RayEntry root, PointType const& origin, PointType const& direction,
+				Filter& filter, Handle& hit, PrecisionType& distance, bool& found) const;
+		template<typename Shape> static void project(Shape const& volume, PointType const& normal,
+				PrecisionType& center, PrecisionType& extent);
+		static void project(HyperSphere<PrecisionType, Volume::getDimension()> const& volume, PointType const& normal,
+				PrecisionType& center, PrecisionType& extent);
+		static Volume merge(Volume const& lhs, Volume const& rhs);
+		static PrecisionType area(Volume const& volume);
+		static PrecisionType area(PointType const& lower, PointType const& upper);
+		static bool equals(Volume const& lhs, Volume const& rhs);
 
-		Node* m_pRoot = nullptr;
+		std::vector<Node> m_nodes;
+		std::vector<unsigned int> m_freeNodes;
+		std::vector<Aggregate> m_elements;
+		std::vector<unsigned int> m_leaves;
+		std::vector<Handle> m_freeElements;
+		unsigned int m_root = s_invalid;
+		bool m_rotations = true;
 	};
 }
 
@@ -18,6 +18,7 @@
 #include <type_traits>
 #include "AbstractTree.h"
 #include "DBGL/Core/Shape/Shapes.h"
+#include "DBGL/Core/Utility/Parallel.h"
 
 namespace dbgl
 {
@@ -178,9 +179,22 @@ namespace dbgl
 		 * @brief Finds the k nearest neighbors to point
 		 * @param point Point to find the nearest neighbors for
 		 * @param k Amount of nearest neighbors to find
-		 * @param[out] nearest This list will be filled with the found nearest neighbors
+		 * @param[out] nearest This list will be filled with the found nearest neighbors, closest first
+		 * @throws std::invalid_argument if k is zero
 		 */
 		void findKNearestNeighbors(Point const& point, unsigned int k, std::vector<Container>& nearest) const;
+		/**
+		 * @brief Finds the k nearest neighbors to each of multiple points
+		 * @details The queries are distributed over multiple threads if there are enough of them.
+		 * @param points Array of points to find the nearest neighbors for
+		 * @param amount Amount of points
+		 * @param k Amount of nearest neighbors to find per point
+		 * @param[out] results Array of \p amount lists. The list at index i will be filled with the nearest
+		 * 			neighbors of the point at index i, closest first.
+		 * @throws std::invalid_argument if k is zero
+		 */
+		void findKNearestNeighbors(Point const* points, std::size_t amount, unsigned int k,
+				std::vector<Container>* results) const;
 		/**
 		 * @brief Finds all points within \p range
 		 * @param range Range to find all points in
@@ -219,7 +233,19 @@ namespace dbgl
 		{
 			Node const* pNode = nullptr;
 			float sqDist = std::numeric_limits<float>::max();
+			bool operator<(NearestNeighbor const& other) const
+			{
+				return sqDist < other.sqDist;
+			}
 		};
+		/**
+		 * @brief Minimum amount of elements in a partition to build its subtrees concurrently
+		 */
+		static constexpr std::size_t s_minParallelBuildSize = 16384;
+		/**
+		 * @brief Minimum amount of queries worth a thread of their own
+		 */
+		static constexpr std::size_t s_minParallelQueries = 256;
 
 		/**
 		 * @brief Copies a node and all of its children
@@ -312,17 +338,26 @@ namespace dbgl
 		void findNearestNeighbor(Point const& point, Node const& node, NearestNeighbor& currentBest, bool goDown,
 				unsigned int curDepth) const;
 
+		/**
+		 * @brief Finds the k nearest neighbors to point
+		 * @param point Point to find nearest neighbors for
+		 * @param k Amount of nearest neighbors to find
+		 * @param heap Buffer used for the candidate heap, will be cleared
+		 * @param[out] nearest This list will be filled with the found nearest neighbors, closest first
+		 */
+		void findKNearestNeighbors(Point const& point, unsigned int k, std::vector<NearestNeighbor>& heap,
+				std::vector<Container>& nearest) const;
 		/**
 		 * @brief Recursively finds the k nearest neighbors to point
 		 * @param point Point to find nearest neighbors for
 		 * @param k Amount of nearest neighbors to find
 		 * @param node Node to start search at
-		 * @param currentBest List of current best matches. Needs to have space for exactly k elements.
-		 * @param goDown Tells the algorithm to check for closer nodes down of the current node
+		 * @param heap Max-heap of the current best matches, ordered by squared distance. Holds at most k
+		 * 			elements.
 		 * @param curDepth Current depth
 		 */
 		void findKNearestNeighbors(Point const& point, unsigned int k, Node const& node,
-				std::vector<NearestNeighbor>& currentBest, bool goDown, unsigned int curDepth) const;
+				std::vector<NearestNeighbor>& heap, unsigned int curDepth) const;
 		/**
 		 * @brief Recursively finds all points within \p range
 		 * @param range Range to find points in
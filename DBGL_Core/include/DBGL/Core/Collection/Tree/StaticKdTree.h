@@ -0,0 +1,237 @@
+//////////////////////////////////////////////////////////////////////
+/// Dragon Blaze Game Library
+///
+/// Copyright (c) 2015 by Jan Moeller
+///
+/// This software is provided "as-is" and does not claim to be
+/// complete or free of bugs in any way. It should work, but
+/// it might also begin to hurt your kittens.
+//////////////////////////////////////////////////////////////////////
+
+#ifndef STATICKDTREE_H_
+#define STATICKDTREE_H_
+
+#include <iterator>
+#include <algorithm>
+#include <vector>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include "KdTree.h"
+#include "DBGL/Core/Shape/Shapes.h"
+#include "DBGL/Core/Utility/Parallel.h"
+
+namespace dbgl
+{
+	/**
+	 * @brief A k-d tree that is built once and can't be modified afterwards.
+	 * @details Provides the same queries as KdTree, but stores the tree in flat arrays instead of
+	 * 		individually allocated nodes. The tree is left-balanced and stored in implicit order, i.e.
+	 * 		the children of the node at index i are located at 2i+1 and 2i+2, so no child pointers
+	 * 		are needed at all. Coordinates are stored per dimension (structure of arrays), which keeps
+	 * 		the splitting coordinates that are touched during a query close together in memory.
+	 * 		Queries don't allocate any memory except for the returned results.
+	 * @note This implementation is meant to be used with dbgl::Vector as Point.
+	 */
+	template<typename Data, typename Point> class StaticKdTree
+	{
+	private:
+		using PrecisionType = typename std::remove_const<typename std::remove_reference<decltype((*((Point*)(0)))[0])>::type>::type;
+	public:
+		/**
+		 * @brief Container struct used to create a k-d tree from a list and to return query results
+		 */
+		using Container = typename KdTree<Data, Point>::Container;
+
+		/**
+		 * @brief Constructs an empty k-d tree.
+		 */
+		StaticKdTree() = default;
+		/**
+		 * @brief Constructs an k-d tree from the passed elements
+		 * @details The iterators have to be random-access iterators to a list of StaticKdTree::Container
+		 * @param begin Iterator pointing to the first element to add
+		 * @param end iterator pointing to the last element to add
+		 */
+		template<class RandomAccessIterator> StaticKdTree(RandomAccessIterator begin, RandomAccessIterator end);
+		/**
+		 * @brief Constructs an k-d tree from the passed elements
+		 * @details The iterators have to be random-access iterators to a list of Point/Data
+		 * @param beginPoints Iterator pointing to the first point to add
+		 * @param endPoints iterator pointing to the last point to add
+		 * @param beginDat Iterator pointing to the first data to add
+		 * @param endDat iterator pointing to the last data to add
+		 * @throws std::range_error if the amount of points and data doesn't match
+		 */
+		template<class RandomAccessIterator1, class RandomAccessIterator2> StaticKdTree(
+				RandomAccessIterator1 beginPoints, RandomAccessIterator1 endPoints, RandomAccessIterator2 beginDat,
+				RandomAccessIterator2 endDat);
+		/**
+		 * @brief Gets the data attached to the passed point
+		 * @param point Point to get data for
+		 * @return Pointer to the data attached to the passed point or NULL if the point wasn't found
+		 */
+		Data const* get(Point const& point) const;
+		/**
+		 * @brief Gets the data attached to the first found point similar to the passed one
+		 * @param point Point to get data for
+		 * @param precision Defines how close every coordinate has to be to be treated as similar
+		 * @return Pointer to the data attached to the passed point or NULL if the point wasn't found
+		 */
+		Data const* getSimilar(Point const& point, double precision = 0.001) const;
+		/**
+		 * @brief Finds the nearest neighbor to point
+		 * @param point Point to find the nearest neighbor for
+		 * @param[out] nearest Location of the nearest neighbor will be copied here
+		 * @param[out] data Data attached to the nearest neighbor will be copied here
+		 * @throws std::logic_error if the tree is empty
+		 */
+		void findNearestNeighbor(Point const& point, Point& nearest, Data& data) const;
+		/**
+		 * @brief Finds the k nearest neighbors to point
+		 * @param point Point to find the nearest neighbors for
+		 * @param k Amount of nearest neighbors to find
+		 * @param[out] nearest This list will be filled with the found nearest neighbors, closest first
+		 * @throws std::invalid_argument if k is zero
+		 */
+		void findKNearestNeighbors(Point const& point, unsigned int k, std::vector<Container>& nearest) const;
+		/**
+		 * @brief Finds the k nearest neighbors to each of multiple points
+		 * @details The queries are distributed over multiple threads if there are enough of them.
+		 * @param points Array of points to find the nearest neighbors for
+		 * @param amount Amount of points
+		 * @param k Amount of nearest neighbors to find per point
+		 * @param[out] results Array of \p amount lists. The list at index i will be filled with the nearest
+		 * 			neighbors of the point at index i, closest first.
+		 * @throws std::invalid_argument if k is zero
+		 */
+		void findKNearestNeighbors(Point const* points, std::size_t amount, unsigned int k,
+				std::vector<Container>* results) const;
+		/**
+		 * @brief Finds all points within \p range
+		 * @param range Range to find all points in
+		 * @param[out] result This list will be filled with the found points
+		 */
+		void findRange(HyperRectangle<PrecisionType, Point::getDimension()> const& range,
+				std::vector<Container>& result) const;
+		/**
+		 * @brief Collects all elements stored in the tree
+		 * @param[out] container Adds all elements to this list
+		 */
+		void getAll(std::vector<Container>& container) const;
+		/**
+		 * @return Amount of elements held by the tree
+		 */
+		unsigned int size() const;
+		/**
+		 * @brief Clears the tree.
+		 */
+		void clear();
+	private:
+		/**
+		 * @brief Entry of the explicit stack used to traverse the tree without recursion
+		 */
+		struct StackEntry
+		{
+			unsigned int index;
+			unsigned int depth;
+			PrecisionType sqDist;
+		};
+		/**
+		 * @brief Candidate for the k nearest neighbors
+		 */
+		struct NearestNeighbor
+		{
+			unsigned int index;
+			PrecisionType sqDist;
+			bool operator<(NearestNeighbor const& other) const
+			{
+				return sqDist < other.sqDist;
+			}
+		};
+		/**
+		 * @brief Maximum depth of the explicit traversal stack, enough for 2^64 elements
+		 */
+		static constexpr unsigned int s_maxDepth = 64;
+		/**
+		 * @brief Minimum amount of elements in a partition to build its subtrees concurrently
+		 */
+		static constexpr std::size_t s_minParallelBuildSize = 16384;
+		/**
+		 * @brief Minimum amount of queries worth a thread of their own
+		 */
+		static constexpr std::size_t s_minParallelQueries = 256;
+
+		/**
+		 * @brief Builds the tree from the passed list
+		 * @param elements Elements to build the tree from. Will be reordered.
+		 */
+		void build(std::vector<Container>& elements);
+		/**
+		 * @brief Recursively builds the subtree rooted at \p index
+		 * @param begin Iterator pointing to the first element of the subtree
+		 * @param end Iterator pointing behind the last element of the subtree
+		 * @param index Array index of the subtree root
+		 * @param depth Depth of the subtree root
+		 */
+		void buildSubtree(typename std::vector<Container>::iterator begin,
+				typename std::vector<Container>::iterator end, unsigned int index, unsigned int depth);
+		/**
+		 * @brief Computes the size of the left subtree of a left-balanced tree
+		 * @param n Total amount of elements in the tree
+		 * @return Amount of elements in the left subtree
+		 */
+		static unsigned int leftSubtreeSize(unsigned int n);
+		/**
+		 * @brief Finds the k nearest neighbors to point
+		 * @param point Point to find nearest neighbors for
+		 * @param k Amount of nearest neighbors to find, must not be zero
+		 * @param heap Buffer used for the candidate heap, will be cleared
+		 * @param[out] nearest This list will be filled with the found nearest neighbors, closest first
+		 */
+		void findKNearestNeighbors(Point const& point, unsigned int k, std::vector<NearestNeighbor>& heap,
+				std::vector<Container>& nearest) const;
+		/**
+		 * @brief Searches for a point matching \p point
+		 * @param point Point to search for
+		 * @param match Function used to check if an element matches
+		 * @param precision Coordinate precision of \p match, used to decide which subtrees to visit
+		 * @return Index of the first matching element or size() if nothing matched
+		 */
+		template<typename Match> unsigned int search(Point const& point, Match const& match,
+				PrecisionType precision) const;
+		/**
+		 * @brief Retrieves a coordinate of an element
+		 * @param index Element index
+		 * @param dim Dimension
+		 * @return The coordinate
+		 */
+		inline PrecisionType coord(unsigned int index, unsigned int dim) const;
+		/**
+		 * @brief Computes the squared distance of an element to a point
+		 * @param index Element index
+		 * @param point Point
+		 * @return Squared distance
+		 */
+		inline PrecisionType sqDistance(unsigned int index, Point const& point) const;
+		/**
+		 * @brief Reconstructs the point of an element
+		 * @param index Element index
+		 * @return The point
+		 */
+		inline Point getPoint(unsigned int index) const;
+
+		/**
+		 * @brief Coordinates, stored as one block of size() coordinates per dimension
+		 */
+		std::vector<PrecisionType> m_coords;
+		/**
+		 * @brief Data attached to the elements
+		 */
+		std::vector<Data> m_data;
+	};
+}
+
+#include "StaticKdTree.imp"
+
+#endif /* STATICKDTREE_H_ */
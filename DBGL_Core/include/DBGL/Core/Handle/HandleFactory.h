@@ -12,9 +12,9 @@
 #define INCLUDE_DBGL_CORE_HANDLE_HANDLEFACTORY_H_
 
 #include <vector>
-#include <set>
 #include <limits>
-#include <exception>
+#include <stdexcept>
+#include <string>
 #include <cstdint>
 #include <algorithm>
 #include <functional>
@@ -27,17 +27,31 @@ namespace dbgl
      * 		Handles will be generated sequentially, with lower identifiers being
      * 		favored over higher ones, i.e. if a low qualifier is getting invalidated, a
      * 		newly generated one will take the same ID instead of generating a new one.
-     * 		Copying an existing identifier will link the copy to the "original". If one
-     * 		is getting invalidated, the other one will be invalid as well. When the last
-     * 		instance of an identifier is destroyed, the handle will automatically become
-     * 		invalid and will be reused for future identifiers.
+     * 		Internally, every handle is a generational index: the index of a slot in a
+     * 		dense slot array and the generation of that slot, packed into one integer of
+     * 		type \p T. Whenever a slot is freed its generation is increased, which
+     * 		invalidates all handles that still refer to the old generation. Thus, checking
+     * 		a handle for validity is a constant-time array lookup, and handles don't need
+     * 		any heap memory on their own.
+     * 		If \p RefCounted is true, each slot also keeps track of the amount of handles
+     * 		referring to it. Copying an existing identifier will link the copy to the
+     * 		"original". If one is getting invalidated, the other one will be invalid as well.
+     * 		When the last instance of an identifier is destroyed, the handle will automatically
+     * 		become invalid and will be reused for future identifiers. Without reference
+     * 		counting, handles are plain values and are only freed by invalidate().
      * 		It is possible to create handles from a integers; in that case the
      * 		passed integer must not be already in use. This can be used to store handles
      * 		on harddisk and reload them at a later time.
      * 		If the factory is destroyed, all handles left will be invalidated.
+     * 		Once the generation of a slot is exhausted, the slot is retired instead of wrapping
+     * 		around, so an invalidated handle never becomes valid again.
+     * @warning Handles of a factory without reference counting must not be used after the factory
+     * 		has been destroyed.
      */
-    template<typename T = uint32_t> class HandleFactory
+    template<typename T = uint32_t, bool RefCounted = true> class HandleFactory
     {
+	private:
+	    struct State;
 	public:
 	    /**
 	     * @brief Handle object that can uniquely identify other objects.
@@ -48,18 +62,29 @@ namespace dbgl
 		    /**
 		     * @brief Construct an invalid handle
 		     */
-		    Handle();
+		    Handle() = default;
 		    /**
 		     * @brief Copy constructor
 		     * @param other Handle to copy
 		     */
 		    Handle(Handle const& other);
+		    /**
+		     * @brief Move constructor
+		     * @param other Handle to move, will be invalid afterwards
+		     */
+		    Handle(Handle&& other);
 		    /**
 		     * @brief Copy-assignment
 		     * @param other Handle to copy
 		     * @return Reference to the handle that has been assigned to.
 		     */
 		    Handle& operator=(Handle const& other);
+		    /**
+		     * @brief Move-assignment
+		     * @param other Handle to move, will be invalid afterwards
+		     * @return Reference to the handle that has been assigned to.
+		     */
+		    Handle& operator=(Handle&& other);
 		    /**
 		     * @brief Destructor
 		     */
@@ -75,11 +100,18 @@ namespace dbgl
 		    void invalidate();
 		    /**
 		     * @brief Retrieves the raw value of this handle
-		     * @return The value of this handle
+		     * @return The value of this handle, which is the index of its slot, or InvalidHandle
+		     * 	       if the handle is not valid
 		     */
 		    T getValue() const;
+		    /**
+		     * @brief Retrieves the generation of this handle
+		     * @return The generation of the slot this handle has been created for
+		     */
+		    T getGeneration() const;
 		    /**
 		     * @brief Retrieves the reference count of this handle
+		     * @return The reference count or 0 if reference counting is disabled or the handle is invalid
 		     */
 		    unsigned long getRefCount() const;
 		    /**
@@ -101,16 +133,22 @@ namespace dbgl
 		    static const T InvalidHandle = std::numeric_limits<T>::max();
 
 		private:
-		    Handle(T id, HandleFactory<T>* factory);
-		    void checkDelete();
+		    Handle(T key, State* pState);
+		    bool matches() const;
+		    void release();
 
-		    T* m_pId = nullptr;
-		    unsigned long* m_pRefCount = nullptr;
-		    HandleFactory<T>* m_pFactory = nullptr;
+		    T m_key = InvalidHandle;
+		    State* m_pState = nullptr;
 
-		    friend class HandleFactory<T>;
+		    friend class HandleFactory<T, RefCounted>;
 	    };
 
+	    /**
+	     * @brief Constructor
+	     */
+	    HandleFactory();
+	    HandleFactory(HandleFactory<T, RefCounted> const& other) = delete;
+	    HandleFactory<T, RefCounted>& operator=(HandleFactory<T, RefCounted> const& other) = delete;
 	    /**
 	     * @brief Destructor
 	     * @details Invalidates all handles handed out by this factory
@@ -134,8 +172,9 @@ namespace dbgl
 	     * @brief Checks if the passed handle is valid
 	     * @param handle Handle to check
 	     * @return True in case the handle is valid and in use, otherwise false
+	     * @note This operation has a constant time complexity
 	     */
-	    bool isValid(Handle const& handle);
+	    bool isValid(Handle const& handle) const;
 	    /**
 	     * @brief Invalidates a handle
 	     * @param handle Handle to invalidate
@@ -150,7 +189,61 @@ namespace dbgl
 	     * @return The amount of handles that are in use
 	     */
 	    T totalInUse() const;
+
+	    /**
+	     * @brief Amount of bits of a handle used for the slot index
+	     */
+	    static constexpr unsigned int s_indexBits = std::numeric_limits<T>::digits * 5 / 8;
+	    /**
+	     * @brief Highest slot index that can be handed out plus one
+	     */
+	    static constexpr T s_maxIndex = (T(1) << s_indexBits) - 1;
+	    /**
+	     * @brief Last generation of a slot, it is retired when freed afterwards
+	     */
+	    static constexpr T s_maxGeneration = (T(1) << (std::numeric_limits<T>::digits - s_indexBits)) - 1;
 	private:
+	    /**
+	     * @brief Entry of the slot array
+	     */
+	    struct Slot
+	    {
+		    T m_generation = 0;
+		    bool m_used = false;
+		    unsigned long m_refCount = 0;
+	    };
+	    /**
+	     * @brief Book-keeping shared between the factory and its handles
+	     * @details With reference counting, this outlives the factory until the last handle is gone.
+	     */
+	    struct State
+	    {
+		    /**
+		     * @brief Slot array, indexed by handle index
+		     */
+		    std::vector<Slot> m_slots {};
+		    /**
+		     * @brief Next ID that is not used yet
+		     */
+		    T m_next = 0;
+		    /**
+		     * @brief List of IDs that are currently not in use, but lower than @see next
+		     */
+		    std::vector<T> m_open {};
+		    /**
+		     * @brief Amount of slots in use
+		     */
+		    T m_inUse = 0;
+		    /**
+		     * @brief Amount of handle objects referring to this state
+		     */
+		    unsigned long m_handles = 0;
+		    /**
+		     * @brief Indicates if the factory still exists
+		     */
+		    bool m_alive = true;
+	    };
+
 	    /**
 	     * @brief Gets the next id to use and marks it as used
 	     * @return ID to use
@@ -163,19 +256,24 @@ namespace dbgl
 	     * @return ID to use
 	     */
 	    T tryUse(T id);
-
-	    /**
-	     * @brief Next ID that is not used yet
-	     */
-	    T m_next = 0;
 	    /**
-	     * @brief List of IDs that are currently not in use, but lower than @see next
+	     * @brief Marks a slot as used and creates the first handle for it
+	     * @param index Slot index
+	     * @return The new handle
 	     */
-	    std::vector<T> m_open{};
+	    Handle occupy(T index);
 	    /**
-	     * @brief Currently valid handles
+	     * @brief Frees a slot, invalidating all handles referring to it
+	     * @details Slots whose generation is exhausted are not reused anymore.
+	     * @param pState State the slot belongs to
+	     * @param index Slot index
 	     */
-	    std::set<T*> m_handles{};
+	    static void free(State* pState, T index);
+	    static constexpr T getIndex(T key);
+	    static constexpr T getGeneration(T key);
+	    static constexpr T makeKey(T index, T generation);
+
+	    State* m_pState;
     };
 }
 
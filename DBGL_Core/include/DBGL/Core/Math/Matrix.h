@@ -11,7 +11,6 @@
 #ifndef MATRIX_H_
 #define MATRIX_H_
 
-#include "DBGL/Core/Debug/Log.h"
 #include "Vector.h"
 
 namespace dbgl
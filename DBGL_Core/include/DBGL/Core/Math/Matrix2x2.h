@@ -11,7 +11,6 @@
 #ifndef MATRIX2X2_H_
 #define MATRIX2X2_H_
 
-#include "DBGL/Core/Debug/Log.h"
 #include "Matrix.h"
 #include "Vector2.h"
 
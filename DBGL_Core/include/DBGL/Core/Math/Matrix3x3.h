@@ -11,7 +11,6 @@
 #ifndef MATRIX3X3_H_
 #define MATRIX3X3_H_
 
-#include "DBGL/Core/Debug/Log.h"
 #include "Matrix.h"
 #include "Vector3.h"
 
@@ -12,11 +12,11 @@
 #define MATRIX4X4_H_
 
 #include <cmath>
-#include "DBGL/Core/Debug/Log.h"
 #include "Vector3.h"
 #include "Vector4.h"
 #include "Matrix.h"
 #include "Utility.h"
+#include "SIMD.h"
 
 namespace dbgl
 {
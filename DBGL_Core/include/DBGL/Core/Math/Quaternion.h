@@ -17,6 +17,8 @@
 #include "Vector4.h"
 #include "Matrix4x4.h"
 #include "Utility.h"
+#include "SIMD.h"
+#include "DBGL/Core/Debug/Log.h"
 
 namespace dbgl
 {
@@ -0,0 +1,184 @@
+//////////////////////////////////////////////////////////////////////
+/// Dragon Blaze Game Library
+///
+/// Copyright (c) 2015 by Jan Moeller
+///
+/// This software is provided "as-is" and does not claim to be
+/// complete or free of bugs in any way. It should work, but
+/// it might also begin to hurt your kittens.
+//////////////////////////////////////////////////////////////////////
+
+#ifndef SIMD_H_
+#define SIMD_H_
+
+#include <cmath>
+#include <cstddef>
+
+// SSE is used whenever the compiler targets it (always the case on x86-64), AVX only if enabled
+// explicitly, e.g. by passing -mavx. Define DBGL_MATH_NO_SIMD to force the scalar code path.
+#if !defined(DBGL_MATH_NO_SIMD) && (defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1))
+#define DBGL_MATH_SIMD
+#include <xmmintrin.h>
+#ifdef __AVX__
+#define DBGL_MATH_AVX
+#include <immintrin.h>
+#endif
+#endif
+
+namespace dbgl
+{
+	/**
+	 * @brief Portable implementation of the performance critical float operations of the math module
+	 * @details All matrices are expected to be 16 floats in column-major order, quaternions are 4 floats in
+	 * 			the order x, y, z, w. Three-dimensional vectors are 3 floats without any padding.
+	 * 			This implementation serves as reference for the SIMD code path and is used if SIMD is not
+	 * 			available on the target.
+	 */
+	class ScalarMathKernel
+	{
+	public:
+		/**
+		 * @brief Multiplies two 4x4 matrices
+		 * @param lhs Left hand side matrix
+		 * @param rhs Right hand side matrix
+		 * @param out Result of lhs * rhs. May not alias any of the inputs.
+		 */
+		static inline void multiplyMat4(float const* lhs, float const* rhs, float* out);
+		/**
+		 * @brief Transforms a four-dimensional vector by a 4x4 matrix
+		 * @param mat Matrix
+		 * @param vec Vector
+		 * @param out Result of mat * vec. May not alias any of the inputs.
+		 */
+		static inline void transformVec4(float const* mat, float const* vec, float* out);
+		/**
+		 * @brief Transforms a point by a 4x4 matrix, assuming a w coordinate of 1
+		 * @details No perspective division is done.
+		 * @param mat Matrix
+		 * @param vec Three-dimensional point
+		 * @param out Three-dimensional result. May not alias any of the inputs.
+		 */
+		static inline void transformPoint3(float const* mat, float const* vec, float* out);
+		/**
+		 * @brief Transforms a direction by a 4x4 matrix, assuming a w coordinate of 0
+		 * @param mat Matrix
+		 * @param vec Three-dimensional direction
+		 * @param out Three-dimensional result. May not alias any of the inputs.
+		 */
+		static inline void transformDirection3(float const* mat, float const* vec, float* out);
+		/**
+		 * @brief Transposes a 4x4 matrix
+		 * @param mat Matrix to transpose
+		 * @param out Transposed matrix. May not alias the input.
+		 */
+		static inline void transposeMat4(float const* mat, float* out);
+		/**
+		 * @brief Inverts a 4x4 matrix
+		 * @param mat Matrix to invert
+		 * @param out Inverted matrix. May not alias the input. Undefined if the determinant is 0.
+		 * @return Determinant of \p mat
+		 */
+		static inline float invertMat4(float const* mat, float* out);
+		/**
+		 * @brief Computes the dot product of two four-dimensional vectors
+		 * @param lhs Left hand side vector
+		 * @param rhs Right hand side vector
+		 * @return Dot product
+		 */
+		static inline float dotVec4(float const* lhs, float const* rhs);
+		/**
+		 * @brief Adds two four-dimensional vectors
+		 * @param lhs Left hand side vector
+		 * @param rhs Right hand side vector
+		 * @param out Sum lhs + rhs. May alias any of the inputs.
+		 */
+		static inline void addVec4(float const* lhs, float const* rhs, float* out);
+		/**
+		 * @brief Subtracts two four-dimensional vectors
+		 * @param lhs Left hand side vector
+		 * @param rhs Right hand side vector
+		 * @param out Difference lhs - rhs. May alias any of the inputs.
+		 */
+		static inline void subtractVec4(float const* lhs, float const* rhs, float* out);
+		/**
+		 * @brief Multiplies a four-dimensional vector with a scalar
+		 * @param vec Vector to scale
+		 * @param scalar Factor
+		 * @param out Scaled vector. May alias the input.
+		 */
+		static inline void scaleVec4(float const* vec, float scalar, float* out);
+		/**
+		 * @brief Multiplies two quaternions
+		 * @param lhs Left hand side quaternion
+		 * @param rhs Right hand side quaternion
+		 * @param out Hamilton product lhs * rhs. May not alias any of the inputs.
+		 */
+		static inline void multiplyQuat(float const* lhs, float const* rhs, float* out);
+		/**
+		 * @brief Rotates a three-dimensional vector by a unit quaternion
+		 * @param quat Quaternion
+		 * @param vec Vector to rotate
+		 * @param out Rotated vector. May not alias any of the inputs.
+		 */
+		static inline void rotateVec3(float const* quat, float const* vec, float* out);
+		/**
+		 * @brief Normalizes a list of three-dimensional vectors stored as structure of arrays
+		 * @details Vectors of length 0 are left untouched.
+		 * @param x First coordinates of all vectors
+		 * @param y Second coordinates of all vectors
+		 * @param z Third coordinates of all vectors
+		 * @param count Amount of vectors
+		 */
+		static inline void normalizeVec3SoA(float* x, float* y, float* z, std::size_t count);
+	};
+
+#ifdef DBGL_MATH_SIMD
+	/**
+	 * @brief SSE implementation of the performance critical float operations of the math module
+	 * @details Same interface and memory layout as ScalarMathKernel. Inputs and outputs don't need to be
+	 * 			aligned. Three-dimensional vectors are padded to four lanes while they are in registers,
+	 * 			thus they don't need any padding in memory. If AVX is available, matrix multiplication
+	 * 			processes two columns at once. Lists stored as structure of arrays are processed four
+	 * 			elements at a time.
+	 */
+	class SIMDMathKernel
+	{
+	public:
+		static inline void multiplyMat4(float const* lhs, float const* rhs, float* out);
+		static inline void transformVec4(float const* mat, float const* vec, float* out);
+		static inline void transformPoint3(float const* mat, float const* vec, float* out);
+		static inline void transformDirection3(float const* mat, float const* vec, float* out);
+		static inline void transposeMat4(float const* mat, float* out);
+		static inline float invertMat4(float const* mat, float* out);
+		static inline float dotVec4(float const* lhs, float const* rhs);
+		static inline void addVec4(float const* lhs, float const* rhs, float* out);
+		static inline void subtractVec4(float const* lhs, float const* rhs, float* out);
+		static inline void scaleVec4(float const* vec, float scalar, float* out);
+		static inline void multiplyQuat(float const* lhs, float const* rhs, float* out);
+		static inline void rotateVec3(float const* quat, float const* vec, float* out);
+		static inline void normalizeVec3SoA(float* x, float* y, float* z, std::size_t count);
+	private:
+		static inline __m128 load3(float const* vec);
+		static inline void store3(__m128 vec, float* out);
+		static inline __m128 cross3(__m128 lhs, __m128 rhs);
+		static inline __m128 transform(float const* mat, __m128 vec);
+		static inline __m128 mat2Mul(__m128 lhs, __m128 rhs);
+		static inline __m128 mat2AdjMul(__m128 lhs, __m128 rhs);
+		static inline __m128 mat2MulAdj(__m128 lhs, __m128 rhs);
+	};
+
+	/**
+	 * @brief Kernel used by the float specializations of the math classes
+	 */
+	using MathKernel = SIMDMathKernel;
+#else
+	/**
+	 * @brief Kernel used by the float specializations of the math classes
+	 */
+	using MathKernel = ScalarMathKernel;
+#endif
+}
+
+#include "SIMD.imp"
+
+#endif /* SIMD_H_ */
@@ -0,0 +1,81 @@
+//////////////////////////////////////////////////////////////////////
+/// Dragon Blaze Game Library
+///
+/// Copyright (c) 2015 by Jan Moeller
+///
+/// This software is provided "as-is" and does not claim to be
+/// complete or free of bugs in any way. It should work, but
+/// it might also begin to hurt your kittens.
+//////////////////////////////////////////////////////////////////////
+
+#ifndef TRANSFORM_H_
+#define TRANSFORM_H_
+
+#include <cstddef>
+#include "Vector3.h"
+#include "Vector4.h"
+#include "Matrix4x4.h"
+
+namespace dbgl
+{
+	/**
+	 * @brief Transforms an array of points by a matrix, assuming a w coordinate of 1
+	 * @details No perspective division is done, see projectPoints() for that. Large arrays are split up
+	 * 			over multiple threads.
+	 * @param mat Transformation matrix
+	 * @param in Points to transform
+	 * @param out Array to write the transformed points to. May be the same as \p in.
+	 * @param n Amount of points
+	 */
+	void transformPoints(Mat4f const& mat, Vec3f const* in, Vec3f* out, std::size_t n);
+	/**
+	 * @brief Transforms an array of directions by a matrix, assuming a w coordinate of 0
+	 * @details Large arrays are split up over multiple threads.
+	 * @param mat Transformation matrix
+	 * @param in Directions to transform
+	 * @param out Array to write the transformed directions to. May be the same as \p in.
+	 * @param n Amount of directions
+	 */
+	void transformDirections(Mat4f const& mat, Vec3f const* in, Vec3f* out, std::size_t n);
+	/**
+	 * @brief Transforms an array of normals by the normal matrix of a transformation matrix
+	 * @details The normal matrix is the inverse transpose of \p mat, so that normals stay perpendicular to
+	 * 			their surface under non-uniform scaling. The resulting normals are normalized. Large arrays
+	 * 			are split up over multiple threads.
+	 * @param mat Transformation matrix, the same one used to transform the points. Must be invertible.
+	 * @param in Normals to transform
+	 * @param out Array to write the transformed normals to. May be the same as \p in.
+	 * @param n Amount of normals
+	 */
+	void transformNormals(Mat4f const& mat, Vec3f const* in, Vec3f* out, std::size_t n);
+	/**
+	 * @brief Transforms an array of points by a projective matrix, assuming a w coordinate of 1, and
+	 * 		  divides the results by their w coordinate
+	 * @details Large arrays are split up over multiple threads.
+	 * @param mat Transformation matrix, e.g. a view-projection matrix
+	 * @param in Points to transform
+	 * @param out Array to write the transformed points to. May be the same as \p in.
+	 * @param n Amount of points
+	 */
+	void projectPoints(Mat4f const& mat, Vec3f const* in, Vec3f* out, std::size_t n);
+	/**
+	 * @brief Transforms an array of four-dimensional vectors by a matrix
+	 * @details Large arrays are split up over multiple threads.
+	 * @param mat Transformation matrix
+	 * @param in Vectors to transform
+	 * @param out Array to write the transformed vectors to. May be the same as \p in.
+	 * @param n Amount of vectors
+	 */
+	void transformVectors(Mat4f const& mat, Vec4f const* in, Vec4f* out, std::size_t n);
+	/**
+	 * @brief Multiplies a matrix with an array of matrices
+	 * @details Computes out[i] = lhs * rhs[i]. Large arrays are split up over multiple threads.
+	 * @param lhs Left hand side matrix, e.g. a view-projection matrix
+	 * @param rhs Right hand side matrices, e.g. model matrices
+	 * @param out Array to write the results to. May be the same as \p rhs.
+	 * @param n Amount of matrices
+	 */
+	void multiplyMatrices(Mat4f const& lhs, Mat4f const* rhs, Mat4f* out, std::size_t n);
+}
+
+#endif /* TRANSFORM_H_ */
@@ -19,7 +19,6 @@
 #include <cstring>
 #include <algorithm>
 #include "Utility.h"
-#include "DBGL/Core/Debug/Log.h"
 
 namespace dbgl
 {
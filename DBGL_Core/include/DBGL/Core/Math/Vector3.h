@@ -16,7 +16,6 @@
 #include <cmath>
 #include "Utility.h"
 #include "Vector.h"
-#include "DBGL/Core/Debug/Log.h"
 
 namespace dbgl
 {
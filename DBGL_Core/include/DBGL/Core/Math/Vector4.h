@@ -16,7 +16,7 @@
 #include <cmath>
 #include "Utility.h"
 #include "Vector.h"
-#include "DBGL/Core/Debug/Log.h"
+#include "SIMD.h"
 
 namespace dbgl
 {
@@ -30,7 +30,8 @@ namespace dbgl
 	 * 		 returns a new vector containing the cross product of
 	 * 		 this vector and another one. For the *= operator there
 	 * 		 is an overload for the cross product, but not for the
-	 * 		 dot product.
+	 * 		 dot product. Vectors of floats use the SIMD kernels for
+	 * 		 addition, subtraction, scaling, dot product and length.
 	 */
 	template<typename T> class Vector4: public Vector<T, 4>
 	{
@@ -107,6 +108,14 @@ namespace dbgl
 		 * @brief Translates this vector by the specified amount
 		 */
 		Vector4<T>& translate(T x, T y, T z, T w);
+		/**
+		 * @brief Returns the squared length of this vector
+		 */
+		inline T getSquaredLength() const;
+		/**
+		 * @brief Returns the length of this vector
+		 */
+		inline T getLength() const;
 		/**
 		 * @brief Normalizes this vector so it has the length 1
 		 */
@@ -0,0 +1,78 @@
+//////////////////////////////////////////////////////////////////////
+/// Dragon Blaze Game Library
+///
+/// Copyright (c) 2015 by Jan Moeller
+///
+/// This software is provided "as-is" and does not claim to be
+/// complete or free of bugs in any way. It should work, but
+/// it might also begin to hurt your kittens.
+//////////////////////////////////////////////////////////////////////
+
+#ifndef FRAMEALLOCATOR_H_
+#define FRAMEALLOCATOR_H_
+
+#include "StackAllocator.h"
+
+namespace dbgl
+{
+    /**
+     * @brief Double-buffered stack allocator for per-frame scratch memory
+     * @details Holds two stacks and alternates between them every frame. Memory allocated during a frame
+     * 		stays valid throughout the next frame, which allows to hand over data from one frame to the next
+     * 		(e.g. to a render thread that lags behind by one frame). On nextFrame() the stack of the frame
+     * 		before the previous one is cleared and becomes the current stack.
+     */
+    class FrameAllocator
+    {
+	public:
+	    /**
+	     * @brief Constructor
+	     * @param size Maximum amount of memory that can be allocated per frame
+	     */
+	    FrameAllocator(unsigned long long size);
+	    FrameAllocator(FrameAllocator const& other) = delete;
+	    FrameAllocator& operator=(FrameAllocator const& other) = delete;
+	    /**
+	     * @brief Allocates raw memory for the current frame
+	     * @param size Amount of memory to allocate
+	     * @param alignment Alignment of the returned address. Must be a power of two.
+	     * @return Pointer to the allocated memory or nullptr if no memory left
+	     */
+	    void* allocate(unsigned long long size, unsigned long long alignment = alignof(std::max_align_t));
+	    /**
+	     * @brief Allocates and initializes an object for the current frame
+	     * @return Pointer to the allocated object or nullptr if no memory left
+	     * @see StackAllocator::allocate()
+	     */
+	    template<typename T> T* allocate();
+	    /**
+	     * @brief Allocates and default-constructs an array of objects for the current frame
+	     * @param n Amount of objects
+	     * @return Pointer to the first object or nullptr if no memory left
+	     * @see StackAllocator::allocateArray()
+	     */
+	    template<typename T> T* allocateArray(std::size_t n);
+	    /**
+	     * @brief Begins a new frame
+	     * @details Memory of the frame that just ended stays valid, memory of the frame before is released.
+	     */
+	    void nextFrame();
+	    /**
+	     * @brief Provides the stack of the current frame
+	     * @return Reference to the current stack
+	     */
+	    StackAllocator& getCurrent();
+	    /**
+	     * @brief Provides the stack of the previous frame
+	     * @return Reference to the previous stack
+	     */
+	    StackAllocator& getPrevious();
+	private:
+	    StackAllocator m_stacks[2];
+	    unsigned int m_current = 0;
+    };
+}
+
+#include "FrameAllocator.imp"
+
+#endif /* FRAMEALLOCATOR_H_ */
@@ -11,46 +11,126 @@
 #ifndef POOLALLOCATOR_H_
 #define POOLALLOCATOR_H_
 
-#include <iostream>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <new>
 #include <stdexcept>
+#include <type_traits>
 
 namespace dbgl
 {
+    /**
+     * @brief Type-independent part of the pool allocator
+     * @details Hands out a small, dense index to every thread that uses a pool allocator. Each pool keeps
+     * 		one free-list cache per index, so a thread can allocate and deallocate without synchronization
+     * 		as long as its cache is not empty or overfull. Indices are recycled when a thread exits, in
+     * 		which case the next thread to acquire that index inherits the cached blocks.
+     */
+    class PoolAllocatorBase
+    {
+	public:
+	    /**
+	     * @brief Maximum amount of threads that get their own free-list cache
+	     * @details Threads beyond this amount fall back to the shared free list.
+	     */
+	    static constexpr unsigned int s_maxThreadCaches = 64;
+	    /**
+	     * @brief Retrieves the cache index of the calling thread
+	     * @return The index of the calling thread or s_maxThreadCaches if all indices are taken
+	     */
+	    static unsigned int getThreadIndex();
+    };
+
     /**
      * @brief Pool-based allocator.
      * @details Pre-allocates a certain amount of memory on creation and serves requests from
      * 		this preallocated memory. Thus no context switch is needed on creation.
      * 		A pool allocator can only be used to allocate multiple objects of the same type.
+     * 		If the pool runs out of memory, another slab is chained to it, doubling the capacity.
+     * 		Every thread serves requests from its own cache of free blocks; blocks are exchanged
+     * 		with the other threads through a lock-free global free list. Objects can be deallocated
+     * 		on any thread, no matter which thread allocated them.
      */
-    template <typename T> class PoolAllocator
+    template <typename T> class PoolAllocator : public PoolAllocatorBase
     {
 	public:
 	    /**
 	     * @brief Constructor
-	     * @param size Amount of objects that can be allocated with this allocator
+	     * @param size Amount of objects that can be allocated before the pool needs to grow
 	     */
 	    PoolAllocator(unsigned long long size);
+	    PoolAllocator(PoolAllocator<T> const& other) = delete;
+	    PoolAllocator<T>& operator=(PoolAllocator<T> const& other) = delete;
 	    /**
 	     * @brief Destructor
+	     * @warning Does not call the destructors of objects which have not been deallocated
 	     */
 	    ~PoolAllocator();
 	    /**
 	     * @brief Allocates and constructs a new object
 	     * @return Pointer to the allocated object
+	     * @throws std::bad_alloc if the pool needs to grow but no more memory is available
 	     */
 	    T* allocate();
 	    /**
 	     * @brief Destructs and deallocates a previously allocated object
-	     * @param obj Pointer to the object to deallocate
+	     * @param obj Pointer to the object to deallocate. Will be set to nullptr.
+	     * @throws std::invalid_argument if the passed object has not been allocated by this pool
 	     */
 	    void deallocate(T*& obj);
+	    /**
+	     * @brief Provides the amount of objects the pool can hold without growing
+	     * @return Total amount of blocks over all slabs
+	     */
+	    unsigned long long capacity() const;
 	private:
-	    void* m_pMemory = nullptr;
-	    T** m_pFreeListStart = nullptr;
-	    T** m_pFreeListEnd = nullptr;
-	    unsigned long long m_size;
+	    /**
+	     * @brief A single block, either holds an object or points to the next free block
+	     */
+	    union Block
+	    {
+		    Block* m_pNext;
+		    typename std::aligned_storage<sizeof(T), alignof(T)>::type m_storage;
+	    };
+	    /**
+	     * @brief Chunk of contiguous blocks
+	     */
+	    struct Slab
+	    {
+		    Block* m_pBlocks;
+		    unsigned long long m_size;
+		    Slab* m_pNext;
+	    };
+	    /**
+	     * @brief Per-thread free list, padded to avoid false sharing between threads
+	     */
+	    struct ThreadCache
+	    {
+		    Block* m_pHead = nullptr;
+		    unsigned int m_count = 0;
+		    char m_padding[64 - sizeof(Block*) - sizeof(unsigned int)];
+	    };
+
+	    void refill(ThreadCache& cache);
+	    void flush(ThreadCache& cache, unsigned int amount);
+	    void pushGlobal(Block* pFirst, Block* pLast);
+	    Block* carve(unsigned int amount, Block*& pLast, unsigned int& carved);
+	    void grow(unsigned long long size);
+	    bool owns(void const* ptr) const;
+
+	    /**
+	     * @brief Amount of blocks moved between a thread cache and the global list at once
+	     */
+	    static constexpr unsigned int s_batchSize = 32;
 
-	    bool canAllocate();
+	    ThreadCache m_caches[s_maxThreadCaches];
+	    std::atomic<Block*> m_globalFreeList { nullptr };
+	    std::atomic<Slab*> m_pSlabs { nullptr };
+	    std::atomic<unsigned long long> m_capacity { 0 };
+	    std::mutex m_slabMutex;
+	    Block* m_pBump = nullptr;
+	    Block* m_pBumpEnd = nullptr;
     };
 }
 
@@ -11,6 +11,13 @@
 #ifndef STACKALLOCATOR_H_
 #define STACKALLOCATOR_H_
 
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+
 namespace dbgl
 {
     /**
@@ -27,29 +34,69 @@ namespace dbgl
 	     */
 	    using Marker = void*;
 
+	    /**
+	     * @brief Rolls back the stack to the top address it had on construction once it goes out of scope
+	     */
+	    class ScopedMarker
+	    {
+		public:
+		    /**
+		     * @brief Constructor
+		     * @param allocator Allocator to mark
+		     */
+		    explicit ScopedMarker(StackAllocator& allocator);
+		    ScopedMarker(ScopedMarker const& other) = delete;
+		    ScopedMarker& operator=(ScopedMarker const& other) = delete;
+		    /**
+		     * @brief Destructor, rolls back the allocator
+		     */
+		    ~ScopedMarker();
+		    /**
+		     * @brief Retrieves the marker this guard rolls back to
+		     * @return The marker
+		     */
+		    Marker get() const;
+		private:
+		    StackAllocator& m_allocator;
+		    Marker m_marker;
+	    };
+
 	    /**
 	     * @brief Constructs the allocator with a certain maximum size
 	     * @param size Maximum amount of memory that can be allocated
 	     */
 	    StackAllocator(unsigned long long size);
+	    StackAllocator(StackAllocator const& other) = delete;
+	    StackAllocator& operator=(StackAllocator const& other) = delete;
 	    /**
 	     * @brief Destructor
+	     * @details Destructs all arrays that are still alive
 	     */
 	    ~StackAllocator();
 	    /**
 	     * @brief Allocates raw memory on the stack
 	     * @param size Amount of memory to allocate
+	     * @param alignment Alignment of the returned address. Must be a power of two.
 	     * @return Pointer to the allocated memory or nullptr if no memory left
+	     * @throws std::invalid_argument if \p alignment is not a power of two
 	     */
-	    void* allocate(unsigned long long size);
+	    void* allocate(unsigned long long size, unsigned long long alignment = alignof(std::max_align_t));
 	    /**
 	     * @brief Allocates and initializes an object on the stack
 	     * @warning The stack doesn't keep track of actual objects, therefore the
-	     * 		constructor will not be called automatically on rollBack().
+	     * 		destructor will not be called automatically on rollBack().
 	     * 		It's the caller's responsibility to call the destructor.
 	     * @return Pointer to the allocated object or nullptr if no memory left
 	     */
 	    template<typename T> T* allocate();
+	    /**
+	     * @brief Allocates and default-constructs an array of objects on the stack
+	     * @details Unlike allocate<T>(), the stack remembers arrays of types that are not trivially
+	     * 		destructible and destructs them on rollBack(), clear() and destruction.
+	     * @param n Amount of objects
+	     * @return Pointer to the first object or nullptr if no memory left or the size doesn't fit into size_t
+	     */
+	    template<typename T> T* allocateArray(std::size_t n);
 	    /**
 	     * @brief Retrieves a marker of the current top address on the stack
 	     * @return Marker for the top address on the stack
@@ -57,7 +104,8 @@ namespace dbgl
 	    Marker top();
 	    /**
 	     * @brief Rolls back the stack to a previously obtained marker
-	     * @warning Does not call any destructors on objects that have been created after
+	     * @details Destructs all arrays obtained by allocateArray() after the marker in reverse order.
+	     * @warning Does not call any destructors on objects that have been created by allocate<T>() after
 	     * 		the marker has been obtained.
 	     * @param marker Marker to roll back to
 	     */
@@ -67,10 +115,34 @@ namespace dbgl
 	     * @see rollBack()
 	     */
 	    void clear();
+	    /**
+	     * @brief Provides the amount of memory currently in use
+	     * @return Amount of used bytes, including alignment padding
+	     */
+	    unsigned long long getUsed() const;
+	    /**
+	     * @brief Provides the total amount of memory managed by this allocator
+	     * @return Size in bytes
+	     */
+	    unsigned long long getSize() const;
 	private:
+	    /**
+	     * @brief Bookkeeping record placed in front of arrays that need destruction
+	     */
+	    struct Finalizer
+	    {
+		    void (*m_destroy)(void*, std::size_t);
+		    void* m_pObjects;
+		    std::size_t m_count;
+		    Finalizer* m_pPrev;
+	    };
+
+	    template<typename T> static void destroyArray(void* pObjects, std::size_t count);
+
 	    void* m_pMemory = nullptr;
 	    void* m_pCur = nullptr;
 	    void* m_pEnd = nullptr;
+	    Finalizer* m_pFinalizers = nullptr;
     };
 }
 
@@ -0,0 +1,58 @@
+//////////////////////////////////////////////////////////////////////
+/// Dragon Blaze Game Library
+///
+/// Copyright (c) 2015 by Jan Moeller
+///
+/// This software is provided "as-is" and does not claim to be
+/// complete or free of bugs in any way. It should work, but
+/// it might also begin to hurt your kittens.
+//////////////////////////////////////////////////////////////////////
+
+#ifndef INCLUDE_DBGL_CORE_UTILITY_PARALLEL_H_
+#define INCLUDE_DBGL_CORE_UTILITY_PARALLEL_H_
+
+#include <cstddef>
+#include <exception>
+#include <thread>
+#include <vector>
+
+namespace dbgl
+{
+	/**
+	 * @brief Provides functionality to split up work on a range of indices over multiple threads
+	 */
+	class Parallel
+	{
+	public:
+		/**
+		 * @brief Retrieves the amount of threads work is split up to
+		 * @return Amount of hardware threads, at least 1
+		 */
+		static unsigned int getThreadCount();
+		/**
+		 * @brief Calls a function on consecutive chunks of the range [0, \p n)
+		 * @details The range is split into at most getThreadCount() chunks of at least \p minChunk indices
+		 * 			each. One of the chunks is processed on the calling thread, all others on their own thread.
+		 * 			If \p n is smaller than 2 * \p minChunk, \p func is called once on the calling thread.
+		 * 			Returns once all chunks have been processed.
+		 * @param n Amount of indices
+		 * @param minChunk Minimum amount of indices worth a thread of their own
+		 * @param func Function with signature void(std::size_t begin, std::size_t end) to call on each chunk
+		 * @throws Rethrows the first exception thrown by \p func, after all chunks are done
+		 */
+		template<typename Func> static void forRange(std::size_t n, std::size_t minChunk, Func const& func);
+		/**
+		 * @brief Runs two functions concurrently
+		 * @details \p first is run on a new thread, \p second on the calling thread. Returns once both are done.
+		 * 			Meant for fork-join style recursion, e.g. to process both halves of a partition at once.
+		 * @param first Function with signature void() to run on a new thread
+		 * @param second Function with signature void() to run on the calling thread
+		 * @throws Rethrows the exception thrown by \p first or \p second, after both are done
+		 */
+		template<typename Func1, typename Func2> static void invoke(Func1 const& first, Func2 const& second);
+	};
+}
+
+#include "Parallel.imp"
+
+#endif /* INCLUDE_DBGL_CORE_UTILITY_PARALLEL_H_ */
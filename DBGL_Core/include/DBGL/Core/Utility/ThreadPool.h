@@ -0,0 +1,101 @@
+//////////////////////////////////////////////////////////////////////
+/// Dragon Blaze Game Library
+///
+/// Copyright (c) 2015 by Jan Moeller
+///
+/// This software is provided "as-is" and does not claim to be
+/// complete or free of bugs in any way. It should work, but
+/// it might also begin to hurt your kittens.
+//////////////////////////////////////////////////////////////////////
+
+#ifndef INCLUDE_DBGL_CORE_UTILITY_THREADPOOL_H_
+#define INCLUDE_DBGL_CORE_UTILITY_THREADPOOL_H_
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "Parallel.h"
+
+namespace dbgl
+{
+	/**
+	 * @brief Set of worker threads that are started once and reused for every call
+	 * @details Parallel::forRange() starts and joins new threads on every call, which is fine for one-off work
+	 * 			like building a tree, but adds a fixed cost to work that is split up many times per second, like
+	 * 			the passes of a frame. The pool keeps its workers waiting for the next call instead. Only one
+	 * 			thread may call forRange() at a time, and \p func must not call forRange() of the same pool.
+	 */
+	class ThreadPool
+	{
+	public:
+		/**
+		 * @brief Constructor
+		 * @param threads Amount of threads work is split up to, including the calling thread. Thus, threads - 1
+		 * 				  workers are started. 0 is treated like 1.
+		 */
+		explicit ThreadPool(unsigned int threads = Parallel::getThreadCount());
+		/**
+		 * @brief Destructor, stops and joins all workers
+		 */
+		~ThreadPool();
+		ThreadPool(ThreadPool const&) = delete;
+		ThreadPool& operator=(ThreadPool const&) = delete;
+		/**
+		 * @brief Retrieves the amount of threads work is split up to
+		 * @return Amount of workers plus the calling thread
+		 */
+		unsigned int getThreadCount() const;
+		/**
+		 * @brief Calls a function on consecutive chunks of the range [0, \p n)
+		 * @details Same as Parallel::forRange(), but the chunks are processed by the workers of this pool and
+		 * 			the calling thread.
+		 * @param n Amount of indices
+		 * @param minChunk Minimum amount of indices worth a thread of their own
+		 * @param func Function with signature void(std::size_t begin, std::size_t end) to call on each chunk
+		 * @throws Rethrows the first exception thrown by \p func, after all chunks are done
+		 */
+		template<typename Func> void forRange(std::size_t n, std::size_t minChunk, Func const& func);
+	private:
+		/**
+		 * @brief Type-erased chunk function, called with the context and the index of the chunk
+		 */
+		using Job = void (*)(void* context, std::size_t chunk);
+
+		/**
+		 * @brief Runs \p chunks chunks of a job on the workers and the calling thread, returns once all are done
+		 */
+		void run(Job job, void* context, std::size_t chunks);
+		/**
+		 * @brief Processes chunks of the current job until none are left
+		 */
+		void process(Job job, void* context, std::size_t chunks);
+		void work();
+
+		std::vector<std::thread> m_workers;
+		std::mutex m_mutex;
+		std::condition_variable m_wake;
+		std::condition_variable m_done;
+		Job m_job = nullptr;
+		void* m_pContext = nullptr;
+		std::size_t m_chunks = 0;
+		std::atomic<std::size_t> m_nextChunk { 0 };
+		/**
+		 * @brief Incremented for every job, so workers notice a new job even if they missed the notification
+		 */
+		unsigned long long m_generation = 0;
+		/**
+		 * @brief Amount of workers that took the current job and are not done with it yet
+		 */
+		unsigned int m_active = 0;
+		bool m_stop = false;
+	};
+}
+
+#include "ThreadPool.imp"
+
+#endif /* INCLUDE_DBGL_CORE_UTILITY_THREADPOOL_H_ */
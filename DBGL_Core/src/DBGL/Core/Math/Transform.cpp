@@ -0,0 +1,114 @@
+//////////////////////////////////////////////////////////////////////
+/// Dragon Blaze Game Library
+///
+/// Copyright (c) 2015 by Jan Moeller
+///
+/// This software is provided "as-is" and does not claim to be
+/// complete or free of bugs in any way. It should work, but
+/// it might also begin to hurt your kittens.
+//////////////////////////////////////////////////////////////////////
+
+#include "DBGL/Core/Math/Transform.h"
+#include "DBGL/Core/Math/SIMD.h"
+#include "DBGL/Core/Utility/Parallel.h"
+#include <cstring>
+
+namespace dbgl
+{
+	namespace
+	{
+		// Amount of elements below which it doesn't pay off to start another thread
+		const std::size_t s_minChunk = 16384;
+
+		static_assert(sizeof(Vec3f) == 3 * sizeof(float), "Vec3f arrays must be tightly packed");
+		static_assert(sizeof(Vec4f) == 4 * sizeof(float), "Vec4f arrays must be tightly packed");
+		static_assert(sizeof(Mat4f) == 16 * sizeof(float), "Mat4f arrays must be tightly packed");
+
+		/**
+		 * @brief Runs a kernel on every element of an array, going through a temporary so that the input
+		 * 		  may alias the output
+		 */
+		template<unsigned int InSize, unsigned int OutSize, typename T, typename Kernel> void run(T const* in,
+				T* out, std::size_t n, Kernel const& kernel)
+		{
+			auto pIn = reinterpret_cast<float const*>(in);
+			auto pOut = reinterpret_cast<float*>(out);
+			Parallel::forRange(n, s_minChunk, [&](std::size_t begin, std::size_t end)
+			{
+				float tmp[OutSize];
+				for (std::size_t i = begin; i < end; i++)
+				{
+					kernel(pIn + i * InSize, tmp);
+					std::memcpy(pOut + i * OutSize, tmp, sizeof(tmp));
+				}
+			});
+		}
+	}
+
+	void transformPoints(Mat4f const& mat, Vec3f const* in, Vec3f* out, std::size_t n)
+	{
+		float const* m = mat.getDataPointer();
+		run<3, 3>(in, out, n, [m](float const* v, float* res)
+		{
+			MathKernel::transformPoint3(m, v, res);
+		});
+	}
+
+	void transformDirections(Mat4f const& mat, Vec3f const* in, Vec3f* out, std::size_t n)
+	{
+		float const* m = mat.getDataPointer();
+		run<3, 3>(in, out, n, [m](float const* v, float* res)
+		{
+			MathKernel::transformDirection3(m, v, res);
+		});
+	}
+
+	void transformNormals(Mat4f const& mat, Vec3f const* in, Vec3f* out, std::size_t n)
+	{
+		Mat4f normalMat = mat.getInverted().transpose();
+		float const* m = normalMat.getDataPointer();
+		run<3, 3>(in, out, n, [m](float const* v, float* res)
+		{
+			MathKernel::transformDirection3(m, v, res);
+			float length = std::sqrt(res[0] * res[0] + res[1] * res[1] + res[2] * res[2]);
+			if (length > 0)
+			{
+				res[0] /= length;
+				res[1] /= length;
+				res[2] /= length;
+			}
+		});
+	}
+
+	void projectPoints(Mat4f const& mat, Vec3f const* in, Vec3f* out, std::size_t n)
+	{
+		float const* m = mat.getDataPointer();
+		run<3, 3>(in, out, n, [m](float const* v, float* res)
+		{
+			float homogeneous[4] = { v[0], v[1], v[2], 1 };
+			float clip[4];
+			MathKernel::transformVec4(m, homogeneous, clip);
+			res[0] = clip[0] / clip[3];
+			res[1] = clip[1] / clip[3];
+			res[2] = clip[2] / clip[3];
+		});
+	}
+
+	void transformVectors(Mat4f const& mat, Vec4f const* in, Vec4f* out, std::size_t n)
+	{
+		float const* m = mat.getDataPointer();
+		run<4, 4>(in, out, n, [m](float const* v, float* res)
+		{
+			MathKernel::transformVec4(m, v, res);
+		});
+	}
+
+	void multiplyMatrices(Mat4f const& lhs, Mat4f const* rhs, Mat4f* out, std::size_t n)
+	{
+		float const* m = lhs.getDataPointer();
+		run<16, 16>(rhs, out, n, [m](float const* r, float* res)
+		{
+			MathKernel::multiplyMat4(m, r, res);
+		});
+	}
+}
@@ -0,0 +1,39 @@
+//////////////////////////////////////////////////////////////////////
+/// Dragon Blaze Game Library
+///
+/// Copyright (c) 2015 by Jan Moeller
+///
+/// This software is provided "as-is" and does not claim to be
+/// complete or free of bugs in any way. It should work, but
+/// it might also begin to hurt your kittens.
+//////////////////////////////////////////////////////////////////////
+
+#include "DBGL/Core/Memory/FrameAllocator.h"
+
+namespace dbgl
+{
+    FrameAllocator::FrameAllocator(unsigned long long size) : m_stacks { { size }, { size } }
+    {
+    }
+
+    void* FrameAllocator::allocate(unsigned long long size, unsigned long long alignment)
+    {
+	return m_stacks[m_current].allocate(size, alignment);
+    }
+
+    void FrameAllocator::nextFrame()
+    {
+	m_current = 1 - m_current;
+	m_stacks[m_current].clear();
+    }
+
+    StackAllocator& FrameAllocator::getCurrent()
+    {
+	return m_stacks[m_current];
+    }
+
+    StackAllocator& FrameAllocator::getPrevious()
+    {
+	return m_stacks[1 - m_current];
+    }
+}
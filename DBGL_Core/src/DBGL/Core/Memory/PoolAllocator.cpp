@@ -0,0 +1,69 @@
+//////////////////////////////////////////////////////////////////////
+/// Dragon Blaze Game Library
+///
+/// Copyright (c) 2015 by Jan Moeller
+///
+/// This software is provided "as-is" and does not claim to be
+/// complete or free of bugs in any way. It should work, but
+/// it might also begin to hurt your kittens.
+//////////////////////////////////////////////////////////////////////
+
+#include "DBGL/Core/Memory/PoolAllocator.h"
+
+namespace dbgl
+{
+    namespace
+    {
+	std::mutex& getIndexMutex()
+	{
+	    static std::mutex s_mutex {};
+	    return s_mutex;
+	}
+
+	bool* getTakenIndices()
+	{
+	    static bool s_taken[PoolAllocatorBase::s_maxThreadCaches] = {};
+	    return s_taken;
+	}
+
+	/**
+	 * @brief Reserves a cache index for the lifetime of a thread
+	 */
+	struct ThreadIndex
+	{
+	    unsigned int m_index = PoolAllocatorBase::s_maxThreadCaches;
+
+	    ThreadIndex()
+	    {
+		std::lock_guard<std::mutex> lock(getIndexMutex());
+		bool* taken = getTakenIndices();
+		for(unsigned int i = 0; i < PoolAllocatorBase::s_maxThreadCaches; i++)
+		{
+		    if(!taken[i])
+		    {
+			taken[i] = true;
+			m_index = i;
+			break;
+		    }
+		}
+	    }
+
+	    ~ThreadIndex()
+	    {
+		if(m_index < PoolAllocatorBase::s_maxThreadCaches)
+		{
+		    std::lock_guard<std::mutex> lock(getIndexMutex());
+		    getTakenIndices()[m_index] = false;
+		}
+	    }
+	};
+    }
+
+    constexpr unsigned int PoolAllocatorBase::s_maxThreadCaches;
+
+    unsigned int PoolAllocatorBase::getThreadIndex()
+    {
+	static thread_local ThreadIndex s_index {};
+	return s_index.m_index;
+    }
+}
@@ -12,6 +12,21 @@
 
 namespace dbgl
 {
+    StackAllocator::ScopedMarker::ScopedMarker(StackAllocator& allocator) : m_allocator(allocator),
+	    m_marker { allocator.top() }
+    {
+    }
+
+    StackAllocator::ScopedMarker::~ScopedMarker()
+    {
+	m_allocator.rollBack(m_marker);
+    }
+
+    auto StackAllocator::ScopedMarker::get() const -> Marker
+    {
+	return m_marker;
+    }
+
     StackAllocator::StackAllocator(unsigned long long size)
     {
 	// Allocate raw memory
@@ -22,16 +37,22 @@ namespace dbgl
 
     StackAllocator::~StackAllocator()
     {
+	clear();
 	operator delete(m_pMemory);
     }
 
-    void* StackAllocator::allocate(unsigned long long size)
+    void* StackAllocator::allocate(unsigned long long size, unsigned long long alignment)
     {
-	if ((reinterpret_cast<char*>(m_pCur) + size) <= m_pEnd)
+	if (alignment == 0 || (alignment & (alignment - 1)) != 0)
+	    throw std::invalid_argument("Alignment must be a power of two.");
+	// Round the current top up to the next multiple of alignment
+	auto cur = reinterpret_cast<std::uintptr_t>(m_pCur);
+	auto end = reinterpret_cast<std::uintptr_t>(m_pEnd);
+	auto aligned = (cur + alignment - 1) & ~static_cast<std::uintptr_t>(alignment - 1);
+	if (aligned >= cur && aligned <= end && size <= end - aligned)
 	{
-	    void* addr = m_pCur;
-	    m_pCur = reinterpret_cast<char*>(m_pCur) + size;
-	    return addr;
+	    m_pCur = reinterpret_cast<void*>(aligned + size);
+	    return reinterpret_cast<void*>(aligned);
 	}
 	else
 	    return nullptr;
@@ -45,11 +66,30 @@ namespace dbgl
     void StackAllocator::rollBack(Marker marker)
     {
 	if(marker < m_pCur)
+	{
+	    // Destruct all arrays that have been allocated after the marker, newest first
+	    while (m_pFinalizers != nullptr && static_cast<void*>(m_pFinalizers) >= marker)
+	    {
+		Finalizer* pFinalizer = m_pFinalizers;
+		m_pFinalizers = pFinalizer->m_pPrev;
+		pFinalizer->m_destroy(pFinalizer->m_pObjects, pFinalizer->m_count);
+	    }
 	    m_pCur = marker;
+	}
     }
 
     void StackAllocator::clear()
     {
 	rollBack(m_pMemory);
     }
+
+    unsigned long long StackAllocator::getUsed() const
+    {
+	return reinterpret_cast<char*>(m_pCur) - reinterpret_cast<char*>(m_pMemory);
+    }
+
+    unsigned long long StackAllocator::getSize() const
+    {
+	return reinterpret_cast<char*>(m_pEnd) - reinterpret_cast<char*>(m_pMemory);
+    }
 }
@@ -0,0 +1,20 @@
+//////////////////////////////////////////////////////////////////////
+/// Dragon Blaze Game Library
+///
+/// Copyright (c) 2015 by Jan Moeller
+///
+/// This software is provided "as-is" and does not claim to be
+/// complete or free of bugs in any way. It should work, but
+/// it might also begin to hurt your kittens.
+//////////////////////////////////////////////////////////////////////
+
+#include "DBGL/Core/Utility/Parallel.h"
+
+namespace dbgl
+{
+	unsigned int Parallel::getThreadCount()
+	{
+		static const unsigned int s_threads = std::thread::hardware_concurrency();
+		return s_threads > 0 ? s_threads : 1;
+	}
+}
@@ -0,0 +1,90 @@
+//////////////////////////////////////////////////////////////////////
+/// Dragon Blaze Game Library
+///
+/// Copyright (c) 2015 by Jan Moeller
+///
+/// This software is provided "as-is" and does not claim to be
+/// complete or free of bugs in any way. It should work, but
+/// it might also begin to hurt your kittens.
+//////////////////////////////////////////////////////////////////////
+
+#include "DBGL/Core/Utility/ThreadPool.h"
+
+namespace dbgl
+{
+	ThreadPool::ThreadPool(unsigned int threads)
+	{
+		for (unsigned int i = 1; i < threads; i++)
+			m_workers.emplace_back(&ThreadPool::work, this);
+	}
+
+	ThreadPool::~ThreadPool()
+	{
+		{
+			std::lock_guard<std::mutex> lock { m_mutex };
+			m_stop = true;
+		}
+		m_wake.notify_all();
+		for (auto& worker : m_workers)
+			worker.join();
+	}
+
+	unsigned int ThreadPool::getThreadCount() const
+	{
+		return static_cast<unsigned int>(m_workers.size()) + 1;
+	}
+
+	void ThreadPool::run(Job job, void* context, std::size_t chunks)
+	{
+		{
+			std::lock_guard<std::mutex> lock { m_mutex };
+			m_job = job;
+			m_pContext = context;
+			m_chunks = chunks;
+			m_nextChunk = 0;
+			m_generation++;
+		}
+		m_wake.notify_all();
+		process(job, context, chunks);
+		// Workers that took the job may still be busy with their last chunk
+		std::unique_lock<std::mutex> lock { m_mutex };
+		m_done.wait(lock, [this]()
+		{
+			return m_active == 0;
+		});
+		m_job = nullptr;
+		m_pContext = nullptr;
+	}
+
+	void ThreadPool::process(Job job, void* context, std::size_t chunks)
+	{
+		for (std::size_t chunk = m_nextChunk++; chunk < chunks; chunk = m_nextChunk++)
+			job(context, chunk);
+	}
+
+	void ThreadPool::work()
+	{
+		unsigned long long seen = 0;
+		std::unique_lock<std::mutex> lock { m_mutex };
+		while (true)
+		{
+			m_wake.wait(lock, [this, seen]()
+			{
+				return m_stop || (m_generation != seen && m_job);
+			});
+			if (m_stop)
+				return;
+			// The job can't change while a worker is active, the caller waits for all of them
+			seen = m_generation;
+			Job job = m_job;
+			void* context = m_pContext;
+			std::size_t chunks = m_chunks;
+			m_active++;
+			lock.unlock();
+			process(job, context, chunks);
+			lock.lock();
+			if (--m_active == 0)
+				m_done.notify_one();
+		}
+	}
+}
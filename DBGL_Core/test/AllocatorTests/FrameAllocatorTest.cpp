@@ -0,0 +1,37 @@
+//////////////////////////////////////////////////////////////////////
+/// Dragon Blaze Game Library
+///
+/// Copyright (c) 2015 by Jan Moeller
+///
+/// This software is provided "as-is" and does not claim to be
+/// complete or free of bugs in any way. It should work, but
+/// it might also begin to hurt your kittens.
+//////////////////////////////////////////////////////////////////////
+
+#include "DBGL/Core/Memory/FrameAllocator.h"
+#include "DBGL/Core/Test/Test.h"
+
+using namespace dbgl;
+using namespace std;
+
+TEST(FrameAllocator,main)
+{
+    FrameAllocator mem{64};
+    int* frame0 = mem.allocateArray<int>(4);
+    ASSERT(frame0);
+    frame0[3] = 42;
+    ASSERT(!mem.allocate(64));
+    mem.nextFrame();
+    // Previous frame's memory is still intact, and there is a fresh stack for this frame
+    ASSERT_EQ(frame0[3], 42);
+    ASSERT_EQ(mem.getCurrent().getUsed(), 0);
+    ASSERT_EQ(mem.getPrevious().getUsed(), 4 * sizeof(int));
+    float* frame1 = mem.allocate<float>();
+    ASSERT(frame1);
+    ASSERT(frame1 != reinterpret_cast<float*>(frame0));
+    mem.nextFrame();
+    // Frame 0 memory has been released, frame 1 memory is still in use
+    ASSERT_EQ(mem.getCurrent().getUsed(), 0);
+    ASSERT(mem.getPrevious().getUsed() > 0);
+    ASSERT(mem.allocate(64));
+}
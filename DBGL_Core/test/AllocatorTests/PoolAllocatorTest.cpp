@@ -8,7 +8,11 @@
 /// it might also begin to hurt your kittens.
 //////////////////////////////////////////////////////////////////////
 
+#include <atomic>
 #include <iostream>
+#include <set>
+#include <thread>
+#include <vector>
 #include "DBGL/Core/Memory/PoolAllocator.h"
 #include "DBGL/Core/Test/Test.h"
 
@@ -31,16 +35,120 @@ TEST(PoolAllocator,main)
     PoolAllocator<foo> mem{8};
     foo* bar = mem.allocate();
     ASSERT_NOTHROW(mem.deallocate(bar));
+    ASSERT(bar == nullptr);
     foo* arr[8];
     for(unsigned int i = 0; i < 8; i++)
     {
-	ASSERT((arr[i] = mem.allocate()) || i == 7);
+	ASSERT(arr[i] = mem.allocate());
+	ASSERT(arr[i]->x == 1 && arr[i]->y == 2);
     }
-    foo* baz ;
-    ASSERT(!(baz = mem.allocate()));
+    ASSERT_EQ(mem.capacity(), 8);
+    foo baz {};
+    foo* pBaz = &baz;
+    ASSERT_THROWS(mem.deallocate(pBaz), std::invalid_argument);
     for(unsigned int i = 0; i < 8; i++)
 	ASSERT_NOTHROW(mem.deallocate(arr[i]));
-    ASSERT_NOTHROW(mem.deallocate(baz));
     ASSERT(bar = mem.allocate());
     ASSERT_NOTHROW(mem.deallocate(bar));
 }
+
+TEST(PoolAllocator,grow)
+{
+    PoolAllocator<foo> mem{4};
+    std::vector<foo*> objs;
+    for(unsigned int i = 0; i < 100; i++)
+    {
+	objs.push_back(mem.allocate());
+	ASSERT(objs.back());
+	objs.back()->x = i;
+    }
+    ASSERT(mem.capacity() >= 100);
+    // Every object must have its own block
+    for(unsigned int i = 0; i < 100; i++)
+	ASSERT_EQ(objs[i]->x, static_cast<int>(i));
+    auto capacity = mem.capacity();
+    for(auto& obj : objs)
+	ASSERT_NOTHROW(mem.deallocate(obj));
+    // Freed blocks must be reused
+    for(unsigned int i = 0; i < 100; i++)
+	ASSERT(objs[i] = mem.allocate());
+    ASSERT_EQ(mem.capacity(), capacity);
+    for(auto& obj : objs)
+	mem.deallocate(obj);
+}
+
+TEST(PoolAllocator,threads)
+{
+    PoolAllocator<foo> mem{16};
+    std::vector<foo*> objs(1000);
+    // Allocate on one thread, deallocate on another
+    std::thread producer([&]()
+    {
+	for(unsigned int i = 0; i < objs.size(); i++)
+	    objs[i] = mem.allocate();
+    });
+    producer.join();
+    std::set<foo*> unique(objs.begin(), objs.end());
+    ASSERT_EQ(unique.size(), objs.size());
+    auto capacity = mem.capacity();
+    std::thread consumer([&]()
+    {
+	for(auto& obj : objs)
+	    mem.deallocate(obj);
+    });
+    consumer.join();
+    for(auto& obj : objs)
+	ASSERT(obj == nullptr);
+    // The blocks freed by the consumer must be available to other threads
+    std::thread reuser([&]()
+    {
+	for(unsigned int i = 0; i < objs.size(); i++)
+	    objs[i] = mem.allocate();
+    });
+    reuser.join();
+    ASSERT_EQ(mem.capacity(), capacity);
+    for(auto& obj : objs)
+	mem.deallocate(obj);
+}
+
+TEST(PoolAllocator,contention)
+{
+    const unsigned int threadCount = 8;
+    const unsigned int live = 32;
+    PoolAllocator<foo> mem{threadCount * live};
+    std::atomic<unsigned int> errors{0};
+    std::vector<std::thread> threads;
+    for(unsigned int t = 0; t < threadCount; t++)
+    {
+	threads.emplace_back([&, t]()
+	{
+	    foo* objs[live] = {};
+	    for(unsigned int i = 0; i < 20000; i++)
+	    {
+		// A block handed out twice would have been overwritten by another thread
+		auto& obj = objs[i % live];
+		if(obj && (obj->x != static_cast<int>(t) || obj->y != static_cast<int>(i - live)))
+		    errors++;
+		if(obj)
+		    mem.deallocate(obj);
+		obj = mem.allocate();
+		obj->x = t;
+		obj->y = i;
+	    }
+	    for(auto& obj : objs)
+		mem.deallocate(obj);
+	});
+    }
+    for(auto& thread : threads)
+	thread.join();
+    ASSERT_EQ(errors.load(), 0u);
+    // Blocks cached by the exited threads must not be handed out a second time
+    auto capacity = mem.capacity();
+    std::vector<foo*> objs;
+    for(unsigned int i = 0; i < capacity; i++)
+	objs.push_back(mem.allocate());
+    std::set<foo*> unique(objs.begin(), objs.end());
+    ASSERT_EQ(unique.size(), objs.size());
+    for(auto& obj : objs)
+	mem.deallocate(obj);
+}
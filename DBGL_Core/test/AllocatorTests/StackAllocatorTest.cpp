@@ -9,6 +9,7 @@
 //////////////////////////////////////////////////////////////////////
 
 #include <iostream>
+#include <limits>
 #include "DBGL/Core/Memory/StackAllocator.h"
 #include "DBGL/Core/Test/Test.h"
 
@@ -52,3 +53,86 @@ TEST(StackAllocator,main)
 }
 
 
+
+struct counted
+{
+	static int alive;
+	int value = 7;
+	counted()
+	{
+	    alive++;
+	}
+	~counted()
+	{
+	    alive--;
+	}
+};
+int counted::alive = 0;
+
+TEST(StackAllocator,alignment)
+{
+    StackAllocator mem{256};
+    ASSERT(mem.allocate(1, 1));
+    void* p16 = mem.allocate(16, 16);
+    ASSERT(p16);
+    ASSERT_EQ(reinterpret_cast<std::uintptr_t>(p16) % 16, 0);
+    ASSERT(mem.allocate(3, 1));
+    void* p32 = mem.allocate(64, 32);
+    ASSERT(p32);
+    ASSERT_EQ(reinterpret_cast<std::uintptr_t>(p32) % 32, 0);
+    ASSERT(mem.allocate<char>());
+    double* d = mem.allocate<double>();
+    ASSERT(d);
+    ASSERT_EQ(reinterpret_cast<std::uintptr_t>(d) % alignof(double), 0);
+    ASSERT_THROWS(mem.allocate(8, 3), std::invalid_argument);
+    ASSERT(!mem.allocate(1024, 1));
+}
+
+TEST(StackAllocator,allocateArray)
+{
+    {
+	StackAllocator mem{1024};
+	int* numbers = mem.allocateArray<int>(16);
+	ASSERT(numbers);
+	for(unsigned int i = 0; i < 16; i++)
+	    ASSERT_EQ(numbers[i], 0);
+	auto mark = mem.top();
+	counted* objs = mem.allocateArray<counted>(10);
+	ASSERT(objs);
+	ASSERT_EQ(counted::alive, 10);
+	ASSERT_EQ(objs[9].value, 7);
+	ASSERT(mem.allocateArray<counted>(5));
+	ASSERT_EQ(counted::alive, 15);
+	ASSERT(!mem.allocateArray<counted>(1000));
+	ASSERT_EQ(counted::alive, 15);
+	// Sizes that wrap around must not turn into small allocations
+	auto used = mem.getUsed();
+	ASSERT(!mem.allocateArray<int>(std::numeric_limits<std::size_t>::max() / sizeof(int) + 1));
+	ASSERT(!mem.allocateArray<counted>(std::numeric_limits<std::size_t>::max() / sizeof(counted) + 1));
+	ASSERT_EQ(counted::alive, 15);
+	ASSERT_EQ(mem.getUsed(), used);
+	mem.rollBack(mark);
+	ASSERT_EQ(counted::alive, 0);
+	ASSERT(mem.allocateArray<counted>(3));
+	ASSERT_EQ(counted::alive, 3);
+    }
+    // Destructor cleans up the rest
+    ASSERT_EQ(counted::alive, 0);
+}
+
+TEST(StackAllocator,scopedMarker)
+{
+    StackAllocator mem{256};
+    ASSERT(mem.allocate(10));
+    auto used = mem.getUsed();
+    {
+	StackAllocator::ScopedMarker scope{mem};
+	ASSERT(mem.allocateArray<counted>(4));
+	ASSERT(mem.allocate(32));
+	ASSERT_EQ(counted::alive, 4);
+	ASSERT(mem.getUsed() > used);
+    }
+    ASSERT_EQ(counted::alive, 0);
+    ASSERT_EQ(mem.getUsed(), used);
+    ASSERT_EQ(mem.getSize(), 256);
+}
@@ -0,0 +1,79 @@
+//////////////////////////////////////////////////////////////////////
+/// Dragon Blaze Game Library
+///
+/// Copyright (c) 2015 by Jan Moeller
+///
+/// This software is provided "as-is" and does not claim to be
+/// complete or free of bugs in any way. It should work, but
+/// it might also begin to hurt your kittens.
+//////////////////////////////////////////////////////////////////////
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include "DBGL/Core/Test/Test.h"
+#include "DBGL/Core/Collection/FlatHashMap.h"
+
+using namespace dbgl;
+using namespace std;
+
+TEST(FlatHashMap,insert)
+{
+	FlatHashMap<string, int> map;
+	ASSERT(map.empty());
+	ASSERT(map.find("a") == nullptr);
+	auto inserted = map.insert("a", 1);
+	ASSERT(inserted.second);
+	ASSERT_EQ(*inserted.first, 1);
+	// Present keys are not overwritten
+	inserted = map.insert("a", 2);
+	ASSERT(!inserted.second);
+	ASSERT_EQ(*inserted.first, 1);
+	map["b"] = 3;
+	map["b"]++;
+	ASSERT_EQ(map.size(), 2u);
+	ASSERT_EQ(*map.find("a"), 1);
+	ASSERT_EQ(*map.find("b"), 4);
+	ASSERT_EQ(map["c"], 0);
+	ASSERT_EQ(map.size(), 3u);
+	map.clear();
+	ASSERT(map.empty());
+	ASSERT(map.find("a") == nullptr);
+}
+
+TEST(FlatHashMap,erase)
+{
+	// Compare against std::map while growing and erasing, identity hashes of consecutive keys form long clusters
+	FlatHashMap<uint64_t, unsigned int> map { 4 };
+	std::map<uint64_t, unsigned int> reference;
+	for (unsigned int i = 0; i < 5000; i++)
+	{
+		uint64_t key = (i * 7919u) % 3001u;
+		if (i % 3 == 2)
+		{
+			ASSERT_EQ(map.erase(key), reference.erase(key) == 1);
+		}
+		else
+		{
+			map[key] = i;
+			reference[key] = i;
+		}
+		ASSERT_EQ(map.size(), reference.size());
+	}
+	for (uint64_t key = 0; key < 3001; key++)
+	{
+		auto it = reference.find(key);
+		if (it == reference.end())
+			ASSERT(map.find(key) == nullptr);
+		else
+			ASSERT_EQ(*map.find(key), it->second);
+	}
+	size_t visited = 0;
+	map.forEach([&](uint64_t const& key, unsigned int& value)
+	{
+		ASSERT_EQ(reference[key], value);
+		visited++;
+	});
+	ASSERT_EQ(visited, reference.size());
+	ASSERT(!map.erase(5000));
+}
@@ -8,6 +8,9 @@
 /// it might also begin to hurt your kittens.
 //////////////////////////////////////////////////////////////////////
 
+#include <algorithm>
+#include <limits>
+#include <random>
 #include <vector>
 #include "DBGL/Core/Test/Test.h"
 #include "DBGL/Core/Collection/Tree/BoundingVolumeHierarchy.h"
@@ -117,3 +120,338 @@ TEST(BoundingVolumeHierarchy,get)
 	checkResult(results, { 5 });
 	results.clear();
 }
+
+namespace dbgl_test_BoundingVolumeHierarchy
+{
+	using BVH = BoundingVolumeHierarchy<int, Sphere<float>>;
+
+	std::vector<BVH::Aggregate> randomSpheres(unsigned int amount, unsigned int seed)
+	{
+		std::mt19937 rng { seed };
+		std::uniform_real_distribution<float> pos { -100, 100 };
+		std::uniform_real_distribution<float> rad { 0.1f, 2 };
+		std::vector<BVH::Aggregate> spheres;
+		for (unsigned int i = 0; i < amount; i++)
+			spheres.push_back( { Sphere<float> { Vec3f { pos(rng), pos(rng), pos(rng) }, rad(rng) }, static_cast<int>(i) });
+		return spheres;
+	}
+
+	std::vector<int> bruteForce(std::vector<BVH::Aggregate> const& elements, AABB<float> const& range)
+	{
+		std::vector<int> result;
+		for (auto const& e : elements)
+			if (e.m_volume.intersects(range))
+				result.push_back(e.m_data);
+		std::sort(result.begin(), result.end());
+		return result;
+	}
+
+	std::vector<int> query(BVH const& bvh, AABB<float> const& range)
+	{
+		std::vector<int> result;
+		bvh.get(range, result);
+		std::sort(result.begin(), result.end());
+		return result;
+	}
+}
+
+using namespace dbgl_test_BoundingVolumeHierarchy;
+
+TEST(BoundingVolumeHierarchy,build)
+{
+	auto elements = randomSpheres(2000, 1);
+	BVH bvh { elements.begin(), elements.end() };
+	ASSERT_EQ(bvh.size(), elements.size());
+	for (unsigned int i = 0; i < elements.size(); i++)
+		ASSERT_EQ(bvh.getAggregate(i).m_data, elements[i].m_data);
+	std::mt19937 rng { 2 };
+	std::uniform_real_distribution<float> pos { -110, 110 };
+	for (unsigned int i = 0; i < 100; i++)
+	{
+		AABB<float> range { Vec3f { pos(rng), pos(rng), pos(rng) }, Vec3f { 20, 20, 20 } };
+		ASSERT(query(bvh, range) == bruteForce(elements, range));
+	}
+
+	// Building with the surface area heuristic has to beat inserting one by one
+	BVH incremental { };
+	incremental.setRotations(false);
+	for (auto const& e : elements)
+		incremental.insert(e.m_volume, e.m_data);
+	ASSERT(bvh.getCost() < incremental.getCost());
+
+	bvh.build( { });
+	ASSERT_EQ(bvh.size(), 0u);
+	ASSERT(query(bvh, AABB<float> { Vec3f { -1000, -1000, -1000 }, Vec3f { 2000, 2000, 2000 } }).empty());
+}
+
+TEST(BoundingVolumeHierarchy,update)
+{
+	auto elements = randomSpheres(1000, 3);
+	for (bool rotations : { false, true })
+	{
+		BVH bvh { };
+		bvh.setRotations(rotations);
+		ASSERT_EQ(bvh.getRotations(), rotations);
+		std::vector<BVH::Handle> handles;
+		for (auto const& e : elements)
+			handles.push_back(bvh.insert(e.m_volume, e.m_data));
+		auto moved = elements;
+		std::mt19937 rng { 4 };
+		std::uniform_real_distribution<float> offset { -5, 5 };
+		for (unsigned int frame = 0; frame < 10; frame++)
+		{
+			for (unsigned int i = 0; i < moved.size(); i++)
+			{
+				moved[i].m_volume.center() += Vec3f { offset(rng), offset(rng), offset(rng) };
+				// Alternate between immediate refit and refitting everything at once
+				bvh.update(handles[i], moved[i].m_volume, frame % 2 == 0);
+			}
+			if (frame % 2 != 0)
+				bvh.refit();
+			for (auto const& range : { AABB<float> { Vec3f { -50, -50, -50 }, Vec3f { 40, 40, 40 } },
+					AABB<float> { Vec3f { 0, 0, 0 }, Vec3f { 100, 10, 100 } } })
+				ASSERT(query(bvh, range) == bruteForce(moved, range));
+		}
+		ASSERT_EQ(bvh.size(), elements.size());
+	}
+	BVH bvh { };
+	ASSERT_THROWS(bvh.update(0, Sphere<float> { }), std::invalid_argument);
+}
+
+TEST(BoundingVolumeHierarchy,removeHandle)
+{
+	auto elements = randomSpheres(500, 5);
+	BVH bvh { elements.begin(), elements.end() };
+	std::vector<BVH::Aggregate> remaining;
+	for (unsigned int i = 0; i < elements.size(); i++)
+	{
+		if (i % 3 == 0)
+			bvh.remove(i);
+		else
+			remaining.push_back(elements[i]);
+	}
+	ASSERT_EQ(bvh.size(), remaining.size());
+	ASSERT_THROWS(bvh.remove(0), std::invalid_argument);
+	AABB<float> all { Vec3f { -1000, -1000, -1000 }, Vec3f { 2000, 2000, 2000 } };
+	ASSERT(query(bvh, all) == bruteForce(remaining, all));
+	// Freed handles are reused
+	auto handle = bvh.insert(Sphere<float> { Vec3f { 0, 0, 0 }, 1 }, 42);
+	ASSERT_EQ(handle % 3, 0u);
+	ASSERT_EQ(bvh.getAggregate(handle).m_data, 42);
+}
+
+TEST(BoundingVolumeHierarchy,copy)
+{
+	auto elements = randomSpheres(100, 6);
+	BVH bvh { elements.begin(), elements.end() };
+	BVH copy { bvh };
+	AABB<float> all { Vec3f { -1000, -1000, -1000 }, Vec3f { 2000, 2000, 2000 } };
+	ASSERT(query(copy, all) == query(bvh, all));
+	BVH moved { std::move(copy) };
+	ASSERT_EQ(copy.size(), 0u);
+	ASSERT(query(moved, all) == query(bvh, all));
+	copy = moved;
+	ASSERT_EQ(copy.size(), bvh.size());
+}
+
+TEST(BoundingVolumeHierarchy,query)
+{
+	auto elements = randomSpheres(2000, 8);
+	BVH bvh { elements.begin(), elements.end() };
+	AABB<float> range { Vec3f { -30, -30, -30 }, Vec3f { 60, 60, 60 } };
+	std::vector<int> result;
+	bvh.query(range, [&result](BVH::Handle handle, BVH::Aggregate const& element)
+	{
+		ASSERT_EQ(static_cast<int>(handle), element.m_data);
+		result.push_back(element.m_data);
+		return true;
+	});
+	std::sort(result.begin(), result.end());
+	ASSERT(result == bruteForce(elements, range));
+	ASSERT(result.size() > 3);
+
+	// Returning false stops the query
+	unsigned int visited = 0;
+	bvh.query(range, [&visited](BVH::Handle, BVH::Aggregate const&)
+	{
+		return ++visited < 3;
+	});
+	ASSERT_EQ(visited, 3u);
+}
+
+TEST(BoundingVolumeHierarchy,queryPlanes)
+{
+	auto elements = randomSpheres(2000, 9);
+	BVH bvh { elements.begin(), elements.end() };
+	std::mt19937 rng { 10 };
+	std::uniform_real_distribution<float> coord { -1, 1 };
+	std::uniform_real_distribution<float> pos { -50, 50 };
+	for (unsigned int i = 0; i < 50; i++)
+	{
+		// Random convex volume around a random point
+		Vec3f center { pos(rng), pos(rng), pos(rng) };
+		Plane<float> planes[6];
+		for (auto& plane : planes)
+		{
+			Vec3f normal = Vec3f { coord(rng), coord(rng), coord(rng) }.normalize();
+			plane = Plane<float> { center - normal * 40, normal };
+		}
+		std::vector<int> expected;
+		for (auto const& e : elements)
+		{
+			bool inside = true;
+			for (auto const& plane : planes)
+				inside &= plane.getSignedDistance(e.m_volume.getCenter()) >= -e.m_volume.getRadius();
+			if (inside)
+				expected.push_back(e.m_data);
+		}
+		std::vector<int> result;
+		bvh.queryPlanes(planes, 6, [&result](BVH::Handle, BVH::Aggregate const& element)
+		{
+			result.push_back(element.m_data);
+			return true;
+		});
+		std::sort(result.begin(), result.end());
+		ASSERT(result == expected);
+	}
+	Plane<float> planes[33];
+	ASSERT_THROWS(bvh.queryPlanes(planes, 33, [](BVH::Handle, BVH::Aggregate const&) { return true; }),
+			std::invalid_argument);
+}
+
+TEST(BoundingVolumeHierarchy,split)
+{
+	auto elements = randomSpheres(1000, 13);
+	BVH bvh { elements.begin(), elements.end() };
+	Plane<float> planes[2] { Plane<float> { Vec3f { -50, 0, 0 }, Vec3f { 1, 0, 0 } }, Plane<float> { Vec3f { 50, 0,
+			0 }, Vec3f { -1, 0, 0 } } };
+	std::vector<int> expected;
+	bvh.queryPlanes(planes, 2, [&expected](BVH::Handle, BVH::Aggregate const& element)
+	{
+		expected.push_back(element.m_data);
+		return true;
+	});
+	std::sort(expected.begin(), expected.end());
+	for (unsigned int amount : { 1u, 2u, 7u, 64u })
+	{
+		std::vector<BVH::Subtree> subtrees;
+		bvh.split(amount, subtrees);
+		ASSERT(subtrees.size() >= amount);
+		// The subtrees partition the elements
+		std::vector<int> result;
+		for (auto subtree : subtrees)
+			bvh.queryPlanes(subtree, planes, 2, [&result](BVH::Handle, BVH::Aggregate const& element)
+			{
+				result.push_back(element.m_data);
+				return true;
+			});
+		std::sort(result.begin(), result.end());
+		ASSERT(result == expected);
+	}
+	std::vector<BVH::Subtree> subtrees;
+	BVH small { elements.begin(), elements.begin() + 3 };
+	small.split(16, subtrees);
+	ASSERT_EQ(subtrees.size(), 3u);
+	BVH empty { };
+	empty.split(16, subtrees);
+	ASSERT(subtrees.empty());
+	ASSERT_THROWS(empty.queryPlanes(0, planes, 2, [](BVH::Handle, BVH::Aggregate const&) { return true; }),
+			std::invalid_argument);
+}
+
+TEST(BoundingVolumeHierarchy,castRay)
+{
+	auto elements = randomSpheres(2000, 11);
+	BVH bvh { elements.begin(), elements.end() };
+	std::mt19937 rng { 12 };
+	std::uniform_real_distribution<float> coord { -1, 1 };
+	std::uniform_real_distribution<float> pos { -120, 120 };
+	unsigned int hits = 0;
+	for (unsigned int i = 0; i < 200; i++)
+	{
+		Vec3f origin { pos(rng), pos(rng), pos(rng) };
+		Vec3f direction { coord(rng), coord(rng), coord(rng) };
+		float closest = std::numeric_limits<float>::max();
+		for (auto const& e : elements)
+		{
+			float t;
+			if (e.m_volume.intersectsRay(origin, direction, t))
+				closest = std::min(closest, t);
+		}
+		BVH::Handle hit;
+		float distance;
+		bool found = bvh.castRay(origin, direction, std::numeric_limits<float>::max(), hit, distance);
+		ASSERT_EQ(found, closest != std::numeric_limits<float>::max());
+		if (found)
+		{
+			hits++;
+			ASSERT_EQ(distance, closest);
+			float t;
+			ASSERT(elements[hit].m_volume.intersectsRay(origin, direction, t));
+			ASSERT_EQ(t, distance);
+			// The same hit limited by a segment
+			float fraction;
+			ASSERT(bvh.castSegment(origin, origin + direction * (distance * 2 + 1), hit, fraction));
+			ASSERT(!bvh.castSegment(origin, origin + direction * (distance / 2), hit, fraction) || distance == 0);
+		}
+	}
+	ASSERT(hits > 0);
+
+	// Filters can reject elements, e.g. the ones with an even number
+	Vec3f origin { -200, 0, 0 };
+	Vec3f direction { 1, 0, 0 };
+	std::vector<BVH::Aggregate> row;
+	for (int i = 0; i < 10; i++)
+		row.push_back( { Sphere<float> { Vec3f { i * 10.0f, 0, 0 }, 1 }, i });
+	BVH line { row.begin(), row.end() };
+	BVH::Handle hit;
+	float distance;
+	ASSERT(line.castRay(origin, direction, 1000, hit, distance));
+	ASSERT_EQ(line.getAggregate(hit).m_data, 0);
+	ASSERT_APPROX(distance, 199.0f, 0.001f);
+	ASSERT(line.castRay(origin, direction, 1000, [](BVH::Handle, BVH::Aggregate const& element, float&)
+	{
+		return element.m_data % 2 != 0;
+	}, hit, distance));
+	ASSERT_EQ(line.getAggregate(hit).m_data, 1);
+	ASSERT(!line.castRay(origin, direction, 100, hit, distance));
+	ASSERT(!line.castRay(origin, -direction, 1000, hit, distance));
+}
+
+TEST(BoundingVolumeHierarchy,deepTree)
+{
+	// Inserting along a line without rotations creates a tree deeper than the traversal stack
+	BVH bvh { };
+	bvh.setRotations(false);
+	std::vector<BVH::Aggregate> elements;
+	for (int i = 0; i < 1000; i++)
+	{
+		elements.push_back( { Sphere<float> { Vec3f { i * 1.0f, 0, 0 }, 0.25f }, i });
+		bvh.insert(elements.back().m_volume, i);
+	}
+	AABB<float> all { Vec3f { -10, -10, -10 }, Vec3f { 2000, 20, 20 } };
+	ASSERT(query(bvh, all) == bruteForce(elements, all));
+	BVH::Handle hit;
+	float distance;
+	ASSERT(bvh.castRay(Vec3f { 2000, 0, 0 }, Vec3f { -1, 0, 0 }, 10000, hit, distance));
+	ASSERT_EQ(bvh.getAggregate(hit).m_data, 999);
+}
+
+TEST(BoundingVolumeHierarchy,insertMatchesBuild)
+{
+	// Trees inserted one by one (with rotations) and built at once have to find the same elements
+	auto elements = randomSpheres(5000, 7);
+	BVH incremental { };
+	for (auto const& e : elements)
+		incremental.insert(e.m_volume, e.m_data);
+	BVH built { elements.begin(), elements.end() };
+	ASSERT_EQ(incremental.size(), built.size());
+	std::mt19937 rng { 14 };
+	std::uniform_real_distribution<float> pos { -110, 110 };
+	for (unsigned int i = 0; i < 100; i++)
+	{
+		AABB<float> range { Vec3f { pos(rng), pos(rng), pos(rng) }, Vec3f { 30, 30, 30 } };
+		ASSERT(query(incremental, range) == query(built, range));
+	}
+	ASSERT(built.getCost() <= incremental.getCost());
+}
@@ -8,6 +8,8 @@
 /// it might also begin to hurt your kittens.
 //////////////////////////////////////////////////////////////////////
 
+#include <algorithm>
+#include <random>
 #include <vector>
 #include "DBGL/Core/Math/Vector2.h"
 #include "DBGL/Core/Math/Vector3.h"
@@ -265,6 +267,61 @@ TEST(KdTree,findKNearestNeighbors)
     list.clear();
     tree2.findKNearestNeighbors(Vec2f(0.2f, -0.25f), 7, list);
     checkResult(list, {0, 3, 5, 1, 4, 2});
+    list.clear();
+    tree2.findKNearestNeighbors(Vec2f(0.2f, -0.25f), 3, list);
+    ASSERT_EQ(list[0].data, 0);
+    ASSERT_EQ(list[1].data, 3);
+    ASSERT_EQ(list[2].data, 5);
+    ASSERT_THROWS(tree2.findKNearestNeighbors(Vec2f(0, 0), 0, list), std::invalid_argument);
+}
+
+TEST(KdTree,findKNearestNeighborsBatched)
+{
+    std::mt19937 rng{3};
+    std::uniform_real_distribution<float> dist{-10, 10};
+    std::vector<typename KdTree<int, Vec3f>::Container> data;
+    for(int i = 0; i < 3000; i++)
+	data.push_back({Vec3f{dist(rng), dist(rng), dist(rng)}, i});
+    std::vector<Vec3f> queries;
+    for(int i = 0; i < 1000; i++)
+	queries.push_back(Vec3f{dist(rng), dist(rng), dist(rng)});
+    KdTree<int, Vec3f> tree(data.begin(), data.end());
+    std::vector<std::vector<typename KdTree<int, Vec3f>::Container>> results(queries.size());
+    tree.findKNearestNeighbors(queries.data(), queries.size(), 5, results.data());
+    for(unsigned int i = 0; i < queries.size(); i++)
+    {
+	// Compare with brute force
+	auto sorted = data;
+	std::partial_sort(sorted.begin(), sorted.begin() + 5, sorted.end(),
+		[&](KdTree<int, Vec3f>::Container const& a, KdTree<int, Vec3f>::Container const& b)
+		{
+		    return (a.point - queries[i]).getSquaredLength() < (b.point - queries[i]).getSquaredLength();
+		});
+	ASSERT_EQ(results[i].size(), 5u);
+	for(unsigned int j = 0; j < 5; j++)
+	    ASSERT_EQ(results[i][j].data, sorted[j].data);
+    }
+    ASSERT_THROWS(tree.findKNearestNeighbors(queries.data(), queries.size(), 0, results.data()),
+	    std::invalid_argument);
+}
+
+TEST(KdTree,parallelBuild)
+{
+    // Large enough to build the upper subtrees concurrently
+    std::mt19937 rng{5};
+    std::uniform_real_distribution<float> dist{-1000, 1000};
+    std::vector<typename KdTree<int, Vec3f>::Container> data;
+    for(int i = 0; i < 100000; i++)
+	data.push_back({Vec3f{dist(rng), dist(rng), dist(rng)}, i});
+    auto copy = data;
+    KdTree<int, Vec3f> tree(copy.begin(), copy.end());
+    ASSERT_EQ(tree.size(), data.size());
+    for(auto const& item : data)
+    {
+	auto found = tree.get(item.point);
+	ASSERT_NEQ(found, nullptr);
+	ASSERT_EQ(*found, item.data);
+    }
 }
 
 TEST(KdTree,findRange)
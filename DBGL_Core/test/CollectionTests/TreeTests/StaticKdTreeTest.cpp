@@ -0,0 +1,248 @@
+//////////////////////////////////////////////////////////////////////
+/// Dragon Blaze Game Library
+///
+/// Copyright (c) 2015 by Jan Moeller
+///
+/// This software is provided "as-is" and does not claim to be
+/// complete or free of bugs in any way. It should work, but
+/// it might also begin to hurt your kittens.
+//////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <random>
+#include <vector>
+#include "DBGL/Core/Math/Vector2.h"
+#include "DBGL/Core/Math/Vector3.h"
+#include "DBGL/Core/Test/Test.h"
+#include "DBGL/Core/Collection/Tree/StaticKdTree.h"
+#include "DBGL/Core/Shape/Shapes.h"
+
+using namespace dbgl;
+using namespace std;
+
+namespace dbgl_test_StaticKdTree
+{
+    using Container2 = StaticKdTree<int, Vec2f>::Container;
+    using Container3 = StaticKdTree<unsigned int, Vec3f>::Container;
+
+    const std::vector<Container2> s_data = {
+	    {Vec2f(0, 0), 0},
+	    {Vec2f(1, 0), 1},
+	    {Vec2f(-1, 1), 2},
+	    {Vec2f(0.5f, -0.5f), 3},
+	    {Vec2f(0.75f, 0.5f), 4},
+	    {Vec2f(-0.5f, -0.5f), 5},
+    };
+
+    void checkResult(std::vector<Container2> const& result, std::vector<int> needed)
+    {
+	for(auto item : result)
+	{
+	    auto it = std::find(needed.begin(), needed.end(), item.data);
+	    if(it == needed.end())
+		FAIL();
+	}
+	ASSERT_EQ(result.size(), needed.size());
+    }
+
+    std::vector<Container3> randomPoints(unsigned int amount, unsigned int seed)
+    {
+	std::mt19937 rng{seed};
+	std::uniform_real_distribution<float> dist{-100, 100};
+	std::vector<Container3> points;
+	points.reserve(amount);
+	for(unsigned int i = 0; i < amount; i++)
+	    points.push_back({Vec3f{dist(rng), dist(rng), dist(rng)}, i});
+	return points;
+    }
+}
+
+using namespace dbgl_test_StaticKdTree;
+
+TEST(StaticKdTree,construct)
+{
+    std::vector<Vec3f> vectors = { {0, 0, 0}, {1, 0, 0}, {0, 1, 0}, {0, 0, 1} };
+    std::vector<int> data = { 0, 1, 2, 3 };
+    std::vector<StaticKdTree<int,Vec3f>::Container> containers = { {{0, 0, 0},0}, {{0, 0, 1},1} };
+
+    StaticKdTree<int, Vec3f> tree1;
+    ASSERT_EQ(tree1.size(), 0u);
+
+    StaticKdTree<int, Vec3f> tree2(containers.begin(), containers.end());
+    ASSERT_EQ(tree2.size(), 2u);
+
+    StaticKdTree<int, Vec3f> tree3(vectors.begin(), vectors.end(), data.begin(), data.end());
+    ASSERT_EQ(tree3.size(), 4u);
+
+    ASSERT_THROWS((StaticKdTree<int, Vec3f>(vectors.begin(), vectors.end(), data.begin(), data.begin() + 2)),
+	    std::range_error);
+}
+
+TEST(StaticKdTree,get)
+{
+    StaticKdTree<int, Vec2f> tree(s_data.begin(), s_data.end());
+    for(auto const& item : s_data)
+    {
+	auto data = tree.get(item.point);
+	ASSERT_NEQ(data, nullptr);
+	ASSERT_EQ(*data, item.data);
+    }
+    ASSERT_EQ(tree.get(Vec2f(0.1f, 0)), nullptr);
+    StaticKdTree<int, Vec2f> empty;
+    ASSERT_EQ(empty.get(Vec2f(0, 0)), nullptr);
+}
+
+TEST(StaticKdTree,getSimilar)
+{
+    StaticKdTree<int, Vec2f> tree(s_data.begin(), s_data.end());
+    auto data = tree.getSimilar(Vec2f(0.0001f, -0.0001f));
+    ASSERT_NEQ(data, nullptr);
+    ASSERT_EQ(*data, 0);
+    data = tree.getSimilar(Vec2f(0.76f, 0.49f), 0.02);
+    ASSERT_NEQ(data, nullptr);
+    ASSERT_EQ(*data, 4);
+    ASSERT_EQ(tree.getSimilar(Vec2f(0.1f, 0)), nullptr);
+}
+
+TEST(StaticKdTree,duplicates)
+{
+    // Points with equal coordinates on the splitting axis may end up in either subtree
+    std::vector<Container2> data;
+    for(int i = 0; i < 50; i++)
+	data.push_back({Vec2f(static_cast<float>(i % 3), static_cast<float>(i % 5)), i});
+    StaticKdTree<int, Vec2f> tree(data.begin(), data.end());
+    for(auto const& item : data)
+	ASSERT_NEQ(tree.get(item.point), nullptr);
+    std::vector<Container2> result;
+    tree.findRange(Rectangle<float>{Vec2f(0, 0), Vec2f(0, 0)}, result);
+    ASSERT_EQ(result.size(), 4u);
+}
+
+TEST(StaticKdTree,findNearestNeighbor)
+{
+    StaticKdTree<int, Vec2f> tree(s_data.begin(), s_data.end());
+    Vec2f nearest;
+    int data = -1;
+    tree.findNearestNeighbor(Vec2f(0.1f, 0.1f), nearest, data);
+    ASSERT_EQ(data, 0);
+    ASSERT_EQ(nearest, Vec2f(0, 0));
+    tree.findNearestNeighbor(Vec2f(0.8f, 0.6f), nearest, data);
+    ASSERT_EQ(data, 4);
+    tree.findNearestNeighbor(Vec2f(-10, 10), nearest, data);
+    ASSERT_EQ(data, 2);
+
+    StaticKdTree<int, Vec2f> empty;
+    ASSERT_THROWS(empty.findNearestNeighbor(Vec2f(0, 0), nearest, data), std::logic_error);
+}
+
+TEST(StaticKdTree,findKNearestNeighbors)
+{
+    StaticKdTree<int, Vec2f> tree(s_data.begin(), s_data.end());
+    std::vector<Container2> result;
+    tree.findKNearestNeighbors(Vec2f(0, 0), 3, result);
+    ASSERT_EQ(result.size(), 3u);
+    ASSERT_EQ(result[0].data, 0);
+    checkResult(result, {0, 3, 5});
+
+    result.clear();
+    tree.findKNearestNeighbors(Vec2f(0, 0), 100, result);
+    ASSERT_EQ(result.size(), s_data.size());
+
+    ASSERT_THROWS(tree.findKNearestNeighbors(Vec2f(0, 0), 0, result), std::invalid_argument);
+}
+
+TEST(StaticKdTree,findRange)
+{
+    StaticKdTree<int, Vec2f> tree(s_data.begin(), s_data.end());
+    std::vector<Container2> result;
+    tree.findRange(Rectangle<float>{Vec2f(-0.6f, -0.6f), Vec2f(1.2f, 1.2f)}, result);
+    checkResult(result, {0, 3, 5});
+
+    result.clear();
+    tree.findRange(Rectangle<float>{Vec2f(5, 5), Vec2f(1, 1)}, result);
+    ASSERT_EQ(result.size(), 0u);
+
+    result.clear();
+    tree.findRange(Rectangle<float>{Vec2f(-10, -10), Vec2f(20, 20)}, result);
+    ASSERT_EQ(result.size(), s_data.size());
+}
+
+TEST(StaticKdTree,compareBruteForce)
+{
+    auto points = randomPoints(2000, 42);
+    auto queries = randomPoints(200, 7);
+    StaticKdTree<unsigned int, Vec3f> tree(points.begin(), points.end());
+    ASSERT_EQ(tree.size(), points.size());
+    for(auto const& query : queries)
+    {
+	// Sort all points by distance
+	auto sorted = points;
+	std::sort(sorted.begin(), sorted.end(), [&query](Container3 const& a, Container3 const& b)
+	{
+	    return (a.point - query.point).getSquaredLength() < (b.point - query.point).getSquaredLength();
+	});
+
+	Vec3f nearest;
+	unsigned int data = 0;
+	tree.findNearestNeighbor(query.point, nearest, data);
+	ASSERT_EQ(data, sorted[0].data);
+
+	std::vector<Container3> kNearest;
+	tree.findKNearestNeighbors(query.point, 10, kNearest);
+	ASSERT_EQ(kNearest.size(), 10u);
+	for(unsigned int i = 0; i < 10; i++)
+	    ASSERT_EQ(kNearest[i].data, sorted[i].data);
+
+	std::vector<Container3> range;
+	Box<float> box{query.point - Vec3f{10, 10, 10}, Vec3f{20, 20, 20}};
+	tree.findRange(box, range);
+	unsigned int inRange = std::count_if(points.begin(), points.end(), [&box](Container3 const& c)
+	{
+	    return box.contains(c.point);
+	});
+	ASSERT_EQ(range.size(), inRange);
+    }
+}
+
+TEST(StaticKdTree,findKNearestNeighborsBatched)
+{
+    auto points = randomPoints(100000, 11);
+    auto queries = randomPoints(2000, 12);
+    std::vector<Vec3f> queryPoints;
+    for(auto const& query : queries)
+	queryPoints.push_back(query.point);
+    StaticKdTree<unsigned int, Vec3f> tree(points.begin(), points.end());
+    std::vector<std::vector<Container3>> results(queryPoints.size());
+    tree.findKNearestNeighbors(queryPoints.data(), queryPoints.size(), 8, results.data());
+    for(unsigned int i = 0; i < queryPoints.size(); i++)
+    {
+	std::vector<Container3> single;
+	tree.findKNearestNeighbors(queryPoints[i], 8, single);
+	ASSERT_EQ(results[i].size(), 8u);
+	for(unsigned int j = 0; j < 8; j++)
+	    ASSERT_EQ(results[i][j].data, single[j].data);
+    }
+    // Parallel build has to produce a valid tree
+    for(auto const& item : points)
+    {
+	auto found = tree.get(item.point);
+	ASSERT_NEQ(found, nullptr);
+	ASSERT_EQ(*found, item.data);
+    }
+}
+
+TEST(StaticKdTree,getAll)
+{
+    StaticKdTree<int, Vec2f> tree(s_data.begin(), s_data.end());
+    std::vector<Container2> all;
+    tree.getAll(all);
+    checkResult(all, {0, 1, 2, 3, 4, 5});
+}
+
+TEST(StaticKdTree,clear)
+{
+    StaticKdTree<int, Vec2f> tree(s_data.begin(), s_data.end());
+    tree.clear();
+    ASSERT_EQ(tree.size(), 0u);
+    ASSERT_EQ(tree.get(Vec2f(0, 0)), nullptr);
+}
@@ -133,3 +133,95 @@ TEST(Handle,clean)
     auto handle = handleFactory.next();
     ASSERT_EQ(0, handle.getValue());
 }
+
+TEST(Handle,generation)
+{
+    HandleFactory<> handleFactory;
+
+    auto handle1 = handleFactory.next();
+    HandleFactory<>::Handle stale{handle1};
+    ASSERT_EQ(handle1.getRefCount(), 2);
+    handle1.invalidate();
+    ASSERT_EQ(handleFactory.totalInUse(), 0);
+    // The slot is reused, but the old handle must not become valid again
+    auto handle2 = handleFactory.next();
+    ASSERT_EQ(0, handle2.getValue());
+    ASSERT(handle2.getGeneration() != stale.getGeneration());
+    ASSERT(handle2.isValid());
+    ASSERT(!stale.isValid());
+    ASSERT(!handleFactory.isValid(stale));
+    ASSERT(handle2 != stale);
+    ASSERT_EQ(handle2.getRefCount(), 1);
+    // Destroying the stale handles must not affect the new one
+    stale = HandleFactory<>::Handle{};
+    handle1 = HandleFactory<>::Handle{};
+    ASSERT(handle2.isValid());
+    ASSERT_EQ(handle2.getRefCount(), 1);
+    ASSERT_EQ(handleFactory.totalInUse(), 1);
+}
+
+TEST(Handle,generationExhausted)
+{
+    HandleFactory<> handleFactory;
+
+    auto first = handleFactory.next();
+    HandleFactory<>::Handle stale{first};
+    first.invalidate();
+    // Reuse the slot until its generation is exhausted and beyond
+    for (unsigned int i = 0; i <= HandleFactory<>::s_maxGeneration; i++)
+    {
+	auto handle = handleFactory.next();
+	ASSERT(handle.isValid());
+	ASSERT(!handleFactory.isValid(stale));
+	ASSERT(!stale.isValid());
+	handle.invalidate();
+    }
+    // The exhausted slot has been retired, so the next one is used
+    auto handle = handleFactory.next();
+    ASSERT_EQ(1, handle.getValue());
+    ASSERT(!stale.isValid());
+    ASSERT_EQ(handleFactory.totalInUse(), 1);
+}
+
+TEST(Handle,refCount)
+{
+    HandleFactory<> handleFactory;
+
+    auto handle1 = handleFactory.next();
+    ASSERT_EQ(handle1.getRefCount(), 1);
+    {
+	auto copy1 = handle1;
+	HandleFactory<>::Handle copy2;
+	copy2 = copy1;
+	ASSERT_EQ(handle1.getRefCount(), 3);
+	auto moved = std::move(copy2);
+	ASSERT_EQ(handle1.getRefCount(), 3);
+	ASSERT(!copy2.isValid());
+	ASSERT(moved == handle1);
+    }
+    ASSERT_EQ(handle1.getRefCount(), 1);
+    ASSERT_EQ(handleFactory.totalInUse(), 1);
+}
+
+TEST(Handle,noRefCount)
+{
+    HandleFactory<uint32_t, false> handleFactory;
+
+    HandleFactory<uint32_t, false>::Handle copy;
+    {
+	auto handle1 = handleFactory.next();
+	ASSERT_EQ(0, handle1.getValue());
+	ASSERT_EQ(handle1.getRefCount(), 0);
+	copy = handle1;
+    }
+    // Handles stay valid until they are invalidated explicitly
+    ASSERT(copy.isValid());
+    ASSERT_EQ(handleFactory.totalInUse(), 1);
+    auto handle2 = handleFactory.next();
+    ASSERT_EQ(1, handle2.getValue());
+    copy.invalidate();
+    ASSERT(!copy.isValid());
+    ASSERT_EQ(handleFactory.totalInUse(), 1);
+    auto handle3 = handleFactory.next();
+    ASSERT_EQ(0, handle3.getValue());
+}
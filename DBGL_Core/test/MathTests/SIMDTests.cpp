@@ -0,0 +1,178 @@
+//////////////////////////////////////////////////////////////////////
+/// Dragon Blaze Game Library
+///
+/// Copyright (c) 2015 by Jan Moeller
+///
+/// This software is provided "as-is" and does not claim to be
+/// complete or free of bugs in any way. It should work, but
+/// it might also begin to hurt your kittens.
+//////////////////////////////////////////////////////////////////////
+
+#include "DBGL/Core/Test/Test.h"
+#include "DBGL/Core/Math/SIMD.h"
+#include "DBGL/Core/Math/Matrix4x4.h"
+#include "DBGL/Core/Math/Quaternion.h"
+#include "DBGL/Core/Math/Utility.h"
+
+using namespace dbgl;
+using namespace std;
+
+namespace dbgl_test_SIMD
+{
+	const float numbers[] = { -1.5f, 1.0f, 0.256f, 25.0f, -100.38585f, 0.00001f, 42.1337f, 571, 43.495f };
+	const float precision = 0.001f;
+
+	/**
+	 * @brief Fills a matrix with the test numbers, keeping it invertible
+	 */
+	void fillMatrix(float* mat, unsigned int offset)
+	{
+		for (unsigned int i = 0; i < 16; i++)
+			mat[i] = numbers[(i + offset) % 9];
+		for (unsigned int i = 0; i < 4; i++)
+			mat[i * 5] += 1000;
+	}
+
+	void assertSimilar(float const* lhs, float const* rhs, unsigned int n)
+	{
+		for (unsigned int i = 0; i < n; i++)
+			ASSERT_APPROX(lhs[i], rhs[i], precision * max(1.0f, abs(lhs[i])));
+	}
+}
+
+using namespace dbgl_test_SIMD;
+
+TEST(SIMD,matrix)
+{
+	float lhs[16], rhs[16], simd[16], scalar[16];
+	for (unsigned int offset = 0; offset < 9; offset++)
+	{
+		fillMatrix(lhs, offset);
+		fillMatrix(rhs, offset + 4);
+		MathKernel::multiplyMat4(lhs, rhs, simd);
+		ScalarMathKernel::multiplyMat4(lhs, rhs, scalar);
+		assertSimilar(scalar, simd, 16);
+		MathKernel::transposeMat4(lhs, simd);
+		ScalarMathKernel::transposeMat4(lhs, scalar);
+		assertSimilar(scalar, simd, 16);
+		float detSIMD = MathKernel::invertMat4(lhs, simd);
+		float detScalar = ScalarMathKernel::invertMat4(lhs, scalar);
+		ASSERT_APPROX(detScalar, detSIMD, precision * abs(detScalar));
+		assertSimilar(scalar, simd, 16);
+	}
+	// Results have to match the generic implementation
+	Mat4f mat = Mat4f::makeRotationX(numbers[2]) * Mat4f::makeTranslation(numbers[0], numbers[1], numbers[3]);
+	Mat4f identity = mat * mat.getInverted();
+	for (unsigned int x = 0; x < 4; x++)
+		for (unsigned int y = 0; y < 4; y++)
+			ASSERT_APPROX(identity[x][y], x == y ? 1.0f : 0.0f, precision);
+	Matrix<float, 4, 4> generic = mat;
+	ASSERT_EQ(Mat4f { generic.getTransposed() }, mat.getTransposed());
+}
+
+TEST(SIMD,vector)
+{
+	float mat[16], simd[4], scalar[4];
+	for (unsigned int offset = 0; offset < 9; offset++)
+	{
+		fillMatrix(mat, offset);
+		float const* vec = &numbers[offset % 5];
+		MathKernel::transformVec4(mat, vec, simd);
+		ScalarMathKernel::transformVec4(mat, vec, scalar);
+		assertSimilar(scalar, simd, 4);
+		MathKernel::transformPoint3(mat, vec, simd);
+		ScalarMathKernel::transformPoint3(mat, vec, scalar);
+		assertSimilar(scalar, simd, 3);
+		MathKernel::transformDirection3(mat, vec, simd);
+		ScalarMathKernel::transformDirection3(mat, vec, scalar);
+		assertSimilar(scalar, simd, 3);
+		ASSERT_APPROX(ScalarMathKernel::dotVec4(vec, mat), MathKernel::dotVec4(vec, mat), 0.1f);
+		MathKernel::addVec4(vec, mat, simd);
+		ScalarMathKernel::addVec4(vec, mat, scalar);
+		assertSimilar(scalar, simd, 4);
+		MathKernel::subtractVec4(vec, mat, simd);
+		ScalarMathKernel::subtractVec4(vec, mat, scalar);
+		assertSimilar(scalar, simd, 4);
+		MathKernel::scaleVec4(vec, numbers[offset], simd);
+		ScalarMathKernel::scaleVec4(vec, numbers[offset], scalar);
+		assertSimilar(scalar, simd, 4);
+		// Element-wise kernels may write to their input
+		MathKernel::addVec4(simd, mat, simd);
+		ScalarMathKernel::addVec4(scalar, mat, scalar);
+		assertSimilar(scalar, simd, 4);
+	}
+	Vec4f vec { numbers[0], numbers[1], numbers[2], 1 };
+	auto transformed = Mat4f::makeTranslation(1, 2, 3) * vec;
+	ASSERT_EQ(transformed, Vec4f(numbers[0] + 1, numbers[1] + 2, numbers[2] + 3, 1));
+	ASSERT_APPROX(vec * vec, numbers[0] * numbers[0] + numbers[1] * numbers[1] + numbers[2] * numbers[2] + 1,
+			precision);
+	Vec4f other { numbers[3], numbers[4], numbers[5], numbers[6] };
+	ASSERT_EQ(vec + other, Vec4f(numbers[0] + numbers[3], numbers[1] + numbers[4], numbers[2] + numbers[5],
+			1 + numbers[6]));
+	ASSERT_EQ(vec - other, Vec4f(numbers[0] - numbers[3], numbers[1] - numbers[4], numbers[2] - numbers[5],
+			1 - numbers[6]));
+	ASSERT_EQ(vec * 2.0f, Vec4f(numbers[0] * 2, numbers[1] * 2, numbers[2] * 2, 2));
+	ASSERT_APPROX(vec.getLength(), sqrt(vec * vec), precision);
+	ASSERT_APPROX(vec.getNormalized().getLength(), 1.0f, precision);
+	vec += other;
+	vec -= other;
+	vec *= 0.5f;
+	ASSERT(vec.isSimilar(Vec4f(numbers[0] / 2, numbers[1] / 2, numbers[2] / 2, 0.5f), precision));
+}
+
+TEST(SIMD,quaternion)
+{
+	float simd[4], scalar[4];
+	for (unsigned int offset = 0; offset < 5; offset++)
+	{
+		QuatF lhs { Vec3f { numbers[offset], numbers[offset + 1], numbers[offset + 2] }.getNormalized(),
+				numbers[offset + 3] };
+		QuatF rhs { Vec3f { numbers[offset + 4], numbers[offset + 2], numbers[offset] }.getNormalized(),
+				numbers[offset + 1] };
+		float const* l = &lhs.x();
+		float const* r = &rhs.x();
+		MathKernel::multiplyQuat(l, r, simd);
+		ScalarMathKernel::multiplyQuat(l, r, scalar);
+		assertSimilar(scalar, simd, 4);
+		MathKernel::rotateVec3(l, &numbers[offset], simd);
+		ScalarMathKernel::rotateVec3(l, &numbers[offset], scalar);
+		assertSimilar(scalar, simd, 3);
+		// Rotation by quaternion has to match rotation by matrix
+		Vec3f vec { numbers[offset], numbers[offset + 1], numbers[offset + 2] };
+		Vec3f byQuat = (lhs * rhs) * vec;
+		Vec4f byMat = (lhs.getMatrix() * rhs.getMatrix()) * Vec4f { vec.x(), vec.y(), vec.z(), 1 };
+		for (unsigned int i = 0; i < 3; i++)
+			ASSERT_APPROX(byQuat[i], byMat[i], precision * max(1.0f, abs(byMat[i])));
+	}
+}
+
+TEST(SIMD,normalize)
+{
+	// Odd count to cover the remainder that doesn't fill a whole register
+	const unsigned int count = 11;
+	float x[count], y[count], z[count], sx[count], sy[count], sz[count];
+	for (unsigned int i = 0; i < count; i++)
+	{
+		x[i] = sx[i] = numbers[i % 9];
+		y[i] = sy[i] = numbers[(i + 3) % 9];
+		z[i] = sz[i] = numbers[(i + 5) % 9];
+	}
+	x[2] = y[2] = z[2] = sx[2] = sy[2] = sz[2] = 0;
+	x[3] = y[3] = sx[3] = sy[3] = 0;
+	z[3] = sz[3] = 7;
+	MathKernel::normalizeVec3SoA(x, y, z, count);
+	ScalarMathKernel::normalizeVec3SoA(sx, sy, sz, count);
+	assertSimilar(sx, x, count);
+	assertSimilar(sy, y, count);
+	assertSimilar(sz, z, count);
+	for (unsigned int i = 0; i < count; i++)
+	{
+		if (i != 2)
+			ASSERT_APPROX(x[i] * x[i] + y[i] * y[i] + z[i] * z[i], 1.0f, precision);
+	}
+	// Zero vectors stay zero, axis-aligned ones are exact
+	ASSERT_EQ(x[2], 0.0f);
+	ASSERT_EQ(z[2], 0.0f);
+	ASSERT_EQ(z[3], 1.0f);
+	ASSERT_EQ(x[3], 0.0f);
+}
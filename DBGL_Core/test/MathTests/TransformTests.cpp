@@ -0,0 +1,120 @@
+//////////////////////////////////////////////////////////////////////
+/// Dragon Blaze Game Library
+///
+/// Copyright (c) 2015 by Jan Moeller
+///
+/// This software is provided "as-is" and does not claim to be
+/// complete or free of bugs in any way. It should work, but
+/// it might also begin to hurt your kittens.
+//////////////////////////////////////////////////////////////////////
+
+#include <vector>
+#include "DBGL/Core/Test/Test.h"
+#include "DBGL/Core/Math/Transform.h"
+#include "DBGL/Core/Math/Utility.h"
+
+using namespace dbgl;
+using namespace std;
+
+namespace dbgl_test_Transform
+{
+	const float numbers[] = { -1.5f, 1.0f, 0.256f, 25.0f, -100.38585f, 0.00001f, 42.1337f, 571, 43.495f };
+	const float precision = 0.001f;
+	// Large enough to be split up over multiple threads
+	const unsigned int s_amount = 100000;
+
+	Mat4f makeTransform()
+	{
+		return Mat4f::makeTranslation(numbers[0], numbers[1], numbers[2]) * Mat4f::makeRotationY(numbers[3])
+				* Mat4f::makeScale(numbers[1], numbers[6], numbers[8]);
+	}
+
+	vector<Vec3f> makePoints()
+	{
+		vector<Vec3f> points(s_amount);
+		for (unsigned int i = 0; i < s_amount; i++)
+			points[i] = Vec3f { numbers[i % 9], numbers[(i + 1) % 9], numbers[(i + 2) % 9] + i % 7 };
+		return points;
+	}
+
+	Vec3f transform(Mat4f const& mat, Vec3f const& vec, float w)
+	{
+		Vec4f res = mat * Vec4f { vec.x(), vec.y(), vec.z(), w };
+		return Vec3f { res.x(), res.y(), res.z() };
+	}
+
+	template<unsigned int N> void assertSimilar(Vector<float, N> const& lhs, Vector<float, N> const& rhs)
+	{
+		for (unsigned int i = 0; i < N; i++)
+			ASSERT_APPROX(lhs[i], rhs[i], precision * max(1.0f, abs(rhs[i])));
+	}
+}
+
+using namespace dbgl_test_Transform;
+
+TEST(Transform,points)
+{
+	Mat4f mat = makeTransform();
+	auto points = makePoints();
+	vector<Vec3f> out(s_amount);
+	transformPoints(mat, points.data(), out.data(), s_amount);
+	for (unsigned int i = 0; i < s_amount; i++)
+		assertSimilar<3>(out[i], transform(mat, points[i], 1));
+	transformDirections(mat, points.data(), out.data(), s_amount);
+	for (unsigned int i = 0; i < s_amount; i++)
+		assertSimilar<3>(out[i], transform(mat, points[i], 0));
+	// In-place
+	auto copy = points;
+	transformPoints(mat, copy.data(), copy.data(), s_amount);
+	transformPoints(mat, points.data(), out.data(), s_amount);
+	for (unsigned int i = 0; i < s_amount; i++)
+		ASSERT_EQ(copy[i], out[i]);
+	ASSERT_NOTHROW(transformPoints(mat, nullptr, nullptr, 0));
+}
+
+TEST(Transform,normals)
+{
+	// Non-uniform scaling would skew normals if they were transformed like directions
+	Mat4f mat = Mat4f::makeScale(1, 4, 1);
+	Vec3f normal = Vec3f { 1, 1, 0 }.getNormalized();
+	Vec3f out;
+	transformNormals(mat, &normal, &out, 1);
+	assertSimilar<3>(out, Vec3f { 4, 1, 0 }.getNormalized());
+	// Normal stays perpendicular to the transformed surface direction
+	Vec3f surface { 1, -1, 0 };
+	Vec3f transformedSurface;
+	transformDirections(mat, &surface, &transformedSurface, 1);
+	ASSERT_APPROX(out * transformedSurface, 0.0f, precision);
+	ASSERT_APPROX(out.getLength(), 1.0f, precision);
+}
+
+TEST(Transform,project)
+{
+	Mat4f proj = Mat4f::makeProjection(toRadians(90.0f), 1.0f, 1.0f, 100.0f);
+	Vec3f points[] = { { 0, 0, -1 }, { 0, 0, -100 }, { 50, 0, -50 } };
+	Vec3f out[3];
+	projectPoints(proj, points, out, 3);
+	assertSimilar<3>(out[0], Vec3f { 0, 0, 0 });
+	assertSimilar<3>(out[1], Vec3f { 0, 0, 1 });
+	ASSERT_APPROX(out[2].x(), 1.0f, precision);
+}
+
+TEST(Transform,matrices)
+{
+	Mat4f lhs = makeTransform();
+	vector<Mat4f> rhs(s_amount);
+	for (unsigned int i = 0; i < s_amount; i++)
+		rhs[i] = Mat4f::makeTranslation(numbers[i % 9], numbers[(i + 3) % 9], i);
+	vector<Mat4f> out(s_amount);
+	multiplyMatrices(lhs, rhs.data(), out.data(), s_amount);
+	for (unsigned int i = 0; i < s_amount; i++)
+		for (unsigned int x = 0; x < 4; x++)
+			assertSimilar<4>(out[i][x], (lhs * rhs[i])[x]);
+	vector<Vec4f> vectors(s_amount);
+	for (unsigned int i = 0; i < s_amount; i++)
+		vectors[i] = Vec4f { numbers[i % 9], numbers[(i + 4) % 9], 1, numbers[(i + 8) % 9] };
+	vector<Vec4f> transformed(s_amount);
+	transformVectors(lhs, vectors.data(), transformed.data(), s_amount);
+	for (unsigned int i = 0; i < s_amount; i++)
+		assertSimilar<4>(transformed[i], lhs * vectors[i]);
+}
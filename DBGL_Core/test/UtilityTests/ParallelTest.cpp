@@ -0,0 +1,78 @@
+//////////////////////////////////////////////////////////////////////
+/// Dragon Blaze Game Library
+///
+/// Copyright (c) 2015 by Jan Moeller
+///
+/// This software is provided "as-is" and does not claim to be
+/// complete or free of bugs in any way. It should work, but
+/// it might also begin to hurt your kittens.
+//////////////////////////////////////////////////////////////////////
+
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+#include "DBGL/Core/Test/Test.h"
+#include "DBGL/Core/Utility/Parallel.h"
+
+using namespace dbgl;
+using namespace std;
+
+TEST(Parallel,forRange)
+{
+	ASSERT(Parallel::getThreadCount() >= 1);
+	// Every index has to be visited exactly once
+	for (size_t n : { 0u, 1u, 7u, 100u, 100003u })
+	{
+		vector<atomic<unsigned int>> visited(n);
+		for (auto& v : visited)
+			v = 0;
+		atomic<unsigned int> calls { 0 };
+		Parallel::forRange(n, 10, [&](size_t begin, size_t end)
+		{
+			ASSERT(begin < end);
+			calls++;
+			for (size_t i = begin; i < end; i++)
+				visited[i]++;
+		});
+		for (auto& v : visited)
+			ASSERT_EQ(v, 1u);
+		ASSERT(calls <= Parallel::getThreadCount());
+		if (n < 20)
+			ASSERT(calls <= 1u);
+	}
+}
+
+TEST(Parallel,exception)
+{
+	ASSERT_THROWS(Parallel::forRange(100000, 1, [](size_t begin, size_t)
+	{
+		if (begin == 0)
+			throw std::runtime_error("Failed");
+	}), std::runtime_error);
+}
+
+TEST(Parallel,invoke)
+{
+	atomic<unsigned int> first { 0 }, second { 0 };
+	Parallel::invoke([&]()
+	{
+		first++;
+	}, [&]()
+	{
+		second++;
+	});
+	ASSERT_EQ(first, 1u);
+	ASSERT_EQ(second, 1u);
+	ASSERT_THROWS(Parallel::invoke([]()
+	{
+		throw std::runtime_error("Failed");
+	}, []()
+	{
+	}), std::runtime_error);
+	ASSERT_THROWS(Parallel::invoke([]()
+	{
+	}, []()
+	{
+		throw std::runtime_error("Failed");
+	}), std::runtime_error);
+}
@@ -0,0 +1,96 @@
+//////////////////////////////////////////////////////////////////////
+/// Dragon Blaze Game Library
+///
+/// Copyright (c) 2015 by Jan Moeller
+///
+/// This software is provided "as-is" and does not claim to be
+/// complete or free of bugs in any way. It should work, but
+/// it might also begin to hurt your kittens.
+//////////////////////////////////////////////////////////////////////
+
+#include <atomic>
+#include <mutex>
+#include <set>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include "DBGL/Core/Test/Test.h"
+#include "DBGL/Core/Utility/ThreadPool.h"
+
+using namespace dbgl;
+using namespace std;
+
+TEST(ThreadPool,forRange)
+{
+	ThreadPool pool { 4 };
+	ASSERT_EQ(pool.getThreadCount(), 4u);
+	// Every index has to be visited exactly once, also when the pool is reused many times
+	for (unsigned int round = 0; round < 200; round++)
+	{
+		for (size_t n : { 0u, 1u, 7u, 100u, 10003u })
+		{
+			vector<atomic<unsigned int>> visited(n);
+			for (auto& v : visited)
+				v = 0;
+			atomic<unsigned int> calls { 0 };
+			pool.forRange(n, 10, [&](size_t begin, size_t end)
+			{
+				ASSERT(begin < end);
+				calls++;
+				for (size_t i = begin; i < end; i++)
+					visited[i]++;
+			});
+			for (auto& v : visited)
+				ASSERT_EQ(v, 1u);
+			ASSERT(calls <= pool.getThreadCount());
+			if (n < 20)
+				ASSERT(calls <= 1u);
+		}
+	}
+	ThreadPool single { 0 };
+	ASSERT_EQ(single.getThreadCount(), 1u);
+	unsigned int calls = 0;
+	single.forRange(1000, 1, [&calls](size_t begin, size_t end)
+	{
+		ASSERT_EQ(begin, 0u);
+		ASSERT_EQ(end, 1000u);
+		calls++;
+	});
+	ASSERT_EQ(calls, 1u);
+}
+
+TEST(ThreadPool,workers)
+{
+	// Chunks that block until all of them run prove that the workers process them concurrently
+	ThreadPool pool { 3 };
+	atomic<unsigned int> arrived { 0 };
+	std::mutex mutex;
+	std::set<std::thread::id> threads;
+	pool.forRange(3, 1, [&](size_t, size_t)
+	{
+		arrived++;
+		while (arrived < 3)
+			std::this_thread::yield();
+		std::lock_guard<std::mutex> lock { mutex };
+		threads.insert(std::this_thread::get_id());
+	});
+	ASSERT_EQ(threads.size(), 3u);
+	ASSERT_EQ(threads.count(std::this_thread::get_id()), 1u);
+}
+
+TEST(ThreadPool,exception)
+{
+	ThreadPool pool { 4 };
+	ASSERT_THROWS(pool.forRange(100000, 1, [](size_t begin, size_t)
+	{
+		if (begin == 0)
+			throw std::runtime_error("Failed");
+	}), std::runtime_error);
+	// The pool is still usable afterwards
+	atomic<unsigned int> sum { 0 };
+	pool.forRange(100, 1, [&sum](size_t begin, size_t end)
+	{
+		sum += static_cast<unsigned int>(end - begin);
+	});
+	ASSERT_EQ(sum, 100u);
+}
@@ -0,0 +1,67 @@
+//////////////////////////////////////////////////////////////////////
+/// Dragon Blaze Game Library
+///
+/// Copyright (c) 2015 by Jan Moeller
+///
+/// This software is provided "as-is" and does not claim to be
+/// complete or free of bugs in any way. It should work, but
+/// it might also begin to hurt your kittens.
+//////////////////////////////////////////////////////////////////////
+
+#ifndef INCLUDE_DBGL_PLATFORM_FILE_MAPPEDFILE_H_
+#define INCLUDE_DBGL_PLATFORM_FILE_MAPPEDFILE_H_
+
+#include <cstddef>
+#include "DBGL/Platform/File/Filename.h"
+
+namespace dbgl
+{
+	/**
+	 * @brief Read-only view of a file mapped into memory
+	 * @details The operating system pages the contents in on access, so the file is never copied into a buffer of
+	 *          its own. The view stays valid until the mapped file is closed or destroyed.
+	 */
+	class MappedFile
+	{
+	public:
+		/**
+		 * @brief Constructor
+		 * @param path Path of the file to map
+		 */
+		explicit MappedFile(Filename const& path);
+		/**
+		 * @brief Destructor, unmaps the file
+		 */
+		~MappedFile();
+		MappedFile(MappedFile const& other) = delete;
+		MappedFile& operator=(MappedFile const& other) = delete;
+		/**
+		 * @brief Maps the file into memory
+		 * @return True in case the file was mapped, otherwise false. Empty files are opened without a mapping.
+		 */
+		bool open();
+		/**
+		 * @brief Unmaps the file
+		 */
+		void close();
+		/**
+		 * @return True in case the file is mapped, otherwise false
+		 */
+		bool isOpen() const;
+		/**
+		 * @return Pointer to the first byte of the file, or nullptr if the file isn't mapped or empty
+		 */
+		char const* getData() const;
+		/**
+		 * @return Size of the file in bytes
+		 */
+		std::size_t getSize() const;
+	private:
+		Filename m_path;
+		char const* m_pData = nullptr;
+		std::size_t m_size = 0;
+		bool m_open = false;
+	};
+}
+
+#endif /* INCLUDE_DBGL_PLATFORM_FILE_MAPPEDFILE_H_ */
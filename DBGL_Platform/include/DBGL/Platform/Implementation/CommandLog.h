@@ -0,0 +1,155 @@
+//////////////////////////////////////////////////////////////////////
+/// Dragon Blaze Game Library
+///
+/// Copyright (c) 2015 by Jan Moeller
+///
+/// This software is provided "as-is" and does not claim to be
+/// complete or free of bugs in any way. It should work, but
+/// it might also begin to hurt your kittens.
+//////////////////////////////////////////////////////////////////////
+
+#ifndef INCLUDE_DBGL_PLATFORM_IMPLEMENTATION_COMMANDLOG_H_
+#define INCLUDE_DBGL_PLATFORM_IMPLEMENTATION_COMMANDLOG_H_
+
+#include <array>
+#include <cstddef>
+#include <vector>
+
+namespace dbgl
+{
+	/**
+	 * @brief Records the commands issued to the headless platform implementation
+	 * @details Every command is stored as a small fixed-size entry, and a counter per command type is kept. Storing
+	 *          the entries can be switched off to only count commands, e.g. when benchmarking many frames.
+	 */
+	class CommandLog
+	{
+	public:
+		/**
+		 * @brief Lists all recorded command types
+		 */
+		enum class Type : unsigned char
+		{
+			Clear,           //!< Buffers cleared, value is the bitmask
+			DepthTest,       //!< Depth test changed, value is the new IRenderContext::DepthTestValue
+			AlphaBlend,      //!< Blend factors changed, value is source factor << 8 | destination factor
+			FaceCulling,     //!< Face culling changed, value is the new IRenderContext::FaceCullingValue
+			DrawMode,        //!< Draw mode changed, value is the new IRenderContext::DrawMode
+			LineWidth,       //!< Line width changed
+			LineAntialiasing, //!< Line antialiasing changed, value is 1 if enabled
+			PointSize,       //!< Point size changed
+			DepthBuffer,     //!< Depth buffer writes changed, value is 1 if enabled
+			ColorBuffer,     //!< Color buffer writes changed, value is a mask of the enabled components
+			Multisampling,   //!< Multisampling changed, value is 1 if enabled
+			ClearColor,      //!< Clear color changed
+			BindContext,     //!< Render context bound
+			Viewport,        //!< Viewport changed
+			ReadPixels,      //!< Pixels read back
+			DrawMesh,        //!< Mesh drawn, value is the amount of indices
+			UpdateMesh,      //!< Mesh buffers updated, value is the amount of updated vertices
+			CompileShader,   //!< Shader compiled
+			LinkProgram,     //!< Shader program linked
+			UseProgram,      //!< Shader program made current
+			Uniform,         //!< Uniform uploaded to the current program, value is the handle
+			BindTexture,     //!< Texture bound
+			ActivateUnit,    //!< Texture unit activated, value is the unit
+			WriteTexture,    //!< Texture level written, value is the level
+			TextureParameter, //!< Texture filter, wrap mode or row alignment changed
+			GenerateMipMaps, //!< Mip maps generated
+			UniformBlockBinding, //!< Uniform block of the current program connected, value is the binding point
+			WriteUniformBuffer, //!< Uniform buffer written, value is the amount of bytes
+			BindUniformBuffer, //!< Uniform buffer bound, value is the binding point
+			DrawMeshInstanced, //!< Mesh drawn multiple times, value is the amount of instances
+			WriteInstanceBuffer, //!< Matrices appended to an instance buffer, value is the amount of matrices
+		};
+		/**
+		 * @brief Amount of command types
+		 */
+		static constexpr std::size_t s_typeCount = static_cast<std::size_t>(Type::WriteInstanceBuffer) + 1;
+
+		/**
+		 * @brief Single recorded command
+		 */
+		struct Command
+		{
+			/**
+			 * @brief Object the command has been issued to or with, e.g. the render context or the drawn mesh
+			 */
+			void const* m_object;
+			/**
+			 * @brief Type specific argument
+			 */
+			unsigned int m_value;
+			Type m_type;
+		};
+
+		/**
+		 * @brief Records a command
+		 * @param type Command type
+		 * @param object Object the command has been issued to or with
+		 * @param value Type specific argument
+		 */
+		void record(Type type, void const* object = nullptr, unsigned int value = 0);
+		/**
+		 * @brief Records an instanced draw as a DrawMeshInstanced command
+		 * @param mesh Drawn mesh
+		 * @param indices Amount of indices per instance
+		 * @param instances Amount of instances
+		 */
+		void recordInstanced(void const* mesh, unsigned int indices, unsigned int instances);
+		/**
+		 * @brief Forgets all recorded commands and resets all counters
+		 */
+		void clear();
+		/**
+		 * @brief Enables or disables storing the commands. Counters are always updated.
+		 * @param store True to store all commands, false to only count them
+		 */
+		void setStoreCommands(bool store);
+		/**
+		 * @brief Checks if commands are stored
+		 * @return True if commands are stored, otherwise false
+		 */
+		bool getStoreCommands() const;
+		/**
+		 * @brief Provides all stored commands in the order they have been issued
+		 * @return The stored commands
+		 */
+		std::vector<Command> const& getCommands() const;
+		/**
+		 * @brief Retrieves how often a command type has been recorded since the last call to clear()
+		 * @param type Command type
+		 * @return Amount of commands of type \p type
+		 */
+		unsigned int getCount(Type type) const;
+		/**
+		 * @brief Retrieves the amount of render state changes since the last call to clear()
+		 * @return Amount of commands for which isStateChange() is true
+		 */
+		unsigned int getStateChanges() const;
+		/**
+		 * @brief Retrieves the amount of indices drawn since the last call to clear()
+		 * @return Sum of the indices of all instances drawn by DrawMesh and DrawMeshInstanced commands
+		 */
+		std::size_t getDrawnIndices() const;
+		/**
+		 * @brief Retrieves the amount of drawn mesh instances since the last call to clear()
+		 * @return Amount of DrawMesh commands plus the values of all DrawMeshInstanced commands
+		 */
+		std::size_t getDrawnInstances() const;
+		/**
+		 * @brief Checks if a command type changes the render state of a context
+		 * @param type Command type
+		 * @return True for all types from DepthTest to ClearColor, otherwise false
+		 */
+		static bool isStateChange(Type type);
+	private:
+		std::vector<Command> m_commands;
+		std::array<unsigned int, s_typeCount> m_counts { };
+		std::size_t m_drawnIndices = 0;
+		std::size_t m_drawnInstances = 0;
+		bool m_storeCommands = true;
+	};
+}
+
+#endif /* INCLUDE_DBGL_PLATFORM_IMPLEMENTATION_COMMANDLOG_H_ */
@@ -0,0 +1,61 @@
+//////////////////////////////////////////////////////////////////////
+/// Dragon Blaze Game Library
+///
+/// Copyright (c) 2015 by Jan Moeller
+///
+/// This software is provided "as-is" and does not claim to be
+/// complete or free of bugs in any way. It should work, but
+/// it might also begin to hurt your kittens.
+//////////////////////////////////////////////////////////////////////
+
+#ifndef INCLUDE_DBGL_PLATFORM_IMPLEMENTATION_HEADLESS_H_
+#define INCLUDE_DBGL_PLATFORM_IMPLEMENTATION_HEADLESS_H_
+
+#include "DBGL/Platform/Platform.h"
+#include "DBGL/Platform/Implementation/CommandLog.h"
+#include "DBGL/Platform/Shader/ShaderProgramCommandsHeadless.h"
+#include "DBGL/Platform/Texture/TextureCommandsHeadless.h"
+
+namespace dbgl
+{
+	/**
+	 * @brief Headless implementation of the platform toolkit
+	 * @details Doesn't need any graphics hardware or window system. Meshes, textures and shaders keep their data in
+	 *          main memory, and all commands issued to render contexts, shader programs and textures are recorded
+	 *          to a CommandLog. This allows to test and profile everything built on top of the platform, e.g. on
+	 *          a headless build server. Windows can't be created.
+	 */
+	class Headless: public Platform::IImplementation
+	{
+	public:
+		virtual ~Headless() = default;
+		/**
+		 * @brief Always throws, there are no windows without a window system
+		 * @throws std::runtime_error
+		 */
+		virtual IWindow* createWindow(std::string title = "Dragon Blaze Game Library", int width = 800,
+				int height = 600, bool fullscreen = false, unsigned int multisampling = 2);
+		virtual IMonitor* createMonitor();
+		virtual ITimer* createTimer();
+		virtual IShader* createShader(IShader::Type type, std::string code);
+		virtual IShaderProgram* createShaderProgram();
+		virtual IUniformBuffer* createUniformBuffer(std::size_t size);
+		virtual ITexture* createTexture(ITexture::Type type);
+		virtual IMesh* createMesh();
+		virtual IInstanceBuffer* createInstanceBuffer(unsigned int capacity);
+		virtual IRenderContext* createRenderContext(unsigned int width, unsigned int height, bool createDepthBuf = false);
+		virtual IShaderProgramCommands* curShaderProgram();
+		virtual ITextureCommands* curTexture();
+		/**
+		 * @brief Provides access to the log all commands are recorded to
+		 * @return The command log
+		 */
+		CommandLog& getLog();
+	private:
+		CommandLog m_log;
+		ShaderProgramCommandsHeadless m_shaderProgramCommands { &m_log };
+		TextureCommandsHeadless m_textureCommands { &m_log };
+	};
+}
+
+#endif /* INCLUDE_DBGL_PLATFORM_IMPLEMENTATION_HEADLESS_H_ */
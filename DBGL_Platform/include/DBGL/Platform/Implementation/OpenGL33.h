@@ -34,8 +34,10 @@ namespace dbgl
 		virtual ITimer* createTimer();
 		virtual IShader* createShader(IShader::Type type, std::string code);
 		virtual IShaderProgram* createShaderProgram();
+		virtual IUniformBuffer* createUniformBuffer(std::size_t size);
 		virtual ITexture* createTexture(ITexture::Type type);
 		virtual IMesh* createMesh();
+		virtual IInstanceBuffer* createInstanceBuffer(unsigned int capacity);
 		virtual IRenderContext* createRenderContext(unsigned int width, unsigned int height, bool createDepthBuf = false);
 		virtual IShaderProgramCommands* curShaderProgram();
 		virtual ITextureCommands* curTexture();
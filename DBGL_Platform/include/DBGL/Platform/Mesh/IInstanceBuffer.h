@@ -0,0 +1,49 @@
+//////////////////////////////////////////////////////////////////////
+/// Dragon Blaze Game Library
+///
+/// Copyright (c) 2015 by Jan Moeller
+///
+/// This software is provided "as-is" and does not claim to be
+/// complete or free of bugs in any way. It should work, but
+/// it might also begin to hurt your kittens.
+//////////////////////////////////////////////////////////////////////
+
+#ifndef INCLUDE_DBGL_PLATFORM_MESH_IINSTANCEBUFFER_H_
+#define INCLUDE_DBGL_PLATFORM_MESH_IINSTANCEBUFFER_H_
+
+#include "DBGL/Core/Math/Matrix4x4.h"
+
+namespace dbgl
+{
+	/**
+	 * @brief Interface class for ring buffers of per-instance model matrices
+	 * @details Matrices are appended behind the previously appended ones. Once the end of the buffer is reached,
+	 *          appending starts over at the front, so data that might still be in use by earlier draws is never
+	 *          overwritten in place. Vertex shaders read the matrix of the current instance from the attribute
+	 *          locations IRenderContext::s_instanceAttribute to IRenderContext::s_instanceAttribute + 3, e.g.
+	 *          <tt>layout(location = 5) in mat4 i_m4_Model;</tt>.
+	 */
+	class IInstanceBuffer
+	{
+	public:
+		/**
+		 * @brief Destructor
+		 */
+		virtual ~IInstanceBuffer() = default;
+		/**
+		 * @brief Retrieves the amount of matrices the buffer can hold
+		 * @return The capacity
+		 */
+		virtual unsigned int getCapacity() const = 0;
+		/**
+		 * @brief Uploads matrices to the buffer
+		 * @param matrices Matrices to upload
+		 * @param count Amount of matrices
+		 * @return Index of the first uploaded matrix within the buffer
+		 * @throws std::invalid_argument if \p count exceeds the capacity
+		 */
+		virtual unsigned int append(Mat4f const* matrices, unsigned int count) = 0;
+	};
+}
+
+#endif /* INCLUDE_DBGL_PLATFORM_MESH_IINSTANCEBUFFER_H_ */
@@ -14,15 +14,23 @@
 #include <vector>
 #include "DBGL/Core/Math/Vector2.h"
 #include "DBGL/Core/Math/Vector3.h"
+#include "DBGL/Platform/Mesh/VertexLayout.h"
 
 namespace dbgl
 {
 	/**
 	 * @brief Interface class for mesh implementations.
+	 * @details Vertex attributes are kept in separate lists and converted into an interleaved hardware buffer as
+	 *          specified by the vertex layout, see setLayout(). Indices are 32 bit, but are stored with 16 bit in the
+	 *          hardware buffer if all of them fit.
 	 */
 	class IMesh
 	{
 	public:
+		/**
+		 * @brief Type of a vertex index
+		 */
+		using Index = unsigned int;
 		/**
 		 * @brief Mesh buffer usage
 		 */
@@ -46,7 +54,7 @@ namespace dbgl
 		/**
 		 * @return A reference to the indices list
 		 */
-		virtual std::vector<unsigned short>& indices() = 0;
+		virtual std::vector<Index>& indices() = 0;
 		/**
 		 * @return A reference to the vertices list
 		 */
@@ -67,6 +75,16 @@ namespace dbgl
 		 * @return A reference to the bitangents list
 		 */
 		virtual std::vector<Vec3f>& bitangents() = 0;
+		/**
+		 * @brief Sets the layout of the hardware vertex buffer
+		 * @param layout New layout, takes effect on the next full update. Attributes without data are left out.
+		 */
+		virtual void setLayout(VertexLayout const& layout) = 0;
+		/**
+		 * @brief Retrieves the layout of the hardware vertex buffer
+		 * @return The layout as set by setLayout(). By default all attributes are stored as floats.
+		 */
+		virtual VertexLayout const& getLayout() const = 0;
 		/**
 		 * @return Amount of indices inside the hardware buffer
 		 */
@@ -103,8 +121,32 @@ namespace dbgl
 		virtual Usage getUsage() const = 0;
 		/**
 		 * @brief Updates the underlying hardware buffers
+		 * @throws std::invalid_argument if an attribute of the layout has data, but not one element per vertex
 		 */
 		virtual void updateBuffers() = 0;
+		/**
+		 * @brief Only updates a range of vertices in the hardware vertex buffer
+		 * @details The index buffer is left untouched. If the amount of vertices, the attributes with data or the
+		 *          layout have changed since the last update, all buffers are updated instead.
+		 * @param first First vertex to update
+		 * @param count Amount of vertices to update
+		 * @throws std::invalid_argument if the range exceeds the vertices
+		 */
+		virtual void updateBuffers(std::size_t first, std::size_t count) = 0;
+		/**
+		 * @brief Fills the hardware buffers with data that is already in the hardware format
+		 * @details The lists of this mesh are left untouched, the data is not kept anywhere else. A later full
+		 *          update replaces the buffers with the contents of the lists again.
+		 * @param layout Layout of \p vertexData, also becomes the layout of this mesh
+		 * @param vertexData Packed vertices as written by VertexLayout::pack()
+		 * @param vertexCount Amount of vertices
+		 * @param indexData Indices
+		 * @param indexCount Amount of indices
+		 * @param indexSize Size of an index in bytes, either 2 or 4
+		 * @throws std::invalid_argument if \p indexSize is neither 2 nor 4
+		 */
+		virtual void uploadBuffers(VertexLayout const& layout, void const* vertexData, std::size_t vertexCount,
+				void const* indexData, std::size_t indexCount, unsigned int indexSize) = 0;
 	    /**
 	     * @brief Generates a deep copy of this mesh
 	     * @return The clone
@@ -0,0 +1,50 @@
+//////////////////////////////////////////////////////////////////////
+/// Dragon Blaze Game Library
+///
+/// Copyright (c) 2015 by Jan Moeller
+///
+/// This software is provided "as-is" and does not claim to be
+/// complete or free of bugs in any way. It should work, but
+/// it might also begin to hurt your kittens.
+//////////////////////////////////////////////////////////////////////
+
+#ifndef INCLUDE_DBGL_PLATFORM_MESH_INSTANCEBUFFERGL33_H_
+#define INCLUDE_DBGL_PLATFORM_MESH_INSTANCEBUFFERGL33_H_
+
+#include <GL/glew.h>
+#include "IInstanceBuffer.h"
+
+namespace dbgl
+{
+	/**
+	 * @brief OpenGL 3.3 implementation of instance buffers
+	 * @details Matrices are written through unsynchronized mappings, since appended ranges never overlap ranges that
+	 *          draws might still read. When appending starts over at the front, the storage is orphaned first.
+	 */
+	class InstanceBufferGL33: public IInstanceBuffer
+	{
+	public:
+		/**
+		 * @brief Constructor
+		 * @param capacity Amount of matrices the buffer can hold
+		 */
+		InstanceBufferGL33(unsigned int capacity);
+		InstanceBufferGL33(InstanceBufferGL33 const& other) = delete;
+		InstanceBufferGL33& operator=(InstanceBufferGL33 const& other) = delete;
+		virtual ~InstanceBufferGL33();
+		virtual unsigned int getCapacity() const;
+		virtual unsigned int append(Mat4f const* matrices, unsigned int count);
+
+		/**
+		 * @return Internal buffer handle
+		 */
+		GLuint getHandle() const;
+
+	private:
+		GLuint m_id = 0;
+		unsigned int m_capacity;
+		unsigned int m_next = 0;
+	};
+}
+
+#endif /* INCLUDE_DBGL_PLATFORM_MESH_INSTANCEBUFFERGL33_H_ */
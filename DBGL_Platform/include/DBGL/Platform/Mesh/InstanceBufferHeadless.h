@@ -0,0 +1,52 @@
+//////////////////////////////////////////////////////////////////////
+/// Dragon Blaze Game Library
+///
+/// Copyright (c) 2015 by Jan Moeller
+///
+/// This software is provided "as-is" and does not claim to be
+/// complete or free of bugs in any way. It should work, but
+/// it might also begin to hurt your kittens.
+//////////////////////////////////////////////////////////////////////
+
+#ifndef INCLUDE_DBGL_PLATFORM_MESH_INSTANCEBUFFERHEADLESS_H_
+#define INCLUDE_DBGL_PLATFORM_MESH_INSTANCEBUFFERHEADLESS_H_
+
+#include <vector>
+#include "IInstanceBuffer.h"
+#include "DBGL/Platform/Implementation/CommandLog.h"
+
+namespace dbgl
+{
+	/**
+	 * @brief Headless implementation of instance buffers, keeps its matrices in memory
+	 */
+	class InstanceBufferHeadless: public IInstanceBuffer
+	{
+	public:
+		/**
+		 * @brief Constructor
+		 * @param capacity Amount of matrices the buffer can hold
+		 * @param log Log to record commands to
+		 */
+		InstanceBufferHeadless(unsigned int capacity, CommandLog* log);
+		virtual unsigned int getCapacity() const;
+		virtual unsigned int append(Mat4f const* matrices, unsigned int count);
+
+		/**
+		 * @return The buffer contents
+		 */
+		std::vector<Mat4f> const& getData() const;
+		/**
+		 * @return How often appending started over at the front of the buffer
+		 */
+		unsigned int getWrapCount() const;
+
+	private:
+		std::vector<Mat4f> m_data;
+		unsigned int m_next = 0;
+		unsigned int m_wraps = 0;
+		CommandLog* m_pLog;
+	};
+}
+
+#endif /* INCLUDE_DBGL_PLATFORM_MESH_INSTANCEBUFFERHEADLESS_H_ */
@@ -18,6 +18,7 @@ namespace dbgl
 {
     /**
      * @brief OpenGL 3.3 implementation of the mesh class.
+     * @details All vertex attributes are interleaved in a single buffer.
      */
     class MeshGL33 : public IMesh
     {
@@ -44,7 +45,7 @@ namespace dbgl
 	    /**
 	     * @copydoc IMesh::indices()
 	     */
-	    virtual std::vector<unsigned short>& indices();
+	    virtual std::vector<Index>& indices();
 	    /**
 	     * @copydoc IMesh::vertices()
 	     */
@@ -65,6 +66,14 @@ namespace dbgl
 	     * @copydoc IMesh::bitangents()
 	     */
 	    virtual std::vector<Vec3f>& bitangents();
+	    /**
+	     * @copydoc IMesh::setLayout()
+	     */
+	    virtual void setLayout(VertexLayout const& layout);
+	    /**
+	     * @copydoc IMesh::getLayout()
+	     */
+	    virtual VertexLayout const& getLayout() const;
 	    /**
 	     * @copydoc IMesh::getIndexCount()
 	     */
@@ -101,6 +110,15 @@ namespace dbgl
 	     * @copydoc IMesh::updateBuffers()
 	     */
 	    virtual void updateBuffers();
+	    /**
+	     * @copydoc IMesh::updateBuffers(std::size_t, std::size_t)
+	     */
+	    virtual void updateBuffers(std::size_t first, std::size_t count);
+	    /**
+	     * @copydoc IMesh::uploadBuffers()
+	     */
+	    virtual void uploadBuffers(VertexLayout const& layout, void const* vertexData, std::size_t vertexCount,
+	    		void const* indexData, std::size_t indexCount, unsigned int indexSize);
 	    /**
 	     * @copydoc IMesh::clone()
 	     */
@@ -114,43 +132,54 @@ namespace dbgl
 	     */
 	    GLuint getVertexHandle() const;
 	    /**
-	     * @return Internal normal buffer handle
+	     * @return Layout of the data inside the vertex buffer, i.e. the layout restricted to the uploaded attributes
 	     */
-	    GLuint getNormalHandle() const;
+	    VertexLayout const& getBufferLayout() const;
 	    /**
-	     * @return Internal uv buffer handle
+	     * @return Type of the data inside the index buffer, either GL_UNSIGNED_SHORT or GL_UNSIGNED_INT
 	     */
-	    GLuint getUVHandle() const;
+	    GLenum getIndexType() const;
 	    /**
-	     * @return Internal tangent buffer handle
+	     * @brief Converts a vertex attribute format into the OpenGL type used by glVertexAttribPointer
+	     * @param format Format to convert
+	     * @return The type
 	     */
-	    GLuint getTangentHandle() const;
-	    /**
-	     * @return Internal bitangent buffer handle
-	     */
-	    GLuint getBitangentHandle() const;
+	    static GLenum format2GL(VertexLayout::Format format);
 
 	private:
-	    std::vector<unsigned short> m_indices;
+	    std::vector<Index> m_indices;
 	    GLuint m_indexBuffer = GL_INVALID_VALUE;
 	    unsigned int m_indexCount = 0;
+	    GLenum m_indexType = GL_UNSIGNED_SHORT;
 	    std::vector<Vec3f> m_vertices;
 	    GLuint m_vertexBuffer = GL_INVALID_VALUE;
 	    unsigned int m_vertexCount = 0;
 	    std::vector<Vec3f> m_normals;
-	    GLuint m_normalBuffer = GL_INVALID_VALUE;
-	    unsigned int m_normalsCount = 0;
 	    std::vector<Vec2f> m_uv;
-	    GLuint m_uvBuffer = GL_INVALID_VALUE;
-	    unsigned int m_uvCount = 0;
 	    std::vector<Vec3f> m_tangents;
-	    GLuint m_tangentBuffer = GL_INVALID_VALUE;
-	    unsigned int m_tangentCount = 0;
 	    std::vector<Vec3f> m_bitangents;
-	    GLuint m_bitangentBuffer = GL_INVALID_VALUE;
-	    unsigned int m_bitangentCount = 0;
+	    VertexLayout m_layout = VertexLayout::makeFloat();
+	    VertexLayout m_bufferLayout;
 	    Usage m_usage = Usage::StaticDraw;
 
+	    /**
+	     * @brief Deletes all buffers
+	     */
+	    void deleteBuffers();
+	    /**
+	     * @brief Copies the hardware buffers of another mesh
+	     * @details Used for meshes whose buffers were filled by uploadBuffers() and thus can't be recreated from
+	     *          the lists.
+	     * @param other Mesh to copy from
+	     */
+	    void copyBuffers(MeshGL33 const& other);
+	    /**
+	     * @brief Retrieves the amount of elements of an attribute inside the hardware buffer
+	     * @param attribute Attribute to check
+	     * @return Amount of vertices if \p attribute has been uploaded, otherwise 0
+	     */
+	    unsigned int getAttributeCount(VertexLayout::Attribute attribute) const;
+
 	    /**
 	     * @brief Converts the Usage enum into a GLenum
 	     * @return
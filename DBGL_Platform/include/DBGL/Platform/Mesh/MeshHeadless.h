@@ -0,0 +1,104 @@
+//////////////////////////////////////////////////////////////////////
+/// Dragon Blaze Game Library
+///
+/// Copyright (c) 2015 by Jan Moeller
+///
+/// This software is provided "as-is" and does not claim to be
+/// complete or free of bugs in any way. It should work, but
+/// it might also begin to hurt your kittens.
+//////////////////////////////////////////////////////////////////////
+
+#ifndef INCLUDE_DBGL_PLATFORM_MESH_MESHHEADLESS_H_
+#define INCLUDE_DBGL_PLATFORM_MESH_MESHHEADLESS_H_
+
+#include "IMesh.h"
+#include "DBGL/Platform/Implementation/CommandLog.h"
+
+namespace dbgl
+{
+	/**
+	 * @brief Headless implementation of the mesh class
+	 * @details There are no hardware buffers, updateBuffers() packs the vertices into a byte array the same way a
+	 *          hardware buffer would be filled, and records the amount of elements.
+	 */
+	class MeshHeadless: public IMesh
+	{
+	public:
+		/**
+		 * @brief Constructor
+		 * @param log Log to record commands to
+		 */
+		MeshHeadless(CommandLog* log);
+		virtual ~MeshHeadless() = default;
+		virtual std::vector<Index>& indices();
+		virtual std::vector<Vec3f>& vertices();
+		virtual std::vector<Vec3f>& normals();
+		virtual std::vector<Vec2f>& uvs();
+		virtual std::vector<Vec3f>& tangents();
+		virtual std::vector<Vec3f>& bitangents();
+		virtual void setLayout(VertexLayout const& layout);
+		virtual VertexLayout const& getLayout() const;
+		virtual unsigned int getIndexCount() const;
+		virtual unsigned int getVertexCount() const;
+		virtual unsigned int getUVCount() const;
+		virtual unsigned int getNormalCount() const;
+		virtual unsigned int getTangentCount() const;
+		virtual unsigned int getBitangentCount() const;
+		virtual void setUsage(Usage usage);
+		virtual Usage getUsage() const;
+		/**
+		 * @copydoc IMesh::updateBuffers()
+		 * @details Records an UpdateMesh command with the amount of vertices.
+		 */
+		virtual void updateBuffers();
+		/**
+		 * @copydoc IMesh::updateBuffers(std::size_t, std::size_t)
+		 * @details Records an UpdateMesh command with \p count if only the range is updated.
+		 */
+		virtual void updateBuffers(std::size_t first, std::size_t count);
+		/**
+		 * @copydoc IMesh::uploadBuffers()
+		 * @details Records an UpdateMesh command with \p vertexCount.
+		 */
+		virtual void uploadBuffers(VertexLayout const& layout, void const* vertexData, std::size_t vertexCount,
+				void const* indexData, std::size_t indexCount, unsigned int indexSize);
+		virtual IMesh* clone() const;
+		/**
+		 * @return Layout of the packed vertex data, i.e. the layout restricted to the uploaded attributes
+		 */
+		VertexLayout const& getBufferLayout() const;
+		/**
+		 * @return The packed vertex data as it would be sent to a hardware buffer
+		 */
+		std::vector<unsigned char> const& getVertexData() const;
+		/**
+		 * @return Size of an index inside the hardware buffer in bytes, either 2 or 4
+		 */
+		unsigned int getIndexSize() const;
+		/**
+		 * @return The indices as they would be sent to a hardware buffer, in the size given by getIndexSize()
+		 */
+		std::vector<unsigned char> const& getIndexData() const;
+
+	private:
+		CommandLog* m_pLog;
+		std::vector<Index> m_indices;
+		unsigned int m_indexCount = 0;
+		unsigned int m_indexSize = sizeof(unsigned short);
+		std::vector<Vec3f> m_vertices;
+		unsigned int m_vertexCount = 0;
+		std::vector<Vec3f> m_normals;
+		std::vector<Vec2f> m_uv;
+		std::vector<Vec3f> m_tangents;
+		std::vector<Vec3f> m_bitangents;
+		std::vector<unsigned char> m_vertexData;
+		std::vector<unsigned char> m_indexData;
+		VertexLayout m_layout = VertexLayout::makeFloat();
+		VertexLayout m_bufferLayout;
+		Usage m_usage = Usage::StaticDraw;
+
+		unsigned int getAttributeCount(VertexLayout::Attribute attribute) const;
+	};
+}
+
+#endif /* INCLUDE_DBGL_PLATFORM_MESH_MESHHEADLESS_H_ */
@@ -0,0 +1,171 @@
+//////////////////////////////////////////////////////////////////////
+/// Dragon Blaze Game Library
+///
+/// Copyright (c) 2015 by Jan Moeller
+///
+/// This software is provided "as-is" and does not claim to be
+/// complete or free of bugs in any way. It should work, but
+/// it might also begin to hurt your kittens.
+//////////////////////////////////////////////////////////////////////
+
+#ifndef INCLUDE_DBGL_PLATFORM_MESH_VERTEXLAYOUT_H_
+#define INCLUDE_DBGL_PLATFORM_MESH_VERTEXLAYOUT_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace dbgl
+{
+	class IMesh;
+
+	/**
+	 * @brief Describes how the vertex attributes of a mesh are stored in its hardware buffer
+	 * @details All attributes are interleaved in a single buffer, in the order they have been added. Every attribute
+	 *          is read by shaders from a fixed location:
+	 *          <table>
+	 *          <tr><th>Attribute</th><th>Location</th><th>Float</th><th>Half</th><th>Snorm1010102</th>
+	 *              <th>Octahedral</th></tr>
+	 *          <tr><td>Position</td><td>0</td><td>vec3</td><td>vec4, w = 1</td><td>-</td><td>-</td></tr>
+	 *          <tr><td>UV</td><td>1</td><td>vec2</td><td>vec2</td><td>-</td><td>-</td></tr>
+	 *          <tr><td>Normal</td><td>2</td><td>vec3</td><td>-</td><td>vec4, w = 0</td><td>vec2</td></tr>
+	 *          <tr><td>Tangent</td><td>3</td><td>vec4</td><td>vec4</td><td>vec4</td><td>-</td></tr>
+	 *          <tr><td>Bitangent</td><td>4</td><td>vec3</td><td>-</td><td>vec4, w = 0</td><td>-</td></tr>
+	 *          </table>
+	 *          The w component of tangents holds the handedness of the tangent frame, so that the bitangent doesn't
+	 *          need to be stored: <tt>bitangent = cross(normal, tangent.xyz) * tangent.w</tt>. Octahedral normals
+	 *          need to be decoded by the shader:
+	 * @code
+	 * vec3 n = vec3(oct.xy, 1.0 - abs(oct.x) - abs(oct.y));
+	 * if (n.z < 0) n.xy = (1.0 - abs(n.yx)) * sign(n.xy);
+	 * n = normalize(n);
+	 * @endcode
+	 */
+	class VertexLayout
+	{
+	public:
+		/**
+		 * @brief Vertex attributes
+		 */
+		enum class Attribute : unsigned char
+		{
+			Position, //!< Position
+			UV,       //!< UV
+			Normal,   //!< Normal
+			Tangent,  //!< Tangent
+			Bitangent, //!< Bitangent
+		};
+		/**
+		 * @brief Amount of vertex attributes
+		 */
+		static constexpr std::size_t s_attributeCount = static_cast<std::size_t>(Attribute::Bitangent) + 1;
+		/**
+		 * @brief Storage formats of vertex attributes
+		 */
+		enum class Format : unsigned char
+		{
+			Float,        //!< 32 bit float per component
+			Half,         //!< 16 bit float per component
+			Snorm1010102, //!< Three signed normalized 10 bit components and a signed normalized 2 bit component
+			Octahedral,   //!< Unit vector mapped onto an octahedron, two signed normalized 16 bit components
+		};
+		/**
+		 * @brief Single attribute within the layout
+		 */
+		struct Element
+		{
+			Attribute m_attribute;
+			Format m_format;
+			/**
+			 * @brief Offset from the start of a vertex in bytes
+			 */
+			unsigned int m_offset;
+		};
+
+		/**
+		 * @brief Creates a layout with full precision for all attributes
+		 * @return The layout
+		 */
+		static VertexLayout makeFloat();
+		/**
+		 * @brief Creates a compact layout
+		 * @details Positions are stored as floats, UVs as half floats, normals and tangents as 10:10:10:2. Bitangents
+		 *          are left out. This takes 24 bytes per vertex instead of 60.
+		 * @return The layout
+		 */
+		static VertexLayout makePacked();
+		/**
+		 * @brief Appends an attribute to the layout
+		 * @param attribute Attribute to append
+		 * @param format Format to store the attribute in
+		 * @return Reference to this layout
+		 * @throws std::invalid_argument if the attribute is already part of the layout or the format isn't supported
+		 *         for this attribute
+		 */
+		VertexLayout& add(Attribute attribute, Format format);
+		/**
+		 * @brief Restricts the layout to the attributes a mesh has data for
+		 * @param mesh Mesh to check
+		 * @return A layout only containing attributes whose data isn't empty
+		 * @throws std::invalid_argument if the mesh has data for an attribute of the layout, but not one element per
+		 *         vertex
+		 */
+		VertexLayout select(IMesh& mesh) const;
+		/**
+		 * @brief Looks up an attribute
+		 * @param attribute Attribute to look up
+		 * @return Pointer to the element of \p attribute, or nullptr if it isn't part of the layout
+		 */
+		Element const* find(Attribute attribute) const;
+		/**
+		 * @return All attributes in the order they are stored
+		 */
+		std::vector<Element> const& getElements() const;
+		/**
+		 * @return Size of a vertex in bytes
+		 */
+		unsigned int getStride() const;
+		/**
+		 * @brief Converts a range of vertices of a mesh into this layout
+		 * @param mesh Mesh to convert. Needs to have data for all attributes of the layout.
+		 * @param first First vertex to convert
+		 * @param count Amount of vertices to convert
+		 * @param[out] out Buffer to write to, needs to hold \p count times getStride() bytes
+		 */
+		void pack(IMesh& mesh, std::size_t first, std::size_t count, void* out) const;
+		bool operator==(VertexLayout const& other) const;
+		bool operator!=(VertexLayout const& other) const;
+
+		/**
+		 * @brief Retrieves the amount of components a shader reads for an attribute
+		 * @param attribute Attribute
+		 * @param format Format of the attribute
+		 * @return Amount of components, or 0 if the format isn't supported for \p attribute
+		 */
+		static unsigned int getComponents(Attribute attribute, Format format);
+		/**
+		 * @brief Retrieves the size of an attribute
+		 * @param attribute Attribute
+		 * @param format Format of the attribute
+		 * @return Size in bytes, or 0 if the format isn't supported for \p attribute
+		 */
+		static unsigned int getSize(Attribute attribute, Format format);
+		/**
+		 * @brief Converts a float to a half float, rounding to nearest even
+		 * @param value Value to convert
+		 * @return Bits of the half float
+		 */
+		static std::uint16_t toHalf(float value);
+		/**
+		 * @brief Converts a half float to a float
+		 * @param half Bits of the half float
+		 * @return The value
+		 */
+		static float fromHalf(std::uint16_t half);
+	private:
+		std::vector<Element> m_elements;
+		unsigned int m_stride = 0;
+	};
+}
+
+#endif /* INCLUDE_DBGL_PLATFORM_MESH_VERTEXLAYOUT_H_ */
@@ -0,0 +1,29 @@
+//////////////////////////////////////////////////////////////////////
+/// Dragon Blaze Game Library
+///
+/// Copyright (c) 2015 by Jan Moeller
+///
+/// This software is provided "as-is" and does not claim to be
+/// complete or free of bugs in any way. It should work, but
+/// it might also begin to hurt your kittens.
+//////////////////////////////////////////////////////////////////////
+
+#ifndef INCLUDE_DBGL_PLATFORM_MONITOR_MONITORHEADLESS_H_
+#define INCLUDE_DBGL_PLATFORM_MONITOR_MONITORHEADLESS_H_
+
+#include "IMonitor.h"
+
+namespace dbgl
+{
+	/**
+	 * @brief Headless implementation of the monitor class, pretends to be a full HD monitor
+	 */
+	class MonitorHeadless: public IMonitor
+	{
+	public:
+		virtual ~MonitorHeadless() = default;
+		virtual void getResolution(int& width, int& height);
+	};
+}
+
+#endif /* INCLUDE_DBGL_PLATFORM_MONITOR_MONITORHEADLESS_H_ */
@@ -18,8 +18,10 @@
 #include "DBGL/Platform/Shader/IShader.h"
 #include "DBGL/Platform/Shader/IShaderProgram.h"
 #include "DBGL/Platform/Shader/IShaderProgramCommands.h"
+#include "DBGL/Platform/Shader/IUniformBuffer.h"
 #include "DBGL/Platform/Texture/ITexture.h"
 #include "DBGL/Platform/Texture/ITextureCommands.h"
+#include "DBGL/Platform/Mesh/IInstanceBuffer.h"
 
 namespace dbgl
 {
@@ -78,6 +80,13 @@ namespace dbgl
 			 * @note The created object needs to be deleted manually
 			 */
 			virtual IShaderProgram* createShaderProgram() = 0;
+			/**
+			 * @brief Creates a uniform buffer
+			 * @param size Buffer size in bytes
+			 * @return Pointer to the created uniform buffer
+			 * @note The created object needs to be deleted manually
+			 */
+			virtual IUniformBuffer* createUniformBuffer(std::size_t size) = 0;
 			/**
 			 * @brief Creates an empty texture
 			 * @param type Texture type
@@ -91,6 +100,13 @@ namespace dbgl
 			 * @note The created object needs to be deleted manually
 			 */
 			virtual IMesh* createMesh() = 0;
+			/**
+			 * @brief Creates an instance buffer
+			 * @param capacity Amount of model matrices the buffer can hold
+			 * @return Pointer to the created instance buffer
+			 * @note The created object needs to be deleted manually
+			 */
+			virtual IInstanceBuffer* createInstanceBuffer(unsigned int capacity) = 0;
 			/**
 			 * @brief Creates a render context that can be used to draw onto textures
 			 * @param width Width in pixels
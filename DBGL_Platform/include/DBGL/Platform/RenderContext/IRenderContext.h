@@ -13,17 +13,26 @@
 
 #include <array>
 #include "DBGL/Platform/Mesh/IMesh.h"
+#include "DBGL/Platform/Mesh/IInstanceBuffer.h"
 #include "DBGL/Platform/Texture/ITexture.h"
 #include "DBGL/Platform/Texture/ITextureCommands.h"
 
 namespace dbgl
 {
+	class RenderStateBlock;
+	class RenderStateCounters;
+
 	/**
 	 * @brief Interface class for render contexts
 	 */
 	class IRenderContext
 	{
 	public:
+		/**
+		 * @brief First vertex attribute location of the per-instance model matrix, which occupies four locations
+		 */
+		static constexpr unsigned int s_instanceAttribute = 5;
+
 		/**
 		 * @brief Types of buffers attached to the render context
 		 */
@@ -213,6 +222,24 @@ namespace dbgl
 		 * @param color Color used to clear the context
 		 */
 		virtual void setClearColor(std::array<float, 3> color) = 0;
+		/**
+		 * @brief Applies all states of a block at once
+		 * @details Only states that differ from the current ones are changed.
+		 * @param block Block to apply
+		 */
+		virtual void apply(RenderStateBlock const& block) = 0;
+		/**
+		 * @brief Captures all states covered by RenderStateBlock, e.g. to restore them later on
+		 * @return Block holding the current states
+		 */
+		virtual RenderStateBlock getStateBlock() const = 0;
+		/**
+		 * @brief Provides counters of requested and actually performed state changes
+		 * @details Every call to a state setter, as well as every state in an applied block, counts as a request.
+		 *          Requests that don't change anything are filtered out and aren't sent to the graphics API.
+		 * @return Counters of this context
+		 */
+		virtual RenderStateCounters& getStateCounters() = 0;
 		/**
 		 * @brief Bind this context
 		 */
@@ -258,6 +285,18 @@ namespace dbgl
 		 * @param mesh Mesh to draw
 		 */
 		virtual void drawMesh(IMesh* mesh) = 0;
+		/**
+		 * @brief Renders the \p mesh multiple times with a single draw call
+		 * @details Instance i reads matrix \p first + i of \p instances from the vertex attributes starting at
+		 *          s_instanceAttribute.
+		 * @param mesh Mesh to draw
+		 * @param instances Buffer holding one model matrix per instance
+		 * @param first Index of the matrix of the first instance, as returned by IInstanceBuffer::append()
+		 * @param count Amount of instances to draw
+		 * @throws std::invalid_argument if the range of matrices exceeds \p instances
+		 */
+		virtual void drawMeshInstanced(IMesh* mesh, IInstanceBuffer* instances, unsigned int first,
+				unsigned int count) = 0;
 	};
 }
 
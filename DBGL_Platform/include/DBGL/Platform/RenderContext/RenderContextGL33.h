@@ -14,6 +14,7 @@
 #include <stdexcept>
 #include <GL/glew.h>
 #include "IRenderContext.h"
+#include "RenderStateBlock.h"
 #include "DBGL/Platform/Mesh/MeshGL33.h"
 #include "DBGL/Platform/Texture/TextureGL33.h"
 
@@ -21,6 +22,11 @@ namespace dbgl
 {
 	/**
 	 * @brief Common functionality for render contexts using OpenGL 3.3
+	 * @details The states covered by RenderStateBlock are shadowed. Requests that wouldn't change anything are
+	 *          filtered out, and state changes only issue the OpenGL calls needed to get from the shadowed state to
+	 *          the requested one. As OpenGL state is shared by all frame buffers, the shadow state is shared by all
+	 *          render contexts as well. If OpenGL state is modified without going through a render context,
+	 *          invalidateStateCache() needs to be called.
 	 */
 	class RenderContextGL33: public IRenderContext
 	{
@@ -125,6 +131,18 @@ namespace dbgl
 		 * @copydoc IRenderContext::setClearColor()
 		 */
 		virtual void setClearColor(std::array<float, 3> color);
+		/**
+		 * @copydoc IRenderContext::apply()
+		 */
+		virtual void apply(RenderStateBlock const& block);
+		/**
+		 * @copydoc IRenderContext::getStateBlock()
+		 */
+		virtual RenderStateBlock getStateBlock() const;
+		/**
+		 * @copydoc IRenderContext::getStateCounters()
+		 */
+		virtual RenderStateCounters& getStateCounters();
 		/**
 		 * @copydoc IRenderContext::bind()
 		 */
@@ -148,6 +166,11 @@ namespace dbgl
 		 * @copydoc IRenderContext::drawMesh()
 		 */
 		virtual void drawMesh(IMesh* mesh);
+		/**
+		 * @copydoc IRenderContext::drawMeshInstanced()
+		 */
+		virtual void drawMeshInstanced(IMesh* mesh, IInstanceBuffer* instances, unsigned int first,
+				unsigned int count);
 
 		/**
 		 * Converts AlphaBlendValue into OpenGL enums
@@ -155,24 +178,18 @@ namespace dbgl
 		 * @return The OpenGL equivalent of \p val
 		 */
 		static GLenum alphaBlendValue2GL(AlphaBlendValue val);
-
-	protected:
 		/**
-		 * @brief Current depth test value
+		 * @brief Forces the next request of every shadowed state to be sent to OpenGL
+		 * @details Needs to be called if OpenGL state has been modified without going through a render context, e.g.
+		 *          by third party code.
 		 */
-		DepthTestValue m_curDepthTestVal = DepthTestValue::Always;
-		/**
-		 * @brief Current source alpha blend value
-		 */
-		AlphaBlendValue m_curSrcAlphaBlendVal = AlphaBlendValue::Zero;
-		/**
-		 * @brief Current destination alpha blend value
-		 */
-		AlphaBlendValue m_curDestAlphaBlendVal = AlphaBlendValue::Zero;
+		static void invalidateStateCache();
+
+	protected:
 		/**
-		 * @brief Current face culling value
+		 * @brief Counters of requested and issued state changes
 		 */
-		FaceCullingValue m_curFaceCullingVal = FaceCullingValue::Off;
+		RenderStateCounters m_stateCounters;
 		/**
 		 * @brief Internal frame buffer handle
 		 */
@@ -194,6 +211,70 @@ namespace dbgl
 		 * @brief Currently bound frame buffer
 		 */
 		static GLuint s_curFrameBufferId;
+		/**
+		 * @brief Shadow of the OpenGL state
+		 */
+		static RenderStateBlock s_state;
+		/**
+		 * @brief Mask of states whose OpenGL value is unknown, as returned by RenderStateBlock::diff()
+		 */
+		static unsigned int s_invalidStates;
+
+	private:
+		/**
+		 * @brief Binds the vertex buffer of a mesh to the attribute locations of its layout
+		 * @param pMesh Mesh to bind
+		 */
+		static void enableAttributes(MeshGL33* pMesh);
+		/**
+		 * @brief Disables the attribute locations used by a mesh
+		 * @param pMesh Previously bound mesh
+		 */
+		static void disableAttributes(MeshGL33* pMesh);
+		/**
+		 * @brief Sends the OpenGL calls to change the depth test and updates the shadow state
+		 * @param val New value
+		 */
+		static void changeDepthTest(DepthTestValue val);
+		/**
+		 * @brief Sends the OpenGL calls to change the blend factors and updates the shadow state
+		 * @param src New source factor
+		 * @param dest New destination factor
+		 */
+		static void changeAlphaBlend(AlphaBlendValue src, AlphaBlendValue dest);
+		/**
+		 * @brief Sends the OpenGL calls to change face culling and updates the shadow state
+		 * @param val New value
+		 */
+		static void changeFaceCulling(FaceCullingValue val);
+		/**
+		 * @brief Sends the OpenGL calls to change the draw mode and updates the shadow state
+		 * @param mode New mode
+		 */
+		static void changeDrawMode(DrawMode mode);
+		/**
+		 * @brief Sends the OpenGL calls to change depth writes and updates the shadow state
+		 * @param enable New value
+		 */
+		static void changeDepthBuffer(bool enable);
+		/**
+		 * @brief Sends the OpenGL calls to change color writes and updates the shadow state
+		 * @param mask New color mask
+		 */
+		static void changeColorBuffer(std::array<bool, 4> const& mask);
+		/**
+		 * @brief Checks if a state request needs to be sent and counts it
+		 * @param state Requested state
+		 * @param changed True if the requested value differs from the shadowed one
+		 * @return True if the request needs to be sent to OpenGL
+		 */
+		bool request(RenderStateBlock::State state, bool changed);
+		/**
+		 * @brief Checks if the OpenGL value of a state is known
+		 * @param state State to check
+		 * @return True if the shadow state is valid for \p state
+		 */
+		static bool isKnown(RenderStateBlock::State state);
 	};
 }
 
@@ -0,0 +1,95 @@
+//////////////////////////////////////////////////////////////////////
+/// Dragon Blaze Game Library
+///
+/// Copyright (c) 2015 by Jan Moeller
+///
+/// This software is provided "as-is" and does not claim to be
+/// complete or free of bugs in any way. It should work, but
+/// it might also begin to hurt your kittens.
+//////////////////////////////////////////////////////////////////////
+
+#ifndef INCLUDE_DBGL_PLATFORM_RENDERCONTEXT_RENDERCONTEXTHEADLESS_H_
+#define INCLUDE_DBGL_PLATFORM_RENDERCONTEXT_RENDERCONTEXTHEADLESS_H_
+
+#include "IRenderContext.h"
+#include "RenderStateBlock.h"
+#include "DBGL/Platform/Implementation/CommandLog.h"
+
+namespace dbgl
+{
+	/**
+	 * @brief Headless implementation of a render context
+	 * @details Doesn't render anything, but keeps track of its state and records every state change, clear and draw.
+	 *          Like with a real graphics API, every command binds the context first if it isn't bound yet. Just like
+	 *          RenderContextGL33, requests that don't change the states covered by RenderStateBlock are filtered out
+	 *          and only counted.
+	 */
+	class RenderContextHeadless: public IRenderContext
+	{
+	public:
+		/**
+		 * @brief Constructor
+		 * @param width Frame width in pixels
+		 * @param height Frame height in pixels
+		 * @param log Log to record commands to
+		 */
+		RenderContextHeadless(unsigned int width, unsigned int height, CommandLog* log);
+		virtual ~RenderContextHeadless();
+		virtual void clear(int bitmask);
+		virtual void setDepthTest(DepthTestValue val);
+		virtual DepthTestValue getDepthTest() const;
+		virtual void setAlphaBlend(AlphaBlendValue src, AlphaBlendValue dest);
+		virtual AlphaBlendValue getSrcAlphaBlend() const;
+		virtual AlphaBlendValue getDestAlphaBlend() const;
+		virtual void setFaceCulling(FaceCullingValue val);
+		virtual FaceCullingValue getFaceCulling() const;
+		virtual void setDrawMode(DrawMode mode);
+		virtual DrawMode getDrawMode() const;
+		virtual void setLineWidth(float width);
+		virtual float getLineWidth() const;
+		virtual void setLineAntialiasing(bool smooth);
+		virtual bool getLineAntialiasing() const;
+		virtual void setPointSize(float size);
+		virtual float getPointSize() const;
+		virtual void enableDepthBuffer(bool enable);
+		virtual bool isDepthBufferEnabled() const;
+		virtual void enableColorBuffer(bool red, bool green, bool blue, bool alpha);
+		virtual std::array<bool, 4> isColorBufferEnabled() const;
+		virtual void setMultisampling(bool msaa);
+		virtual bool getMultisampling() const;
+		virtual std::array<float, 3> getClearColor() const;
+		virtual void setClearColor(std::array<float, 3> color);
+		virtual void apply(RenderStateBlock const& block);
+		virtual RenderStateBlock getStateBlock() const;
+		virtual RenderStateCounters& getStateCounters();
+		virtual void bind();
+		virtual bool isBound() const;
+		virtual int getWidth();
+		virtual int getHeight();
+		virtual void viewport(unsigned int x, unsigned int y, unsigned int width, unsigned int height);
+		virtual void readPixels(int x, int y, int width, int height, ITextureCommands::PixelFormat format,
+				ITextureCommands::PixelType type, unsigned int bufsize, char* buf);
+		virtual void drawMesh(IMesh* mesh);
+		virtual void drawMeshInstanced(IMesh* mesh, IInstanceBuffer* instances, unsigned int first,
+				unsigned int count);
+	private:
+		unsigned int m_width;
+		unsigned int m_height;
+		CommandLog* m_pLog;
+		RenderStateBlock m_state;
+		RenderStateCounters m_stateCounters;
+		float m_lineWidth = 1;
+		bool m_lineAntialiasing = false;
+		float m_pointSize = 1;
+		bool m_multisampling = false;
+		std::array<float, 3> m_clearColor { { 0, 0, 0 } };
+
+		static RenderContextHeadless const* s_pBound;
+
+		void record(CommandLog::Type type, unsigned int value = 0);
+		bool request(RenderStateBlock::State state, bool changed);
+		static unsigned int floatBits(float value);
+	};
+}
+
+#endif /* INCLUDE_DBGL_PLATFORM_RENDERCONTEXT_RENDERCONTEXTHEADLESS_H_ */
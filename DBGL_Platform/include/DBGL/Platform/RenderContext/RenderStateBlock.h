@@ -0,0 +1,200 @@
+//////////////////////////////////////////////////////////////////////
+/// Dragon Blaze Game Library
+///
+/// Copyright (c) 2015 by Jan Moeller
+///
+/// This software is provided "as-is" and does not claim to be
+/// complete or free of bugs in any way. It should work, but
+/// it might also begin to hurt your kittens.
+//////////////////////////////////////////////////////////////////////
+
+#ifndef INCLUDE_DBGL_PLATFORM_RENDERCONTEXT_RENDERSTATEBLOCK_H_
+#define INCLUDE_DBGL_PLATFORM_RENDERCONTEXT_RENDERSTATEBLOCK_H_
+
+#include <array>
+#include <cstddef>
+#include "IRenderContext.h"
+
+namespace dbgl
+{
+	/**
+	 * @brief Immutable set of render states that can be applied to a render context at once
+	 * @details Blocks are meant to be built once, e.g. one per render pass, and then applied whenever needed. The
+	 *          render context compares the block against the state it has already set and only sends the differences
+	 *          to the graphics API.
+	 * @code
+	 * static RenderStateBlock const zPrePass = RenderStateBlock { }.withColorBuffer(false, false, false, false)
+	 * 		.withDepthTest(IRenderContext::DepthTestValue::Less);
+	 * rc->apply(zPrePass);
+	 * @endcode
+	 */
+	class RenderStateBlock
+	{
+	public:
+		/**
+		 * @brief States covered by a block
+		 */
+		enum class State : unsigned char
+		{
+			DepthTest,   //!< Depth test
+			AlphaBlend,  //!< Source and destination blend factors
+			FaceCulling, //!< Face culling
+			DrawMode,    //!< Polygon draw mode
+			DepthBuffer, //!< Depth buffer writes
+			ColorBuffer, //!< Color buffer component writes
+		};
+		/**
+		 * @brief Amount of states covered by a block
+		 */
+		static constexpr std::size_t s_stateCount = static_cast<std::size_t>(State::ColorBuffer) + 1;
+
+		/**
+		 * @brief Constructs a block with the default state of a freshly created context
+		 * @details No depth test, no alpha blending, no face culling, filled polygons and all buffers writable.
+		 */
+		RenderStateBlock() = default;
+		/**
+		 * @brief Creates a copy of this block with a different depth test
+		 * @param val Depth test value
+		 * @return The modified copy
+		 */
+		RenderStateBlock withDepthTest(IRenderContext::DepthTestValue val) const;
+		/**
+		 * @brief Creates a copy of this block with different blend factors
+		 * @param src Source factor
+		 * @param dest Destination factor
+		 * @return The modified copy
+		 * @note Set both \p src and \p dest to Zero in order to disable alpha blending
+		 */
+		RenderStateBlock withAlphaBlend(IRenderContext::AlphaBlendValue src, IRenderContext::AlphaBlendValue dest) const;
+		/**
+		 * @brief Creates a copy of this block with a different face culling
+		 * @param val Face culling value
+		 * @return The modified copy
+		 */
+		RenderStateBlock withFaceCulling(IRenderContext::FaceCullingValue val) const;
+		/**
+		 * @brief Creates a copy of this block with a different draw mode
+		 * @param mode Draw mode
+		 * @return The modified copy
+		 */
+		RenderStateBlock withDrawMode(IRenderContext::DrawMode mode) const;
+		/**
+		 * @brief Creates a copy of this block with depth buffer writes enabled or disabled
+		 * @param enable True to enable depth writes
+		 * @return The modified copy
+		 */
+		RenderStateBlock withDepthBuffer(bool enable) const;
+		/**
+		 * @brief Creates a copy of this block with different color buffer components enabled
+		 * @param red Indicates if the red component should be written
+		 * @param green Indicates if the green component should be written
+		 * @param blue Indicates if the blue component should be written
+		 * @param alpha Indicates if the alpha component should be written
+		 * @return The modified copy
+		 */
+		RenderStateBlock withColorBuffer(bool red, bool green, bool blue, bool alpha) const;
+		/**
+		 * @return The depth test value
+		 */
+		IRenderContext::DepthTestValue getDepthTest() const;
+		/**
+		 * @return The source blend factor
+		 */
+		IRenderContext::AlphaBlendValue getSrcAlphaBlend() const;
+		/**
+		 * @return The destination blend factor
+		 */
+		IRenderContext::AlphaBlendValue getDestAlphaBlend() const;
+		/**
+		 * @return The face culling value
+		 */
+		IRenderContext::FaceCullingValue getFaceCulling() const;
+		/**
+		 * @return The draw mode
+		 */
+		IRenderContext::DrawMode getDrawMode() const;
+		/**
+		 * @return True if depth writes are enabled
+		 */
+		bool isDepthBufferEnabled() const;
+		/**
+		 * @return Array in the order red-green-blue-alpha, indicating if the components are enabled
+		 */
+		std::array<bool, 4> const& isColorBufferEnabled() const;
+		/**
+		 * @brief Compares this block to another one
+		 * @param other Block to compare to
+		 * @return Bit mask with bit \p i set if the State with value \p i differs
+		 */
+		unsigned int diff(RenderStateBlock const& other) const;
+		/**
+		 * @brief Checks if a state is part of a bit mask as returned by diff()
+		 * @param mask Bit mask
+		 * @param state State to check
+		 * @return True if the bit of \p state is set
+		 */
+		static bool contains(unsigned int mask, State state);
+		bool operator==(RenderStateBlock const& other) const;
+		bool operator!=(RenderStateBlock const& other) const;
+	private:
+		IRenderContext::DepthTestValue m_depthTest = IRenderContext::DepthTestValue::Always;
+		IRenderContext::AlphaBlendValue m_srcBlend = IRenderContext::AlphaBlendValue::Zero;
+		IRenderContext::AlphaBlendValue m_destBlend = IRenderContext::AlphaBlendValue::Zero;
+		IRenderContext::FaceCullingValue m_faceCulling = IRenderContext::FaceCullingValue::Off;
+		IRenderContext::DrawMode m_drawMode = IRenderContext::DrawMode::Fill;
+		bool m_depthBuffer = true;
+		std::array<bool, 4> m_colorBuffer { { true, true, true, true } };
+	};
+
+	/**
+	 * @brief Counts how often each state of a RenderStateBlock has been requested and how often it actually had to
+	 *        be sent to the graphics API
+	 */
+	class RenderStateCounters
+	{
+	public:
+		/**
+		 * @brief Counts a request to set a state
+		 * @param state Requested state
+		 * @param issued True if the request changed the state, false if it was redundant
+		 */
+		void count(RenderStateBlock::State state, bool issued);
+		/**
+		 * @brief Resets all counters to zero
+		 */
+		void reset();
+		/**
+		 * @brief Retrieves how often a state has been requested
+		 * @param state State to check
+		 * @return Amount of requests for \p state, including redundant ones
+		 */
+		unsigned int getRequested(RenderStateBlock::State state) const;
+		/**
+		 * @brief Retrieves how often a state has actually been changed
+		 * @param state State to check
+		 * @return Amount of requests for \p state that had to be sent to the graphics API
+		 */
+		unsigned int getIssued(RenderStateBlock::State state) const;
+		/**
+		 * @brief Retrieves the amount of requests over all states
+		 * @return Sum of getRequested() over all states
+		 */
+		unsigned int getRequested() const;
+		/**
+		 * @brief Retrieves the amount of changes over all states
+		 * @return Sum of getIssued() over all states
+		 */
+		unsigned int getIssued() const;
+		/**
+		 * @brief Retrieves the amount of requests that have been filtered out
+		 * @return Difference between getRequested() and getIssued()
+		 */
+		unsigned int getRedundant() const;
+	private:
+		std::array<unsigned int, RenderStateBlock::s_stateCount> m_requested { };
+		std::array<unsigned int, RenderStateBlock::s_stateCount> m_issued { };
+	};
+}
+
+#endif /* INCLUDE_DBGL_PLATFORM_RENDERCONTEXT_RENDERSTATEBLOCK_H_ */
@@ -31,6 +31,10 @@ namespace dbgl
 		 * @brief Handles that distinctly describe a uniform within a program
 		 */
 		using UniformHandle = int;
+		/**
+		 * @brief Handles that distinctly describe a uniform block within a program
+		 */
+		using UniformBlockHandle = int;
 		/**
 		 * @brief Value of invalid attribute handles
 		 */
@@ -39,6 +43,10 @@ namespace dbgl
 		 * @brief Value of invalid uniform handles
 		 */
 		static constexpr UniformHandle InvalidUniformHandle = -1;
+		/**
+		 * @brief Value of invalid uniform block handles
+		 */
+		static constexpr UniformBlockHandle InvalidUniformBlockHandle = -1;
 
 		/**
 		 * @brief Destructor
@@ -52,6 +60,8 @@ namespace dbgl
 		virtual void attach(IShader* shader) = 0;
 		/**
 		 * @brief Link the attached shaders
+		 * @details Also gathers all active attributes, uniforms and uniform blocks, so that looking up their handles
+		 *          later on doesn't need to query the graphics API.
 		 */
 		virtual void link() = 0;
 		/**
@@ -63,13 +73,20 @@ namespace dbgl
 		 * @param name Attribute name
 		 * @return Handle to the attribute or InvalidAttribHandle if no attribute with name \p name could be found
 		 */
-		virtual AttribHandle getAttributeHandle(std::string name) const = 0;
+		virtual AttribHandle getAttributeHandle(std::string const& name) const = 0;
 		/**
 		 * @brief Provides a handle for a uniform by its name
 		 * @param name Uniform name
 		 * @return Handle to the uniform or InvalidUniformHandle if no uniform with name \p name could be found
 		 */
-		virtual UniformHandle getUniformHandle(std::string name) const = 0;
+		virtual UniformHandle getUniformHandle(std::string const& name) const = 0;
+		/**
+		 * @brief Provides a handle for a uniform block by its name
+		 * @param name Uniform block name
+		 * @return Handle to the uniform block or InvalidUniformBlockHandle if no uniform block with name \p name could
+		 *         be found
+		 */
+		virtual UniformBlockHandle getUniformBlockHandle(std::string const& name) const = 0;
 	};
 }
 
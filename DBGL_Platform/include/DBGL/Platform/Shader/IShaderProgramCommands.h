@@ -23,6 +23,7 @@ namespace dbgl
 	public:
 		using AttribHandle = IShaderProgram::AttribHandle;
 		using UniformHandle = IShaderProgram::UniformHandle;
+		using UniformBlockHandle = IShaderProgram::UniformBlockHandle;
 		/**
 		 * @brief Default destructor
 		 */
@@ -188,6 +189,14 @@ namespace dbgl
 		 * @param value New value
 		 */
 		virtual void setUniformSampler(UniformHandle handle, const int value) = 0;
+		/**
+		 * @brief Connects a uniform block to a binding point
+		 * @details The block gets its values from the uniform buffer bound to \p bindingPoint, see
+		 *          IUniformBuffer::bind().
+		 * @param handle Uniform block handle
+		 * @param bindingPoint Binding point
+		 */
+		virtual void setUniformBlockBinding(UniformBlockHandle handle, unsigned int bindingPoint) = 0;
 	private:
 	};
 }
@@ -0,0 +1,51 @@
+//////////////////////////////////////////////////////////////////////
+/// Dragon Blaze Game Library
+///
+/// Copyright (c) 2015 by Jan Moeller
+///
+/// This software is provided "as-is" and does not claim to be
+/// complete or free of bugs in any way. It should work, but
+/// it might also begin to hurt your kittens.
+//////////////////////////////////////////////////////////////////////
+
+#ifndef INCLUDE_DBGL_PLATFORM_SHADER_IUNIFORMBUFFER_H_
+#define INCLUDE_DBGL_PLATFORM_SHADER_IUNIFORMBUFFER_H_
+
+#include <cstddef>
+
+namespace dbgl
+{
+	/**
+	 * @brief Interface class for buffers holding the values of uniform blocks
+	 * @details A buffer is bound to a binding point, and all uniform blocks connected to that binding point read their
+	 *          values from it. See IShaderProgramCommands::setUniformBlockBinding().
+	 */
+	class IUniformBuffer
+	{
+	public:
+		/**
+		 * @brief Destructor
+		 */
+		virtual ~IUniformBuffer() = default;
+		/**
+		 * @brief Retrieves the buffer size
+		 * @return Size in bytes
+		 */
+		virtual std::size_t getSize() const = 0;
+		/**
+		 * @brief Uploads data to the buffer
+		 * @param data Data to upload
+		 * @param size Amount of bytes to upload
+		 * @param offset Offset into the buffer in bytes
+		 * @throws std::invalid_argument if the range exceeds the buffer
+		 */
+		virtual void write(void const* data, std::size_t size, std::size_t offset = 0) = 0;
+		/**
+		 * @brief Binds this buffer to a binding point
+		 * @param bindingPoint Binding point
+		 */
+		virtual void bind(unsigned int bindingPoint) = 0;
+	};
+}
+
+#endif /* INCLUDE_DBGL_PLATFORM_SHADER_IUNIFORMBUFFER_H_ */
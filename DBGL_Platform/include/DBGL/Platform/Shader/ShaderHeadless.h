@@ -0,0 +1,51 @@
+//////////////////////////////////////////////////////////////////////
+/// Dragon Blaze Game Library
+///
+/// Copyright (c) 2015 by Jan Moeller
+///
+/// This software is provided "as-is" and does not claim to be
+/// complete or free of bugs in any way. It should work, but
+/// it might also begin to hurt your kittens.
+//////////////////////////////////////////////////////////////////////
+
+#ifndef INCLUDE_DBGL_PLATFORM_SHADER_SHADERHEADLESS_H_
+#define INCLUDE_DBGL_PLATFORM_SHADER_SHADERHEADLESS_H_
+
+#include "IShader.h"
+#include "DBGL/Platform/Implementation/CommandLog.h"
+
+namespace dbgl
+{
+	/**
+	 * @brief Headless implementation of the shader class
+	 * @details Nothing is compiled, the code is only kept so that shader programs can find out about their
+	 *          attributes and uniforms.
+	 */
+	class ShaderHeadless: public IShader
+	{
+	public:
+		/**
+		 * @brief Constructor
+		 * @param type Shader type
+		 * @param code Code of the shader
+		 * @param log Log to record commands to
+		 */
+		ShaderHeadless(Type type, std::string code, CommandLog* log);
+		virtual ~ShaderHeadless() = default;
+		virtual void compile();
+		/**
+		 * @return Shader type
+		 */
+		Type getType() const;
+		/**
+		 * @return Code of the shader
+		 */
+		std::string const& getCode() const;
+	private:
+		Type m_type;
+		std::string m_code;
+		CommandLog* m_pLog;
+	};
+}
+
+#endif /* INCLUDE_DBGL_PLATFORM_SHADER_SHADERHEADLESS_H_ */
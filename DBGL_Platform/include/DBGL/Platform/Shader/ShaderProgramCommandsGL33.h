@@ -53,6 +53,12 @@ namespace dbgl
 		virtual void setUniformFloatMatrix4Array(UniformHandle handle, unsigned int count, bool transpose,
 				const float* values);
 		virtual void setUniformSampler(UniformHandle handle, const int value);
+		virtual void setUniformBlockBinding(UniformBlockHandle handle, unsigned int bindingPoint);
+
+	private:
+		static GLuint s_curProgramId;
+
+		friend class ShaderProgramGL33;
 	};
 }
 
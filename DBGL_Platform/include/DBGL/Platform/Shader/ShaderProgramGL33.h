@@ -11,6 +11,8 @@
 #ifndef SHADERPROGRAMGL33_H_
 #define SHADERPROGRAMGL33_H_
 
+#include <string>
+#include <unordered_map>
 #include "IShaderProgram.h"
 #include "ShaderGL33.h"
 
@@ -18,6 +20,9 @@ namespace dbgl
 {
 	/**
 	 * @brief OpenGL 3.3 implementation of the shader program class
+	 * @details On link() all active attributes, uniforms and uniform blocks are queried once and stored in hash
+	 *          tables, so handle lookups don't need to call into OpenGL. Uniform arrays can be looked up both with and
+	 *          without the "[0]" suffix.
 	 */
 	class ShaderProgramGL33: public IShaderProgram
 	{
@@ -30,8 +35,9 @@ namespace dbgl
 		virtual void attach(IShader* shader);
 		virtual void link();
 		virtual void use();
-		virtual AttribHandle getAttributeHandle(std::string name) const;
-		virtual UniformHandle getUniformHandle(std::string name) const;
+		virtual AttribHandle getAttributeHandle(std::string const& name) const;
+		virtual UniformHandle getUniformHandle(std::string const& name) const;
+		virtual UniformBlockHandle getUniformBlockHandle(std::string const& name) const;
 
 		/**
 		 * @return Internal shader program handle
@@ -40,8 +46,15 @@ namespace dbgl
 
 	private:
 		GLuint m_id;
+		std::unordered_map<std::string, AttribHandle> m_attributes;
+		std::unordered_map<std::string, UniformHandle> m_uniforms;
+		std::unordered_map<std::string, UniformBlockHandle> m_uniformBlocks;
 
 		void useInternal() const;
+		/**
+		 * @brief Queries all active attributes, uniforms and uniform blocks
+		 */
+		void reflect();
 	};
 }
 
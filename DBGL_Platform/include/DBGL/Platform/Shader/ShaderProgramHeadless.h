@@ -0,0 +1,61 @@
+//////////////////////////////////////////////////////////////////////
+/// Dragon Blaze Game Library
+///
+/// Copyright (c) 2015 by Jan Moeller
+///
+/// This software is provided "as-is" and does not claim to be
+/// complete or free of bugs in any way. It should work, but
+/// it might also begin to hurt your kittens.
+//////////////////////////////////////////////////////////////////////
+
+#ifndef INCLUDE_DBGL_PLATFORM_SHADER_SHADERPROGRAMHEADLESS_H_
+#define INCLUDE_DBGL_PLATFORM_SHADER_SHADERPROGRAMHEADLESS_H_
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "IShaderProgram.h"
+#include "ShaderHeadless.h"
+#include "DBGL/Platform/Implementation/CommandLog.h"
+
+namespace dbgl
+{
+	class ShaderProgramCommandsHeadless;
+
+	/**
+	 * @brief Headless implementation of the shader program class
+	 * @details On link() the code of all attached shaders is scanned for uniform declarations and for the inputs of
+	 *          vertex shaders. Each of them is assigned a handle in the order of declaration, names that aren't
+	 *          declared yield invalid handles just like they would with a real graphics API. Uniform blocks get
+	 *          handles of their own, their members aren't plain uniforms.
+	 */
+	class ShaderProgramHeadless: public IShaderProgram
+	{
+	public:
+		/**
+		 * @brief Constructor
+		 * @param log Log to record commands to
+		 * @param commands Commands object that keeps track of the program in use
+		 */
+		ShaderProgramHeadless(CommandLog* log, ShaderProgramCommandsHeadless* commands);
+		virtual ~ShaderProgramHeadless();
+		virtual void attach(IShader* shader);
+		virtual void link();
+		virtual void use();
+		virtual AttribHandle getAttributeHandle(std::string const& name) const;
+		virtual UniformHandle getUniformHandle(std::string const& name) const;
+		virtual UniformBlockHandle getUniformBlockHandle(std::string const& name) const;
+
+	private:
+		CommandLog* m_pLog;
+		ShaderProgramCommandsHeadless* m_pCommands;
+		std::vector<std::pair<IShader::Type, std::string>> m_sources;
+		std::unordered_map<std::string, AttribHandle> m_attributes;
+		std::unordered_map<std::string, UniformHandle> m_uniforms;
+		std::unordered_map<std::string, UniformBlockHandle> m_uniformBlocks;
+
+		static std::vector<std::string> tokenize(std::string const& code);
+	};
+}
+
+#endif /* INCLUDE_DBGL_PLATFORM_SHADER_SHADERPROGRAMHEADLESS_H_ */
@@ -0,0 +1,104 @@
+//////////////////////////////////////////////////////////////////////
+/// Dragon Blaze Game Library
+///
+/// Copyright (c) 2015 by Jan Moeller
+///
+/// This software is provided "as-is" and does not claim to be
+/// complete or free of bugs in any way. It should work, but
+/// it might also begin to hurt your kittens.
+//////////////////////////////////////////////////////////////////////
+
+#ifndef INCLUDE_DBGL_PLATFORM_SHADER_UNIFORMBLOCK_H_
+#define INCLUDE_DBGL_PLATFORM_SHADER_UNIFORMBLOCK_H_
+
+#include <string>
+#include <type_traits>
+#include "DBGL/Platform/Platform.h"
+
+namespace dbgl
+{
+	/**
+	 * @brief Typed uniform block
+	 * @details Per-draw uniforms are staged in an instance of \p Layout and sent to the graphics API in a single
+	 *          upload, instead of one call per uniform.
+	 * @code
+	 * struct Transform
+	 * {
+	 * 	Mat4f m_mvp;
+	 * 	Mat4f m_model;
+	 * };
+	 * UniformBlock<Transform> block { 0 };
+	 * shader->use();
+	 * block.attach(shader, "Transform");
+	 * block.bind();
+	 * for (auto e : entities)
+	 * {
+	 * 	block.data().m_mvp = VP * e->getModelMatrix();
+	 * 	block.data().m_model = e->getModelMatrix();
+	 * 	block.upload();
+	 * 	rc->drawMesh(e->getMesh());
+	 * }
+	 * @endcode
+	 * @tparam Layout Standard layout type matching the std140 layout of the uniform block in the shader. Note that
+	 *                std140 aligns vec3 like vec4, and array elements to 16 bytes.
+	 */
+	template<class Layout> class UniformBlock
+	{
+		static_assert(std::is_standard_layout<Layout>::value, "Uniform block layouts need to have standard layout");
+	public:
+		/**
+		 * @brief Constructor
+		 * @param bindingPoint Binding point to use for this block
+		 */
+		explicit UniformBlock(unsigned int bindingPoint);
+		/**
+		 * @brief Destructor
+		 */
+		~UniformBlock();
+		UniformBlock(UniformBlock const& other) = delete;
+		UniformBlock& operator=(UniformBlock const& other) = delete;
+		/**
+		 * @brief Provides the staged values
+		 * @return Reference to the staged values
+		 */
+		Layout& data();
+		/**
+		 * @brief Provides the staged values
+		 * @return Reference to the staged values
+		 */
+		Layout const& data() const;
+		/**
+		 * @brief Sends all staged values to the graphics API at once
+		 */
+		void upload();
+		/**
+		 * @brief Binds the underlying buffer to the binding point of this block
+		 */
+		void bind();
+		/**
+		 * @brief Connects the uniform block called \p name of a program to the binding point of this block
+		 * @param program Program to connect, needs to be in use
+		 * @param name Name of the uniform block in \p program
+		 * @return True if \p program has a block called \p name, otherwise false
+		 */
+		bool attach(IShaderProgram const* program, std::string const& name);
+		/**
+		 * @brief Retrieves the binding point of this block
+		 * @return The binding point
+		 */
+		unsigned int getBindingPoint() const;
+		/**
+		 * @brief Provides the underlying buffer
+		 * @return Pointer to the underlying buffer
+		 */
+		IUniformBuffer* getBuffer() const;
+	private:
+		Layout m_data { };
+		IUniformBuffer* m_pBuffer;
+		unsigned int m_bindingPoint;
+	};
+}
+
+#include "UniformBlock.imp"
+
+#endif /* INCLUDE_DBGL_PLATFORM_SHADER_UNIFORMBLOCK_H_ */
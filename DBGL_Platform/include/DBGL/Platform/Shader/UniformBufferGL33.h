@@ -0,0 +1,50 @@
+//////////////////////////////////////////////////////////////////////
+/// Dragon Blaze Game Library
+///
+/// Copyright (c) 2015 by Jan Moeller
+///
+/// This software is provided "as-is" and does not claim to be
+/// complete or free of bugs in any way. It should work, but
+/// it might also begin to hurt your kittens.
+//////////////////////////////////////////////////////////////////////
+
+#ifndef INCLUDE_DBGL_PLATFORM_SHADER_UNIFORMBUFFERGL33_H_
+#define INCLUDE_DBGL_PLATFORM_SHADER_UNIFORMBUFFERGL33_H_
+
+#include <GL/glew.h>
+#include "IUniformBuffer.h"
+
+namespace dbgl
+{
+	/**
+	 * @brief OpenGL 3.3 implementation of uniform buffers
+	 * @details Rewriting the whole buffer orphans the old storage, so the upload doesn't need to wait for draws that
+	 *          still read the previous values.
+	 */
+	class UniformBufferGL33: public IUniformBuffer
+	{
+	public:
+		/**
+		 * @brief Constructor
+		 * @param size Buffer size in bytes
+		 */
+		UniformBufferGL33(std::size_t size);
+		UniformBufferGL33(UniformBufferGL33 const& other) = delete;
+		UniformBufferGL33& operator=(UniformBufferGL33 const& other) = delete;
+		virtual ~UniformBufferGL33();
+		virtual std::size_t getSize() const;
+		virtual void write(void const* data, std::size_t size, std::size_t offset = 0);
+		virtual void bind(unsigned int bindingPoint);
+
+		/**
+		 * @return Internal buffer handle
+		 */
+		GLuint getHandle() const;
+
+	private:
+		GLuint m_id = 0;
+		std::size_t m_size;
+	};
+}
+
+#endif /* INCLUDE_DBGL_PLATFORM_SHADER_UNIFORMBUFFERGL33_H_ */
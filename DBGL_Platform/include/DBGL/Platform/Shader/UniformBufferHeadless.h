@@ -0,0 +1,47 @@
+//////////////////////////////////////////////////////////////////////
+/// Dragon Blaze Game Library
+///
+/// Copyright (c) 2015 by Jan Moeller
+///
+/// This software is provided "as-is" and does not claim to be
+/// complete or free of bugs in any way. It should work, but
+/// it might also begin to hurt your kittens.
+//////////////////////////////////////////////////////////////////////
+
+#ifndef INCLUDE_DBGL_PLATFORM_SHADER_UNIFORMBUFFERHEADLESS_H_
+#define INCLUDE_DBGL_PLATFORM_SHADER_UNIFORMBUFFERHEADLESS_H_
+
+#include <vector>
+#include "IUniformBuffer.h"
+#include "DBGL/Platform/Implementation/CommandLog.h"
+
+namespace dbgl
+{
+	/**
+	 * @brief Headless implementation of uniform buffers, keeps its data in memory
+	 */
+	class UniformBufferHeadless: public IUniformBuffer
+	{
+	public:
+		/**
+		 * @brief Constructor
+		 * @param size Buffer size in bytes
+		 * @param log Log to record commands to
+		 */
+		UniformBufferHeadless(std::size_t size, CommandLog* log);
+		virtual std::size_t getSize() const;
+		virtual void write(void const* data, std::size_t size, std::size_t offset = 0);
+		virtual void bind(unsigned int bindingPoint);
+
+		/**
+		 * @return The buffer contents
+		 */
+		std::vector<char> const& getData() const;
+
+	private:
+		std::vector<char> m_data;
+		CommandLog* m_pLog;
+	};
+}
+
+#endif /* INCLUDE_DBGL_PLATFORM_SHADER_UNIFORMBUFFERHEADLESS_H_ */
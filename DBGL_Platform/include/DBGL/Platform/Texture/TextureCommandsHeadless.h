@@ -0,0 +1,81 @@
+//////////////////////////////////////////////////////////////////////
+/// Dragon Blaze Game Library
+///
+/// Copyright (c) 2015 by Jan Moeller
+///
+/// This software is provided "as-is" and does not claim to be
+/// complete or free of bugs in any way. It should work, but
+/// it might also begin to hurt your kittens.
+//////////////////////////////////////////////////////////////////////
+
+#ifndef INCLUDE_DBGL_PLATFORM_TEXTURE_TEXTURECOMMANDSHEADLESS_H_
+#define INCLUDE_DBGL_PLATFORM_TEXTURE_TEXTURECOMMANDSHEADLESS_H_
+
+#include "ITextureCommands.h"
+#include "TextureHeadless.h"
+#include "DBGL/Platform/Implementation/CommandLog.h"
+
+namespace dbgl
+{
+	/**
+	 * @brief Headless implementation of the texture commands, operating on the bound TextureHeadless
+	 * @details Pixel data can be read back in the format and type it has been written in. Uncompressed unsigned
+	 *          byte data can also be converted to any other unsigned byte format.
+	 */
+	class TextureCommandsHeadless: public ITextureCommands
+	{
+	public:
+		/**
+		 * @brief Constructor
+		 * @param log Log to record commands to
+		 */
+		TextureCommandsHeadless(CommandLog* log);
+		virtual ~TextureCommandsHeadless() = default;
+		virtual void activateUnit(unsigned int unit);
+		virtual void write(unsigned int level, unsigned int width, unsigned int height, PixelFormat format,
+				PixelType type, void const* data);
+		virtual void writeCompressed(unsigned int level, unsigned int width, unsigned int height,
+				PixelFormatCompressed format, unsigned int size, void const* data);
+		virtual void setRowAlignment(RowAlignment type, unsigned int align);
+		virtual void setMinFilter(MinFilter filter);
+		virtual void setMagFilter(MagFilter filter);
+		virtual void setWrapMode(WrapDirection dir, WrapMode mode);
+		virtual WrapMode getWrapMode(WrapDirection dir);
+		virtual void generateMipMaps();
+		virtual void getSize(unsigned int& width, unsigned int& height, unsigned int level = 0);
+		virtual unsigned int getWidth() const;
+		virtual unsigned int getHeight() const;
+		virtual void getPixelData(PixelFormat format, PixelType type, char* buffer, unsigned int level = 0) const;
+		/**
+		 * @brief Retrieves the bound texture
+		 * @return The bound texture or nullptr if there is none
+		 */
+		TextureHeadless* getCurrent() const;
+		/**
+		 * @brief Changes the bound texture
+		 * @param texture New bound texture
+		 */
+		void setCurrent(TextureHeadless* texture);
+		/**
+		 * @brief Retrieves the amount of channels of a pixel format
+		 * @param format Pixel format
+		 * @return Amount of channels
+		 */
+		static unsigned int pixelFormatSize(PixelFormat format);
+		/**
+		 * @brief Retrieves the size of a pixel type
+		 * @param type Pixel type
+		 * @return Size in bytes
+		 */
+		static unsigned int pixelTypeSize(PixelType type);
+	private:
+		CommandLog* m_pLog;
+		TextureHeadless* m_pCurrent = nullptr;
+
+		TextureHeadless& current() const;
+		TextureHeadless::Level& level(unsigned int level) const;
+		static void convertPixel(char const* src, PixelFormat srcFormat, char* dest, PixelFormat destFormat);
+	};
+}
+
+#endif /* INCLUDE_DBGL_PLATFORM_TEXTURE_TEXTURECOMMANDSHEADLESS_H_ */
@@ -0,0 +1,78 @@
+//////////////////////////////////////////////////////////////////////
+/// Dragon Blaze Game Library
+///
+/// Copyright (c) 2015 by Jan Moeller
+///
+/// This software is provided "as-is" and does not claim to be
+/// complete or free of bugs in any way. It should work, but
+/// it might also begin to hurt your kittens.
+//////////////////////////////////////////////////////////////////////
+
+#ifndef INCLUDE_DBGL_PLATFORM_TEXTURE_TEXTUREHEADLESS_H_
+#define INCLUDE_DBGL_PLATFORM_TEXTURE_TEXTUREHEADLESS_H_
+
+#include <vector>
+#include "ITexture.h"
+#include "ITextureCommands.h"
+#include "DBGL/Platform/Implementation/CommandLog.h"
+
+namespace dbgl
+{
+	class TextureCommandsHeadless;
+
+	/**
+	 * @brief Headless implementation of the texture class
+	 * @details All mip levels are kept in main memory exactly as they have been written.
+	 */
+	class TextureHeadless: public ITexture
+	{
+	public:
+		/**
+		 * @brief Constructor
+		 * @param type Texture type
+		 * @param log Log to record commands to
+		 * @param commands Commands object that keeps track of the bound texture
+		 */
+		TextureHeadless(Type type, CommandLog* log, TextureCommandsHeadless* commands);
+		/**
+		 * @brief Copy constructor
+		 * @param copy Texture to copy
+		 */
+		TextureHeadless(TextureHeadless const& copy) = default;
+		/**
+		 * @brief Copy-assignment operator
+		 * @param copy Texture to copy
+		 * @return This texture
+		 */
+		TextureHeadless& operator=(TextureHeadless const& copy) = default;
+		virtual ~TextureHeadless();
+		virtual void bind() const;
+		virtual Type getType() const;
+		virtual ITexture* clone() const;
+
+	private:
+		/**
+		 * @brief Single mip level
+		 */
+		struct Level
+		{
+			unsigned int m_width = 0;
+			unsigned int m_height = 0;
+			ITextureCommands::PixelFormat m_format = ITextureCommands::PixelFormat::RGBA;
+			ITextureCommands::PixelType m_type = ITextureCommands::PixelType::UBYTE;
+			bool m_compressed = false;
+			std::vector<char> m_data;
+		};
+
+		Type m_type;
+		CommandLog* m_pLog;
+		TextureCommandsHeadless* m_pCommands;
+		std::vector<Level> m_levels;
+		ITextureCommands::WrapMode m_wrapS = ITextureCommands::WrapMode::REPEAT;
+		ITextureCommands::WrapMode m_wrapT = ITextureCommands::WrapMode::REPEAT;
+
+		friend class TextureCommandsHeadless;
+	};
+}
+
+#endif /* INCLUDE_DBGL_PLATFORM_TEXTURE_TEXTUREHEADLESS_H_ */
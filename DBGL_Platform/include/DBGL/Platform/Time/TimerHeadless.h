@@ -0,0 +1,34 @@
+//////////////////////////////////////////////////////////////////////
+/// Dragon Blaze Game Library
+///
+/// Copyright (c) 2015 by Jan Moeller
+///
+/// This software is provided "as-is" and does not claim to be
+/// complete or free of bugs in any way. It should work, but
+/// it might also begin to hurt your kittens.
+//////////////////////////////////////////////////////////////////////
+
+#ifndef INCLUDE_DBGL_PLATFORM_TIME_TIMERHEADLESS_H_
+#define INCLUDE_DBGL_PLATFORM_TIME_TIMERHEADLESS_H_
+
+#include <chrono>
+#include "ITimer.h"
+
+namespace dbgl
+{
+	/**
+	 * @brief Headless implementation of the timer class, based on the steady clock of the standard library
+	 */
+	class TimerHeadless: public ITimer
+	{
+	public:
+		virtual ~TimerHeadless() = default;
+		virtual double getTime();
+		virtual double getDelta();
+	private:
+		std::chrono::steady_clock::time_point m_start = std::chrono::steady_clock::now();
+		double m_last = 0;
+	};
+}
+
+#endif /* INCLUDE_DBGL_PLATFORM_TIME_TIMERHEADLESS_H_ */
@@ -0,0 +1,126 @@
+//////////////////////////////////////////////////////////////////////
+/// Dragon Blaze Game Library
+///
+/// Copyright (c) 2015 by Jan Moeller
+///
+/// This software is provided "as-is" and does not claim to be
+/// complete or free of bugs in any way. It should work, but
+/// it might also begin to hurt your kittens.
+//////////////////////////////////////////////////////////////////////
+
+#include "DBGL/Platform/File/MappedFile.h"
+
+#ifdef __linux__
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#elif __WIN32
+	#undef _MSC_EXTENSIONS
+	#include <windows.h>
+#endif
+
+namespace dbgl
+{
+	MappedFile::MappedFile(Filename const& path)
+			: m_path { path }
+	{
+	}
+
+	MappedFile::~MappedFile()
+	{
+		close();
+	}
+
+	bool MappedFile::open()
+	{
+		close();
+#ifdef __linux__
+		int file = ::open(m_path.get().c_str(), O_RDONLY);
+		if (file < 0)
+			return false;
+		struct stat info { };
+		if (fstat(file, &info) != 0)
+		{
+			::close(file);
+			return false;
+		}
+		m_size = static_cast<std::size_t>(info.st_size);
+		if (m_size > 0)
+		{
+			void* data = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, file, 0);
+			if (data == MAP_FAILED)
+			{
+				::close(file);
+				m_size = 0;
+				return false;
+			}
+			// Contents are read front to back
+			madvise(data, m_size, MADV_SEQUENTIAL);
+			m_pData = static_cast<char const*>(data);
+		}
+		// The mapping keeps the file alive
+		::close(file);
+#elif __WIN32
+		HANDLE file = CreateFile(m_path.get().c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+				FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+		if (file == INVALID_HANDLE_VALUE)
+			return false;
+		LARGE_INTEGER size { };
+		if (!GetFileSizeEx(file, &size))
+		{
+			CloseHandle(file);
+			return false;
+		}
+		m_size = static_cast<std::size_t>(size.QuadPart);
+		if (m_size > 0)
+		{
+			HANDLE mapping = CreateFileMapping(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+			void* data = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+			// The view keeps the mapping and the file alive
+			if (mapping)
+				CloseHandle(mapping);
+			if (!data)
+			{
+				CloseHandle(file);
+				m_size = 0;
+				return false;
+			}
+			m_pData = static_cast<char const*>(data);
+		}
+		CloseHandle(file);
+#endif
+		m_open = true;
+		return true;
+	}
+
+	void MappedFile::close()
+	{
+		if (m_pData)
+		{
+#ifdef __linux__
+			munmap(const_cast<char*>(m_pData), m_size);
+#elif __WIN32
+			UnmapViewOfFile(m_pData);
+#endif
+		}
+		m_pData = nullptr;
+		m_size = 0;
+		m_open = false;
+	}
+
+	bool MappedFile::isOpen() const
+	{
+		return m_open;
+	}
+
+	char const* MappedFile::getData() const
+	{
+		return m_pData;
+	}
+
+	std::size_t MappedFile::getSize() const
+	{
+		return m_size;
+	}
+}
@@ -0,0 +1,87 @@
+//////////////////////////////////////////////////////////////////////
+/// Dragon Blaze Game Library
+///
+/// Copyright (c) 2015 by Jan Moeller
+///
+/// This software is provided "as-is" and does not claim to be
+/// complete or free of bugs in any way. It should work, but
+/// it might also begin to hurt your kittens.
+//////////////////////////////////////////////////////////////////////
+
+#include "DBGL/Platform/Implementation/CommandLog.h"
+
+namespace dbgl
+{
+	constexpr std::size_t CommandLog::s_typeCount;
+
+	void CommandLog::record(Type type, void const* object, unsigned int value)
+	{
+		m_counts[static_cast<std::size_t>(type)]++;
+		if (type == Type::DrawMesh)
+		{
+			m_drawnIndices += value;
+			m_drawnInstances++;
+		}
+		if (m_storeCommands)
+			m_commands.push_back( { object, value, type });
+	}
+
+	void CommandLog::recordInstanced(void const* mesh, unsigned int indices, unsigned int instances)
+	{
+		record(Type::DrawMeshInstanced, mesh, instances);
+		m_drawnIndices += static_cast<std::size_t>(indices) * instances;
+		m_drawnInstances += instances;
+	}
+
+	void CommandLog::clear()
+	{
+		m_commands.clear();
+		m_counts.fill(0);
+		m_drawnIndices = 0;
+		m_drawnInstances = 0;
+	}
+
+	void CommandLog::setStoreCommands(bool store)
+	{
+		m_storeCommands = store;
+	}
+
+	bool CommandLog::getStoreCommands() const
+	{
+		return m_storeCommands;
+	}
+
+	auto CommandLog::getCommands() const -> std::vector<Command> const&
+	{
+		return m_commands;
+	}
+
+	unsigned int CommandLog::getCount(Type type) const
+	{
+		return m_counts[static_cast<std::size_t>(type)];
+	}
+
+	unsigned int CommandLog::getStateChanges() const
+	{
+		unsigned int changes = 0;
+		for (std::size_t i = 0; i < s_typeCount; i++)
+			if (isStateChange(static_cast<Type>(i)))
+				changes += m_counts[i];
+		return changes;
+	}
+
+	std::size_t CommandLog::getDrawnIndices() const
+	{
+		return m_drawnIndices;
+	}
+
+	std::size_t CommandLog::getDrawnInstances() const
+	{
+		return m_drawnInstances;
+	}
+
+	bool CommandLog::isStateChange(Type type)
+	{
+		return type >= Type::DepthTest && type <= Type::ClearColor;
+	}
+}
@@ -0,0 +1,90 @@
+//////////////////////////////////////////////////////////////////////
+/// Dragon Blaze Game Library
+///
+/// Copyright (c) 2015 by Jan Moeller
+///
+/// This software is provided "as-is" and does not claim to be
+/// complete or free of bugs in any way. It should work, but
+/// it might also begin to hurt your kittens.
+//////////////////////////////////////////////////////////////////////
+
+#include <stdexcept>
+#include "DBGL/Platform/Implementation/Headless.h"
+#include "DBGL/Platform/Monitor/MonitorHeadless.h"
+#include "DBGL/Platform/Time/TimerHeadless.h"
+#include "DBGL/Platform/Shader/ShaderHeadless.h"
+#include "DBGL/Platform/Shader/ShaderProgramHeadless.h"
+#include "DBGL/Platform/Shader/UniformBufferHeadless.h"
+#include "DBGL/Platform/Texture/TextureHeadless.h"
+#include "DBGL/Platform/Mesh/MeshHeadless.h"
+#include "DBGL/Platform/Mesh/InstanceBufferHeadless.h"
+#include "DBGL/Platform/RenderContext/RenderContextHeadless.h"
+
+namespace dbgl
+{
+	IWindow* Headless::createWindow(std::string /* title */, int /* width */, int /* height */, bool /* fullscreen */,
+			unsigned int /* multisampling */)
+	{
+		throw std::runtime_error { "The headless platform can't create windows." };
+	}
+
+	IMonitor* Headless::createMonitor()
+	{
+		return new MonitorHeadless { };
+	}
+
+	ITimer* Headless::createTimer()
+	{
+		return new TimerHeadless { };
+	}
+
+	IShader* Headless::createShader(IShader::Type type, std::string code)
+	{
+		return new ShaderHeadless { type, code, &m_log };
+	}
+
+	IShaderProgram* Headless::createShaderProgram()
+	{
+		return new ShaderProgramHeadless { &m_log, &m_shaderProgramCommands };
+	}
+
+	IUniformBuffer* Headless::createUniformBuffer(std::size_t size)
+	{
+		return new UniformBufferHeadless { size, &m_log };
+	}
+
+	ITexture* Headless::createTexture(ITexture::Type type)
+	{
+		return new TextureHeadless { type, &m_log, &m_textureCommands };
+	}
+
+	IMesh* Headless::createMesh()
+	{
+		return new MeshHeadless { &m_log };
+	}
+
+	IInstanceBuffer* Headless::createInstanceBuffer(unsigned int capacity)
+	{
+		return new InstanceBufferHeadless { capacity, &m_log };
+	}
+
+	IRenderContext* Headless::createRenderContext(unsigned int width, unsigned int height, bool /* createDepthBuf */)
+	{
+		return new RenderContextHeadless { width, height, &m_log };
+	}
+
+	IShaderProgramCommands* Headless::curShaderProgram()
+	{
+		return &m_shaderProgramCommands;
+	}
+
+	ITextureCommands* Headless::curTexture()
+	{
+		return &m_textureCommands;
+	}
+
+	CommandLog& Headless::getLog()
+	{
+		return m_log;
+	}
+}
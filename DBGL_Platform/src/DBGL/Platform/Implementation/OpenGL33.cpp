@@ -14,7 +14,9 @@
 #include "DBGL/Platform/Time/TimerGL33.h"
 #include "DBGL/Platform/Shader/ShaderGL33.h"
 #include "DBGL/Platform/Shader/ShaderProgramGL33.h"
+#include "DBGL/Platform/Shader/UniformBufferGL33.h"
 #include "DBGL/Platform/Texture/TextureGL33.h"
+#include "DBGL/Platform/Mesh/InstanceBufferGL33.h"
 #include "DBGL/Platform/RenderContext/RenderContextGL33Texture.h"
 
 namespace dbgl
@@ -67,6 +69,11 @@ namespace dbgl
 		return new ShaderProgramGL33 { };
 	}
 
+	IUniformBuffer* OpenGL33::createUniformBuffer(std::size_t size)
+	{
+		return new UniformBufferGL33 { size };
+	}
+
 	ITexture* OpenGL33::createTexture(ITexture::Type type)
 	{
 		return new TextureGL33 { type };
@@ -77,6 +84,11 @@ namespace dbgl
 		return new MeshGL33 { };
 	}
 
+	IInstanceBuffer* OpenGL33::createInstanceBuffer(unsigned int capacity)
+	{
+		return new InstanceBufferGL33 { capacity };
+	}
+
 	IRenderContext* OpenGL33::createRenderContext(unsigned int width, unsigned int height, bool createDepthBuf)
 	{
 		return new RenderContextGL33Texture { width, height, createDepthBuf };
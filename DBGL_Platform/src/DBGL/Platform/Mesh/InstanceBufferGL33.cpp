@@ -0,0 +1,63 @@
+//////////////////////////////////////////////////////////////////////
+/// Dragon Blaze Game Library
+///
+/// Copyright (c) 2015 by Jan Moeller
+///
+/// This software is provided "as-is" and does not claim to be
+/// complete or free of bugs in any way. It should work, but
+/// it might also begin to hurt your kittens.
+//////////////////////////////////////////////////////////////////////
+
+#include <cstring>
+#include <stdexcept>
+#include "DBGL/Platform/Mesh/InstanceBufferGL33.h"
+
+namespace dbgl
+{
+	InstanceBufferGL33::InstanceBufferGL33(unsigned int capacity)
+			: m_capacity { capacity }
+	{
+		glGenBuffers(1, &m_id);
+		if (m_id == 0)
+			throw std::runtime_error("Couldn't create instance buffer");
+		glBindBuffer(GL_ARRAY_BUFFER, m_id);
+		glBufferData(GL_ARRAY_BUFFER, m_capacity * sizeof(Mat4f), nullptr, GL_STREAM_DRAW);
+	}
+
+	InstanceBufferGL33::~InstanceBufferGL33()
+	{
+		glDeleteBuffers(1, &m_id);
+	}
+
+	unsigned int InstanceBufferGL33::getCapacity() const
+	{
+		return m_capacity;
+	}
+
+	unsigned int InstanceBufferGL33::append(Mat4f const* matrices, unsigned int count)
+	{
+		if (count > m_capacity)
+			throw std::invalid_argument("Instance buffer too small.");
+		glBindBuffer(GL_ARRAY_BUFFER, m_id);
+		if (count > m_capacity - m_next)
+		{
+			// Orphan the old storage, draws still reading it keep it alive
+			glBufferData(GL_ARRAY_BUFFER, m_capacity * sizeof(Mat4f), nullptr, GL_STREAM_DRAW);
+			m_next = 0;
+		}
+		unsigned int first = m_next;
+		void* dest = glMapBufferRange(GL_ARRAY_BUFFER, first * sizeof(Mat4f), count * sizeof(Mat4f),
+				GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+		if (dest == nullptr)
+			throw std::runtime_error("Couldn't map instance buffer");
+		std::memcpy(dest, matrices, count * sizeof(Mat4f));
+		glUnmapBuffer(GL_ARRAY_BUFFER);
+		m_next += count;
+		return first;
+	}
+
+	GLuint InstanceBufferGL33::getHandle() const
+	{
+		return m_id;
+	}
+}
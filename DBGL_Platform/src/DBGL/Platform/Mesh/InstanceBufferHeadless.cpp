@@ -0,0 +1,52 @@
+//////////////////////////////////////////////////////////////////////
+/// Dragon Blaze Game Library
+///
+/// Copyright (c) 2015 by Jan Moeller
+///
+/// This software is provided "as-is" and does not claim to be
+/// complete or free of bugs in any way. It should work, but
+/// it might also begin to hurt your kittens.
+//////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <stdexcept>
+#include "DBGL/Platform/Mesh/InstanceBufferHeadless.h"
+
+namespace dbgl
+{
+	InstanceBufferHeadless::InstanceBufferHeadless(unsigned int capacity, CommandLog* log)
+			: m_data(capacity), m_pLog { log }
+	{
+	}
+
+	unsigned int InstanceBufferHeadless::getCapacity() const
+	{
+		return m_data.size();
+	}
+
+	unsigned int InstanceBufferHeadless::append(Mat4f const* matrices, unsigned int count)
+	{
+		if (count > m_data.size())
+			throw std::invalid_argument("Instance buffer too small.");
+		if (count > m_data.size() - m_next)
+		{
+			m_next = 0;
+			m_wraps++;
+		}
+		unsigned int first = m_next;
+		std::copy(matrices, matrices + count, m_data.begin() + first);
+		m_next += count;
+		m_pLog->record(CommandLog::Type::WriteInstanceBuffer, this, count);
+		return first;
+	}
+
+	std::vector<Mat4f> const& InstanceBufferHeadless::getData() const
+	{
+		return m_data;
+	}
+
+	unsigned int InstanceBufferHeadless::getWrapCount() const
+	{
+		return m_wraps;
+	}
+}
@@ -8,6 +8,9 @@
 /// it might also begin to hurt your kittens.
 //////////////////////////////////////////////////////////////////////
 
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
 #include "DBGL/Platform/Mesh/MeshGL33.h"
 
 namespace dbgl
@@ -20,56 +23,41 @@ namespace dbgl
 		m_uv = copy.m_uv;
 		m_tangents = copy.m_tangents;
 		m_bitangents = copy.m_bitangents;
+		m_layout = copy.m_layout;
 		m_usage = copy.m_usage;
-		updateBuffers();
+		if (m_vertices.empty() && copy.m_vertexCount > 0)
+			copyBuffers(copy);
+		else
+			updateBuffers();
 	}
 
 	MeshGL33& MeshGL33::operator=(MeshGL33 const& copy)
 	{
 		if(this != &copy)
 		{
-			this->~MeshGL33();
-			m_vertexBuffer = GL_INVALID_VALUE;
-			m_indexBuffer = GL_INVALID_VALUE;
-			m_normalBuffer = GL_INVALID_VALUE;
-			m_uvBuffer = GL_INVALID_VALUE;
-			m_tangentBuffer = GL_INVALID_VALUE;
-			m_bitangentBuffer = GL_INVALID_VALUE;
-			m_indexCount = 0;
-			m_vertexCount = 0;
-			m_normalsCount = 0;
-			m_uvCount = 0;
-			m_tangentCount = 0;
-			m_bitangentCount = 0;
+			deleteBuffers();
 			m_indices = copy.m_indices;
 			m_vertices = copy.m_vertices;
 			m_normals = copy.m_normals;
 			m_uv = copy.m_uv;
 			m_tangents = copy.m_tangents;
 			m_bitangents = copy.m_bitangents;
+			m_layout = copy.m_layout;
 			m_usage = copy.m_usage;
-			updateBuffers();
+			if (m_vertices.empty() && copy.m_vertexCount > 0)
+				copyBuffers(copy);
+			else
+				updateBuffers();
 		}
 		return *this;
 	}
 
 	MeshGL33::~MeshGL33()
 	{
-		if (m_indexBuffer != GL_INVALID_VALUE)
-			glDeleteBuffers(1, &m_indexBuffer);
-		if (m_vertexBuffer != GL_INVALID_VALUE)
-			glDeleteBuffers(1, &m_vertexBuffer);
-		if (m_normalBuffer != GL_INVALID_VALUE)
-			glDeleteBuffers(1, &m_normalBuffer);
-		if (m_uvBuffer != GL_INVALID_VALUE)
-			glDeleteBuffers(1, &m_uvBuffer);
-		if (m_tangentBuffer != GL_INVALID_VALUE)
-			glDeleteBuffers(1, &m_tangentBuffer);
-		if (m_bitangentBuffer != GL_INVALID_VALUE)
-			glDeleteBuffers(1, &m_bitangentBuffer);
+		deleteBuffers();
 	}
 
-	auto MeshGL33::indices() -> std::vector<unsigned short>&
+	auto MeshGL33::indices() -> std::vector<Index>&
 	{
 		return m_indices;
 	}
@@ -99,6 +87,16 @@ namespace dbgl
 		return m_bitangents;
 	}
 
+	void MeshGL33::setLayout(VertexLayout const& layout)
+	{
+		m_layout = layout;
+	}
+
+	VertexLayout const& MeshGL33::getLayout() const
+	{
+		return m_layout;
+	}
+
 	unsigned int MeshGL33::getIndexCount() const
 	{
 		return m_indexCount;
@@ -111,22 +109,22 @@ namespace dbgl
 
 	unsigned int MeshGL33::getUVCount() const
 	{
-		return m_uvCount;
+		return getAttributeCount(VertexLayout::Attribute::UV);
 	}
 
 	unsigned int MeshGL33::getNormalCount() const
 	{
-		return m_normalsCount;
+		return getAttributeCount(VertexLayout::Attribute::Normal);
 	}
 
 	unsigned int MeshGL33::getTangentCount() const
 	{
-		return m_tangentCount;
+		return getAttributeCount(VertexLayout::Attribute::Tangent);
 	}
 
 	unsigned int MeshGL33::getBitangentCount() const
 	{
-		return m_bitangentCount;
+		return getAttributeCount(VertexLayout::Attribute::Bitangent);
 	}
 
 	void MeshGL33::setUsage(Usage usage)
@@ -141,65 +139,84 @@ namespace dbgl
 
 	void MeshGL33::updateBuffers()
 	{
-		m_indexCount = m_indices.size();
+		m_bufferLayout = m_layout.select(*this);
 		m_vertexCount = m_vertices.size();
-		m_normalsCount = m_normals.size();
-		m_uvCount = m_uv.size();
-		m_tangentCount = m_tangents.size();
-		m_bitangentCount = m_bitangents.size();
+		m_indexCount = m_indices.size();
 		if (m_vertexCount > 0)
 		{
 			if (m_vertexBuffer == GL_INVALID_VALUE)
 				m_vertexBuffer = generateBuffer();
-			fillBuffer(m_vertexBuffer, GL_ARRAY_BUFFER, m_vertexCount * sizeof(Vec3f), &m_vertices[0],
-					convertUsage(m_usage));
+			std::vector<unsigned char> data(m_vertexCount * m_bufferLayout.getStride());
+			m_bufferLayout.pack(*this, 0, m_vertexCount, data.data());
+			fillBuffer(m_vertexBuffer, GL_ARRAY_BUFFER, data.size(), data.data(), convertUsage(m_usage));
 		}
 		else if (m_vertexBuffer != GL_INVALID_VALUE)
+		{
 			glDeleteBuffers(1, &m_vertexBuffer);
+			m_vertexBuffer = GL_INVALID_VALUE;
+		}
 		if (m_indexCount > 0)
 		{
 			if (m_indexBuffer == GL_INVALID_VALUE)
 				m_indexBuffer = generateBuffer();
-			fillBuffer(m_indexBuffer, GL_ELEMENT_ARRAY_BUFFER, m_indexCount * sizeof(unsigned short), &m_indices[0],
-					convertUsage(m_usage));
+			// Halve the index buffer if all indices fit into 16 bit
+			if (*std::max_element(m_indices.begin(), m_indices.end()) <= std::numeric_limits<GLushort>::max())
+			{
+				std::vector<GLushort> shortIndices(m_indices.begin(), m_indices.end());
+				m_indexType = GL_UNSIGNED_SHORT;
+				fillBuffer(m_indexBuffer, GL_ELEMENT_ARRAY_BUFFER, shortIndices.size() * sizeof(GLushort),
+						shortIndices.data(), convertUsage(m_usage));
+			}
+			else
+			{
+				m_indexType = GL_UNSIGNED_INT;
+				fillBuffer(m_indexBuffer, GL_ELEMENT_ARRAY_BUFFER, m_indexCount * sizeof(Index), m_indices.data(),
+						convertUsage(m_usage));
+			}
 		}
 		else if (m_indexBuffer != GL_INVALID_VALUE)
-			glDeleteBuffers(1, &m_indexBuffer);
-		if (m_normalsCount > 0)
-		{
-			if (m_normalBuffer == GL_INVALID_VALUE)
-				m_normalBuffer = generateBuffer();
-			fillBuffer(m_normalBuffer, GL_ARRAY_BUFFER, m_normalsCount * sizeof(Vec3f), &m_normals[0],
-					convertUsage(m_usage));
-		}
-		else if (m_normalBuffer != GL_INVALID_VALUE)
-			glDeleteBuffers(1, &m_normalBuffer);
-		if (m_uvCount > 0)
 		{
-			if (m_uvBuffer == GL_INVALID_VALUE)
-				m_uvBuffer = generateBuffer();
-			fillBuffer(m_uvBuffer, GL_ARRAY_BUFFER, m_uvCount * sizeof(Vec2f), &m_uv[0], GL_STATIC_DRAW);
-		}
-		else if (m_uvBuffer != GL_INVALID_VALUE)
-			glDeleteBuffers(1, &m_uvBuffer);
-		if (m_tangentCount > 0)
-		{
-			if (m_tangentBuffer == GL_INVALID_VALUE)
-				m_tangentBuffer = generateBuffer();
-			fillBuffer(m_tangentBuffer, GL_ARRAY_BUFFER, m_tangentCount * sizeof(Vec3f), &m_tangents[0],
-			GL_STATIC_DRAW);
+			glDeleteBuffers(1, &m_indexBuffer);
+			m_indexBuffer = GL_INVALID_VALUE;
 		}
-		else if (m_tangentBuffer != GL_INVALID_VALUE)
-			glDeleteBuffers(1, &m_tangentBuffer);
-		if (m_bitangentCount > 0)
+	}
+
+	void MeshGL33::updateBuffers(std::size_t first, std::size_t count)
+	{
+		if (first > m_vertices.size() || count > m_vertices.size() - first)
+			throw std::invalid_argument("Update range exceeds the vertices.");
+		if (m_vertexBuffer == GL_INVALID_VALUE || m_vertexCount != m_vertices.size()
+				|| m_layout.select(*this) != m_bufferLayout)
 		{
-			if (m_bitangentBuffer == GL_INVALID_VALUE)
-				m_bitangentBuffer = generateBuffer();
-			fillBuffer(m_bitangentBuffer, GL_ARRAY_BUFFER, m_bitangentCount * sizeof(Vec3f), &m_bitangents[0],
-					GL_STATIC_DRAW);
+			updateBuffers();
+			return;
 		}
-		else if (m_bitangentBuffer != GL_INVALID_VALUE)
-			glDeleteBuffers(1, &m_bitangentBuffer);
+		if (count == 0)
+			return;
+		unsigned int const stride = m_bufferLayout.getStride();
+		std::vector<unsigned char> data(count * stride);
+		m_bufferLayout.pack(*this, first, count, data.data());
+		glBindBuffer(GL_ARRAY_BUFFER, m_vertexBuffer);
+		glBufferSubData(GL_ARRAY_BUFFER, first * stride, data.size(), data.data());
+	}
+
+	void MeshGL33::uploadBuffers(VertexLayout const& layout, void const* vertexData, std::size_t vertexCount,
+			void const* indexData, std::size_t indexCount, unsigned int indexSize)
+	{
+		if (indexSize != sizeof(GLushort) && indexSize != sizeof(GLuint))
+			throw std::invalid_argument("Indices need to be 16 or 32 bit.");
+		m_layout = layout;
+		m_bufferLayout = layout;
+		m_vertexCount = vertexCount;
+		m_indexCount = indexCount;
+		m_indexType = indexSize == sizeof(GLushort) ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+		if (m_vertexBuffer == GL_INVALID_VALUE)
+			m_vertexBuffer = generateBuffer();
+		fillBuffer(m_vertexBuffer, GL_ARRAY_BUFFER, vertexCount * layout.getStride(), vertexData,
+				convertUsage(m_usage));
+		if (m_indexBuffer == GL_INVALID_VALUE)
+			m_indexBuffer = generateBuffer();
+		fillBuffer(m_indexBuffer, GL_ELEMENT_ARRAY_BUFFER, indexCount * indexSize, indexData, convertUsage(m_usage));
 	}
 
 	IMesh* MeshGL33::clone() const
@@ -218,24 +235,69 @@ namespace dbgl
 		return m_vertexBuffer;
 	}
 
-	GLuint MeshGL33::getNormalHandle() const
+	VertexLayout const& MeshGL33::getBufferLayout() const
+	{
+		return m_bufferLayout;
+	}
+
+	GLenum MeshGL33::getIndexType() const
+	{
+		return m_indexType;
+	}
+
+	GLenum MeshGL33::format2GL(VertexLayout::Format format)
 	{
-		return m_normalBuffer;
+		switch (format)
+		{
+		case VertexLayout::Format::Float:
+			return GL_FLOAT;
+		case VertexLayout::Format::Half:
+			return GL_HALF_FLOAT;
+		case VertexLayout::Format::Snorm1010102:
+			return GL_INT_2_10_10_10_REV;
+		case VertexLayout::Format::Octahedral:
+			return GL_SHORT;
+		}
+		return GL_INVALID_ENUM;
 	}
 
-	GLuint MeshGL33::getUVHandle() const
+	void MeshGL33::deleteBuffers()
 	{
-		return m_uvBuffer;
+		if (m_indexBuffer != GL_INVALID_VALUE)
+			glDeleteBuffers(1, &m_indexBuffer);
+		if (m_vertexBuffer != GL_INVALID_VALUE)
+			glDeleteBuffers(1, &m_vertexBuffer);
+		m_indexBuffer = GL_INVALID_VALUE;
+		m_vertexBuffer = GL_INVALID_VALUE;
+		m_indexCount = 0;
+		m_vertexCount = 0;
 	}
 
-	GLuint MeshGL33::getTangentHandle() const
+	void MeshGL33::copyBuffers(MeshGL33 const& other)
 	{
-		return m_tangentBuffer;
+		m_bufferLayout = other.m_bufferLayout;
+		m_vertexCount = other.m_vertexCount;
+		m_indexCount = other.m_indexCount;
+		m_indexType = other.m_indexType;
+		GLsizeiptr const vertexSize = m_vertexCount * m_bufferLayout.getStride();
+		GLsizeiptr const indexSize = m_indexCount
+				* (m_indexType == GL_UNSIGNED_SHORT ? sizeof(GLushort) : sizeof(GLuint));
+		m_vertexBuffer = generateBuffer();
+		fillBuffer(m_vertexBuffer, GL_COPY_WRITE_BUFFER, vertexSize, nullptr, convertUsage(m_usage));
+		glBindBuffer(GL_COPY_READ_BUFFER, other.m_vertexBuffer);
+		glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, vertexSize);
+		if (m_indexCount > 0)
+		{
+			m_indexBuffer = generateBuffer();
+			fillBuffer(m_indexBuffer, GL_COPY_WRITE_BUFFER, indexSize, nullptr, convertUsage(m_usage));
+			glBindBuffer(GL_COPY_READ_BUFFER, other.m_indexBuffer);
+			glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, indexSize);
+		}
 	}
 
-	GLuint MeshGL33::getBitangentHandle() const
+	unsigned int MeshGL33::getAttributeCount(VertexLayout::Attribute attribute) const
 	{
-		return m_bitangentBuffer;
+		return m_bufferLayout.find(attribute) != nullptr ? m_vertexCount : 0;
 	}
 
 	GLenum MeshGL33::convertUsage(Usage usage)
@@ -0,0 +1,187 @@
+//////////////////////////////////////////////////////////////////////
+/// Dragon Blaze Game Library
+///
+/// Copyright (c) 2015 by Jan Moeller
+///
+/// This software is provided "as-is" and does not claim to be
+/// complete or free of bugs in any way. It should work, but
+/// it might also begin to hurt your kittens.
+//////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include "DBGL/Platform/Mesh/MeshHeadless.h"
+
+namespace dbgl
+{
+	MeshHeadless::MeshHeadless(CommandLog* log)
+			: m_pLog { log }
+	{
+	}
+
+	auto MeshHeadless::indices() -> std::vector<Index>&
+	{
+		return m_indices;
+	}
+
+	auto MeshHeadless::vertices() -> std::vector<Vec3f>&
+	{
+		return m_vertices;
+	}
+
+	auto MeshHeadless::normals() -> std::vector<Vec3f>&
+	{
+		return m_normals;
+	}
+
+	auto MeshHeadless::uvs() -> std::vector<Vec2f>&
+	{
+		return m_uv;
+	}
+
+	auto MeshHeadless::tangents() -> std::vector<Vec3f>&
+	{
+		return m_tangents;
+	}
+
+	auto MeshHeadless::bitangents() -> std::vector<Vec3f>&
+	{
+		return m_bitangents;
+	}
+
+	void MeshHeadless::setLayout(VertexLayout const& layout)
+	{
+		m_layout = layout;
+	}
+
+	VertexLayout const& MeshHeadless::getLayout() const
+	{
+		return m_layout;
+	}
+
+	unsigned int MeshHeadless::getIndexCount() const
+	{
+		return m_indexCount;
+	}
+
+	unsigned int MeshHeadless::getVertexCount() const
+	{
+		return m_vertexCount;
+	}
+
+	unsigned int MeshHeadless::getUVCount() const
+	{
+		return getAttributeCount(VertexLayout::Attribute::UV);
+	}
+
+	unsigned int MeshHeadless::getNormalCount() const
+	{
+		return getAttributeCount(VertexLayout::Attribute::Normal);
+	}
+
+	unsigned int MeshHeadless::getTangentCount() const
+	{
+		return getAttributeCount(VertexLayout::Attribute::Tangent);
+	}
+
+	unsigned int MeshHeadless::getBitangentCount() const
+	{
+		return getAttributeCount(VertexLayout::Attribute::Bitangent);
+	}
+
+	void MeshHeadless::setUsage(Usage usage)
+	{
+		m_usage = usage;
+	}
+
+	auto MeshHeadless::getUsage() const -> Usage
+	{
+		return m_usage;
+	}
+
+	void MeshHeadless::updateBuffers()
+	{
+		m_bufferLayout = m_layout.select(*this);
+		m_vertexCount = m_vertices.size();
+		m_indexCount = m_indices.size();
+		m_vertexData.resize(m_vertexCount * m_bufferLayout.getStride());
+		m_bufferLayout.pack(*this, 0, m_vertexCount, m_vertexData.data());
+		if (m_indexCount > 0
+				&& *std::max_element(m_indices.begin(), m_indices.end()) > std::numeric_limits<unsigned short>::max())
+		{
+			m_indexSize = sizeof(Index);
+			m_indexData.resize(m_indexCount * sizeof(Index));
+			std::memcpy(m_indexData.data(), m_indices.data(), m_indexData.size());
+		}
+		else
+		{
+			m_indexSize = sizeof(unsigned short);
+			std::vector<unsigned short> shortIndices(m_indices.begin(), m_indices.end());
+			m_indexData.resize(m_indexCount * sizeof(unsigned short));
+			std::memcpy(m_indexData.data(), shortIndices.data(), m_indexData.size());
+		}
+		m_pLog->record(CommandLog::Type::UpdateMesh, this, m_vertexCount);
+	}
+
+	void MeshHeadless::updateBuffers(std::size_t first, std::size_t count)
+	{
+		if (first > m_vertices.size() || count > m_vertices.size() - first)
+			throw std::invalid_argument("Update range exceeds the vertices.");
+		if (m_vertexCount != m_vertices.size() || m_layout.select(*this) != m_bufferLayout)
+		{
+			updateBuffers();
+			return;
+		}
+		m_bufferLayout.pack(*this, first, count, m_vertexData.data() + first * m_bufferLayout.getStride());
+		m_pLog->record(CommandLog::Type::UpdateMesh, this, count);
+	}
+
+	void MeshHeadless::uploadBuffers(VertexLayout const& layout, void const* vertexData, std::size_t vertexCount,
+			void const* indexData, std::size_t indexCount, unsigned int indexSize)
+	{
+		if (indexSize != sizeof(unsigned short) && indexSize != sizeof(Index))
+			throw std::invalid_argument("Indices need to be 16 or 32 bit.");
+		m_layout = layout;
+		m_bufferLayout = layout;
+		m_vertexCount = vertexCount;
+		m_indexCount = indexCount;
+		m_indexSize = indexSize;
+		auto vertexBytes = static_cast<unsigned char const*>(vertexData);
+		m_vertexData.assign(vertexBytes, vertexBytes + vertexCount * layout.getStride());
+		auto indexBytes = static_cast<unsigned char const*>(indexData);
+		m_indexData.assign(indexBytes, indexBytes + indexCount * indexSize);
+		m_pLog->record(CommandLog::Type::UpdateMesh, this, m_vertexCount);
+	}
+
+	IMesh* MeshHeadless::clone() const
+	{
+		return new MeshHeadless { *this };
+	}
+
+	VertexLayout const& MeshHeadless::getBufferLayout() const
+	{
+		return m_bufferLayout;
+	}
+
+	std::vector<unsigned char> const& MeshHeadless::getVertexData() const
+	{
+		return m_vertexData;
+	}
+
+	unsigned int MeshHeadless::getIndexSize() const
+	{
+		return m_indexSize;
+	}
+
+	std::vector<unsigned char> const& MeshHeadless::getIndexData() const
+	{
+		return m_indexData;
+	}
+
+	unsigned int MeshHeadless::getAttributeCount(VertexLayout::Attribute attribute) const
+	{
+		return m_bufferLayout.find(attribute) != nullptr ? m_vertexCount : 0;
+	}
+}
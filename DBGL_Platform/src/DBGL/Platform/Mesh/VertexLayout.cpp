@@ -0,0 +1,348 @@
+//////////////////////////////////////////////////////////////////////
+/// Dragon Blaze Game Library
+///
+/// Copyright (c) 2015 by Jan Moeller
+///
+/// This software is provided "as-is" and does not claim to be
+/// complete or free of bugs in any way. It should work, but
+/// it might also begin to hurt your kittens.
+//////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+#include "DBGL/Platform/Mesh/VertexLayout.h"
+#include "DBGL/Platform/Mesh/IMesh.h"
+
+namespace dbgl
+{
+	namespace
+	{
+		/**
+		 * @brief Converts a value in [-1, 1] to a signed normalized integer of a given bit width
+		 */
+		std::uint32_t toSnorm(float value, unsigned int bits)
+		{
+			float const max = static_cast<float>((1u << (bits - 1)) - 1);
+			float clamped = std::min(std::max(value, -1.0f), 1.0f);
+			auto snorm = static_cast<std::int32_t>(std::lround(clamped * max));
+			return static_cast<std::uint32_t>(snorm) & ((1u << bits) - 1);
+		}
+
+		std::uint32_t pack1010102(Vec3f const& v, float w)
+		{
+			return toSnorm(v[0], 10) | (toSnorm(v[1], 10) << 10) | (toSnorm(v[2], 10) << 20) | (toSnorm(w, 2) << 30);
+		}
+
+		/**
+		 * @brief Computes the handedness of a tangent frame
+		 */
+		float handedness(IMesh& mesh, std::size_t i)
+		{
+			if (mesh.normals().empty() || mesh.bitangents().empty())
+				return 1;
+			return mesh.normals()[i].cross(mesh.tangents()[i]) * mesh.bitangents()[i] < 0 ? -1 : 1;
+		}
+
+		template<typename T> void write(unsigned char*& out, T const& value)
+		{
+			std::memcpy(out, &value, sizeof(T));
+			out += sizeof(T);
+		}
+
+		void writeFloats(unsigned char*& out, float const* values, unsigned int count)
+		{
+			std::memcpy(out, values, count * sizeof(float));
+			out += count * sizeof(float);
+		}
+
+		void writeHalfs(unsigned char*& out, float const* values, unsigned int count)
+		{
+			for (unsigned int i = 0; i < count; i++)
+				write(out, VertexLayout::toHalf(values[i]));
+		}
+	}
+
+	constexpr std::size_t VertexLayout::s_attributeCount;
+
+	VertexLayout VertexLayout::makeFloat()
+	{
+		VertexLayout layout { };
+		layout.add(Attribute::Position, Format::Float).add(Attribute::UV, Format::Float).add(Attribute::Normal,
+				Format::Float).add(Attribute::Tangent, Format::Float).add(Attribute::Bitangent, Format::Float);
+		return layout;
+	}
+
+	VertexLayout VertexLayout::makePacked()
+	{
+		VertexLayout layout { };
+		layout.add(Attribute::Position, Format::Float).add(Attribute::UV, Format::Half).add(Attribute::Normal,
+				Format::Snorm1010102).add(Attribute::Tangent, Format::Snorm1010102);
+		return layout;
+	}
+
+	VertexLayout& VertexLayout::add(Attribute attribute, Format format)
+	{
+		if (find(attribute) != nullptr)
+			throw std::invalid_argument("Attribute is already part of the vertex layout.");
+		unsigned int size = getSize(attribute, format);
+		if (size == 0)
+			throw std::invalid_argument("Format not supported for this attribute.");
+		m_elements.push_back( { attribute, format, m_stride });
+		m_stride += size;
+		return *this;
+	}
+
+	VertexLayout VertexLayout::select(IMesh& mesh) const
+	{
+		VertexLayout layout { };
+		std::size_t const vertices = mesh.vertices().size();
+		for (auto const& element : m_elements)
+		{
+			std::size_t amount = 0;
+			switch (element.m_attribute)
+			{
+			case Attribute::Position:
+				amount = vertices;
+				break;
+			case Attribute::UV:
+				amount = mesh.uvs().size();
+				break;
+			case Attribute::Normal:
+				amount = mesh.normals().size();
+				break;
+			case Attribute::Tangent:
+				amount = mesh.tangents().size();
+				break;
+			case Attribute::Bitangent:
+				amount = mesh.bitangents().size();
+				break;
+			}
+			if (amount == 0)
+				continue;
+			if (amount != vertices)
+				throw std::invalid_argument("Vertex attributes need one element per vertex.");
+			layout.add(element.m_attribute, element.m_format);
+		}
+		return layout;
+	}
+
+	auto VertexLayout::find(Attribute attribute) const -> Element const*
+	{
+		for (auto const& element : m_elements)
+			if (element.m_attribute == attribute)
+				return &element;
+		return nullptr;
+	}
+
+	auto VertexLayout::getElements() const -> std::vector<Element> const&
+	{
+		return m_elements;
+	}
+
+	unsigned int VertexLayout::getStride() const
+	{
+		return m_stride;
+	}
+
+	void VertexLayout::pack(IMesh& mesh, std::size_t first, std::size_t count, void* out) const
+	{
+		auto bytes = static_cast<unsigned char*>(out);
+		for (std::size_t i = first; i < first + count; i++)
+		{
+			for (auto const& element : m_elements)
+			{
+				switch (element.m_attribute)
+				{
+				case Attribute::Position:
+				{
+					Vec3f const& v = mesh.vertices()[i];
+					if (element.m_format == Format::Float)
+						writeFloats(bytes, v.getDataPointer(), 3);
+					else
+					{
+						float const position[] = { v[0], v[1], v[2], 1 };
+						writeHalfs(bytes, position, 4);
+					}
+					break;
+				}
+				case Attribute::UV:
+					if (element.m_format == Format::Float)
+						writeFloats(bytes, mesh.uvs()[i].getDataPointer(), 2);
+					else
+						writeHalfs(bytes, mesh.uvs()[i].getDataPointer(), 2);
+					break;
+				case Attribute::Normal:
+				{
+					Vec3f const& n = mesh.normals()[i];
+					if (element.m_format == Format::Float)
+						writeFloats(bytes, n.getDataPointer(), 3);
+					else if (element.m_format == Format::Snorm1010102)
+						write(bytes, pack1010102(n, 0));
+					else
+					{
+						// Project onto the octahedron, then fold the lower half over the upper one
+						float l1 = std::abs(n[0]) + std::abs(n[1]) + std::abs(n[2]);
+						float x = l1 > 0 ? n[0] / l1 : 0;
+						float y = l1 > 0 ? n[1] / l1 : 0;
+						if (n[2] < 0)
+						{
+							float foldedX = (1 - std::abs(y)) * (x < 0 ? -1 : 1);
+							float foldedY = (1 - std::abs(x)) * (y < 0 ? -1 : 1);
+							x = foldedX;
+							y = foldedY;
+						}
+						write(bytes, static_cast<std::uint16_t>(toSnorm(x, 16)));
+						write(bytes, static_cast<std::uint16_t>(toSnorm(y, 16)));
+					}
+					break;
+				}
+				case Attribute::Tangent:
+				{
+					Vec3f const& t = mesh.tangents()[i];
+					float const tangent[] = { t[0], t[1], t[2], handedness(mesh, i) };
+					if (element.m_format == Format::Float)
+						writeFloats(bytes, tangent, 4);
+					else if (element.m_format == Format::Half)
+						writeHalfs(bytes, tangent, 4);
+					else
+						write(bytes, pack1010102(t, tangent[3]));
+					break;
+				}
+				case Attribute::Bitangent:
+				{
+					Vec3f const& b = mesh.bitangents()[i];
+					if (element.m_format == Format::Float)
+						writeFloats(bytes, b.getDataPointer(), 3);
+					else
+						write(bytes, pack1010102(b, 0));
+					break;
+				}
+				}
+			}
+		}
+	}
+
+	bool VertexLayout::operator==(VertexLayout const& other) const
+	{
+		if (m_elements.size() != other.m_elements.size())
+			return false;
+		for (std::size_t i = 0; i < m_elements.size(); i++)
+			if (m_elements[i].m_attribute != other.m_elements[i].m_attribute
+					|| m_elements[i].m_format != other.m_elements[i].m_format)
+				return false;
+		return true;
+	}
+
+	bool VertexLayout::operator!=(VertexLayout const& other) const
+	{
+		return !(*this == other);
+	}
+
+	unsigned int VertexLayout::getComponents(Attribute attribute, Format format)
+	{
+		switch (format)
+		{
+		case Format::Float:
+			switch (attribute)
+			{
+			case Attribute::UV:
+				return 2;
+			case Attribute::Tangent:
+				return 4;
+			default:
+				return 3;
+			}
+		case Format::Half:
+			switch (attribute)
+			{
+			case Attribute::Position:
+			case Attribute::Tangent:
+				return 4;
+			case Attribute::UV:
+				return 2;
+			default:
+				return 0;
+			}
+		case Format::Snorm1010102:
+			return attribute == Attribute::Normal || attribute == Attribute::Tangent
+					|| attribute == Attribute::Bitangent ? 4 : 0;
+		case Format::Octahedral:
+			return attribute == Attribute::Normal ? 2 : 0;
+		}
+		return 0;
+	}
+
+	unsigned int VertexLayout::getSize(Attribute attribute, Format format)
+	{
+		unsigned int components = getComponents(attribute, format);
+		switch (format)
+		{
+		case Format::Float:
+			return components * sizeof(float);
+		case Format::Half:
+		case Format::Octahedral:
+			return components * sizeof(std::uint16_t);
+		case Format::Snorm1010102:
+			return components > 0 ? sizeof(std::uint32_t) : 0;
+		}
+		return 0;
+	}
+
+	std::uint16_t VertexLayout::toHalf(float value)
+	{
+		std::uint32_t bits;
+		std::memcpy(&bits, &value, sizeof(bits));
+		auto sign = static_cast<std::uint16_t>((bits >> 16) & 0x8000);
+		std::uint32_t abs = bits & 0x7FFFFFFF;
+		// Infinity and NaN
+		if (abs >= 0x7F800000)
+			return sign | 0x7C00 | (abs > 0x7F800000 ? 0x200 : 0);
+		// Too large, even before rounding
+		if (abs >= 0x47800000)
+			return sign | 0x7C00;
+		std::uint32_t half, remainder, halfway;
+		if (abs < 0x38800000)
+		{
+			// Subnormal half, the implicit leading bit becomes explicit
+			if (abs < 0x33000000)
+				return sign;
+			unsigned int shift = 126 - (abs >> 23);
+			std::uint32_t mantissa = (abs & 0x7FFFFF) | 0x800000;
+			half = mantissa >> shift;
+			remainder = mantissa & ((1u << shift) - 1);
+			halfway = 1u << (shift - 1);
+		}
+		else
+		{
+			// Rebias the exponent from 127 to 15, a carry while rounding correctly moves on to the exponent
+			half = (abs - 0x38000000) >> 13;
+			remainder = abs & 0x1FFF;
+			halfway = 0x1000;
+		}
+		if (remainder > halfway || (remainder == halfway && (half & 1)))
+			half++;
+		return sign | static_cast<std::uint16_t>(half);
+	}
+
+	float VertexLayout::fromHalf(std::uint16_t half)
+	{
+		std::uint32_t sign = static_cast<std::uint32_t>(half & 0x8000) << 16;
+		std::uint32_t exponent = (half >> 10) & 0x1F;
+		std::uint32_t mantissa = half & 0x3FF;
+		std::uint32_t bits;
+		if (exponent == 0x1F)
+			bits = sign | 0x7F800000 | (mantissa << 13);
+		else if (exponent != 0)
+			bits = sign | ((exponent + 112) << 23) | (mantissa << 13);
+		else
+		{
+			float value = std::ldexp(static_cast<float>(mantissa), -24);
+			return sign ? -value : value;
+		}
+		float value;
+		std::memcpy(&value, &bits, sizeof(value));
+		return value;
+	}
+}
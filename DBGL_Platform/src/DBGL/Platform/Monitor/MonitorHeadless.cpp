@@ -0,0 +1,20 @@
+//////////////////////////////////////////////////////////////////////
+/// Dragon Blaze Game Library
+///
+/// Copyright (c) 2015 by Jan Moeller
+///
+/// This software is provided "as-is" and does not claim to be
+/// complete or free of bugs in any way. It should work, but
+/// it might also begin to hurt your kittens.
+//////////////////////////////////////////////////////////////////////
+
+#include "DBGL/Platform/Monitor/MonitorHeadless.h"
+
+namespace dbgl
+{
+	void MonitorHeadless::getResolution(int& width, int& height)
+	{
+		width = 1920;
+		height = 1080;
+	}
+}
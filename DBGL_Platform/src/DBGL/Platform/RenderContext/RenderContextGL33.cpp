@@ -10,10 +10,13 @@
 
 #include "DBGL/Platform/RenderContext/RenderContextGL33.h"
 #include "DBGL/Platform/Texture/TextureCommandsGL33.h"
+#include "DBGL/Platform/Mesh/InstanceBufferGL33.h"
 
 namespace dbgl
 {
 	GLuint RenderContextGL33::s_curFrameBufferId = 0;
+	RenderStateBlock RenderContextGL33::s_state { };
+	unsigned int RenderContextGL33::s_invalidStates = 0;
 
 	RenderContextGL33::~RenderContextGL33()
 	{
@@ -42,155 +45,56 @@ namespace dbgl
 	{
 		if (!isBound())
 			bind();
-		switch (val)
-		{
-		case DepthTestValue::Always:
-			glDisable(GL_DEPTH_TEST);
-			break;
-		case DepthTestValue::Never:
-			glEnable(GL_DEPTH_TEST);
-			glDepthFunc(GL_NEVER);
-			break;
-		case DepthTestValue::Less:
-			glEnable(GL_DEPTH_TEST);
-			glDepthFunc(GL_LESS);
-			break;
-		case DepthTestValue::LessEqual:
-			glEnable(GL_DEPTH_TEST);
-			glDepthFunc(GL_LEQUAL);
-			break;
-		case DepthTestValue::Greater:
-			glEnable(GL_DEPTH_TEST);
-			glDepthFunc(GL_GREATER);
-			break;
-		case DepthTestValue::GreaterEqual:
-			glEnable(GL_DEPTH_TEST);
-			glDepthFunc(GL_GEQUAL);
-			break;
-		case DepthTestValue::Equal:
-			glEnable(GL_DEPTH_TEST);
-			glDepthFunc(GL_EQUAL);
-			break;
-		case DepthTestValue::NotEqual:
-			glEnable(GL_DEPTH_TEST);
-			glDepthFunc(GL_NOTEQUAL);
-			break;
-		default:
-			throw std::invalid_argument("Invalid value for depth testing.");
-			return;
-		}
-		m_curDepthTestVal = val;
+		if (request(RenderStateBlock::State::DepthTest, val != s_state.getDepthTest()))
+			changeDepthTest(val);
 	}
 
 	auto RenderContextGL33::getDepthTest() const -> DepthTestValue
 	{
-		return m_curDepthTestVal;
+		return s_state.getDepthTest();
 	}
 
 	void RenderContextGL33::setAlphaBlend(AlphaBlendValue src, AlphaBlendValue dest)
 	{
 		if (!isBound())
 			bind();
-		if (src == AlphaBlendValue::Zero && dest == AlphaBlendValue::Zero)
-		{
-			glDisable(GL_BLEND);
-			m_curSrcAlphaBlendVal = src;
-			m_curDestAlphaBlendVal = dest;
-			return;
-		}
-		GLenum sfactor = alphaBlendValue2GL(src), dfactor = alphaBlendValue2GL(dest);
-		glGetError(); // Clear last error
-		glEnable(GL_BLEND);
-		glBlendFunc(sfactor, dfactor);
-		if (glGetError() != GL_NO_ERROR)
-		{
-			glDisable(GL_BLEND);
-			m_curSrcAlphaBlendVal = m_curDestAlphaBlendVal = AlphaBlendValue::Zero;
-			throw std::invalid_argument("Invalid value for alpha blending.");
-		}
-		m_curSrcAlphaBlendVal = src;
-		m_curDestAlphaBlendVal = dest;
+		if (request(RenderStateBlock::State::AlphaBlend,
+				src != s_state.getSrcAlphaBlend() || dest != s_state.getDestAlphaBlend()))
+			changeAlphaBlend(src, dest);
 	}
 
 	auto RenderContextGL33::getSrcAlphaBlend() const -> AlphaBlendValue
 	{
-		return m_curSrcAlphaBlendVal;
+		return s_state.getSrcAlphaBlend();
 	}
 
 	auto RenderContextGL33::getDestAlphaBlend() const -> AlphaBlendValue
 	{
-		return m_curDestAlphaBlendVal;
+		return s_state.getDestAlphaBlend();
 	}
 
 	void RenderContextGL33::setFaceCulling(FaceCullingValue val)
 	{
 		if (!isBound())
 			bind();
-		switch (val)
-		{
-		case FaceCullingValue::Off:
-			glDisable(GL_CULL_FACE);
-			break;
-		case FaceCullingValue::Front:
-			glEnable(GL_CULL_FACE);
-			glCullFace(GL_FRONT);
-			break;
-		case FaceCullingValue::Back:
-			glEnable(GL_CULL_FACE);
-			glCullFace(GL_BACK);
-			break;
-		case FaceCullingValue::FrontBack:
-			glEnable(GL_CULL_FACE);
-			glCullFace(GL_FRONT_AND_BACK);
-			break;
-		default:
-			throw std::invalid_argument("Unknown value for face culling.");
-			return;
-		}
-		m_curFaceCullingVal = val;
+		if (request(RenderStateBlock::State::FaceCulling, val != s_state.getFaceCulling()))
+			changeFaceCulling(val);
 	}
 
 	auto RenderContextGL33::getFaceCulling() const -> FaceCullingValue
 	{
-		return m_curFaceCullingVal;
+		return s_state.getFaceCulling();
 	}
 
 	void RenderContextGL33::setDrawMode(DrawMode mode)
 	{
-		GLenum glMode = GL_FILL;
-		switch(mode)
-		{
-		case DrawMode::Fill:
-			glMode = GL_FILL;
-			break;
-		case DrawMode::Line:
-			glMode = GL_LINE;
-			break;
-		case DrawMode::Point:
-			glMode = GL_POINT;
-			break;
-		default:
-			throw std::invalid_argument("Unknown value for draw mode.");
-			return;
-		}
-		glPolygonMode(GL_FRONT_AND_BACK, glMode);
+		if (request(RenderStateBlock::State::DrawMode, mode != s_state.getDrawMode()))
+			changeDrawMode(mode);
 	}
 
 	auto RenderContextGL33::getDrawMode() const -> DrawMode
 	{
-		GLint current[2];
-		glGetIntegerv(GL_POLYGON_MODE, current);
-		switch(current[0])
-		{
-		case GL_FILL:
-			return DrawMode::Fill;
-		case GL_LINE:
-			return DrawMode::Line;
-		case GL_POINT:
-			return DrawMode::Point;
-		default:
-			throw std::invalid_argument("Unknown value for draw mode.");
-		}
+		return s_state.getDrawMode();
 	}
 
 	void RenderContextGL33::setLineWidth(float width)
@@ -232,26 +136,25 @@ namespace dbgl
 
 	void RenderContextGL33::enableDepthBuffer(bool enable)
 	{
-		glDepthMask(enable);
+		if (request(RenderStateBlock::State::DepthBuffer, enable != s_state.isDepthBufferEnabled()))
+			changeDepthBuffer(enable);
 	}
 
 	bool RenderContextGL33::isDepthBufferEnabled() const
 	{
-		GLboolean val;
-		glGetBooleanv(GL_DEPTH_WRITEMASK, &val);
-		return val;
+		return s_state.isDepthBufferEnabled();
 	}
 
 	void RenderContextGL33::enableColorBuffer(bool red, bool green, bool blue, bool alpha)
 	{
-		glColorMask(red, green, blue, alpha);
+		std::array<bool, 4> mask { { red, green, blue, alpha } };
+		if (request(RenderStateBlock::State::ColorBuffer, mask != s_state.isColorBufferEnabled()))
+			changeColorBuffer(mask);
 	}
 
 	std::array<bool, 4> RenderContextGL33::isColorBufferEnabled() const
 	{
-		GLboolean vals[4];
-		glGetBooleanv(GL_COLOR_WRITEMASK, &vals[0]);
-		return {(bool)vals[0], (bool)vals[1], (bool)vals[2], (bool)vals[3]};
+		return s_state.isColorBufferEnabled();
 	}
 
 	void RenderContextGL33::setMultisampling(bool msaa)
@@ -283,6 +186,41 @@ namespace dbgl
 		glClearColor(m_clearcolor[0], m_clearcolor[1], m_clearcolor[2], 0);
 	}
 
+	void RenderContextGL33::apply(RenderStateBlock const& block)
+	{
+		if (!isBound())
+			bind();
+		unsigned int changed = s_state.diff(block);
+		if (request(RenderStateBlock::State::DepthTest, RenderStateBlock::contains(changed,
+				RenderStateBlock::State::DepthTest)))
+			changeDepthTest(block.getDepthTest());
+		if (request(RenderStateBlock::State::AlphaBlend, RenderStateBlock::contains(changed,
+				RenderStateBlock::State::AlphaBlend)))
+			changeAlphaBlend(block.getSrcAlphaBlend(), block.getDestAlphaBlend());
+		if (request(RenderStateBlock::State::FaceCulling, RenderStateBlock::contains(changed,
+				RenderStateBlock::State::FaceCulling)))
+			changeFaceCulling(block.getFaceCulling());
+		if (request(RenderStateBlock::State::DrawMode, RenderStateBlock::contains(changed,
+				RenderStateBlock::State::DrawMode)))
+			changeDrawMode(block.getDrawMode());
+		if (request(RenderStateBlock::State::DepthBuffer, RenderStateBlock::contains(changed,
+				RenderStateBlock::State::DepthBuffer)))
+			changeDepthBuffer(block.isDepthBufferEnabled());
+		if (request(RenderStateBlock::State::ColorBuffer, RenderStateBlock::contains(changed,
+				RenderStateBlock::State::ColorBuffer)))
+			changeColorBuffer(block.isColorBufferEnabled());
+	}
+
+	RenderStateBlock RenderContextGL33::getStateBlock() const
+	{
+		return s_state;
+	}
+
+	RenderStateCounters& RenderContextGL33::getStateCounters()
+	{
+		return m_stateCounters;
+	}
+
 	void RenderContextGL33::bind()
 	{
 		if (m_frameBufferId != s_curFrameBufferId)
@@ -326,88 +264,84 @@ namespace dbgl
 		if (pMesh == nullptr)
 			throw std::invalid_argument("Cannot render null mesh.");
 
-		// Bind vertex buffer : 0
-		if (pMesh->getVertexCount() > 0)
+		enableAttributes(pMesh);
+		if (pMesh->getIndexCount() > 0)
 		{
-			glEnableVertexAttribArray(0);
-			glBindBuffer(GL_ARRAY_BUFFER, pMesh->getVertexHandle());
-			glVertexAttribPointer(0,	// attribute
-					3,			// size
-					GL_FLOAT,		// type
-					GL_FALSE,		// normalized?
-					0,			// stride
-					(void*) 0);		// offset
+			// Index buffer
+			glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, pMesh->getIndexHandle());
+			// Draw!
+			glDrawElements(GL_TRIANGLES,	// mode
+					pMesh->getIndexCount(),	// count
+					pMesh->getIndexType(),	// type
+					(void*) 0);			// offset
 		}
-		// Bind UV buffer : 1
-		if (pMesh->getUVCount() > 0)
+		disableAttributes(pMesh);
+	}
+
+	void RenderContextGL33::drawMeshInstanced(IMesh* mesh, IInstanceBuffer* instances, unsigned int first,
+			unsigned int count)
+	{
+		if (!isBound())
+			bind();
+
+		MeshGL33* pMesh = dynamic_cast<MeshGL33*>(mesh);
+		if (pMesh == nullptr)
+			throw std::invalid_argument("Cannot render null mesh.");
+		InstanceBufferGL33* pInstances = dynamic_cast<InstanceBufferGL33*>(instances);
+		if (pInstances == nullptr || first > pInstances->getCapacity() || count > pInstances->getCapacity() - first)
+			throw std::invalid_argument("Instances exceed the instance buffer.");
+
+		enableAttributes(pMesh);
+		// Bind model matrices, one column per attribute, advancing once per instance
+		glBindBuffer(GL_ARRAY_BUFFER, pInstances->getHandle());
+		for (unsigned int i = 0; i < 4; i++)
 		{
-			glEnableVertexAttribArray(1);
-			glBindBuffer(GL_ARRAY_BUFFER, pMesh->getUVHandle());
-			glVertexAttribPointer(1,	// attribute
-					2,			// size
-					GL_FLOAT,		// type
-					GL_FALSE,		// normalized?
-					0,			// stride
-					(void*) 0);		// offset
+			glEnableVertexAttribArray(s_instanceAttribute + i);
+			glVertexAttribPointer(s_instanceAttribute + i, 4, GL_FLOAT, GL_FALSE, sizeof(Mat4f),
+					(void*) (first * sizeof(Mat4f) + i * sizeof(Vec4f)));
+			glVertexAttribDivisor(s_instanceAttribute + i, 1);
 		}
-		// Bind normal buffer : 2
-		if (pMesh->getNormalCount() > 0)
+		if (pMesh->getIndexCount() > 0)
 		{
-			glEnableVertexAttribArray(2);
-			glBindBuffer(GL_ARRAY_BUFFER, pMesh->getNormalHandle());
-			glVertexAttribPointer(2,	// attribute
-					3,			// size
-					GL_FLOAT,		// type
-					GL_FALSE,		// normalized?
-					0,			// stride
-					(void*) 0);		// offset
+			glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, pMesh->getIndexHandle());
+			glDrawElementsInstanced(GL_TRIANGLES, pMesh->getIndexCount(), pMesh->getIndexType(), (void*) 0,
+					count);
 		}
-		// Bind tangent buffer : 3
-		if (pMesh->getTangentCount() > 0)
+		for (unsigned int i = 0; i < 4; i++)
 		{
-			glEnableVertexAttribArray(3);
-			glBindBuffer(GL_ARRAY_BUFFER, pMesh->getTangentHandle());
-			glVertexAttribPointer(3,	// attribute
-					3,			// size
-					GL_FLOAT,		// type
-					GL_FALSE,		// normalized?
-					0,			// stride
-					(void*) 0);		// offset
+			glVertexAttribDivisor(s_instanceAttribute + i, 0);
+			glDisableVertexAttribArray(s_instanceAttribute + i);
 		}
-		// Bind bitangent buffer : 4
-		if (pMesh->getBitangentCount() > 0)
+		disableAttributes(pMesh);
+	}
+
+	void RenderContextGL33::enableAttributes(MeshGL33* pMesh)
+	{
+		if (pMesh->getVertexCount() == 0)
+			return;
+		// All attributes are interleaved in one buffer, their location is given by the attribute
+		VertexLayout const& layout = pMesh->getBufferLayout();
+		glBindBuffer(GL_ARRAY_BUFFER, pMesh->getVertexHandle());
+		for (auto const& element : layout.getElements())
 		{
-			glEnableVertexAttribArray(4);
-			glBindBuffer(GL_ARRAY_BUFFER, pMesh->getBitangentHandle());
-			glVertexAttribPointer(4,	// attribute
-					3,			// size
-					GL_FLOAT,		// type
-					GL_FALSE,		// normalized?
-					0,			// stride
-					(void*) 0);		// offset
-		}
-		if (pMesh->getIndexCount() > 0)
-		{
-			// Index buffer
-			glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, pMesh->getIndexHandle());
-			// Draw!
-			glDrawElements(GL_TRIANGLES,	// mode
-					pMesh->getIndexCount(),	// count
-					GL_UNSIGNED_SHORT,		// type
-					(void*) 0);			// offset
+			auto location = static_cast<GLuint>(element.m_attribute);
+			glEnableVertexAttribArray(location);
+			glVertexAttribPointer(location,	// attribute
+					VertexLayout::getComponents(element.m_attribute, element.m_format),	// size
+					MeshGL33::format2GL(element.m_format),	// type
+					element.m_format == VertexLayout::Format::Float
+							|| element.m_format == VertexLayout::Format::Half ? GL_FALSE : GL_TRUE,	// normalized?
+					layout.getStride(),	// stride
+					(void*) (std::size_t) element.m_offset);	// offset
 		}
+	}
 
-		// Disable buffers
-		if (pMesh->getVertexCount() > 0)
-			glDisableVertexAttribArray(0);
-		if (pMesh->getUVCount() > 0)
-			glDisableVertexAttribArray(1);
-		if (pMesh->getNormalCount() > 0)
-			glDisableVertexAttribArray(2);
-		if (pMesh->getTangentCount() > 0)
-			glDisableVertexAttribArray(3);
-		if (pMesh->getBitangentCount() > 0)
-			glDisableVertexAttribArray(4);
+	void RenderContextGL33::disableAttributes(MeshGL33* pMesh)
+	{
+		if (pMesh->getVertexCount() == 0)
+			return;
+		for (auto const& element : pMesh->getBufferLayout().getElements())
+			glDisableVertexAttribArray(static_cast<GLuint>(element.m_attribute));
 	}
 
 	GLenum RenderContextGL33::alphaBlendValue2GL(AlphaBlendValue val)
@@ -436,4 +370,164 @@ namespace dbgl
 			return GL_INVALID_ENUM;
 		}
 	}
+
+	void RenderContextGL33::invalidateStateCache()
+	{
+		s_invalidStates = (1u << RenderStateBlock::s_stateCount) - 1;
+	}
+
+	void RenderContextGL33::changeDepthTest(DepthTestValue val)
+	{
+		GLenum func = GL_ALWAYS;
+		switch (val)
+		{
+		case DepthTestValue::Always:
+			break;
+		case DepthTestValue::Never:
+			func = GL_NEVER;
+			break;
+		case DepthTestValue::Less:
+			func = GL_LESS;
+			break;
+		case DepthTestValue::LessEqual:
+			func = GL_LEQUAL;
+			break;
+		case DepthTestValue::Greater:
+			func = GL_GREATER;
+			break;
+		case DepthTestValue::GreaterEqual:
+			func = GL_GEQUAL;
+			break;
+		case DepthTestValue::Equal:
+			func = GL_EQUAL;
+			break;
+		case DepthTestValue::NotEqual:
+			func = GL_NOTEQUAL;
+			break;
+		default:
+			throw std::invalid_argument("Invalid value for depth testing.");
+		}
+		bool wasEnabled = isKnown(RenderStateBlock::State::DepthTest)
+				&& s_state.getDepthTest() != DepthTestValue::Always;
+		if (val == DepthTestValue::Always)
+			glDisable(GL_DEPTH_TEST);
+		else
+		{
+			if (!wasEnabled)
+				glEnable(GL_DEPTH_TEST);
+			glDepthFunc(func);
+		}
+		s_state = s_state.withDepthTest(val);
+		s_invalidStates &= ~(1u << static_cast<unsigned int>(RenderStateBlock::State::DepthTest));
+	}
+
+	void RenderContextGL33::changeAlphaBlend(AlphaBlendValue src, AlphaBlendValue dest)
+	{
+		constexpr unsigned int bit = 1u << static_cast<unsigned int>(RenderStateBlock::State::AlphaBlend);
+		if (src == AlphaBlendValue::Zero && dest == AlphaBlendValue::Zero)
+		{
+			glDisable(GL_BLEND);
+			s_state = s_state.withAlphaBlend(src, dest);
+			s_invalidStates &= ~bit;
+			return;
+		}
+		bool wasEnabled = isKnown(RenderStateBlock::State::AlphaBlend)
+				&& (s_state.getSrcAlphaBlend() != AlphaBlendValue::Zero
+						|| s_state.getDestAlphaBlend() != AlphaBlendValue::Zero);
+		GLenum sfactor = alphaBlendValue2GL(src), dfactor = alphaBlendValue2GL(dest);
+		glGetError(); // Clear last error
+		if (!wasEnabled)
+			glEnable(GL_BLEND);
+		glBlendFunc(sfactor, dfactor);
+		if (glGetError() != GL_NO_ERROR)
+		{
+			glDisable(GL_BLEND);
+			s_state = s_state.withAlphaBlend(AlphaBlendValue::Zero, AlphaBlendValue::Zero);
+			s_invalidStates &= ~bit;
+			throw std::invalid_argument("Invalid value for alpha blending.");
+		}
+		s_state = s_state.withAlphaBlend(src, dest);
+		s_invalidStates &= ~bit;
+	}
+
+	void RenderContextGL33::changeFaceCulling(FaceCullingValue val)
+	{
+		GLenum mode = GL_BACK;
+		switch (val)
+		{
+		case FaceCullingValue::Off:
+			break;
+		case FaceCullingValue::Front:
+			mode = GL_FRONT;
+			break;
+		case FaceCullingValue::Back:
+			mode = GL_BACK;
+			break;
+		case FaceCullingValue::FrontBack:
+			mode = GL_FRONT_AND_BACK;
+			break;
+		default:
+			throw std::invalid_argument("Unknown value for face culling.");
+		}
+		bool wasEnabled = isKnown(RenderStateBlock::State::FaceCulling)
+				&& s_state.getFaceCulling() != FaceCullingValue::Off;
+		if (val == FaceCullingValue::Off)
+			glDisable(GL_CULL_FACE);
+		else
+		{
+			if (!wasEnabled)
+				glEnable(GL_CULL_FACE);
+			glCullFace(mode);
+		}
+		s_state = s_state.withFaceCulling(val);
+		s_invalidStates &= ~(1u << static_cast<unsigned int>(RenderStateBlock::State::FaceCulling));
+	}
+
+	void RenderContextGL33::changeDrawMode(DrawMode mode)
+	{
+		GLenum glMode = GL_FILL;
+		switch(mode)
+		{
+		case DrawMode::Fill:
+			glMode = GL_FILL;
+			break;
+		case DrawMode::Line:
+			glMode = GL_LINE;
+			break;
+		case DrawMode::Point:
+			glMode = GL_POINT;
+			break;
+		default:
+			throw std::invalid_argument("Unknown value for draw mode.");
+		}
+		glPolygonMode(GL_FRONT_AND_BACK, glMode);
+		s_state = s_state.withDrawMode(mode);
+		s_invalidStates &= ~(1u << static_cast<unsigned int>(RenderStateBlock::State::DrawMode));
+	}
+
+	void RenderContextGL33::changeDepthBuffer(bool enable)
+	{
+		glDepthMask(enable);
+		s_state = s_state.withDepthBuffer(enable);
+		s_invalidStates &= ~(1u << static_cast<unsigned int>(RenderStateBlock::State::DepthBuffer));
+	}
+
+	void RenderContextGL33::changeColorBuffer(std::array<bool, 4> const& mask)
+	{
+		glColorMask(mask[0], mask[1], mask[2], mask[3]);
+		s_state = s_state.withColorBuffer(mask[0], mask[1], mask[2], mask[3]);
+		s_invalidStates &= ~(1u << static_cast<unsigned int>(RenderStateBlock::State::ColorBuffer));
+	}
+
+	bool RenderContextGL33::request(RenderStateBlock::State state, bool changed)
+	{
+		bool issue = changed || !isKnown(state);
+		m_stateCounters.count(state, issue);
+		return issue;
+	}
+
+	bool RenderContextGL33::isKnown(RenderStateBlock::State state)
+	{
+		return !RenderStateBlock::contains(s_invalidStates, state);
+	}
 }
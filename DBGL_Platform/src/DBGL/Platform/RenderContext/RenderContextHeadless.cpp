@@ -0,0 +1,272 @@
+//////////////////////////////////////////////////////////////////////
+/// Dragon Blaze Game Library
+///
+/// Copyright (c) 2015 by Jan Moeller
+///
+/// This software is provided "as-is" and does not claim to be
+/// complete or free of bugs in any way. It should work, but
+/// it might also begin to hurt your kittens.
+//////////////////////////////////////////////////////////////////////
+
+#include <cstring>
+#include <algorithm>
+#include "DBGL/Platform/RenderContext/RenderContextHeadless.h"
+
+namespace dbgl
+{
+	RenderContextHeadless const* RenderContextHeadless::s_pBound = nullptr;
+
+	RenderContextHeadless::RenderContextHeadless(unsigned int width, unsigned int height, CommandLog* log)
+			: m_width { width }, m_height { height }, m_pLog { log }
+	{
+	}
+
+	RenderContextHeadless::~RenderContextHeadless()
+	{
+		if (isBound())
+			s_pBound = nullptr;
+	}
+
+	void RenderContextHeadless::clear(int bitmask)
+	{
+		record(CommandLog::Type::Clear, static_cast<unsigned int>(bitmask));
+	}
+
+	void RenderContextHeadless::setDepthTest(DepthTestValue val)
+	{
+		if (!request(RenderStateBlock::State::DepthTest, val != m_state.getDepthTest()))
+			return;
+		m_state = m_state.withDepthTest(val);
+		record(CommandLog::Type::DepthTest, static_cast<unsigned int>(val));
+	}
+
+	auto RenderContextHeadless::getDepthTest() const -> DepthTestValue
+	{
+		return m_state.getDepthTest();
+	}
+
+	void RenderContextHeadless::setAlphaBlend(AlphaBlendValue src, AlphaBlendValue dest)
+	{
+		if (!request(RenderStateBlock::State::AlphaBlend,
+				src != m_state.getSrcAlphaBlend() || dest != m_state.getDestAlphaBlend()))
+			return;
+		m_state = m_state.withAlphaBlend(src, dest);
+		record(CommandLog::Type::AlphaBlend, static_cast<unsigned int>(src) << 8 | static_cast<unsigned int>(dest));
+	}
+
+	auto RenderContextHeadless::getSrcAlphaBlend() const -> AlphaBlendValue
+	{
+		return m_state.getSrcAlphaBlend();
+	}
+
+	auto RenderContextHeadless::getDestAlphaBlend() const -> AlphaBlendValue
+	{
+		return m_state.getDestAlphaBlend();
+	}
+
+	void RenderContextHeadless::setFaceCulling(FaceCullingValue val)
+	{
+		if (!request(RenderStateBlock::State::FaceCulling, val != m_state.getFaceCulling()))
+			return;
+		m_state = m_state.withFaceCulling(val);
+		record(CommandLog::Type::FaceCulling, static_cast<unsigned int>(val));
+	}
+
+	auto RenderContextHeadless::getFaceCulling() const -> FaceCullingValue
+	{
+		return m_state.getFaceCulling();
+	}
+
+	void RenderContextHeadless::setDrawMode(DrawMode mode)
+	{
+		if (!request(RenderStateBlock::State::DrawMode, mode != m_state.getDrawMode()))
+			return;
+		m_state = m_state.withDrawMode(mode);
+		record(CommandLog::Type::DrawMode, static_cast<unsigned int>(mode));
+	}
+
+	auto RenderContextHeadless::getDrawMode() const -> DrawMode
+	{
+		return m_state.getDrawMode();
+	}
+
+	void RenderContextHeadless::setLineWidth(float width)
+	{
+		m_lineWidth = width;
+		record(CommandLog::Type::LineWidth, floatBits(width));
+	}
+
+	float RenderContextHeadless::getLineWidth() const
+	{
+		return m_lineWidth;
+	}
+
+	void RenderContextHeadless::setLineAntialiasing(bool smooth)
+	{
+		m_lineAntialiasing = smooth;
+		record(CommandLog::Type::LineAntialiasing, smooth);
+	}
+
+	bool RenderContextHeadless::getLineAntialiasing() const
+	{
+		return m_lineAntialiasing;
+	}
+
+	void RenderContextHeadless::setPointSize(float size)
+	{
+		m_pointSize = size;
+		record(CommandLog::Type::PointSize, floatBits(size));
+	}
+
+	float RenderContextHeadless::getPointSize() const
+	{
+		return m_pointSize;
+	}
+
+	void RenderContextHeadless::enableDepthBuffer(bool enable)
+	{
+		if (!request(RenderStateBlock::State::DepthBuffer, enable != m_state.isDepthBufferEnabled()))
+			return;
+		m_state = m_state.withDepthBuffer(enable);
+		record(CommandLog::Type::DepthBuffer, enable);
+	}
+
+	bool RenderContextHeadless::isDepthBufferEnabled() const
+	{
+		return m_state.isDepthBufferEnabled();
+	}
+
+	void RenderContextHeadless::enableColorBuffer(bool red, bool green, bool blue, bool alpha)
+	{
+		std::array<bool, 4> mask { { red, green, blue, alpha } };
+		if (!request(RenderStateBlock::State::ColorBuffer, mask != m_state.isColorBufferEnabled()))
+			return;
+		m_state = m_state.withColorBuffer(red, green, blue, alpha);
+		record(CommandLog::Type::ColorBuffer, red | green << 1 | blue << 2 | alpha << 3);
+	}
+
+	std::array<bool, 4> RenderContextHeadless::isColorBufferEnabled() const
+	{
+		return m_state.isColorBufferEnabled();
+	}
+
+	void RenderContextHeadless::setMultisampling(bool msaa)
+	{
+		m_multisampling = msaa;
+		record(CommandLog::Type::Multisampling, msaa);
+	}
+
+	bool RenderContextHeadless::getMultisampling() const
+	{
+		return m_multisampling;
+	}
+
+	std::array<float, 3> RenderContextHeadless::getClearColor() const
+	{
+		return m_clearColor;
+	}
+
+	void RenderContextHeadless::setClearColor(std::array<float, 3> color)
+	{
+		m_clearColor = color;
+		record(CommandLog::Type::ClearColor);
+	}
+
+	void RenderContextHeadless::apply(RenderStateBlock const& block)
+	{
+		setDepthTest(block.getDepthTest());
+		setAlphaBlend(block.getSrcAlphaBlend(), block.getDestAlphaBlend());
+		setFaceCulling(block.getFaceCulling());
+		setDrawMode(block.getDrawMode());
+		enableDepthBuffer(block.isDepthBufferEnabled());
+		auto const& mask = block.isColorBufferEnabled();
+		enableColorBuffer(mask[0], mask[1], mask[2], mask[3]);
+	}
+
+	RenderStateBlock RenderContextHeadless::getStateBlock() const
+	{
+		return m_state;
+	}
+
+	RenderStateCounters& RenderContextHeadless::getStateCounters()
+	{
+		return m_stateCounters;
+	}
+
+	void RenderContextHeadless::bind()
+	{
+		if (!isBound())
+		{
+			s_pBound = this;
+			m_pLog->record(CommandLog::Type::BindContext, this);
+		}
+	}
+
+	bool RenderContextHeadless::isBound() const
+	{
+		return s_pBound == this;
+	}
+
+	int RenderContextHeadless::getWidth()
+	{
+		return m_width;
+	}
+
+	int RenderContextHeadless::getHeight()
+	{
+		return m_height;
+	}
+
+	void RenderContextHeadless::viewport(unsigned int /* x */, unsigned int /* y */, unsigned int /* width */,
+			unsigned int /* height */)
+	{
+		record(CommandLog::Type::Viewport);
+	}
+
+	void RenderContextHeadless::readPixels(int /* x */, int /* y */, int /* width */, int /* height */,
+			ITextureCommands::PixelFormat /* format */, ITextureCommands::PixelType /* type */, unsigned int bufsize,
+			char* buf)
+	{
+		// There is nothing rendered, so everything is black
+		std::fill(buf, buf + bufsize, 0);
+		record(CommandLog::Type::ReadPixels);
+	}
+
+	void RenderContextHeadless::drawMesh(IMesh* mesh)
+	{
+		if (!isBound())
+			bind();
+		m_pLog->record(CommandLog::Type::DrawMesh, mesh, mesh ? mesh->getIndexCount() : 0);
+	}
+
+	void RenderContextHeadless::drawMeshInstanced(IMesh* mesh, IInstanceBuffer* instances, unsigned int first,
+			unsigned int count)
+	{
+		if (instances == nullptr || first > instances->getCapacity() || count > instances->getCapacity() - first)
+			throw std::invalid_argument("Instances exceed the instance buffer.");
+		if (!isBound())
+			bind();
+		m_pLog->recordInstanced(mesh, mesh ? mesh->getIndexCount() : 0, count);
+	}
+
+	void RenderContextHeadless::record(CommandLog::Type type, unsigned int value)
+	{
+		if (!isBound())
+			bind();
+		m_pLog->record(type, this, value);
+	}
+
+	bool RenderContextHeadless::request(RenderStateBlock::State state, bool changed)
+	{
+		m_stateCounters.count(state, changed);
+		return changed;
+	}
+
+	unsigned int RenderContextHeadless::floatBits(float value)
+	{
+		unsigned int bits;
+		static_assert(sizeof(bits) == sizeof(value), "Unexpected size of float");
+		std::memcpy(&bits, &value, sizeof(bits));
+		return bits;
+	}
+}
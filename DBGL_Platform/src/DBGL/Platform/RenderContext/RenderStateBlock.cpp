@@ -0,0 +1,172 @@
+//////////////////////////////////////////////////////////////////////
+/// Dragon Blaze Game Library
+///
+/// Copyright (c) 2015 by Jan Moeller
+///
+/// This software is provided "as-is" and does not claim to be
+/// complete or free of bugs in any way. It should work, but
+/// it might also begin to hurt your kittens.
+//////////////////////////////////////////////////////////////////////
+
+#include "DBGL/Platform/RenderContext/RenderStateBlock.h"
+
+namespace dbgl
+{
+	constexpr std::size_t RenderStateBlock::s_stateCount;
+
+	RenderStateBlock RenderStateBlock::withDepthTest(IRenderContext::DepthTestValue val) const
+	{
+		RenderStateBlock block { *this };
+		block.m_depthTest = val;
+		return block;
+	}
+
+	RenderStateBlock RenderStateBlock::withAlphaBlend(IRenderContext::AlphaBlendValue src,
+			IRenderContext::AlphaBlendValue dest) const
+	{
+		RenderStateBlock block { *this };
+		block.m_srcBlend = src;
+		block.m_destBlend = dest;
+		return block;
+	}
+
+	RenderStateBlock RenderStateBlock::withFaceCulling(IRenderContext::FaceCullingValue val) const
+	{
+		RenderStateBlock block { *this };
+		block.m_faceCulling = val;
+		return block;
+	}
+
+	RenderStateBlock RenderStateBlock::withDrawMode(IRenderContext::DrawMode mode) const
+	{
+		RenderStateBlock block { *this };
+		block.m_drawMode = mode;
+		return block;
+	}
+
+	RenderStateBlock RenderStateBlock::withDepthBuffer(bool enable) const
+	{
+		RenderStateBlock block { *this };
+		block.m_depthBuffer = enable;
+		return block;
+	}
+
+	RenderStateBlock RenderStateBlock::withColorBuffer(bool red, bool green, bool blue, bool alpha) const
+	{
+		RenderStateBlock block { *this };
+		block.m_colorBuffer = { { red, green, blue, alpha } };
+		return block;
+	}
+
+	IRenderContext::DepthTestValue RenderStateBlock::getDepthTest() const
+	{
+		return m_depthTest;
+	}
+
+	IRenderContext::AlphaBlendValue RenderStateBlock::getSrcAlphaBlend() const
+	{
+		return m_srcBlend;
+	}
+
+	IRenderContext::AlphaBlendValue RenderStateBlock::getDestAlphaBlend() const
+	{
+		return m_destBlend;
+	}
+
+	IRenderContext::FaceCullingValue RenderStateBlock::getFaceCulling() const
+	{
+		return m_faceCulling;
+	}
+
+	IRenderContext::DrawMode RenderStateBlock::getDrawMode() const
+	{
+		return m_drawMode;
+	}
+
+	bool RenderStateBlock::isDepthBufferEnabled() const
+	{
+		return m_depthBuffer;
+	}
+
+	std::array<bool, 4> const& RenderStateBlock::isColorBufferEnabled() const
+	{
+		return m_colorBuffer;
+	}
+
+	unsigned int RenderStateBlock::diff(RenderStateBlock const& other) const
+	{
+		unsigned int mask = 0;
+		if (m_depthTest != other.m_depthTest)
+			mask |= 1u << static_cast<unsigned int>(State::DepthTest);
+		if (m_srcBlend != other.m_srcBlend || m_destBlend != other.m_destBlend)
+			mask |= 1u << static_cast<unsigned int>(State::AlphaBlend);
+		if (m_faceCulling != other.m_faceCulling)
+			mask |= 1u << static_cast<unsigned int>(State::FaceCulling);
+		if (m_drawMode != other.m_drawMode)
+			mask |= 1u << static_cast<unsigned int>(State::DrawMode);
+		if (m_depthBuffer != other.m_depthBuffer)
+			mask |= 1u << static_cast<unsigned int>(State::DepthBuffer);
+		if (m_colorBuffer != other.m_colorBuffer)
+			mask |= 1u << static_cast<unsigned int>(State::ColorBuffer);
+		return mask;
+	}
+
+	bool RenderStateBlock::contains(unsigned int mask, State state)
+	{
+		return mask & (1u << static_cast<unsigned int>(state));
+	}
+
+	bool RenderStateBlock::operator==(RenderStateBlock const& other) const
+	{
+		return diff(other) == 0;
+	}
+
+	bool RenderStateBlock::operator!=(RenderStateBlock const& other) const
+	{
+		return diff(other) != 0;
+	}
+
+	void RenderStateCounters::count(RenderStateBlock::State state, bool issued)
+	{
+		m_requested[static_cast<std::size_t>(state)]++;
+		if (issued)
+			m_issued[static_cast<std::size_t>(state)]++;
+	}
+
+	void RenderStateCounters::reset()
+	{
+		m_requested.fill(0);
+		m_issued.fill(0);
+	}
+
+	unsigned int RenderStateCounters::getRequested(RenderStateBlock::State state) const
+	{
+		return m_requested[static_cast<std::size_t>(state)];
+	}
+
+	unsigned int RenderStateCounters::getIssued(RenderStateBlock::State state) const
+	{
+		return m_issued[static_cast<std::size_t>(state)];
+	}
+
+	unsigned int RenderStateCounters::getRequested() const
+	{
+		unsigned int sum = 0;
+		for (auto count : m_requested)
+			sum += count;
+		return sum;
+	}
+
+	unsigned int RenderStateCounters::getIssued() const
+	{
+		unsigned int sum = 0;
+		for (auto count : m_issued)
+			sum += count;
+		return sum;
+	}
+
+	unsigned int RenderStateCounters::getRedundant() const
+	{
+		return getRequested() - getIssued();
+	}
+}
@@ -0,0 +1,34 @@
+//////////////////////////////////////////////////////////////////////
+/// Dragon Blaze Game Library
+///
+/// Copyright (c) 2015 by Jan Moeller
+///
+/// This software is provided "as-is" and does not claim to be
+/// complete or free of bugs in any way. It should work, but
+/// it might also begin to hurt your kittens.
+//////////////////////////////////////////////////////////////////////
+
+#include "DBGL/Platform/Shader/ShaderHeadless.h"
+
+namespace dbgl
+{
+	ShaderHeadless::ShaderHeadless(Type type, std::string code, CommandLog* log)
+			: m_type { type }, m_code { code }, m_pLog { log }
+	{
+	}
+
+	void ShaderHeadless::compile()
+	{
+		m_pLog->record(CommandLog::Type::CompileShader, this);
+	}
+
+	auto ShaderHeadless::getType() const -> Type
+	{
+		return m_type;
+	}
+
+	std::string const& ShaderHeadless::getCode() const
+	{
+		return m_code;
+	}
+}
@@ -12,6 +12,8 @@
 
 namespace dbgl
 {
+	GLuint ShaderProgramCommandsGL33::s_curProgramId = 0;
+
 	void ShaderProgramCommandsGL33::setUniformFloat(UniformHandle handle, const float value)
 	{
 		glUniform1f(handle, value);
@@ -134,4 +136,9 @@ namespace dbgl
 	{
 		glUniform1i(handle, value);
 	}
+
+	void ShaderProgramCommandsGL33::setUniformBlockBinding(UniformBlockHandle handle, unsigned int bindingPoint)
+	{
+		glUniformBlockBinding(s_curProgramId, handle, bindingPoint);
+	}
 }
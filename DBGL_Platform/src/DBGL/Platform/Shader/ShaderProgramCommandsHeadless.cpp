@@ -0,0 +1,171 @@
+//////////////////////////////////////////////////////////////////////
+/// Dragon Blaze Game Library
+///
+/// Copyright (c) 2015 by Jan Moeller
+///
+/// This software is provided "as-is" and does not claim to be
+/// complete or free of bugs in any way. It should work, but
+/// it might also begin to hurt your kittens.
+//////////////////////////////////////////////////////////////////////
+
+#include "DBGL/Platform/Shader/ShaderProgramCommandsHeadless.h"
+
+namespace dbgl
+{
+	ShaderProgramCommandsHeadless::ShaderProgramCommandsHeadless(CommandLog* log)
+			: m_pLog { log }
+	{
+	}
+
+	void ShaderProgramCommandsHeadless::setUniformFloat(UniformHandle handle, const float /* value */)
+	{
+		record(handle);
+	}
+
+	void ShaderProgramCommandsHeadless::setUniformFloat2(UniformHandle handle, const float /* value */[2])
+	{
+		record(handle);
+	}
+
+	void ShaderProgramCommandsHeadless::setUniformFloat3(UniformHandle handle, const float /* value */[3])
+	{
+		record(handle);
+	}
+
+	void ShaderProgramCommandsHeadless::setUniformFloat4(UniformHandle handle, const float /* value */[4])
+	{
+		record(handle);
+	}
+
+	void ShaderProgramCommandsHeadless::setUniformInt(UniformHandle handle, const int /* value */)
+	{
+		record(handle);
+	}
+
+	void ShaderProgramCommandsHeadless::setUniformInt2(UniformHandle handle, const int /* value */[2])
+	{
+		record(handle);
+	}
+
+	void ShaderProgramCommandsHeadless::setUniformInt3(UniformHandle handle, const int /* value */[3])
+	{
+		record(handle);
+	}
+
+	void ShaderProgramCommandsHeadless::setUniformInt4(UniformHandle handle, const int /* value */[4])
+	{
+		record(handle);
+	}
+
+	void ShaderProgramCommandsHeadless::setUniformBool(UniformHandle handle, const bool /* value */)
+	{
+		record(handle);
+	}
+
+	void ShaderProgramCommandsHeadless::setUniformBool2(UniformHandle handle, const bool /* value */[2])
+	{
+		record(handle);
+	}
+
+	void ShaderProgramCommandsHeadless::setUniformBool3(UniformHandle handle, const bool /* value */[3])
+	{
+		record(handle);
+	}
+
+	void ShaderProgramCommandsHeadless::setUniformBool4(UniformHandle handle, const bool /* value */[4])
+	{
+		record(handle);
+	}
+
+	void ShaderProgramCommandsHeadless::setUniformFloatArray(UniformHandle handle, unsigned int /* count */,
+			const float* /* values */)
+	{
+		record(handle);
+	}
+
+	void ShaderProgramCommandsHeadless::setUniformFloat2Array(UniformHandle handle, unsigned int /* count */,
+			const float* /* values */)
+	{
+		record(handle);
+	}
+
+	void ShaderProgramCommandsHeadless::setUniformFloat3Array(UniformHandle handle, unsigned int /* count */,
+			const float* /* values */)
+	{
+		record(handle);
+	}
+
+	void ShaderProgramCommandsHeadless::setUniformFloat4Array(UniformHandle handle, unsigned int /* count */,
+			const float* /* values */)
+	{
+		record(handle);
+	}
+
+	void ShaderProgramCommandsHeadless::setUniformIntArray(UniformHandle handle, unsigned int /* count */,
+			const int* /* values */)
+	{
+		record(handle);
+	}
+
+	void ShaderProgramCommandsHeadless::setUniformInt2Array(UniformHandle handle, unsigned int /* count */,
+			const int* /* values */)
+	{
+		record(handle);
+	}
+
+	void ShaderProgramCommandsHeadless::setUniformInt3Array(UniformHandle handle, unsigned int /* count */,
+			const int* /* values */)
+	{
+		record(handle);
+	}
+
+	void ShaderProgramCommandsHeadless::setUniformInt4Array(UniformHandle handle, unsigned int /* count */,
+			const int* /* values */)
+	{
+		record(handle);
+	}
+
+	void ShaderProgramCommandsHeadless::setUniformFloatMatrix2Array(UniformHandle handle, unsigned int /* count */,
+			bool /* transpose */, const float* /* values */)
+	{
+		record(handle);
+	}
+
+	void ShaderProgramCommandsHeadless::setUniformFloatMatrix3Array(UniformHandle handle, unsigned int /* count */,
+			bool /* transpose */, const float* /* values */)
+	{
+		record(handle);
+	}
+
+	void ShaderProgramCommandsHeadless::setUniformFloatMatrix4Array(UniformHandle handle, unsigned int /* count */,
+			bool /* transpose */, const float* /* values */)
+	{
+		record(handle);
+	}
+
+	void ShaderProgramCommandsHeadless::setUniformSampler(UniformHandle handle, const int /* value */)
+	{
+		record(handle);
+	}
+
+	void ShaderProgramCommandsHeadless::setUniformBlockBinding(UniformBlockHandle /* handle */,
+			unsigned int bindingPoint)
+	{
+		m_pLog->record(CommandLog::Type::UniformBlockBinding, m_pCurrent, bindingPoint);
+	}
+
+	IShaderProgram const* ShaderProgramCommandsHeadless::getCurrent() const
+	{
+		return m_pCurrent;
+	}
+
+	void ShaderProgramCommandsHeadless::setCurrent(IShaderProgram const* program)
+	{
+		m_pCurrent = program;
+	}
+
+	void ShaderProgramCommandsHeadless::record(UniformHandle handle)
+	{
+		m_pLog->record(CommandLog::Type::Uniform, m_pCurrent, static_cast<unsigned int>(handle));
+	}
+}
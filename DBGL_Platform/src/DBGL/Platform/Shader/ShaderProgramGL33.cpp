@@ -8,7 +8,9 @@
 /// it might also begin to hurt your kittens.
 //////////////////////////////////////////////////////////////////////
 
+#include <vector>
 #include "DBGL/Platform/Shader/ShaderProgramGL33.h"
+#include "DBGL/Platform/Shader/ShaderProgramCommandsGL33.h"
 
 namespace dbgl
 {
@@ -21,6 +23,8 @@ namespace dbgl
 
 	ShaderProgramGL33::~ShaderProgramGL33()
 	{
+		if (ShaderProgramCommandsGL33::s_curProgramId == m_id)
+			ShaderProgramCommandsGL33::s_curProgramId = 0;
 		glDeleteProgram(m_id);
 	}
 
@@ -52,6 +56,7 @@ namespace dbgl
 				throw std::runtime_error(message);
 			}
 		}
+		reflect();
 	}
 
 	void ShaderProgramGL33::use()
@@ -59,14 +64,31 @@ namespace dbgl
 		useInternal();
 	}
 
-	auto ShaderProgramGL33::getAttributeHandle(std::string name) const -> AttribHandle
+	auto ShaderProgramGL33::getAttributeHandle(std::string const& name) const -> AttribHandle
 	{
-		return glGetAttribLocation(m_id, name.c_str());
+		auto it = m_attributes.find(name);
+		if (it == m_attributes.end())
+			return InvalidAttribHandle;
+		return it->second;
 	}
 
-	auto ShaderProgramGL33::getUniformHandle(std::string name) const -> UniformHandle
+	auto ShaderProgramGL33::getUniformHandle(std::string const& name) const -> UniformHandle
 	{
-		return glGetUniformLocation(m_id, name.c_str());
+		auto it = m_uniforms.find(name);
+		if (it != m_uniforms.end())
+			return it->second;
+		// Only the first element of arrays is stored, other ones still need to be queried
+		if (!name.empty() && name.back() == ']')
+			return glGetUniformLocation(m_id, name.c_str());
+		return InvalidUniformHandle;
+	}
+
+	auto ShaderProgramGL33::getUniformBlockHandle(std::string const& name) const -> UniformBlockHandle
+	{
+		auto it = m_uniformBlocks.find(name);
+		if (it == m_uniformBlocks.end())
+			return InvalidUniformBlockHandle;
+		return it->second;
 	}
 
 	GLuint ShaderProgramGL33::getHandle() const
@@ -76,6 +98,58 @@ namespace dbgl
 
 	void ShaderProgramGL33::useInternal() const
 	{
-		glUseProgram(m_id);
+		if (ShaderProgramCommandsGL33::s_curProgramId != m_id)
+		{
+			glUseProgram(m_id);
+			ShaderProgramCommandsGL33::s_curProgramId = m_id;
+		}
+	}
+
+	void ShaderProgramGL33::reflect()
+	{
+		m_attributes.clear();
+		m_uniforms.clear();
+		m_uniformBlocks.clear();
+		GLint count = 0, maxLength = 0;
+		GLsizei length = 0;
+		GLint size = 0;
+		GLenum type = 0;
+
+		// Attributes
+		glGetProgramiv(m_id, GL_ACTIVE_ATTRIBUTES, &count);
+		glGetProgramiv(m_id, GL_ACTIVE_ATTRIBUTE_MAX_LENGTH, &maxLength);
+		std::vector<GLchar> name(maxLength + 1);
+		for (GLint i = 0; i < count; i++)
+		{
+			glGetActiveAttrib(m_id, i, name.size(), &length, &size, &type, name.data());
+			m_attributes.emplace(std::string(name.data(), length), glGetAttribLocation(m_id, name.data()));
+		}
+
+		// Uniforms
+		glGetProgramiv(m_id, GL_ACTIVE_UNIFORMS, &count);
+		glGetProgramiv(m_id, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength);
+		name.resize(maxLength + 1);
+		for (GLint i = 0; i < count; i++)
+		{
+			glGetActiveUniform(m_id, i, name.size(), &length, &size, &type, name.data());
+			UniformHandle handle = glGetUniformLocation(m_id, name.data());
+			// Members of uniform blocks don't have a location
+			if (handle == InvalidUniformHandle)
+				continue;
+			std::string uniform(name.data(), length);
+			if (uniform.size() > 3 && uniform.compare(uniform.size() - 3, 3, "[0]") == 0)
+				m_uniforms.emplace(uniform.substr(0, uniform.size() - 3), handle);
+			m_uniforms.emplace(std::move(uniform), handle);
+		}
+
+		// Uniform blocks
+		glGetProgramiv(m_id, GL_ACTIVE_UNIFORM_BLOCKS, &count);
+		glGetProgramiv(m_id, GL_ACTIVE_UNIFORM_BLOCK_MAX_NAME_LENGTH, &maxLength);
+		name.resize(maxLength + 1);
+		for (GLint i = 0; i < count; i++)
+		{
+			glGetActiveUniformBlockName(m_id, i, name.size(), &length, name.data());
+			m_uniformBlocks.emplace(std::string(name.data(), length), i);
+		}
 	}
 }
@@ -0,0 +1,151 @@
+//////////////////////////////////////////////////////////////////////
+/// Dragon Blaze Game Library
+///
+/// Copyright (c) 2015 by Jan Moeller
+///
+/// This software is provided "as-is" and does not claim to be
+/// complete or free of bugs in any way. It should work, but
+/// it might also begin to hurt your kittens.
+//////////////////////////////////////////////////////////////////////
+
+#include <cctype>
+#include "DBGL/Platform/Shader/ShaderProgramHeadless.h"
+#include "DBGL/Platform/Shader/ShaderProgramCommandsHeadless.h"
+
+namespace dbgl
+{
+	ShaderProgramHeadless::ShaderProgramHeadless(CommandLog* log, ShaderProgramCommandsHeadless* commands)
+			: m_pLog { log }, m_pCommands { commands }
+	{
+	}
+
+	ShaderProgramHeadless::~ShaderProgramHeadless()
+	{
+		if (m_pCommands->getCurrent() == this)
+			m_pCommands->setCurrent(nullptr);
+	}
+
+	void ShaderProgramHeadless::attach(IShader* shader)
+	{
+		auto headless = static_cast<ShaderHeadless*>(shader);
+		m_sources.emplace_back(headless->getType(), headless->getCode());
+	}
+
+	void ShaderProgramHeadless::link()
+	{
+		m_attributes.clear();
+		m_uniforms.clear();
+		m_uniformBlocks.clear();
+		for (auto const& source : m_sources)
+		{
+			auto tokens = tokenize(source.second);
+			for (std::size_t i = 0; i < tokens.size(); i++)
+			{
+				bool uniform = tokens[i] == "uniform";
+				bool attribute = source.first == IShader::Type::VERTEX && (tokens[i] == "in" || tokens[i] == "attribute");
+				if (!uniform && !attribute)
+					continue;
+				// Skip precision qualifiers and the type
+				std::size_t j = i + 1;
+				while (j < tokens.size() && (tokens[j] == "lowp" || tokens[j] == "mediump" || tokens[j] == "highp"))
+					j++;
+				j++;
+				// Uniform blocks don't declare any plain uniforms
+				if (j < tokens.size() && tokens[j] == "{")
+				{
+					if (uniform && m_uniformBlocks.find(tokens[j - 1]) == m_uniformBlocks.end())
+						m_uniformBlocks.emplace(tokens[j - 1], static_cast<int>(m_uniformBlocks.size()));
+					i = j;
+					continue;
+				}
+				auto& handles = uniform ? m_uniforms : m_attributes;
+				while (j < tokens.size())
+				{
+					if (handles.find(tokens[j]) == handles.end())
+					{
+						int handle = static_cast<int>(handles.size());
+						handles.emplace(tokens[j], handle);
+					}
+					j++;
+					// Skip array size
+					if (j < tokens.size() && tokens[j] == "[")
+					{
+						while (j < tokens.size() && tokens[j] != "]")
+							j++;
+						j++;
+					}
+					if (j >= tokens.size() || tokens[j] != ",")
+						break;
+					j++;
+				}
+			}
+		}
+		m_pLog->record(CommandLog::Type::LinkProgram, this);
+	}
+
+	void ShaderProgramHeadless::use()
+	{
+		m_pCommands->setCurrent(this);
+		m_pLog->record(CommandLog::Type::UseProgram, this);
+	}
+
+	auto ShaderProgramHeadless::getAttributeHandle(std::string const& name) const -> AttribHandle
+	{
+		auto it = m_attributes.find(name);
+		if (it == m_attributes.end())
+			return InvalidAttribHandle;
+		return it->second;
+	}
+
+	auto ShaderProgramHeadless::getUniformHandle(std::string const& name) const -> UniformHandle
+	{
+		auto it = m_uniforms.find(name);
+		if (it == m_uniforms.end())
+			return InvalidUniformHandle;
+		return it->second;
+	}
+
+	auto ShaderProgramHeadless::getUniformBlockHandle(std::string const& name) const -> UniformBlockHandle
+	{
+		auto it = m_uniformBlocks.find(name);
+		if (it == m_uniformBlocks.end())
+			return InvalidUniformBlockHandle;
+		return it->second;
+	}
+
+	std::vector<std::string> ShaderProgramHeadless::tokenize(std::string const& code)
+	{
+		std::vector<std::string> tokens;
+		std::size_t i = 0;
+		while (i < code.size())
+		{
+			char c = code[i];
+			if (std::isspace(static_cast<unsigned char>(c)))
+				i++;
+			// Skip comments and preprocessor directives
+			else if (code.compare(i, 2, "//") == 0 || c == '#')
+			{
+				i = code.find('\n', i);
+				if (i == std::string::npos)
+					break;
+			}
+			else if (code.compare(i, 2, "/*") == 0)
+			{
+				i = code.find("*/", i + 2);
+				if (i == std::string::npos)
+					break;
+				i += 2;
+			}
+			else if (std::isalnum(static_cast<unsigned char>(c)) || c == '_')
+			{
+				std::size_t start = i;
+				while (i < code.size() && (std::isalnum(static_cast<unsigned char>(code[i])) || code[i] == '_'))
+					i++;
+				tokens.push_back(code.substr(start, i - start));
+			}
+			else
+				tokens.push_back(std::string(1, code[i++]));
+		}
+		return tokens;
+	}
+}
@@ -0,0 +1,56 @@
+//////////////////////////////////////////////////////////////////////
+/// Dragon Blaze Game Library
+///
+/// Copyright (c) 2015 by Jan Moeller
+///
+/// This software is provided "as-is" and does not claim to be
+/// complete or free of bugs in any way. It should work, but
+/// it might also begin to hurt your kittens.
+//////////////////////////////////////////////////////////////////////
+
+#include <stdexcept>
+#include "DBGL/Platform/Shader/UniformBufferGL33.h"
+
+namespace dbgl
+{
+	UniformBufferGL33::UniformBufferGL33(std::size_t size)
+			: m_size { size }
+	{
+		glGenBuffers(1, &m_id);
+		if (m_id == 0)
+			throw std::runtime_error("Couldn't create uniform buffer");
+		glBindBuffer(GL_UNIFORM_BUFFER, m_id);
+		glBufferData(GL_UNIFORM_BUFFER, m_size, nullptr, GL_DYNAMIC_DRAW);
+	}
+
+	UniformBufferGL33::~UniformBufferGL33()
+	{
+		glDeleteBuffers(1, &m_id);
+	}
+
+	std::size_t UniformBufferGL33::getSize() const
+	{
+		return m_size;
+	}
+
+	void UniformBufferGL33::write(void const* data, std::size_t size, std::size_t offset)
+	{
+		if (offset > m_size || size > m_size - offset)
+			throw std::invalid_argument("Uniform buffer write out of range.");
+		glBindBuffer(GL_UNIFORM_BUFFER, m_id);
+		if (offset == 0 && size == m_size)
+			glBufferData(GL_UNIFORM_BUFFER, m_size, data, GL_DYNAMIC_DRAW);
+		else
+			glBufferSubData(GL_UNIFORM_BUFFER, offset, size, data);
+	}
+
+	void UniformBufferGL33::bind(unsigned int bindingPoint)
+	{
+		glBindBufferBase(GL_UNIFORM_BUFFER, bindingPoint, m_id);
+	}
+
+	GLuint UniformBufferGL33::getHandle() const
+	{
+		return m_id;
+	}
+}
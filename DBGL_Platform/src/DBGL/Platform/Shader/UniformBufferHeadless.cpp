@@ -0,0 +1,45 @@
+//////////////////////////////////////////////////////////////////////
+/// Dragon Blaze Game Library
+///
+/// Copyright (c) 2015 by Jan Moeller
+///
+/// This software is provided "as-is" and does not claim to be
+/// complete or free of bugs in any way. It should work, but
+/// it might also begin to hurt your kittens.
+//////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <stdexcept>
+#include "DBGL/Platform/Shader/UniformBufferHeadless.h"
+
+namespace dbgl
+{
+	UniformBufferHeadless::UniformBufferHeadless(std::size_t size, CommandLog* log)
+			: m_data(size), m_pLog { log }
+	{
+	}
+
+	std::size_t UniformBufferHeadless::getSize() const
+	{
+		return m_data.size();
+	}
+
+	void UniformBufferHeadless::write(void const* data, std::size_t size, std::size_t offset)
+	{
+		if (offset > m_data.size() || size > m_data.size() - offset)
+			throw std::invalid_argument("Uniform buffer write out of range.");
+		auto bytes = static_cast<char const*>(data);
+		std::copy(bytes, bytes + size, m_data.begin() + offset);
+		m_pLog->record(CommandLog::Type::WriteUniformBuffer, this, size);
+	}
+
+	void UniformBufferHeadless::bind(unsigned int bindingPoint)
+	{
+		m_pLog->record(CommandLog::Type::BindUniformBuffer, this, bindingPoint);
+	}
+
+	std::vector<char> const& UniformBufferHeadless::getData() const
+	{
+		return m_data;
+	}
+}
@@ -0,0 +1,254 @@
+//////////////////////////////////////////////////////////////////////
+/// Dragon Blaze Game Library
+///
+/// Copyright (c) 2015 by Jan Moeller
+///
+/// This software is provided "as-is" and does not claim to be
+/// complete or free of bugs in any way. It should work, but
+/// it might also begin to hurt your kittens.
+//////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include "DBGL/Platform/Texture/TextureCommandsHeadless.h"
+
+namespace dbgl
+{
+	TextureCommandsHeadless::TextureCommandsHeadless(CommandLog* log)
+			: m_pLog { log }
+	{
+	}
+
+	void TextureCommandsHeadless::activateUnit(unsigned int unit)
+	{
+		m_pLog->record(CommandLog::Type::ActivateUnit, nullptr, unit);
+	}
+
+	void TextureCommandsHeadless::write(unsigned int level, unsigned int width, unsigned int height,
+			PixelFormat format, PixelType type, void const* data)
+	{
+		auto& l = this->level(level);
+		l.m_width = width;
+		l.m_height = height;
+		l.m_format = format;
+		l.m_type = type;
+		l.m_compressed = false;
+		std::size_t size = std::size_t { width } * height * pixelFormatSize(format) * pixelTypeSize(type);
+		if (data)
+			l.m_data.assign(static_cast<char const*>(data), static_cast<char const*>(data) + size);
+		else
+			l.m_data.assign(size, 0);
+		m_pLog->record(CommandLog::Type::WriteTexture, m_pCurrent, level);
+	}
+
+	void TextureCommandsHeadless::writeCompressed(unsigned int level, unsigned int width, unsigned int height,
+			PixelFormatCompressed /* format */, unsigned int size, void const* data)
+	{
+		auto& l = this->level(level);
+		l.m_width = width;
+		l.m_height = height;
+		l.m_compressed = true;
+		l.m_data.assign(static_cast<char const*>(data), static_cast<char const*>(data) + size);
+		m_pLog->record(CommandLog::Type::WriteTexture, m_pCurrent, level);
+	}
+
+	void TextureCommandsHeadless::setRowAlignment(RowAlignment /* type */, unsigned int align)
+	{
+		m_pLog->record(CommandLog::Type::TextureParameter, nullptr, align);
+	}
+
+	void TextureCommandsHeadless::setMinFilter(MinFilter filter)
+	{
+		m_pLog->record(CommandLog::Type::TextureParameter, &current(), static_cast<unsigned int>(filter));
+	}
+
+	void TextureCommandsHeadless::setMagFilter(MagFilter filter)
+	{
+		m_pLog->record(CommandLog::Type::TextureParameter, &current(), static_cast<unsigned int>(filter));
+	}
+
+	void TextureCommandsHeadless::setWrapMode(WrapDirection dir, WrapMode mode)
+	{
+		if (dir == WrapDirection::S)
+			current().m_wrapS = mode;
+		else
+			current().m_wrapT = mode;
+		m_pLog->record(CommandLog::Type::TextureParameter, m_pCurrent, static_cast<unsigned int>(mode));
+	}
+
+	auto TextureCommandsHeadless::getWrapMode(WrapDirection dir) -> WrapMode
+	{
+		return dir == WrapDirection::S ? current().m_wrapS : current().m_wrapT;
+	}
+
+	void TextureCommandsHeadless::generateMipMaps()
+	{
+		auto& levels = current().m_levels;
+		if (levels.empty() || levels[0].m_compressed)
+			return;
+		// Every level picks every second pixel of the previous one
+		levels.resize(1);
+		while (levels.back().m_width > 1 || levels.back().m_height > 1)
+		{
+			TextureHeadless::Level const& prev = levels.back();
+			TextureHeadless::Level next { };
+			next.m_width = std::max(prev.m_width / 2, 1u);
+			next.m_height = std::max(prev.m_height / 2, 1u);
+			next.m_format = prev.m_format;
+			next.m_type = prev.m_type;
+			std::size_t pixelSize = pixelFormatSize(prev.m_format) * pixelTypeSize(prev.m_type);
+			next.m_data.resize(std::size_t { next.m_width } * next.m_height * pixelSize);
+			for (unsigned int y = 0; y < next.m_height; y++)
+			{
+				for (unsigned int x = 0; x < next.m_width; x++)
+				{
+					unsigned int srcX = std::min(2 * x, prev.m_width - 1);
+					unsigned int srcY = std::min(2 * y, prev.m_height - 1);
+					std::memcpy(&next.m_data[(std::size_t { y } * next.m_width + x) * pixelSize],
+							&prev.m_data[(std::size_t { srcY } * prev.m_width + srcX) * pixelSize], pixelSize);
+				}
+			}
+			levels.push_back(std::move(next));
+		}
+		m_pLog->record(CommandLog::Type::GenerateMipMaps, m_pCurrent);
+	}
+
+	void TextureCommandsHeadless::getSize(unsigned int& width, unsigned int& height, unsigned int level)
+	{
+		auto const& levels = current().m_levels;
+		width = level < levels.size() ? levels[level].m_width : 0;
+		height = level < levels.size() ? levels[level].m_height : 0;
+	}
+
+	unsigned int TextureCommandsHeadless::getWidth() const
+	{
+		auto const& levels = current().m_levels;
+		return levels.empty() ? 0 : levels[0].m_width;
+	}
+
+	unsigned int TextureCommandsHeadless::getHeight() const
+	{
+		auto const& levels = current().m_levels;
+		return levels.empty() ? 0 : levels[0].m_height;
+	}
+
+	void TextureCommandsHeadless::getPixelData(PixelFormat format, PixelType type, char* buffer,
+			unsigned int level) const
+	{
+		auto const& levels = current().m_levels;
+		if (level >= levels.size())
+			throw std::runtime_error { "Texture level hasn't been written." };
+		auto const& l = levels[level];
+		if (l.m_compressed)
+			throw std::runtime_error { "Unable to read back compressed texture data." };
+		if (l.m_format == format && l.m_type == type)
+		{
+			std::copy(l.m_data.begin(), l.m_data.end(), buffer);
+			return;
+		}
+		if (l.m_type != PixelType::UBYTE || type != PixelType::UBYTE)
+			throw std::runtime_error { "Unsupported pixel type conversion." };
+		unsigned int srcSize = pixelFormatSize(l.m_format);
+		unsigned int destSize = pixelFormatSize(format);
+		for (std::size_t i = 0; i < std::size_t { l.m_width } * l.m_height; i++)
+			convertPixel(&l.m_data[i * srcSize], l.m_format, buffer + i * destSize, format);
+	}
+
+	TextureHeadless* TextureCommandsHeadless::getCurrent() const
+	{
+		return m_pCurrent;
+	}
+
+	void TextureCommandsHeadless::setCurrent(TextureHeadless* texture)
+	{
+		m_pCurrent = texture;
+	}
+
+	unsigned int TextureCommandsHeadless::pixelFormatSize(PixelFormat format)
+	{
+		switch (format)
+		{
+		case PixelFormat::LUMINANCE:
+			return 1;
+		case PixelFormat::RGB:
+		case PixelFormat::BGR:
+			return 3;
+		case PixelFormat::RGBA:
+		case PixelFormat::BGRA:
+			return 4;
+		default:
+			return 0;
+		}
+	}
+
+	unsigned int TextureCommandsHeadless::pixelTypeSize(PixelType type)
+	{
+		switch (type)
+		{
+		case PixelType::UBYTE:
+		case PixelType::BYTE:
+			return 1;
+		case PixelType::USHORT:
+		case PixelType::SHORT:
+			return 2;
+		case PixelType::UINT:
+		case PixelType::INT:
+		case PixelType::FLOAT:
+			return 4;
+		default:
+			return 0;
+		}
+	}
+
+	TextureHeadless& TextureCommandsHeadless::current() const
+	{
+		if (!m_pCurrent)
+			throw std::runtime_error { "No texture bound." };
+		return *m_pCurrent;
+	}
+
+	TextureHeadless::Level& TextureCommandsHeadless::level(unsigned int level) const
+	{
+		auto& levels = current().m_levels;
+		if (levels.size() <= level)
+			levels.resize(level + 1);
+		return levels[level];
+	}
+
+	void TextureCommandsHeadless::convertPixel(char const* src, PixelFormat srcFormat, char* dest,
+			PixelFormat destFormat)
+	{
+		char rgba[4] = { 0, 0, 0, static_cast<char>(0xFF) };
+		switch (srcFormat)
+		{
+		case PixelFormat::LUMINANCE:
+			rgba[0] = rgba[1] = rgba[2] = src[0];
+			break;
+		case PixelFormat::RGB:
+		case PixelFormat::RGBA:
+			std::copy(src, src + pixelFormatSize(srcFormat), rgba);
+			break;
+		case PixelFormat::BGR:
+		case PixelFormat::BGRA:
+			std::copy(src, src + pixelFormatSize(srcFormat), rgba);
+			std::swap(rgba[0], rgba[2]);
+			break;
+		}
+		switch (destFormat)
+		{
+		case PixelFormat::LUMINANCE:
+			dest[0] = rgba[0];
+			break;
+		case PixelFormat::RGB:
+		case PixelFormat::RGBA:
+			std::copy(rgba, rgba + pixelFormatSize(destFormat), dest);
+			break;
+		case PixelFormat::BGR:
+		case PixelFormat::BGRA:
+			std::swap(rgba[0], rgba[2]);
+			std::copy(rgba, rgba + pixelFormatSize(destFormat), dest);
+			break;
+		}
+	}
+}
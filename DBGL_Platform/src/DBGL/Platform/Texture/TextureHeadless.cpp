@@ -0,0 +1,42 @@
+//////////////////////////////////////////////////////////////////////
+/// Dragon Blaze Game Library
+///
+/// Copyright (c) 2015 by Jan Moeller
+///
+/// This software is provided "as-is" and does not claim to be
+/// complete or free of bugs in any way. It should work, but
+/// it might also begin to hurt your kittens.
+//////////////////////////////////////////////////////////////////////
+
+#include "DBGL/Platform/Texture/TextureHeadless.h"
+#include "DBGL/Platform/Texture/TextureCommandsHeadless.h"
+
+namespace dbgl
+{
+	TextureHeadless::TextureHeadless(Type type, CommandLog* log, TextureCommandsHeadless* commands)
+			: m_type { type }, m_pLog { log }, m_pCommands { commands }
+	{
+	}
+
+	TextureHeadless::~TextureHeadless()
+	{
+		if (m_pCommands->getCurrent() == this)
+			m_pCommands->setCurrent(nullptr);
+	}
+
+	void TextureHeadless::bind() const
+	{
+		m_pCommands->setCurrent(const_cast<TextureHeadless*>(this));
+		m_pLog->record(CommandLog::Type::BindTexture, this);
+	}
+
+	auto TextureHeadless::getType() const -> Type
+	{
+		return m_type;
+	}
+
+	ITexture* TextureHeadless::clone() const
+	{
+		return new TextureHeadless { *this };
+	}
+}
@@ -0,0 +1,27 @@
+//////////////////////////////////////////////////////////////////////
+/// Dragon Blaze Game Library
+///
+/// Copyright (c) 2015 by Jan Moeller
+///
+/// This software is provided "as-is" and does not claim to be
+/// complete or free of bugs in any way. It should work, but
+/// it might also begin to hurt your kittens.
+//////////////////////////////////////////////////////////////////////
+
+#include "DBGL/Platform/Time/TimerHeadless.h"
+
+namespace dbgl
+{
+	double TimerHeadless::getTime()
+	{
+		return std::chrono::duration<double> { std::chrono::steady_clock::now() - m_start }.count();
+	}
+
+	double TimerHeadless::getDelta()
+	{
+		double now = getTime();
+		double step { now - m_last };
+		m_last = now;
+		return step;
+	}
+}
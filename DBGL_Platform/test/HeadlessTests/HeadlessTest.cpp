@@ -0,0 +1,502 @@
+//////////////////////////////////////////////////////////////////////
+/// Dragon Blaze Game Library
+///
+/// Copyright (c) 2015 by Jan Moeller
+///
+/// This software is provided "as-is" and does not claim to be
+/// complete or free of bugs in any way. It should work, but
+/// it might also begin to hurt your kittens.
+//////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+#include "DBGL/Core/Test/Test.h"
+#include "DBGL/Platform/File/MappedFile.h"
+#include "DBGL/Platform/Implementation/Headless.h"
+#include "DBGL/Platform/Mesh/MeshHeadless.h"
+#include "DBGL/Platform/RenderContext/RenderStateBlock.h"
+#include "DBGL/Platform/Shader/UniformBlock.h"
+#include "DBGL/Platform/Shader/UniformBufferHeadless.h"
+
+using namespace dbgl;
+using namespace std;
+
+namespace dbgl_test_Headless
+{
+	CommandLog& getLog()
+	{
+		return static_cast<Headless*>(Platform::get())->getLog();
+	}
+}
+
+using namespace dbgl_test_Headless;
+
+TEST_INITIALIZE(Headless)
+{
+	Platform::init<Headless>();
+}
+
+TEST_TERMINATE(Headless)
+{
+	Platform::destroy();
+}
+
+TEST(Headless,commandLog)
+{
+	CommandLog log { };
+	int object = 0;
+	log.record(CommandLog::Type::DepthTest, &object, 2);
+	log.record(CommandLog::Type::DrawMesh, &object, 36);
+	log.record(CommandLog::Type::DrawMesh, &object, 6);
+	log.record(CommandLog::Type::Uniform);
+	ASSERT_EQ(log.getCommands().size(), 4u);
+	ASSERT(log.getCommands()[0].m_type == CommandLog::Type::DepthTest);
+	ASSERT_EQ(log.getCommands()[0].m_object, &object);
+	ASSERT_EQ(log.getCommands()[0].m_value, 2u);
+	ASSERT_EQ(log.getCount(CommandLog::Type::DrawMesh), 2u);
+	ASSERT_EQ(log.getDrawnIndices(), 42u);
+	ASSERT_EQ(log.getStateChanges(), 1u);
+	// Only count
+	log.setStoreCommands(false);
+	log.record(CommandLog::Type::Clear);
+	ASSERT_EQ(log.getCommands().size(), 4u);
+	ASSERT_EQ(log.getCount(CommandLog::Type::Clear), 1u);
+	log.clear();
+	ASSERT(log.getCommands().empty());
+	ASSERT_EQ(log.getCount(CommandLog::Type::DrawMesh), 0u);
+	ASSERT_EQ(log.getDrawnIndices(), 0u);
+}
+
+TEST(Headless,mesh)
+{
+	getLog().clear();
+	std::unique_ptr<IMesh> mesh { Platform::get()->createMesh() };
+	mesh->vertices() = { { -1, -1, 0 }, { 1, -1, 0 }, { 0, 1, 0 } };
+	mesh->uvs() = { { 0, 0 }, { 1, 0 }, { 0.5f, 1 } };
+	mesh->indices() = { 0, 1, 2 };
+	ASSERT_EQ(mesh->getVertexCount(), 0u);
+	mesh->updateBuffers();
+	ASSERT_EQ(mesh->getVertexCount(), 3u);
+	ASSERT_EQ(mesh->getUVCount(), 3u);
+	ASSERT_EQ(mesh->getIndexCount(), 3u);
+	ASSERT_EQ(mesh->getNormalCount(), 0u);
+	ASSERT_EQ(getLog().getCount(CommandLog::Type::UpdateMesh), 1u);
+	std::unique_ptr<IMesh> clone { mesh->clone() };
+	ASSERT_EQ(clone->getIndexCount(), 3u);
+	ASSERT(clone->vertices() == mesh->vertices());
+	// Attributes without one element per vertex are rejected
+	mesh->normals() = { { 0, 0, 1 } };
+	ASSERT_THROWS(mesh->updateBuffers(), std::invalid_argument);
+}
+
+TEST(Headless,vertexLayout)
+{
+	getLog().clear();
+	ASSERT_EQ(VertexLayout::makeFloat().getStride(), 60u);
+	ASSERT_EQ(VertexLayout::makePacked().getStride(), 24u);
+	ASSERT(VertexLayout::makePacked().find(VertexLayout::Attribute::Bitangent) == nullptr);
+	VertexLayout layout { };
+	ASSERT_THROWS(layout.add(VertexLayout::Attribute::UV, VertexLayout::Format::Snorm1010102), std::invalid_argument);
+	layout.add(VertexLayout::Attribute::Normal, VertexLayout::Format::Octahedral);
+	ASSERT_THROWS(layout.add(VertexLayout::Attribute::Normal, VertexLayout::Format::Float), std::invalid_argument);
+	// Packed layout, but only position, uv and normal have data
+	std::unique_ptr<IMesh> mesh { Platform::get()->createMesh() };
+	auto pMesh = static_cast<MeshHeadless*>(mesh.get());
+	mesh->setLayout(VertexLayout::makePacked());
+	mesh->vertices() = { { -1, -1, 0 }, { 1, -1, 0 }, { 0, 1, 0 } };
+	mesh->uvs() = { { 0, 0 }, { 1, 0 }, { 0.5f, 0.25f } };
+	mesh->normals() = { { 0, 0, 1 }, { 0, 0, -1 }, { 1, 0, 0 } };
+	mesh->indices() = { 0, 1, 2 };
+	mesh->updateBuffers();
+	ASSERT_EQ(mesh->getNormalCount(), 3u);
+	ASSERT_EQ(mesh->getTangentCount(), 0u);
+	ASSERT_EQ(pMesh->getBufferLayout().getStride(), 20u);
+	ASSERT_EQ(pMesh->getVertexData().size(), 3 * 20u);
+	ASSERT_EQ(pMesh->getIndexSize(), 2u);
+	auto readHalf = [pMesh](std::size_t offset)
+	{
+		std::uint16_t half;
+		std::memcpy(&half, pMesh->getVertexData().data() + offset, sizeof(half));
+		return VertexLayout::fromHalf(half);
+	};
+	auto readUInt = [pMesh](std::size_t offset)
+	{
+		std::uint32_t value;
+		std::memcpy(&value, pMesh->getVertexData().data() + offset, sizeof(value));
+		return value;
+	};
+	ASSERT_EQ(readHalf(2 * 20 + 12), 0.5f);
+	ASSERT_EQ(readHalf(2 * 20 + 14), 0.25f);
+	// Normal (0, 0, -1) is stored as z = -511, x = y = w = 0
+	ASSERT_EQ(readUInt(20 + 16), 0x201u << 20);
+	// Partial updates only touch the range
+	mesh->uvs()[1] = Vec2f { 0.75f, 0 };
+	mesh->updateBuffers(1, 1);
+	ASSERT_EQ(getLog().getCommands().back().m_value, 1u);
+	ASSERT_EQ(readHalf(20 + 12), 0.75f);
+	ASSERT_THROWS(mesh->updateBuffers(2, 2), std::invalid_argument);
+	// Changed amounts fall back to a full update
+	mesh->vertices().push_back({ 1, 1, 0 });
+	mesh->uvs().push_back({ 1, 1 });
+	mesh->normals().push_back({ 0, 1, 0 });
+	mesh->updateBuffers(3, 1);
+	ASSERT_EQ(getLog().getCommands().back().m_value, 4u);
+	ASSERT_EQ(pMesh->getVertexData().size(), 4 * 20u);
+	// Indices beyond 16 bit
+	mesh->vertices().resize(70000);
+	mesh->uvs().clear();
+	mesh->normals().clear();
+	mesh->indices() = { 0, 1, 69999 };
+	mesh->updateBuffers();
+	ASSERT_EQ(pMesh->getIndexSize(), 4u);
+	ASSERT_EQ(mesh->getUVCount(), 0u);
+	ASSERT_EQ(pMesh->getBufferLayout().getStride(), 12u);
+	// Tangent handedness
+	std::unique_ptr<IMesh> frame { Platform::get()->createMesh() };
+	frame->vertices() = { { 0, 0, 0 } };
+	frame->normals() = { { 0, 0, 1 } };
+	frame->tangents() = { { 1, 0, 0 } };
+	frame->bitangents() = { { 0, -1, 0 } };
+	frame->updateBuffers();
+	std::vector<unsigned char> const& data = static_cast<MeshHeadless*>(frame.get())->getVertexData();
+	float w = 0;
+	std::memcpy(&w, data.data() + 3 * 4 + 3 * 4 + 3 * 4, sizeof(w));
+	ASSERT_EQ(data.size(), 52u);
+	ASSERT_EQ(w, -1.0f);
+}
+
+TEST(Headless,uploadBuffers)
+{
+	getLog().clear();
+	std::unique_ptr<IMesh> source { Platform::get()->createMesh() };
+	source->setLayout(VertexLayout::makePacked());
+	source->vertices() = { { -1, -1, 0 }, { 1, -1, 0 }, { 0, 1, 0 } };
+	source->normals() = { { 0, 0, 1 }, { 0, 0, 1 }, { 0, 0, 1 } };
+	source->indices() = { 0, 1, 2 };
+	source->updateBuffers();
+	auto pSource = static_cast<MeshHeadless*>(source.get());
+	ASSERT_EQ(pSource->getIndexData().size(), 3 * 2u);
+	// Fill another mesh from the packed data only
+	std::unique_ptr<IMesh> mesh { Platform::get()->createMesh() };
+	mesh->uploadBuffers(pSource->getBufferLayout(), pSource->getVertexData().data(), 3,
+			pSource->getIndexData().data(), 3, 2);
+	auto pMesh = static_cast<MeshHeadless*>(mesh.get());
+	ASSERT(mesh->vertices().empty());
+	ASSERT_EQ(mesh->getVertexCount(), 3u);
+	ASSERT_EQ(mesh->getNormalCount(), 3u);
+	ASSERT_EQ(mesh->getUVCount(), 0u);
+	ASSERT_EQ(mesh->getIndexCount(), 3u);
+	ASSERT(mesh->getLayout() == pSource->getBufferLayout());
+	ASSERT(pMesh->getVertexData() == pSource->getVertexData());
+	ASSERT(pMesh->getIndexData() == pSource->getIndexData());
+	ASSERT_EQ(getLog().getCount(CommandLog::Type::UpdateMesh), 2u);
+	// Clones keep the buffers
+	std::unique_ptr<IMesh> clone { mesh->clone() };
+	ASSERT_EQ(clone->getVertexCount(), 3u);
+	ASSERT(static_cast<MeshHeadless*>(clone.get())->getVertexData() == pSource->getVertexData());
+	ASSERT_THROWS(mesh->uploadBuffers(pSource->getBufferLayout(), pSource->getVertexData().data(), 3,
+			pSource->getIndexData().data(), 3, 1), std::invalid_argument);
+}
+
+TEST(Headless,halfFloat)
+{
+	ASSERT_EQ(VertexLayout::toHalf(1), 0x3C00u);
+	ASSERT_EQ(VertexLayout::toHalf(-2), 0xC000u);
+	ASSERT_EQ(VertexLayout::toHalf(0), 0u);
+	ASSERT_EQ(VertexLayout::toHalf(65504), 0x7BFFu);
+	ASSERT_EQ(VertexLayout::toHalf(65520), 0x7C00u);
+	ASSERT_EQ(VertexLayout::toHalf(1e10f), 0x7C00u);
+	ASSERT_EQ(VertexLayout::fromHalf(0x7C00) > 65504, true);
+	// Smallest subnormal, and rounding to nearest even
+	ASSERT_EQ(VertexLayout::toHalf(5.9604645e-8f), 1u);
+	ASSERT_EQ(VertexLayout::toHalf(2.9802322e-8f), 0u);
+	ASSERT_EQ(VertexLayout::toHalf(1 + 1.0f / 2048), 0x3C00u);
+	ASSERT_EQ(VertexLayout::toHalf(1 + 3.0f / 2048), 0x3C02u);
+	for (std::uint16_t half : { 0x0001, 0x03FF, 0x0400, 0x3555, 0x7BFF, 0x8001, 0xBC00 })
+		ASSERT_EQ(VertexLayout::toHalf(VertexLayout::fromHalf(half)), half);
+}
+
+TEST(Headless,texture)
+{
+	getLog().clear();
+	ASSERT_THROWS(Platform::get()->curTexture()->getWidth(), std::runtime_error);
+	std::unique_ptr<ITexture> tex { Platform::get()->createTexture(ITexture::Type::TEX2D) };
+	tex->bind();
+	auto cmds = Platform::get()->curTexture();
+	unsigned char rgb[] = { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21, 22, 23, 24 };
+	cmds->write(0, 4, 2, ITextureCommands::PixelFormat::RGB, ITextureCommands::PixelType::UBYTE, rgb);
+	ASSERT_EQ(cmds->getWidth(), 4u);
+	ASSERT_EQ(cmds->getHeight(), 2u);
+	// Read back as written
+	std::vector<char> buffer(4 * 2 * 4);
+	cmds->getPixelData(ITextureCommands::PixelFormat::RGB, ITextureCommands::PixelType::UBYTE, buffer.data());
+	for (unsigned int i = 0; i < 24; i++)
+		ASSERT_EQ(static_cast<unsigned char>(buffer[i]), rgb[i]);
+	// Read back converted
+	cmds->getPixelData(ITextureCommands::PixelFormat::BGRA, ITextureCommands::PixelType::UBYTE, buffer.data());
+	ASSERT_EQ(buffer[0], 3);
+	ASSERT_EQ(buffer[1], 2);
+	ASSERT_EQ(buffer[2], 1);
+	ASSERT_EQ(static_cast<unsigned char>(buffer[3]), 0xFF);
+	ASSERT_THROWS(cmds->getPixelData(ITextureCommands::PixelFormat::RGB, ITextureCommands::PixelType::FLOAT,
+			buffer.data()), std::runtime_error);
+	// Mip maps
+	cmds->generateMipMaps();
+	unsigned int width, height;
+	cmds->getSize(width, height, 1);
+	ASSERT_EQ(width, 2u);
+	ASSERT_EQ(height, 1u);
+	cmds->getSize(width, height, 2);
+	ASSERT_EQ(width, 1u);
+	ASSERT_EQ(height, 1u);
+	// Parameters
+	cmds->setWrapMode(ITextureCommands::WrapDirection::S, ITextureCommands::WrapMode::CLAMP_TO_EDGE);
+	ASSERT(cmds->getWrapMode(ITextureCommands::WrapDirection::S) == ITextureCommands::WrapMode::CLAMP_TO_EDGE);
+	ASSERT(cmds->getWrapMode(ITextureCommands::WrapDirection::T) == ITextureCommands::WrapMode::REPEAT);
+	// Copies keep their data
+	std::unique_ptr<ITexture> clone { tex->clone() };
+	clone->bind();
+	ASSERT_EQ(cmds->getWidth(), 4u);
+	ASSERT_EQ(getLog().getCount(CommandLog::Type::BindTexture), 2u);
+	ASSERT_EQ(getLog().getCount(CommandLog::Type::WriteTexture), 1u);
+	clone.reset();
+	ASSERT_THROWS(cmds->getWidth(), std::runtime_error);
+}
+
+TEST(Headless,shaderProgram)
+{
+	std::unique_ptr<IShader> vertex { Platform::get()->createShader(IShader::Type::VERTEX,
+			"#version 330 core\n"
+			"layout(location = 0) in vec3 pos;\n"
+			"in vec2 uv; // uniform float notAUniform;\n"
+			"uniform mat4 MVP;\n"
+			"uniform highp vec3 lights[4], color;\n"
+			"/* uniform vec2 commented; */\n"
+			"out vec2 uvOut;\n"
+			"void main() { gl_Position = MVP * vec4(pos, 1); uvOut = uv; }") };
+	std::unique_ptr<IShader> fragment { Platform::get()->createShader(IShader::Type::FRAGMENT,
+			"#version 330 core\n"
+			"in vec2 uvOut;\n"
+			"uniform sampler2D tex;\n"
+			"uniform vec3 color;\n"
+			"out vec4 result;\n"
+			"void main() { result = texture(tex, uvOut) * vec4(color, 1); }") };
+	vertex->compile();
+	fragment->compile();
+	std::unique_ptr<IShaderProgram> program { Platform::get()->createShaderProgram() };
+	program->attach(vertex.get());
+	program->attach(fragment.get());
+	program->link();
+	ASSERT_EQ(program->getAttributeHandle("pos"), 0);
+	ASSERT_EQ(program->getAttributeHandle("uv"), 1);
+	ASSERT_EQ(program->getAttributeHandle("uvOut"), IShaderProgram::InvalidAttribHandle);
+	ASSERT_EQ(program->getUniformHandle("MVP"), 0);
+	ASSERT_EQ(program->getUniformHandle("lights"), 1);
+	ASSERT_EQ(program->getUniformHandle("color"), 2);
+	ASSERT_EQ(program->getUniformHandle("tex"), 3);
+	ASSERT_EQ(program->getUniformHandle("notAUniform"), IShaderProgram::InvalidUniformHandle);
+	ASSERT_EQ(program->getUniformHandle("commented"), IShaderProgram::InvalidUniformHandle);
+
+	// Uniforms are recorded along with the program in use
+	getLog().clear();
+	program->use();
+	Platform::get()->curShaderProgram()->setUniformSampler(program->getUniformHandle("tex"), 0);
+	float color[] = { 1, 0, 0 };
+	Platform::get()->curShaderProgram()->setUniformFloat3(program->getUniformHandle("color"), color);
+	auto const& commands = getLog().getCommands();
+	ASSERT_EQ(commands.size(), 3u);
+	ASSERT(commands[0].m_type == CommandLog::Type::UseProgram);
+	ASSERT(commands[1].m_type == CommandLog::Type::Uniform);
+	ASSERT_EQ(commands[1].m_object, program.get());
+	ASSERT_EQ(commands[1].m_value, 3u);
+	ASSERT_EQ(commands[2].m_value, 2u);
+}
+
+TEST(Headless,uniformBlock)
+{
+	struct Transform
+	{
+		float m_mvp[16];
+		float m_color[4];
+	};
+	std::unique_ptr<IShader> vertex { Platform::get()->createShader(IShader::Type::VERTEX,
+			"#version 330 core\n"
+			"layout(std140) uniform Transform\n"
+			"{\n"
+			"	mat4 mvp;\n"
+			"	vec4 color;\n"
+			"};\n"
+			"uniform float scale;\n"
+			"in vec3 pos;\n"
+			"void main() { gl_Position = mvp * vec4(pos * scale, 1); }") };
+	vertex->compile();
+	std::unique_ptr<IShaderProgram> program { Platform::get()->createShaderProgram() };
+	program->attach(vertex.get());
+	program->link();
+	ASSERT_EQ(program->getUniformBlockHandle("Transform"), 0);
+	ASSERT_EQ(program->getUniformBlockHandle("scale"), IShaderProgram::InvalidUniformBlockHandle);
+	ASSERT_EQ(program->getUniformHandle("Transform"), IShaderProgram::InvalidUniformHandle);
+	ASSERT_EQ(program->getUniformHandle("mvp"), IShaderProgram::InvalidUniformHandle);
+	ASSERT_EQ(program->getUniformHandle("scale"), 0);
+
+	UniformBlock<Transform> block { 2 };
+	ASSERT_EQ(block.getBuffer()->getSize(), sizeof(Transform));
+	program->use();
+	getLog().clear();
+	ASSERT(block.attach(program.get(), "Transform"));
+	ASSERT(!block.attach(program.get(), "Missing"));
+	block.bind();
+	for (unsigned int i = 0; i < 3; i++)
+	{
+		block.data().m_mvp[0] = i;
+		block.data().m_color[3] = 0.5f;
+		block.upload();
+	}
+	// All values of a block are sent in a single write
+	ASSERT_EQ(getLog().getCount(CommandLog::Type::UniformBlockBinding), 1u);
+	ASSERT_EQ(getLog().getCount(CommandLog::Type::BindUniformBuffer), 1u);
+	ASSERT_EQ(getLog().getCount(CommandLog::Type::WriteUniformBuffer), 3u);
+	ASSERT_EQ(getLog().getCount(CommandLog::Type::Uniform), 0u);
+	auto const& commands = getLog().getCommands();
+	ASSERT_EQ(commands[0].m_value, 2u);
+	ASSERT_EQ(commands.back().m_value, sizeof(Transform));
+	auto buffer = static_cast<UniformBufferHeadless*>(block.getBuffer());
+	Transform uploaded;
+	std::copy(buffer->getData().begin(), buffer->getData().end(), reinterpret_cast<char*>(&uploaded));
+	ASSERT_APPROX(uploaded.m_mvp[0], 2.0f, 1e-6f);
+	ASSERT_APPROX(uploaded.m_color[3], 0.5f, 1e-6f);
+
+	// Writes beyond the buffer are rejected
+	char bytes[8] { };
+	ASSERT_THROWS(block.getBuffer()->write(bytes, sizeof(bytes), sizeof(Transform) - 4), std::invalid_argument);
+}
+
+TEST(Headless,renderContext)
+{
+	std::unique_ptr<IRenderContext> first { Platform::get()->createRenderContext(640, 480) };
+	std::unique_ptr<IRenderContext> second { Platform::get()->createRenderContext(32, 32) };
+	std::unique_ptr<IMesh> mesh { Platform::get()->createMesh() };
+	mesh->indices() = { 0, 1, 2, 2, 1, 3 };
+	mesh->updateBuffers();
+	getLog().clear();
+	ASSERT_EQ(first->getWidth(), 640);
+	ASSERT_EQ(second->getHeight(), 32);
+	first->setDepthTest(IRenderContext::DepthTestValue::LessEqual);
+	first->setAlphaBlend(IRenderContext::AlphaBlendValue::SrcAlpha, IRenderContext::AlphaBlendValue::OneMinusSrcAlpha);
+	first->clear(IRenderContext::COLOR | IRenderContext::DEPTH);
+	first->drawMesh(mesh.get());
+	first->drawMesh(mesh.get());
+	second->drawMesh(mesh.get());
+	ASSERT(first->getDepthTest() == IRenderContext::DepthTestValue::LessEqual);
+	ASSERT(first->getSrcAlphaBlend() == IRenderContext::AlphaBlendValue::SrcAlpha);
+	ASSERT(first->getDestAlphaBlend() == IRenderContext::AlphaBlendValue::OneMinusSrcAlpha);
+	ASSERT(second->isBound());
+	ASSERT(!first->isBound());
+	ASSERT_EQ(getLog().getCount(CommandLog::Type::BindContext), 2u);
+	ASSERT_EQ(getLog().getCount(CommandLog::Type::DrawMesh), 3u);
+	ASSERT_EQ(getLog().getDrawnIndices(), 18u);
+	ASSERT_EQ(getLog().getStateChanges(), 2u);
+	ASSERT_EQ(getLog().getCount(CommandLog::Type::Clear), 1u);
+	// Draw order is preserved
+	std::vector<void const*> drawn;
+	for (auto const& cmd : getLog().getCommands())
+		if (cmd.m_type == CommandLog::Type::DrawMesh || cmd.m_type == CommandLog::Type::BindContext)
+			drawn.push_back(cmd.m_object);
+	std::vector<void const*> expected { first.get(), mesh.get(), mesh.get(), second.get(), mesh.get() };
+	ASSERT(drawn == expected);
+	// Nothing is rendered
+	char pixels[4] = { 1, 1, 1, 1 };
+	second->readPixels(0, 0, 1, 1, ITextureCommands::PixelFormat::RGBA, ITextureCommands::PixelType::UBYTE, 4,
+			pixels);
+	ASSERT_EQ(pixels[3], 0);
+}
+
+TEST(Headless,stateBlock)
+{
+	RenderStateBlock const defaults { };
+	RenderStateBlock const opaque = defaults.withDepthTest(IRenderContext::DepthTestValue::Less).withFaceCulling(
+			IRenderContext::FaceCullingValue::Back);
+	RenderStateBlock const translucent = opaque.withDepthBuffer(false).withAlphaBlend(
+			IRenderContext::AlphaBlendValue::SrcAlpha, IRenderContext::AlphaBlendValue::OneMinusSrcAlpha);
+	ASSERT(opaque.getDepthTest() == IRenderContext::DepthTestValue::Less);
+	ASSERT(defaults.getDepthTest() == IRenderContext::DepthTestValue::Always);
+	ASSERT_EQ(defaults.diff(defaults), 0u);
+	ASSERT(defaults != opaque);
+	unsigned int diff = opaque.diff(translucent);
+	ASSERT(RenderStateBlock::contains(diff, RenderStateBlock::State::DepthBuffer));
+	ASSERT(RenderStateBlock::contains(diff, RenderStateBlock::State::AlphaBlend));
+	ASSERT(!RenderStateBlock::contains(diff, RenderStateBlock::State::DepthTest));
+	ASSERT(!RenderStateBlock::contains(diff, RenderStateBlock::State::ColorBuffer));
+
+	std::unique_ptr<IRenderContext> rc { Platform::get()->createRenderContext(640, 480) };
+	ASSERT(rc->getStateBlock() == defaults);
+	rc->bind();
+	getLog().clear();
+	// Only the differences are applied
+	rc->apply(opaque);
+	ASSERT_EQ(getLog().getStateChanges(), 2u);
+	rc->apply(opaque);
+	ASSERT_EQ(getLog().getStateChanges(), 2u);
+	rc->apply(translucent);
+	ASSERT_EQ(getLog().getStateChanges(), 4u);
+	ASSERT_EQ(getLog().getCount(CommandLog::Type::DepthBuffer), 1u);
+	ASSERT(rc->getStateBlock() == translucent);
+	// Redundant individual requests are filtered as well
+	rc->setDepthTest(IRenderContext::DepthTestValue::Less);
+	rc->enableDepthBuffer(false);
+	ASSERT_EQ(getLog().getStateChanges(), 4u);
+	rc->enableDepthBuffer(true);
+	ASSERT_EQ(getLog().getStateChanges(), 5u);
+	// Every request is counted
+	auto& counters = rc->getStateCounters();
+	ASSERT_EQ(counters.getRequested(), 3 * RenderStateBlock::s_stateCount + 3);
+	ASSERT_EQ(counters.getIssued(), 5u);
+	ASSERT_EQ(counters.getRedundant(), counters.getRequested() - 5);
+	ASSERT_EQ(counters.getRequested(RenderStateBlock::State::DepthBuffer), 5u);
+	ASSERT_EQ(counters.getIssued(RenderStateBlock::State::DepthBuffer), 2u);
+	counters.reset();
+	ASSERT_EQ(rc->getStateCounters().getRequested(), 0u);
+}
+
+TEST(Headless,window)
+{
+	ASSERT_THROWS(Platform::get()->createWindow(), std::runtime_error);
+	std::unique_ptr<IMonitor> monitor { Platform::get()->createMonitor() };
+	int width = 0, height = 0;
+	monitor->getResolution(width, height);
+	ASSERT(width > 0 && height > 0);
+	std::unique_ptr<ITimer> timer { Platform::get()->createTimer() };
+	ASSERT(timer->getTime() >= 0);
+	ASSERT(timer->getDelta() >= 0);
+}
+
+TEST(Headless,mappedFile)
+{
+	{
+		std::ofstream file { "mappedFile.txt", std::ios::binary };
+		file << "v 1 2 3\n";
+	}
+	MappedFile file { Filename { "mappedFile.txt" } };
+	ASSERT(!file.isOpen());
+	ASSERT(file.open());
+	ASSERT_EQ(file.getSize(), 8u);
+	ASSERT_EQ(std::string(file.getData(), file.getSize()), std::string("v 1 2 3\n"));
+	file.close();
+	ASSERT(file.getData() == nullptr);
+	// Empty files can be opened, but have no data
+	{
+		std::ofstream empty { "mappedFile.txt", std::ios::binary | std::ios::trunc };
+	}
+	ASSERT(file.open());
+	ASSERT_EQ(file.getSize(), 0u);
+	ASSERT(file.getData() == nullptr);
+	std::remove("mappedFile.txt");
+	MappedFile missing { Filename { "mappedFile.txt" } };
+	ASSERT(!missing.open());
+	ASSERT(!missing.isOpen());
+}
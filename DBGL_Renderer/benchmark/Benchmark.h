@@ -0,0 +1,26 @@
+//////////////////////////////////////////////////////////////////////
+/// Dragon Blaze Game Library
+///
+/// Copyright (c) 2015 by Jan Moeller
+///
+/// This software is provided "as-is" and does not claim to be
+/// complete or free of bugs in any way. It should work, but
+/// it might also begin to hurt your kittens.
+//////////////////////////////////////////////////////////////////////
+
+#ifndef DBGL_RENDERER_BENCHMARK_BENCHMARK_H_
+#define DBGL_RENDERER_BENCHMARK_BENCHMARK_H_
+
+namespace dbgl_benchmark
+{
+	/**
+	 * @brief Renders 100k entities with the ForwardRenderer on the headless platform
+	 */
+	void forwardRenderer();
+	/**
+	 * @brief Compares the radix sort of DrawQueue to std::stable_sort on 100k opaque draws
+	 */
+	void drawQueueSort();
+}
+
+#endif /* DBGL_RENDERER_BENCHMARK_BENCHMARK_H_ */
@@ -0,0 +1,60 @@
+//////////////////////////////////////////////////////////////////////
+/// Dragon Blaze Game Library
+///
+/// Copyright (c) 2015 by Jan Moeller
+///
+/// This software is provided "as-is" and does not claim to be
+/// complete or free of bugs in any way. It should work, but
+/// it might also begin to hurt your kittens.
+//////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <vector>
+#include "DBGL/Renderer/DrawQueue/DrawQueue.h"
+#include "../Benchmark.h"
+
+using namespace dbgl;
+using namespace std;
+
+namespace dbgl_benchmark
+{
+	void drawQueueSort()
+	{
+		std::mt19937 rng { 6 };
+		std::uniform_int_distribution<int> material { 0, 99 };
+		std::uniform_real_distribution<float> depth { 0, 1 };
+		std::vector<DrawQueue::Item> items;
+		for (unsigned int i = 0; i < 100000; i++)
+		{
+			int m = material(rng);
+			items.push_back( { DrawQueue::makeOpaqueKey(m, nullptr, depth(rng)), nullptr, nullptr, m, false });
+		}
+		DrawQueue queue { };
+		auto start = chrono::high_resolution_clock::now();
+		for (unsigned int i = 0; i < 10; i++)
+		{
+			queue.clear();
+			queue.append(items);
+			queue.sort();
+		}
+		auto end = chrono::high_resolution_clock::now();
+		auto compare = [](DrawQueue::Item const& lhs, DrawQueue::Item const& rhs)
+		{
+			return lhs.m_key < rhs.m_key;
+		};
+		auto startStd = chrono::high_resolution_clock::now();
+		std::vector<DrawQueue::Item> copy;
+		for (unsigned int i = 0; i < 10; i++)
+		{
+			copy = items;
+			std::stable_sort(copy.begin(), copy.end(), compare);
+		}
+		auto endStd = chrono::high_resolution_clock::now();
+		cout << "  100k draws: radix " << chrono::duration<double, milli>(end - start).count() / 10
+				<< " ms, std::stable_sort " << chrono::duration<double, milli>(endStd - startStd).count() / 10
+				<< " ms" << endl;
+	}
+}
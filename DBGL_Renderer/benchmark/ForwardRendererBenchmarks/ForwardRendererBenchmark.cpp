@@ -0,0 +1,198 @@
+//////////////////////////////////////////////////////////////////////
+/// Dragon Blaze Game Library
+///
+/// Copyright (c) 2015 by Jan Moeller
+///
+/// This software is provided "as-is" and does not claim to be
+/// complete or free of bugs in any way. It should work, but
+/// it might also begin to hurt your kittens.
+//////////////////////////////////////////////////////////////////////
+
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <vector>
+#include "DBGL/Renderer/ForwardRenderer/ForwardRenderer.h"
+#include "DBGL/Platform/Implementation/Headless.h"
+#include "DBGL/Platform/RenderContext/RenderStateBlock.h"
+#include "../Benchmark.h"
+
+using namespace dbgl;
+using namespace std;
+
+namespace dbgl_benchmark
+{
+	namespace
+	{
+		class CameraStub: public ICameraEntity
+		{
+		public:
+			CameraStub()
+			{
+				m_view = Mat4f::makeView(m_position, m_direction, m_up);
+				m_projection = Mat4f::makeProjection(getFieldOfView(), getRatio(), getNear(), getFar());
+			}
+			virtual Mat4f const& getViewMatrix()
+			{
+				return m_view;
+			}
+			virtual Mat4f const& getProjectionMatrix()
+			{
+				return m_projection;
+			}
+			virtual Vec3f const& getPosition()
+			{
+				return m_position;
+			}
+			virtual Vec3f const& getDirection()
+			{
+				return m_direction;
+			}
+			virtual Vec3f const& getUp()
+			{
+				return m_up;
+			}
+			virtual float getNear()
+			{
+				return 0.1f;
+			}
+			virtual float getFar()
+			{
+				return 80;
+			}
+			virtual float getFieldOfView()
+			{
+				return 1;
+			}
+			virtual float getRatio()
+			{
+				return 4.0f / 3;
+			}
+
+			Vec3f m_position { 0, 0, 0 };
+			Vec3f m_direction { 0, 0, -1 };
+			Vec3f m_up { 0, 1, 0 };
+			Mat4f m_view;
+			Mat4f m_projection;
+		};
+
+		class EntityStub: public IRenderEntity
+		{
+		public:
+			EntityStub(Sphere<float> const& sphere, int material, bool translucent, bool dynamic,
+					unsigned int* pDrawn)
+					: m_sphere { sphere }, m_material { material }, m_translucent { translucent },
+							m_dynamic { dynamic }, m_pDrawn { pDrawn }
+			{
+			}
+			virtual bool isTranslucent()
+			{
+				return m_translucent;
+			}
+			virtual bool isStatic()
+			{
+				return !m_dynamic;
+			}
+			virtual bool isInstanced()
+			{
+				return false;
+			}
+			virtual void setupUnique()
+			{
+				(*m_pDrawn)++;
+			}
+			virtual void setupMaterial()
+			{
+			}
+			virtual int getMaterialId()
+			{
+				return m_material;
+			}
+			virtual Sphere<float> const& getBoundingSphere()
+			{
+				return m_sphere;
+			}
+			virtual Mat4f const& getModelMatrix()
+			{
+				return m_model;
+			}
+			virtual IMesh* getMesh()
+			{
+				return nullptr;
+			}
+			virtual unsigned int getLodCount()
+			{
+				return 1;
+			}
+			virtual IMesh* getLodMesh(unsigned int)
+			{
+				return nullptr;
+			}
+			virtual float getLodError(unsigned int)
+			{
+				return 0;
+			}
+
+			Sphere<float> m_sphere;
+			int m_material;
+			bool m_translucent;
+			bool m_dynamic;
+			unsigned int* m_pDrawn;
+			Mat4f m_model;
+		};
+
+		std::vector<std::unique_ptr<EntityStub>> randomEntities(unsigned int amount, unsigned int seed,
+				unsigned int* pDrawn)
+		{
+			std::mt19937 rng { seed };
+			std::uniform_real_distribution<float> pos { -100, 100 };
+			std::uniform_real_distribution<float> rad { 0.1f, 2 };
+			std::uniform_int_distribution<int> material { 0, 9 };
+			std::uniform_int_distribution<int> kind { 0, 19 };
+			std::vector<std::unique_ptr<EntityStub>> entities;
+			for (unsigned int i = 0; i < amount; i++)
+			{
+				Sphere<float> sphere { Vec3f { pos(rng), pos(rng), pos(rng) }, rad(rng) };
+				int k = kind(rng);
+				entities.emplace_back(new EntityStub { sphere, material(rng), k == 0, k % 2 == 1, pDrawn });
+			}
+			return entities;
+		}
+	}
+
+	void forwardRenderer()
+	{
+		Platform::init<Headless>();
+		{
+			unsigned int drawn = 0;
+			auto entities = randomEntities(100000, 5, &drawn);
+			CameraStub camera { };
+			std::unique_ptr<IRenderContext> rc { Platform::get()->createRenderContext(800, 600) };
+			CommandLog& commands = static_cast<Headless*>(Platform::get())->getLog();
+			ForwardRenderer renderer { };
+			renderer.setCameraEntity(&camera);
+			for (auto const& e : entities)
+				renderer.addEntity(e.get());
+			renderer.render(rc.get());
+			// Only count commands, storing them would distort the timings
+			commands.setStoreCommands(false);
+			commands.clear();
+			rc->getStateCounters().reset();
+			auto start = chrono::high_resolution_clock::now();
+			for (unsigned int frame = 0; frame < 10; frame++)
+			{
+				drawn = 0;
+				renderer.render(rc.get());
+			}
+			auto end = chrono::high_resolution_clock::now();
+			double seconds = chrono::duration<double> { end - start }.count();
+			cout << "  100k entities, 10 frames: " << seconds * 100 << " ms per frame, " << drawn << " drawn" << endl;
+			cout << "  " << 1e6 / seconds << " entities culled/s, "
+					<< commands.getCount(CommandLog::Type::DrawMesh) / seconds << " draws/s" << endl;
+			cout << "  " << commands.getStateChanges() / 10 << " state changes per frame, "
+					<< rc->getStateCounters().getRedundant() / 10 << " redundant ones filtered" << endl;
+		}
+		Platform::destroy();
+	}
+}
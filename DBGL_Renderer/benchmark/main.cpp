@@ -0,0 +1,25 @@
+//////////////////////////////////////////////////////////////////////
+/// Dragon Blaze Game Library
+///
+/// Copyright (c) 2015 by Jan Moeller
+///
+/// This software is provided "as-is" and does not claim to be
+/// complete or free of bugs in any way. It should work, but
+/// it might also begin to hurt your kittens.
+//////////////////////////////////////////////////////////////////////
+
+#include <iostream>
+#include "Benchmark.h"
+
+/**
+ * @brief Runs all renderer benchmarks and prints their timings
+ * @details Kept apart from the unit tests, so test runs stay fast and quiet.
+ */
+int main()
+{
+	std::cout << "ForwardRenderer..." << std::endl;
+	dbgl_benchmark::forwardRenderer();
+	std::cout << "DrawQueue sort..." << std::endl;
+	dbgl_benchmark::drawQueueSort();
+	return 0;
+}
@@ -11,6 +11,7 @@
 #include <iostream>
 #include <string>
 #include <list>
+#include <vector>
 #include <random>
 #include "DBGL/Platform/Platform.h"
 #include "DBGL/Platform/Implementation/OpenGL33.h"
@@ -29,6 +30,7 @@ IRenderer* pRenderer = nullptr;
 ITimer* pTimer = nullptr;
 IWindow* pWnd = nullptr;
 IMesh* pSphere = nullptr;
+std::vector<MeshUtility::LevelOfDetail> sphereLods;
 IShaderProgram* pShaderProgram = nullptr;
 IShaderProgram* pShaderProgramSprite = nullptr;
 ITexture* pTex = nullptr;
@@ -124,6 +126,10 @@ public:
 	{
 		return true;
 	}
+	virtual bool isInstanced()
+	{
+		return false;
+	}
 	virtual void setupUnique()
 	{
 		// Use shader
@@ -168,6 +174,18 @@ public:
 	{
 		return m_pMesh;
 	}
+	virtual unsigned int getLodCount()
+	{
+		return sphereLods.size();
+	}
+	virtual IMesh* getLodMesh(unsigned int lod)
+	{
+		return sphereLods[lod].m_mesh;
+	}
+	virtual float getLodError(unsigned int lod)
+	{
+		return sphereLods[lod].m_error;
+	}
 	virtual Sphere<float> const& getBoundingSphere()
 	{
 		return m_bounds;
@@ -284,6 +302,7 @@ int main()
 	pWnd->getRenderContext().setFaceCulling(IRenderContext::FaceCullingValue::Back);
 	cout << "Initializing default meshes, textures and shader..." << endl;
 	pSphere = MeshUtility::createIcoSphere(4, true, IMesh::Usage::StaticDraw);
+	sphereLods = MeshUtility::generateLODChain(pSphere, 5);
 	pShaderProgram = loadShader("Assets/Shaders/CamLight.vert", "Assets/Shaders/CamLight.frag");
 	pShaderProgramSprite = loadShader("Assets/Shaders/Sprite.vert", "Assets/Shaders/Sprite.frag");
 	pFont = new BitmapFont{};
@@ -307,6 +326,8 @@ int main()
 		pFont->drawText(&pWnd->getRenderContext(), pShaderProgramSprite, std::to_string(pRenderer->getFPS()), 10, pWnd->getFrameHeight() - pFont->getLineHeight() - 10);
 		pWnd->swapBuffer();
 	}
+	for (std::size_t i = 1; i < sphereLods.size(); i++)
+		delete sphereLods[i].m_mesh;
 	delete pSphere;
 	delete pShaderProgram;
 	delete pShaderProgramSprite;
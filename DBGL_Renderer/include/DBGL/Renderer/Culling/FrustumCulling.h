@@ -11,6 +11,7 @@
 #ifndef INCLUDE_DBGL_RENDERER_CULLING_FRUSTUMCULLING_H_
 #define INCLUDE_DBGL_RENDERER_CULLING_FRUSTUMCULLING_H_
 
+#include <cstddef>
 #include "DBGL/Core/Shape/Shapes.h"
 #include "DBGL/Core/Math/Matrix4x4.h"
 #include "DBGL/Core/Math/Vector3.h"
@@ -29,27 +30,42 @@ namespace dbgl
 		 */
 		FrustumCulling();
 		/**
-		 * @brief Updates the frustum planes internally
+		 * @brief Updates the frustum planes and the view-projection matrix internally
 		 */
 		void update();
 		/**
 		 * @brief Checks if a point is within the frustum
 		 * @param point Point in world space
 		 * @return True if the point lies within the frustum, otherwise false
+		 * @note Uses the camera matrices as of the last call to update()
 		 */
-		bool checkPoint(Vec3f const& point);
+		bool checkPoint(Vec3f const& point) const;
+		/**
+		 * @brief Checks for multiple points if they are within the frustum
+		 * @param points Points in world space
+		 * @param results Array of at least \p n elements, receives true for every point within the frustum
+		 * @param n Amount of points
+		 * @note Uses the camera matrices as of the last call to update(). Doesn't allocate, thus it may be called
+		 * 		 from multiple threads at once.
+		 */
+		void checkPoints(Vec3f const* points, bool* results, std::size_t n) const;
 		/**
 		 * @brief Checks if a sphere intersects the frustum
 		 * @param center Center of the sphere in world space
 		 * @param radius Sphere radius
 		 * @return True in case the sphere intersects the frustum, otherwise false
 		 */
-		bool checkSphere(Vec3f const& center, float radius);
+		bool checkSphere(Vec3f const& center, float radius) const;
 		/**
 		 * @brief Provides a bounding sphere of the frustum
 		 * @return The bounding sphere
 		 */
 		Sphere<float> const& getBoundingSphere() const;
+		/**
+		 * @brief Provides the planes of the frustum
+		 * @return Array of six planes in order near, far, left, right, top, bottom. All normals point inwards.
+		 */
+		Plane<float> const* getPlanes() const;
 		/**
 		 * @brief Set new camera
 		 * @param pCam New camera
@@ -64,6 +80,11 @@ namespace dbgl
 		ICameraEntity* m_pCam = nullptr;
 		Plane<float> m_planes[6]; //near, far, left, right, top, bottom;
 		Sphere<float> m_boundingSphere;
+		Mat4f m_viewProjection;
+		/**
+		 * @brief Amount of points checkPoints() projects at once on the stack
+		 */
+		static constexpr std::size_t s_chunkSize = 256;
 	};
 }
 
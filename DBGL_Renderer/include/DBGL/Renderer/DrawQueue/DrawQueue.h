@@ -0,0 +1,189 @@
+//////////////////////////////////////////////////////////////////////
+/// Dragon Blaze Game Library
+///
+/// Copyright (c) 2015 by Jan Moeller
+///
+/// This software is provided "as-is" and does not claim to be
+/// complete or free of bugs in any way. It should work, but
+/// it might also begin to hurt your kittens.
+//////////////////////////////////////////////////////////////////////
+
+#ifndef INCLUDE_DBGL_RENDERER_DRAWQUEUE_DRAWQUEUE_H_
+#define INCLUDE_DBGL_RENDERER_DRAWQUEUE_DRAWQUEUE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "DBGL/Renderer/Entity/IRenderEntity.h"
+#include "DBGL/Platform/RenderContext/IRenderContext.h"
+
+namespace dbgl
+{
+	/**
+	 * @brief List of draws that are submitted in the order given by a 64 bit sort key per draw
+	 * @details Keys are built by makeOpaqueKey() or makeTranslucentKey(), which pack a layer, the material id, the
+	 *          mesh and the quantized view depth into a single integer. Sorting the queue then only has to compare
+	 *          integers, which is done by a radix sort. Layers are drawn in ascending order, e.g. to draw a skybox
+	 *          or overlays independently of the rest of the scene.
+	 */
+	class DrawQueue
+	{
+	public:
+		using Key = std::uint64_t;
+
+		/**
+		 * @brief Single draw
+		 */
+		struct Item
+		{
+			Key m_key;
+			IRenderEntity* m_entity;
+			/**
+			 * @brief Mesh to draw, i.e. the level of detail of the entity picked by the renderer
+			 */
+			IMesh* m_mesh;
+			int m_material;
+			/**
+			 * @brief Result of IRenderEntity::isInstanced()
+			 */
+			bool m_instanced;
+		};
+
+		/**
+		 * @brief Amount of bits used for the layer
+		 */
+		static constexpr unsigned int s_layerBits = 4;
+		/**
+		 * @brief Amount of bits used for the material id
+		 */
+		static constexpr unsigned int s_materialBits = 16;
+		/**
+		 * @brief Amount of bits used for the mesh
+		 */
+		static constexpr unsigned int s_meshBits = 16;
+		/**
+		 * @brief Amount of bits used for the quantized depth
+		 */
+		static constexpr unsigned int s_depthBits = 28;
+
+		/**
+		 * @brief Builds the sort key of an opaque draw
+		 * @details Opaque draws are ordered by layer, then by material and mesh to minimize state changes, then
+		 *          front-to-back so that early depth tests can reject as many fragments as possible.
+		 * @param material Material id of the draw. Only the lowest 16 bits are used, thus draws of materials that
+		 *                 share them might not be grouped. They are still drawn correctly.
+		 * @param mesh Mesh of the draw
+		 * @param depth View depth, normalized to [0, 1]. Values outside are clamped.
+		 * @param layer Layer to draw in, only the lowest 4 bits are used
+		 * @return The sort key
+		 */
+		static Key makeOpaqueKey(int material, IMesh const* mesh, float depth, unsigned int layer = 0);
+		/**
+		 * @brief Builds the sort key of a translucent draw
+		 * @details Translucent draws are ordered by layer, then back-to-front, so that they blend correctly.
+		 *          Draws at the same depth are grouped by material and mesh.
+		 * @param material Material id of the draw. Only the lowest 16 bits are used.
+		 * @param mesh Mesh of the draw
+		 * @param depth View depth, normalized to [0, 1]. Values outside are clamped.
+		 * @param layer Layer to draw in, only the lowest 4 bits are used
+		 * @return The sort key
+		 */
+		static Key makeTranslucentKey(int material, IMesh const* mesh, float depth, unsigned int layer = 0);
+		/**
+		 * @brief Removes all draws
+		 */
+		void clear();
+		/**
+		 * @brief Adds a draw
+		 * @param item Draw to add
+		 */
+		void push(Item const& item);
+		/**
+		 * @brief Adds a range of draws
+		 * @param items Draws to add
+		 */
+		void append(std::vector<Item> const& items);
+		/**
+		 * @brief Sorts all draws by ascending key
+		 * @details Draws with identical keys keep their relative order.
+		 */
+		void sort();
+		/**
+		 * @brief Draws all entities in their current order
+		 * @details setupMaterial() is only called if the previously drawn entity had a different material.
+		 *          Consecutive instanced entities that share material and mesh are drawn by a single instanced draw,
+		 *          streaming their model matrices into \p instances. setupUnique() is called on all other entities,
+		 *          which are drawn one by one.
+		 * @param rc Render context to draw to
+		 * @param instances Instance buffer to use. If this is nullptr, instanced entities are drawn one by one as
+		 *                  well.
+		 * @return Amount of calls to setupMaterial()
+		 */
+		unsigned int submit(IRenderContext* rc, IInstanceBuffer* instances = nullptr);
+		/**
+		 * @brief Finds the end of a run of draws that can be drawn instanced
+		 * @param begin Index of the first draw of the run
+		 * @return Index past the last consecutive instanced draw that shares material and mesh with the draw at
+		 *         \p begin, or \p begin + 1 if that draw isn't instanced
+		 */
+		std::size_t getRunEnd(std::size_t begin) const;
+		/**
+		 * @brief Draws a mesh once per model matrix
+		 * @details The matrices are appended to \p instances. If they exceed its capacity, they are split into
+		 *          multiple draws.
+		 * @param rc Render context to draw to
+		 * @param instances Instance buffer to use
+		 * @param mesh Mesh to draw
+		 * @param matrices Model matrices of all instances
+		 * @param count Amount of instances
+		 */
+		static void drawInstanced(IRenderContext* rc, IInstanceBuffer* instances, IMesh* mesh, Mat4f const* matrices,
+				std::size_t count);
+		/**
+		 * @brief Retrieves the amount of draws
+		 * @return Amount of draws
+		 */
+		std::size_t size() const;
+		/**
+		 * @brief Checks if there are any draws
+		 * @return True if there are no draws, otherwise false
+		 */
+		bool empty() const;
+		/**
+		 * @brief Provides access to a draw
+		 * @param index Index of the draw
+		 * @return The draw
+		 */
+		Item const& operator[](std::size_t index) const;
+		/**
+		 * @brief Iterator to the first draw
+		 * @return Iterator
+		 */
+		std::vector<Item>::const_iterator begin() const;
+		/**
+		 * @brief Iterator past the last draw
+		 * @return Iterator
+		 */
+		std::vector<Item>::const_iterator end() const;
+	private:
+		/**
+		 * @brief Queues smaller than this are sorted by comparison instead
+		 */
+		static constexpr std::size_t s_minRadixSize = 256;
+
+		static Key quantizeDepth(float depth);
+		static Key hashMesh(IMesh const* mesh);
+
+		std::vector<Item> m_items;
+		/**
+		 * @brief Scratch buffer for the radix sort
+		 */
+		std::vector<Item> m_buffer;
+		/**
+		 * @brief Scratch buffer for the model matrices of instanced draws
+		 */
+		std::vector<Mat4f> m_instanceMatrices;
+	};
+}
+
+#endif /* INCLUDE_DBGL_RENDERER_DRAWQUEUE_DRAWQUEUE_H_ */
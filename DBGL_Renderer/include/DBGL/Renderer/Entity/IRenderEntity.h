@@ -37,6 +37,15 @@ namespace dbgl
 		 * @return True if static, otherwise false
 		 */
 		virtual bool isStatic() = 0;
+		/**
+		 * @brief Checks if the entity may be drawn along with other entities of the same mesh and material in a
+		 *        single instanced draw
+		 * @return True if the entity is instanced, otherwise false
+		 * @note setupUnique() is not called for instanced entities. Instead, the shader set up by setupMaterial()
+		 * 		 reads the model matrix of each instance from the vertex attributes starting at
+		 * 		 IRenderContext::s_instanceAttribute.
+		 */
+		virtual bool isInstanced() = 0;
 		/**
 		 * @brief Sets all render states and shader uniforms, that are unique to this entity.
 		 * @note This method is guaranteed to be called before rendering of each entity.
@@ -70,6 +79,26 @@ namespace dbgl
 		 * @return Pointer to the mesh
 		 */
 		virtual IMesh* getMesh() = 0;
+		/**
+		 * @brief Retrieves the amount of levels of detail of this entity
+		 * @return Amount of levels of detail, at least 1
+		 */
+		virtual unsigned int getLodCount() = 0;
+		/**
+		 * @brief Retrieves the mesh of a level of detail
+		 * @param lod Level of detail, smaller than getLodCount(). Level 0 is the mesh returned by getMesh(), higher
+		 * 			  levels are increasingly coarse.
+		 * @return Pointer to the mesh
+		 */
+		virtual IMesh* getLodMesh(unsigned int lod) = 0;
+		/**
+		 * @brief Retrieves the geometric error of a level of detail
+		 * @param lod Level of detail, smaller than getLodCount()
+		 * @return Approximate distance of the surface of the level to the one of level 0, relative to the radius of
+		 * 		   the bounding sphere. Levels with greater errors are picked for smaller projected bounding spheres.
+		 * @see MeshUtility::generateLODChain()
+		 */
+		virtual float getLodError(unsigned int lod) = 0;
 	};
 }
 
@@ -11,12 +11,15 @@
 #ifndef INCLUDE_DBGL_RENDERER_FORWARDRENDERER_FORWARDRENDERER_H_
 #define INCLUDE_DBGL_RENDERER_FORWARDRENDERER_FORWARDRENDERER_H_
 
+#include <cstddef>
 #include <vector>
 #include <functional>
 #include "DBGL/Renderer/IRenderer.h"
 #include "DBGL/Renderer/Culling/FrustumCulling.h"
+#include "DBGL/Renderer/DrawQueue/DrawQueue.h"
 #include "DBGL/Core/Collection/Tree/BoundingVolumeHierarchy.h"
 #include "DBGL/Core/Shape/Shapes.h"
+#include "DBGL/Core/Utility/ThreadPool.h"
 #include "DBGL/Platform/Shader/IShaderProgram.h"
 #include "DBGL/Platform/Platform.h"
 
@@ -24,6 +27,20 @@ namespace dbgl
 {
 	/**
 	 * @brief Implements a forward renderer
+	 * @details Every frame is processed as a pipeline: the opaque and translucent entities are culled in partitions
+	 *          in a single pass on the renderer's worker threads, each partition picks the levels of detail and
+	 *          builds its own draw list along with the sort keys, and the lists are gathered in a DrawQueue and
+	 *          sorted. The workers are started once with the renderer and reused every frame. Only the final
+	 *          submission of the queue runs on the calling thread and touches the render context. Therefore
+	 *          getBoundingSphere(), getModelMatrix(), getMaterialId(), getMesh(), the level of detail getters,
+	 *          isInstanced() and isStatic() of different entities may be called concurrently, while setupUnique()
+	 *          and setupMaterial() are only called on the thread that calls render(). Every visible entity is drawn
+	 *          with its coarsest level of detail whose error, projected to the screen, stays within the tolerance
+	 *          set by setLodTolerance(). Opaque entities are drawn grouped by material and front-to-back,
+	 *          translucent entities back-to-front. setupMaterial() is skipped if the previously drawn entity has
+	 *          the same material. Consecutive instanced entities that share material and mesh are drawn with a
+	 *          single instanced draw, see DrawQueue::submit(). Their model matrices are streamed into an instance
+	 *          buffer that is used as a ring buffer across frames.
 	 */
 	class ForwardRenderer: public IRenderer
 	{
@@ -45,21 +62,119 @@ namespace dbgl
 		virtual unsigned int getFPS() const;
 		void setUseZPrePass(bool use);
 		bool getUseZPrePass() const;
+		/**
+		 * @brief Sets the maximum error of the levels of detail drawn
+		 * @param tolerance Maximum projected error of a level of detail, relative to the screen height. A value of
+		 * 					0 always draws the most detailed level.
+		 */
+		void setLodTolerance(float tolerance);
+		/**
+		 * @brief Retrieves the maximum error of the levels of detail drawn
+		 * @return Maximum projected error of a level of detail, relative to the screen height
+		 */
+		float getLodTolerance() const;
 	private:
+		using EntityBVH = BoundingVolumeHierarchy<IRenderEntity*, Sphere<float>>;
+
+		/**
+		 * @brief Camera properties needed to cull entities and compute their sort keys
+		 */
+		struct View
+		{
+			Vec3f m_position;
+			Vec3f m_direction;
+			float m_near;
+			/**
+			 * @brief Inverse depth of the view frustum, maps view depths to [0, 1]
+			 */
+			float m_depthScale;
+			/**
+			 * @brief Screen height covered by a distance of 1 at a view depth of 1
+			 */
+			float m_lodScale;
+		};
+
+		/**
+		 * @brief Minimum amount of entities worth a partition of their own
+		 */
+		static constexpr std::size_t s_minPartitionSize = 1024;
+		/**
+		 * @brief Amount of partitions per thread, more partitions balance the load better
+		 */
+		static constexpr unsigned int s_partitionsPerThread = 4;
+		/**
+		 * @brief Amount of model matrices the instance buffer can hold
+		 */
+		static constexpr unsigned int s_instanceCapacity = 16384;
+
 		void renderWithZPrePass(IRenderContext* rc);
 		void renderWithoutZPrePass(IRenderContext* rc);
 		void cullAll();
+		void updateBVH();
+		void rebuildBVH();
+		/**
+		 * @brief Culls a subtree of the BVH and builds its draw list
+		 * @param partition Index of the subtree within m_partitions
+		 * @param view Camera properties
+		 * @param list Draw list to fill
+		 */
+		void cullOpaque(std::size_t partition, View const& view, std::vector<DrawQueue::Item>& list) const;
+		/**
+		 * @brief Culls a range of translucent entities and builds its draw list
+		 * @param partition Index of the range
+		 * @param partitions Amount of ranges the translucent entities are split into
+		 * @param view Camera properties
+		 * @param list Draw list to fill
+		 */
+		void cullTranslucent(std::size_t partition, std::size_t partitions, View const& view,
+				std::vector<DrawQueue::Item>& list) const;
+		/**
+		 * @brief Picks the coarsest level of detail of an entity that is within the tolerance
+		 * @param entity Entity to pick the level of detail of
+		 * @param sphere Bounding sphere of the entity
+		 * @param position Camera position
+		 * @param lodScale Screen height covered by a distance of 1 at a view depth of 1
+		 * @return The mesh to draw
+		 */
+		IMesh* selectLod(IRenderEntity* entity, Sphere<float> const& sphere, Vec3f const& position,
+				float lodScale) const;
+		unsigned int getPartitionCount(std::size_t entities) const;
+		void gather(std::size_t begin, std::size_t end, DrawQueue& queue);
 
 		std::vector<IRenderEntity*> m_translucentEntities; // TODO: Use more appropriate data structure
+		/**
+		 * @brief All opaque entities, static and dynamic. After rebuildBVH() the entity at index i has handle i.
+		 */
 		std::vector<IRenderEntity*> m_entities;
-		BoundingVolumeHierarchy<IRenderEntity*, Sphere<float>> m_bvh;
-		std::vector<IRenderEntity*> m_bvhCulledEntities;
-		std::vector<IRenderEntity*> m_translucentEntitiesCulled;
-		std::vector<IRenderEntity*> m_entitiesCulled;
+		EntityBVH m_bvh;
+		/**
+		 * @brief Handles of all dynamic entities within the BVH
+		 */
+		std::vector<EntityBVH::Handle> m_dynamicHandles;
+		/**
+		 * @brief Set when entities have been added or removed, the BVH is rebuilt on the next frame
+		 */
+		bool m_bvhDirty = false;
+		/**
+		 * @brief BVH subtrees culled independently of each other
+		 */
+		std::vector<EntityBVH::Subtree> m_partitions;
+		/**
+		 * @brief Unsorted draw list of every partition, opaque partitions first
+		 */
+		std::vector<std::vector<DrawQueue::Item>> m_drawLists;
+		DrawQueue m_translucentQueue;
+		DrawQueue m_opaqueQueue;
+		std::vector<Mat4f> m_modelMatrices;
+		std::vector<Mat4f> m_mvpMatrices;
 		ICameraEntity* m_pCamera = nullptr;
 		IShaderProgram* m_pZPrePassShader;
 		IShaderProgram::UniformHandle m_prePassMVPHandle;
+		IShaderProgram* m_pZPrePassInstancedShader;
+		IShaderProgram::UniformHandle m_prePassVPHandle;
+		IInstanceBuffer* m_pInstances = nullptr;
 		bool m_useZPrePass = false;
+		float m_lodTolerance = 0.001f;
 		std::function<void(IRenderContext*)> m_renderFunction;
 		double m_delta = 1;
 		unsigned int m_fps = 0;
@@ -67,6 +182,10 @@ namespace dbgl
 		unsigned int m_curFrames = 0;
 		ITimer* m_pTime = nullptr;
 		FrustumCulling m_frustumCulling;
+		/**
+		 * @brief Workers shared by all passes of a frame
+		 */
+		ThreadPool m_workers;
 	};
 }
 
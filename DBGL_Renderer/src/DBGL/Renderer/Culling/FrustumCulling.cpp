@@ -9,6 +9,8 @@
 //////////////////////////////////////////////////////////////////////
 
 #include "DBGL/Renderer/Culling/FrustumCulling.h"
+#include "DBGL/Core/Math/Transform.h"
+#include <algorithm>
 #include <exception>
 
 namespace dbgl
@@ -50,20 +52,38 @@ namespace dbgl
 		float lambda = (right * (nearCenter - rightMiddle)) / (right * rightDir);
 		m_boundingSphere.center() = rightMiddle + rightDir * lambda;
 		m_boundingSphere.radius() = (m_boundingSphere.center() - farTopRight).getLength();
+
+		// Matrix to transform points into clip space
+		m_viewProjection = m_pCam->getProjectionMatrix() * m_pCam->getViewMatrix();
+	}
+
+	constexpr std::size_t FrustumCulling::s_chunkSize;
+
+	bool FrustumCulling::checkPoint(Vec3f const& point) const
+	{
+		bool result;
+		checkPoints(&point, &result, 1);
+		return result;
 	}
 
-	bool FrustumCulling::checkPoint(Vec3f const& point)
+	void FrustumCulling::checkPoints(Vec3f const* points, bool* results, std::size_t n) const
 	{
-		// Transform point into clip space
-		Mat4f vp = m_pCam->getProjectionMatrix() * m_pCam->getViewMatrix();
-		Vec4f pClip = vp * Vec4f { point[0], point[1], point[2], 1 };
-		float w = pClip.w();
-		pClip /= w;
-		// Check for planes
-		return -1 < pClip.x() && pClip.x() < 1 && -1 < pClip.y() && pClip.y() < 1 && -1 < pClip.z() && pClip.z() < 1;
+		Vec3f projected[s_chunkSize];
+		for (std::size_t first = 0; first < n; first += s_chunkSize)
+		{
+			std::size_t const count = std::min(s_chunkSize, n - first);
+			// Transform points into normalized device coordinates
+			projectPoints(m_viewProjection, points + first, projected, count);
+			// Check for planes
+			for (std::size_t i = 0; i < count; i++)
+			{
+				Vec3f const& p = projected[i];
+				results[first + i] = -1 < p.x() && p.x() < 1 && -1 < p.y() && p.y() < 1 && -1 < p.z() && p.z() < 1;
+			}
+		}
 	}
 
-	bool FrustumCulling::checkSphere(Vec3f const& center, float radius)
+	bool FrustumCulling::checkSphere(Vec3f const& center, float radius) const
 	{
 		// Check against all planes
 		for (unsigned int i = 0; i < 6; i++)
@@ -80,6 +100,11 @@ namespace dbgl
 		return m_boundingSphere;
 	}
 
+	Plane<float> const* FrustumCulling::getPlanes() const
+	{
+		return m_planes;
+	}
+
 	void FrustumCulling::setCamera(ICameraEntity* pCam)
 	{
 		if (pCam)
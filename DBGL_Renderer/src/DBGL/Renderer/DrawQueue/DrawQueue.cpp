@@ -0,0 +1,187 @@
+//////////////////////////////////////////////////////////////////////
+/// Dragon Blaze Game Library
+///
+/// Copyright (c) 2015 by Jan Moeller
+///
+/// This software is provided "as-is" and does not claim to be
+/// complete or free of bugs in any way. It should work, but
+/// it might also begin to hurt your kittens.
+//////////////////////////////////////////////////////////////////////
+
+#include "DBGL/Renderer/DrawQueue/DrawQueue.h"
+#include <algorithm>
+
+namespace dbgl
+{
+	constexpr unsigned int DrawQueue::s_layerBits;
+	constexpr unsigned int DrawQueue::s_materialBits;
+	constexpr unsigned int DrawQueue::s_meshBits;
+	constexpr unsigned int DrawQueue::s_depthBits;
+	constexpr std::size_t DrawQueue::s_minRadixSize;
+
+	DrawQueue::Key DrawQueue::makeOpaqueKey(int material, IMesh const* mesh, float depth, unsigned int layer)
+	{
+		// | layer | material | mesh | depth |
+		Key key = layer & ((1u << s_layerBits) - 1);
+		key = (key << s_materialBits) | (static_cast<unsigned int>(material) & ((1u << s_materialBits) - 1));
+		key = (key << s_meshBits) | hashMesh(mesh);
+		key = (key << s_depthBits) | quantizeDepth(depth);
+		return key;
+	}
+
+	DrawQueue::Key DrawQueue::makeTranslucentKey(int material, IMesh const* mesh, float depth, unsigned int layer)
+	{
+		// | layer | inverted depth | material | mesh |
+		Key key = layer & ((1u << s_layerBits) - 1);
+		key = (key << s_depthBits) | (((Key { 1 } << s_depthBits) - 1) - quantizeDepth(depth));
+		key = (key << s_materialBits) | (static_cast<unsigned int>(material) & ((1u << s_materialBits) - 1));
+		key = (key << s_meshBits) | hashMesh(mesh);
+		return key;
+	}
+
+	void DrawQueue::clear()
+	{
+		m_items.clear();
+	}
+
+	void DrawQueue::push(Item const& item)
+	{
+		m_items.push_back(item);
+	}
+
+	void DrawQueue::append(std::vector<Item> const& items)
+	{
+		m_items.insert(m_items.end(), items.begin(), items.end());
+	}
+
+	void DrawQueue::sort()
+	{
+		if (m_items.size() < s_minRadixSize)
+		{
+			std::stable_sort(m_items.begin(), m_items.end(), [](Item const& lhs, Item const& rhs)
+			{
+				return lhs.m_key < rhs.m_key;
+			});
+			return;
+		}
+		// Least significant digit first radix sort over bytes. All histograms are gathered in a single pass.
+		constexpr unsigned int digits = sizeof(Key);
+		std::size_t counts[digits][256] = { };
+		for (auto const& item : m_items)
+			for (unsigned int d = 0; d < digits; d++)
+				counts[d][(item.m_key >> (8 * d)) & 0xFF]++;
+		m_buffer.resize(m_items.size());
+		for (unsigned int d = 0; d < digits; d++)
+		{
+			// All keys share this byte, nothing to do
+			if (counts[d][(m_items.front().m_key >> (8 * d)) & 0xFF] == m_items.size())
+				continue;
+			std::size_t offsets[256];
+			std::size_t sum = 0;
+			for (unsigned int i = 0; i < 256; i++)
+			{
+				offsets[i] = sum;
+				sum += counts[d][i];
+			}
+			for (auto const& item : m_items)
+				m_buffer[offsets[(item.m_key >> (8 * d)) & 0xFF]++] = item;
+			m_items.swap(m_buffer);
+		}
+	}
+
+	unsigned int DrawQueue::submit(IRenderContext* rc, IInstanceBuffer* instances)
+	{
+		unsigned int materialSetups = 0;
+		std::size_t i = 0;
+		while (i < m_items.size())
+		{
+			auto const& item = m_items[i];
+			if (i == 0 || m_items[i - 1].m_material != item.m_material)
+			{
+				item.m_entity->setupMaterial();
+				materialSetups++;
+			}
+			if (!item.m_instanced || instances == nullptr)
+			{
+				item.m_entity->setupUnique();
+				rc->drawMesh(item.m_mesh);
+				i++;
+				continue;
+			}
+			std::size_t end = getRunEnd(i);
+			m_instanceMatrices.clear();
+			for (std::size_t j = i; j < end; j++)
+				m_instanceMatrices.push_back(m_items[j].m_entity->getModelMatrix());
+			drawInstanced(rc, instances, item.m_mesh, m_instanceMatrices.data(), m_instanceMatrices.size());
+			i = end;
+		}
+		return materialSetups;
+	}
+
+	std::size_t DrawQueue::getRunEnd(std::size_t begin) const
+	{
+		auto const& first = m_items[begin];
+		std::size_t end = begin + 1;
+		if (!first.m_instanced)
+			return end;
+		while (end < m_items.size() && m_items[end].m_instanced && m_items[end].m_material == first.m_material
+				&& m_items[end].m_mesh == first.m_mesh)
+			end++;
+		return end;
+	}
+
+	void DrawQueue::drawInstanced(IRenderContext* rc, IInstanceBuffer* instances, IMesh* mesh, Mat4f const* matrices,
+			std::size_t count)
+	{
+		std::size_t const capacity = instances->getCapacity();
+		for (std::size_t offset = 0; offset < count; offset += capacity)
+		{
+			auto amount = static_cast<unsigned int>(std::min(capacity, count - offset));
+			unsigned int first = instances->append(matrices + offset, amount);
+			rc->drawMeshInstanced(mesh, instances, first, amount);
+		}
+	}
+
+	std::size_t DrawQueue::size() const
+	{
+		return m_items.size();
+	}
+
+	bool DrawQueue::empty() const
+	{
+		return m_items.empty();
+	}
+
+	DrawQueue::Item const& DrawQueue::operator[](std::size_t index) const
+	{
+		return m_items[index];
+	}
+
+	std::vector<DrawQueue::Item>::const_iterator DrawQueue::begin() const
+	{
+		return m_items.begin();
+	}
+
+	std::vector<DrawQueue::Item>::const_iterator DrawQueue::end() const
+	{
+		return m_items.end();
+	}
+
+	DrawQueue::Key DrawQueue::quantizeDepth(float depth)
+	{
+		constexpr Key maxDepth = (Key { 1 } << s_depthBits) - 1;
+		// Also catches NaN
+		if (!(depth > 0))
+			return 0;
+		if (depth >= 1)
+			return maxDepth;
+		return static_cast<Key>(static_cast<double>(depth) * maxDepth);
+	}
+
+	DrawQueue::Key DrawQueue::hashMesh(IMesh const* mesh)
+	{
+		// Meshes are heap allocated, so the lowest bits carry little information
+		auto address = reinterpret_cast<std::uintptr_t>(mesh) >> 4;
+		return (address ^ (address >> s_meshBits) ^ (address >> (2 * s_meshBits))) & ((1u << s_meshBits) - 1);
+	}
+}
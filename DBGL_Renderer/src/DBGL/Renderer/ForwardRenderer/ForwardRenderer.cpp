@@ -9,11 +9,18 @@
 //////////////////////////////////////////////////////////////////////
 
 #include "DBGL/Platform/Platform.h"
+#include "DBGL/Platform/RenderContext/RenderStateBlock.h"
 #include "DBGL/Renderer/ForwardRenderer/ForwardRenderer.h"
+#include "DBGL/Core/Math/Transform.h"
 #include <algorithm>
+#include <cmath>
 
 namespace dbgl
 {
+	constexpr std::size_t ForwardRenderer::s_minPartitionSize;
+	constexpr unsigned int ForwardRenderer::s_partitionsPerThread;
+	constexpr unsigned int ForwardRenderer::s_instanceCapacity;
+
 	ForwardRenderer::ForwardRenderer(bool useZPrePass)
 	{
 		// Initialize shader for z-pre-pass
@@ -41,9 +48,29 @@ namespace dbgl
 		m_pZPrePassShader->attach(fragment);
 		m_pZPrePassShader->link();
 		delete vertex;
-		delete fragment;
 		m_prePassMVPHandle = m_pZPrePassShader->getUniformHandle("MVP");
 
+		// Instanced entities read their model matrix from the instance buffer
+		m_pZPrePassInstancedShader = Platform::get()->createShaderProgram();
+		std::string codeVertexInstanced =
+				R"code(#version 330 core
+			layout(location = 0) in vec3 i_v3_Pos_m; // Vertex position in model space
+			layout(location = 5) in mat4 i_m4_Model; // Model matrix of the instance
+			uniform mat4 VP;						 // View-projection matrix
+			void main()
+			{
+				gl_Position = VP * i_m4_Model * vec4(i_v3_Pos_m, 1); // Vertex position in clip space
+			})code";
+		vertex = Platform::get()->createShader(IShader::Type::VERTEX, codeVertexInstanced);
+		vertex->compile();
+		m_pZPrePassInstancedShader->attach(vertex);
+		m_pZPrePassInstancedShader->attach(fragment);
+		m_pZPrePassInstancedShader->link();
+		delete vertex;
+		delete fragment;
+		m_prePassVPHandle = m_pZPrePassInstancedShader->getUniformHandle("VP");
+		m_pInstances = Platform::get()->createInstanceBuffer(s_instanceCapacity);
+
 		// Timer
 		m_pTime = Platform::get()->createTimer();
 
@@ -57,6 +84,8 @@ namespace dbgl
 	ForwardRenderer::~ForwardRenderer()
 	{
 		delete m_pZPrePassShader;
+		delete m_pZPrePassInstancedShader;
+		delete m_pInstances;
 		delete m_pTime;
 	}
 
@@ -64,10 +93,11 @@ namespace dbgl
 	{
 		if (entity->isTranslucent())
 			m_translucentEntities.push_back(entity);
-		else if (entity->isStatic())
-			m_bvh.insert(entity->getBoundingSphere(), entity);
 		else
+		{
 			m_entities.push_back(entity);
+			m_bvhDirty = true;
+		}
 		return true;
 	}
 
@@ -82,16 +112,13 @@ namespace dbgl
 				return true;
 			}
 		}
-		else if (entity->isStatic())
-		{
-			m_bvh.remove(entity->getBoundingSphere(), entity);
-		}
 		else
 		{
 			auto it = std::find(m_entities.begin(), m_entities.end(), entity);
 			if (it != m_entities.end())
 			{
 				m_entities.erase(it);
+				m_bvhDirty = true;
 				return true;
 			}
 		}
@@ -156,108 +183,228 @@ namespace dbgl
 		return m_useZPrePass;
 	}
 
+	void ForwardRenderer::setLodTolerance(float tolerance)
+	{
+		m_lodTolerance = tolerance;
+	}
+
+	float ForwardRenderer::getLodTolerance() const
+	{
+		return m_lodTolerance;
+	}
+
 	void ForwardRenderer::renderWithZPrePass(IRenderContext* rc)
 	{
 		cullAll();
 		Mat4f VP = m_pCamera->getProjectionMatrix() * m_pCamera->getViewMatrix();
 
+		// Compute all model-view-projection matrices at once
+		m_modelMatrices.resize(m_opaqueQueue.size());
+		m_mvpMatrices.resize(m_opaqueQueue.size());
+		m_workers.forRange(m_opaqueQueue.size(), s_minPartitionSize, [this, &VP](std::size_t begin, std::size_t end)
+		{
+			for (std::size_t i = begin; i < end; i++)
+				m_modelMatrices[i] = m_opaqueQueue[i].m_entity->getModelMatrix();
+			multiplyMatrices(VP, m_modelMatrices.data() + begin, m_mvpMatrices.data() + begin, end - begin);
+		});
+
+		// Face culling and blending are left as set up by the caller
+		RenderStateBlock const state = rc->getStateBlock().withDrawMode(IRenderContext::DrawMode::Fill);
+
 		// Do Z Pre-Pass
-		rc->enableColorBuffer(false, false, false, false);
-		rc->enableDepthBuffer(true);
+		rc->apply(state.withColorBuffer(false, false, false, false).withDepthBuffer(true).withDepthTest(
+				IRenderContext::DepthTestValue::Less));
 		rc->clear(IRenderContext::DEPTH);
-		rc->setDepthTest(IRenderContext::DepthTestValue::Less);
-		rc->setDrawMode(IRenderContext::DrawMode::Fill);
-		m_pZPrePassShader->use();
-		for (auto& e : m_entitiesCulled) // TODO: front-to-back order
+		IShaderProgram* current = nullptr;
+		for (std::size_t i = 0; i < m_opaqueQueue.size();)
 		{
-			Mat4f MVP = VP * e->getModelMatrix();
-			Platform::get()->curShaderProgram()->setUniformFloatMatrix4Array(m_prePassMVPHandle, 1, false,
-					MVP.getDataPointer());
-			rc->drawMesh(e->getMesh());
+			std::size_t end = m_opaqueQueue.getRunEnd(i);
+			if (m_opaqueQueue[i].m_instanced)
+			{
+				if (current != m_pZPrePassInstancedShader)
+				{
+					current = m_pZPrePassInstancedShader;
+					current->use();
+					Platform::get()->curShaderProgram()->setUniformFloatMatrix4Array(m_prePassVPHandle, 1, false,
+							VP.getDataPointer());
+				}
+				DrawQueue::drawInstanced(rc, m_pInstances, m_opaqueQueue[i].m_mesh, m_modelMatrices.data() + i,
+						end - i);
+			}
+			else
+			{
+				if (current != m_pZPrePassShader)
+				{
+					current = m_pZPrePassShader;
+					current->use();
+				}
+				Platform::get()->curShaderProgram()->setUniformFloatMatrix4Array(m_prePassMVPHandle, 1, false,
+						m_mvpMatrices[i].getDataPointer());
+				rc->drawMesh(m_opaqueQueue[i].m_mesh);
+			}
+			i = end;
 		}
 
 		// Do color pass
-		rc->enableColorBuffer(true, true, true, true);
-		rc->enableDepthBuffer(false);
+		RenderStateBlock const colorPass = state.withColorBuffer(true, true, true, true).withDepthTest(
+				IRenderContext::DepthTestValue::LessEqual);
+		rc->apply(colorPass.withDepthBuffer(false));
 		rc->clear(IRenderContext::COLOR);
-		rc->setDepthTest(IRenderContext::DepthTestValue::LessEqual);
-		rc->setDrawMode(IRenderContext::DrawMode::Fill);
-		for (auto& e : m_entitiesCulled) // TODO: ordered by material
-		{
-			e->setupUnique();
-			e->setupMaterial();
-			rc->drawMesh(e->getMesh());
-		}
+		m_opaqueQueue.submit(rc, m_pInstances);
 
 		// Render translucent objects in back-to-front order
-		rc->enableDepthBuffer(true);
-		for (auto& e : m_translucentEntitiesCulled) // TODO: order
-		{
-			e->setupUnique();
-			e->setupMaterial();
-			rc->drawMesh(e->getMesh());
-		}
+		rc->apply(colorPass.withDepthBuffer(true));
+		m_translucentQueue.submit(rc, m_pInstances);
 	}
 
 	void ForwardRenderer::renderWithoutZPrePass(IRenderContext* rc)
 	{
 		cullAll();
-		// Do color pass
-		rc->enableColorBuffer(true, true, true, true);
-		rc->enableDepthBuffer(true);
+		// Do color pass, face culling and blending are left as set up by the caller
+		rc->apply(rc->getStateBlock().withColorBuffer(true, true, true, true).withDepthBuffer(true).withDepthTest(
+				IRenderContext::DepthTestValue::LessEqual).withDrawMode(IRenderContext::DrawMode::Fill));
 		rc->clear(IRenderContext::COLOR | IRenderContext::DEPTH);
-		rc->setDepthTest(IRenderContext::DepthTestValue::LessEqual);
-		rc->setDrawMode(IRenderContext::DrawMode::Fill);
-		for (auto& e : m_entitiesCulled) // TODO: ordered front-to-back
-		{
-			e->setupUnique();
-			e->setupMaterial();
-			rc->drawMesh(e->getMesh());
-		}
+		m_opaqueQueue.submit(rc, m_pInstances);
 
 		// Render translucent objects in back-to-front order
-		for (auto& e : m_translucentEntitiesCulled) // TODO: order
-		{
-			e->setupUnique();
-			e->setupMaterial();
-			rc->drawMesh(e->getMesh());
-		}
+		m_translucentQueue.submit(rc, m_pInstances);
 	}
 
 	void ForwardRenderer::cullAll()
 	{
-		// Clear old culling
-		m_entitiesCulled.clear();
-		m_translucentEntitiesCulled.clear();
-		m_bvhCulledEntities.clear();
 		m_frustumCulling.update();
+		updateBVH();
+		float const near = m_pCamera->getNear();
+		// The field of view spans the screen height
+		View const view { m_pCamera->getPosition(), m_pCamera->getDirection(), near, 1 / (m_pCamera->getFar() - near),
+				1 / (2 * std::tan(m_pCamera->getFieldOfView() / 2)) };
+		// Every subtree of the BVH is tested against the frustum planes on its own. Translucent entities aren't
+		// part of the BVH, so they are partitioned by index. All partitions are culled in the same pass.
+		m_bvh.split(getPartitionCount(m_entities.size()), m_partitions);
+		std::size_t const opaque = m_partitions.size();
+		std::size_t const translucent = getPartitionCount(m_translucentEntities.size());
+		if (m_drawLists.size() < opaque + translucent)
+			m_drawLists.resize(opaque + translucent);
+		// Two partitions mean that there are only few entities, which isn't worth waking the workers
+		std::size_t const minChunk = opaque + translucent > 2 ? 1 : 2;
+		m_workers.forRange(opaque + translucent, minChunk, [this, opaque, translucent, &view](std::size_t begin,
+				std::size_t end)
+		{
+			for (std::size_t i = begin; i < end; i++)
+			{
+				if (i < opaque)
+					cullOpaque(i, view, m_drawLists[i]);
+				else
+					cullTranslucent(i - opaque, translucent, view, m_drawLists[i]);
+			}
+		});
+		gather(0, opaque, m_opaqueQueue);
+		gather(opaque, opaque + translucent, m_translucentQueue);
+	}
 
-		// Iterate over all entities to determine the potentially visible ones
-		// Static entities
-		m_bvh.get(m_frustumCulling.getBoundingSphere(), m_bvhCulledEntities);
-		for (auto& e : m_bvhCulledEntities)
+	void ForwardRenderer::updateBVH()
+	{
+		if (m_bvhDirty)
 		{
-			// Frustum culling
-			auto const& sphere = e->getBoundingSphere();
-			if (m_frustumCulling.checkSphere(sphere.getCenter(), sphere.getRadius()))
-				m_entitiesCulled.push_back(&*e);
+			rebuildBVH();
+			return;
 		}
-		// Dynamic entities
-		for (auto& e : m_entities)
+		// Dynamic entities only adjust the bounds of their ancestors. If there are many of them, gather their
+		// bounds concurrently and adjust the whole tree at once.
+		if (m_dynamicHandles.size() < s_minPartitionSize)
 		{
-			// Frustum culling
-			auto const& sphere = e->getBoundingSphere();
-			if (m_frustumCulling.checkSphere(sphere.getCenter(), sphere.getRadius()))
-				m_entitiesCulled.push_back(&*e);
+			for (auto handle : m_dynamicHandles)
+				m_bvh.update(handle, m_entities[handle]->getBoundingSphere());
+			return;
 		}
-		// Translucent entities
-		for (auto& e : m_translucentEntities)
+		m_workers.forRange(m_dynamicHandles.size(), s_minPartitionSize, [this](std::size_t begin, std::size_t end)
 		{
-			// Frustum culling
+			for (std::size_t i = begin; i < end; i++)
+			{
+				auto handle = m_dynamicHandles[i];
+				m_bvh.update(handle, m_entities[handle]->getBoundingSphere(), false);
+			}
+		});
+		m_bvh.refit();
+	}
+
+	void ForwardRenderer::rebuildBVH()
+	{
+		std::vector<EntityBVH::Aggregate> elements { };
+		elements.reserve(m_entities.size());
+		m_dynamicHandles.clear();
+		for (std::size_t i = 0; i < m_entities.size(); i++)
+		{
+			elements.push_back( { m_entities[i]->getBoundingSphere(), m_entities[i] });
+			if (!m_entities[i]->isStatic())
+				m_dynamicHandles.push_back(static_cast<unsigned int>(i));
+		}
+		m_bvh.build(elements);
+		m_bvhDirty = false;
+	}
+
+	void ForwardRenderer::cullOpaque(std::size_t partition, View const& view, std::vector<DrawQueue::Item>& list) const
+	{
+		list.clear();
+		m_bvh.queryPlanes(m_partitions[partition], m_frustumCulling.getPlanes(), 6, [this, &list, &view](
+				EntityBVH::Handle, EntityBVH::Aggregate const& element)
+		{
+			IRenderEntity* e = element.m_data;
+			int material = e->getMaterialId();
+			float depth = ((element.m_volume.getCenter() - view.m_position) * view.m_direction - view.m_near)
+					* view.m_depthScale;
+			IMesh* mesh = selectLod(e, element.m_volume, view.m_position, view.m_lodScale);
+			list.push_back( { DrawQueue::makeOpaqueKey(material, mesh, depth), e, mesh, material, e->isInstanced() });
+			return true;
+		});
+	}
+
+	void ForwardRenderer::cullTranslucent(std::size_t partition, std::size_t partitions, View const& view,
+			std::vector<DrawQueue::Item>& list) const
+	{
+		list.clear();
+		std::size_t const amount = m_translucentEntities.size();
+		for (std::size_t j = amount * partition / partitions; j < amount * (partition + 1) / partitions; j++)
+		{
+			auto e = m_translucentEntities[j];
 			auto const& sphere = e->getBoundingSphere();
-			if (m_frustumCulling.checkSphere(sphere.getCenter(), sphere.getRadius()))
-				m_translucentEntitiesCulled.push_back(&*e);
+			if (!m_frustumCulling.checkSphere(sphere.getCenter(), sphere.getRadius()))
+				continue;
+			int material = e->getMaterialId();
+			float depth = ((sphere.getCenter() - view.m_position) * view.m_direction - view.m_near)
+					* view.m_depthScale;
+			IMesh* mesh = selectLod(e, sphere, view.m_position, view.m_lodScale);
+			list.push_back( { DrawQueue::makeTranslucentKey(material, mesh, depth), e, mesh, material,
+					e->isInstanced() });
 		}
 	}
-}
 
+	IMesh* ForwardRenderer::selectLod(IRenderEntity* entity, Sphere<float> const& sphere, Vec3f const& position,
+			float lodScale) const
+	{
+		// Projected error relative to the screen height is error * radius * lodScale / distance
+		float const distance = (sphere.getCenter() - position).getLength();
+		float const size = sphere.getRadius() * lodScale;
+		unsigned int lod = entity->getLodCount() - 1;
+		while (lod > 0 && entity->getLodError(lod) * size > m_lodTolerance * distance)
+			lod--;
+		return entity->getLodMesh(lod);
+	}
+
+	unsigned int ForwardRenderer::getPartitionCount(std::size_t entities) const
+	{
+		if (entities < 2 * s_minPartitionSize)
+			return 1;
+		std::size_t partitions = std::min<std::size_t>(m_workers.getThreadCount() * s_partitionsPerThread,
+				entities / s_minPartitionSize);
+		return static_cast<unsigned int>(partitions);
+	}
+
+	void ForwardRenderer::gather(std::size_t begin, std::size_t end, DrawQueue& queue)
+	{
+		queue.clear();
+		for (std::size_t i = begin; i < end; i++)
+			queue.append(m_drawLists[i]);
+		queue.sort();
+	}
+}
@@ -0,0 +1,253 @@
+//////////////////////////////////////////////////////////////////////
+/// Dragon Blaze Game Library
+///
+/// Copyright (c) 2015 by Jan Moeller
+///
+/// This software is provided "as-is" and does not claim to be
+/// complete or free of bugs in any way. It should work, but
+/// it might also begin to hurt your kittens.
+//////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <vector>
+#include "DBGL/Core/Test/Test.h"
+#include "DBGL/Renderer/DrawQueue/DrawQueue.h"
+#include "DBGL/Platform/Implementation/Headless.h"
+#include "DBGL/Platform/Mesh/InstanceBufferHeadless.h"
+
+using namespace dbgl;
+using namespace std;
+
+namespace dbgl_test_DrawQueue
+{
+	class EntityStub: public IRenderEntity
+	{
+	public:
+		virtual bool isTranslucent()
+		{
+			return false;
+		}
+		virtual bool isStatic()
+		{
+			return true;
+		}
+		virtual bool isInstanced()
+		{
+			return m_instanced;
+		}
+		virtual void setupUnique()
+		{
+			m_unique++;
+		}
+		virtual void setupMaterial()
+		{
+			m_material++;
+		}
+		virtual int getMaterialId()
+		{
+			return 0;
+		}
+		virtual Sphere<float> const& getBoundingSphere()
+		{
+			return m_sphere;
+		}
+		virtual Mat4f const& getModelMatrix()
+		{
+			return m_model;
+		}
+		virtual IMesh* getMesh()
+		{
+			return m_pMesh;
+		}
+		virtual unsigned int getLodCount()
+		{
+			return 1;
+		}
+		virtual IMesh* getLodMesh(unsigned int)
+		{
+			return m_pMesh;
+		}
+		virtual float getLodError(unsigned int)
+		{
+			return 0;
+		}
+
+		bool m_instanced = false;
+		IMesh* m_pMesh = nullptr;
+		unsigned int m_unique = 0;
+		unsigned int m_material = 0;
+		Sphere<float> m_sphere;
+		Mat4f m_model;
+	};
+
+	/**
+	 * @brief Checks that sorting a queue matches a stable comparison sort
+	 * @param items Items to sort, their material has to be unique to check stability
+	 */
+	void checkSort(std::vector<DrawQueue::Item> items)
+	{
+		DrawQueue queue { };
+		queue.append(items);
+		queue.sort();
+		std::stable_sort(items.begin(), items.end(), [](DrawQueue::Item const& lhs, DrawQueue::Item const& rhs)
+		{
+			return lhs.m_key < rhs.m_key;
+		});
+		ASSERT_EQ(queue.size(), items.size());
+		for (unsigned int i = 0; i < items.size(); i++)
+		{
+			ASSERT_EQ(queue[i].m_key, items[i].m_key);
+			ASSERT_EQ(queue[i].m_material, items[i].m_material);
+		}
+	}
+
+	/**
+	 * @brief Fills a queue with random keys and checks that sorting it matches a stable comparison sort
+	 */
+	void checkSort(unsigned int amount, unsigned int seed, DrawQueue::Key mask)
+	{
+		std::mt19937_64 rng { seed };
+		std::vector<DrawQueue::Item> items;
+		for (unsigned int i = 0; i < amount; i++)
+			items.push_back( { rng() & mask, nullptr, nullptr, static_cast<int>(i), false });
+		checkSort(items);
+	}
+}
+
+using namespace dbgl_test_DrawQueue;
+
+TEST(DrawQueue,opaqueKey)
+{
+	auto mesh = reinterpret_cast<IMesh const*>(0x1000);
+	// Material takes precedence over depth
+	ASSERT(DrawQueue::makeOpaqueKey(1, mesh, 0.9f) < DrawQueue::makeOpaqueKey(2, mesh, 0.1f));
+	// Front-to-back within a material
+	ASSERT(DrawQueue::makeOpaqueKey(1, mesh, 0.1f) < DrawQueue::makeOpaqueKey(1, mesh, 0.2f));
+	// Layer takes precedence over everything
+	ASSERT(DrawQueue::makeOpaqueKey(9, mesh, 0.9f, 0) < DrawQueue::makeOpaqueKey(0, mesh, 0, 1));
+	// Depth is clamped
+	ASSERT_EQ(DrawQueue::makeOpaqueKey(1, mesh, -5), DrawQueue::makeOpaqueKey(1, mesh, 0));
+	ASSERT_EQ(DrawQueue::makeOpaqueKey(1, mesh, 5), DrawQueue::makeOpaqueKey(1, mesh, 1));
+	ASSERT(DrawQueue::makeOpaqueKey(1, mesh, 0.999f) < DrawQueue::makeOpaqueKey(1, mesh, 1));
+}
+
+TEST(DrawQueue,translucentKey)
+{
+	auto mesh = reinterpret_cast<IMesh const*>(0x1000);
+	// Back-to-front, regardless of material
+	ASSERT(DrawQueue::makeTranslucentKey(2, mesh, 0.9f) < DrawQueue::makeTranslucentKey(1, mesh, 0.1f));
+	ASSERT(DrawQueue::makeTranslucentKey(1, mesh, 0.2f) < DrawQueue::makeTranslucentKey(1, mesh, 0.1f));
+	// Grouped by material at the same depth
+	ASSERT(DrawQueue::makeTranslucentKey(1, mesh, 0.5f) < DrawQueue::makeTranslucentKey(2, mesh, 0.5f));
+	// Layer takes precedence over everything
+	ASSERT(DrawQueue::makeTranslucentKey(0, mesh, 0, 0) < DrawQueue::makeTranslucentKey(0, mesh, 1, 1));
+}
+
+TEST(DrawQueue,sort)
+{
+	checkSort(0, 1, ~DrawQueue::Key { 0 });
+	checkSort(100, 2, ~DrawQueue::Key { 0 });
+	checkSort(10000, 3, ~DrawQueue::Key { 0 });
+	// Many duplicates, stability matters
+	checkSort(10000, 4, 0xF000000000000F0F);
+	// Identical keys
+	checkSort(1000, 5, 0);
+}
+
+TEST(DrawQueue,submit)
+{
+	EntityStub entities[3];
+	int materials[] = { 1, 1, 2, 2, 1, 3, 3 };
+	DrawQueue queue { };
+	for (unsigned int i = 0; i < 7; i++)
+		queue.push( { 0, &entities[i % 3], nullptr, materials[i], false });
+	Platform::init<Headless>();
+	std::unique_ptr<IRenderContext> rc { Platform::get()->createRenderContext(800, 600) };
+	CommandLog& commands = static_cast<Headless*>(Platform::get())->getLog();
+	// Material is set up on the first draw and on every change
+	ASSERT_EQ(queue.submit(rc.get()), 4u);
+	ASSERT_EQ(commands.getCount(CommandLog::Type::DrawMesh), 7u);
+	ASSERT_EQ(entities[0].m_unique + entities[1].m_unique + entities[2].m_unique, 7u);
+	ASSERT_EQ(entities[0].m_material + entities[1].m_material + entities[2].m_material, 4u);
+	queue.clear();
+	ASSERT(queue.empty());
+	ASSERT_EQ(queue.submit(rc.get()), 0u);
+	rc.reset();
+	Platform::destroy();
+}
+
+TEST(DrawQueue,instanced)
+{
+	Platform::init<Headless>();
+	{
+		std::unique_ptr<IRenderContext> rc { Platform::get()->createRenderContext(800, 600) };
+		std::unique_ptr<IMesh> meshA { Platform::get()->createMesh() };
+		std::unique_ptr<IMesh> meshB { Platform::get()->createMesh() };
+		std::unique_ptr<IInstanceBuffer> instances { Platform::get()->createInstanceBuffer(4) };
+		CommandLog& commands = static_cast<Headless*>(Platform::get())->getLog();
+		// Runs: 5 instanced of A, 3 instanced of B, 2 single of A, then 4 instanced of A with another material
+		struct Run
+		{
+			IMesh* m_pMesh;
+			int m_material;
+			bool m_instanced;
+			unsigned int m_count;
+		} runs[] = { { meshA.get(), 1, true, 5 }, { meshB.get(), 1, true, 3 }, { meshA.get(), 1, false, 2 }, {
+				meshA.get(), 2, true, 4 } };
+		EntityStub entities[14];
+		DrawQueue queue { };
+		unsigned int e = 0;
+		for (auto const& run : runs)
+		{
+			for (unsigned int i = 0; i < run.m_count; i++, e++)
+			{
+				entities[e].m_pMesh = run.m_pMesh;
+				entities[e].m_instanced = run.m_instanced;
+				entities[e].m_model = Mat4f::makeTranslation(static_cast<float>(e), 0, 0);
+				queue.push( { 0, &entities[e], run.m_pMesh, run.m_material, run.m_instanced });
+			}
+		}
+		ASSERT_EQ(queue.getRunEnd(0), 5u);
+		ASSERT_EQ(queue.getRunEnd(5), 8u);
+		ASSERT_EQ(queue.getRunEnd(8), 9u);
+		ASSERT_EQ(queue.getRunEnd(10), 14u);
+		ASSERT_EQ(queue.submit(rc.get(), instances.get()), 2u);
+		// The first run exceeds the instance buffer and is split
+		ASSERT_EQ(commands.getCount(CommandLog::Type::DrawMeshInstanced), 4u);
+		ASSERT_EQ(commands.getCount(CommandLog::Type::DrawMesh), 2u);
+		ASSERT_EQ(commands.getDrawnInstances(), 14u);
+		unsigned int unique = 0;
+		for (auto const& entity : entities)
+			unique += entity.m_unique;
+		ASSERT_EQ(unique, 2u);
+		// The last run starts over at the front of the ring buffer
+		auto buffer = static_cast<InstanceBufferHeadless*>(instances.get());
+		ASSERT_EQ(buffer->getWrapCount(), 2u);
+		for (unsigned int i = 0; i < 4; i++)
+			ASSERT(buffer->getData()[i] == entities[10 + i].m_model);
+
+		// Without an instance buffer everything is drawn one by one
+		commands.clear();
+		queue.submit(rc.get());
+		ASSERT_EQ(commands.getCount(CommandLog::Type::DrawMesh), 14u);
+		ASSERT_EQ(commands.getCount(CommandLog::Type::DrawMeshInstanced), 0u);
+		ASSERT_THROWS(rc->drawMeshInstanced(meshA.get(), instances.get(), 2, 3), std::invalid_argument);
+	}
+	Platform::destroy();
+}
+
+TEST(DrawQueue,sortOpaqueKeys)
+{
+	// Realistic keys: few materials, many depths
+	std::mt19937 rng { 6 };
+	std::uniform_int_distribution<int> material { 0, 99 };
+	std::uniform_real_distribution<float> depth { 0, 1 };
+	std::vector<DrawQueue::Item> items;
+	for (unsigned int i = 0; i < 10000; i++)
+		items.push_back( { DrawQueue::makeOpaqueKey(material(rng), nullptr, depth(rng)), nullptr, nullptr,
+				static_cast<int>(i), false });
+	checkSort(items);
+}
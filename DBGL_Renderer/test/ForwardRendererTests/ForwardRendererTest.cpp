@@ -0,0 +1,456 @@
+//////////////////////////////////////////////////////////////////////
+/// Dragon Blaze Game Library
+///
+/// Copyright (c) 2015 by Jan Moeller
+///
+/// This software is provided "as-is" and does not claim to be
+/// complete or free of bugs in any way. It should work, but
+/// it might also begin to hurt your kittens.
+//////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <set>
+#include <utility>
+#include <vector>
+#include "DBGL/Core/Test/Test.h"
+#include "DBGL/Renderer/ForwardRenderer/ForwardRenderer.h"
+#include "DBGL/Renderer/Culling/FrustumCulling.h"
+#include "DBGL/Platform/Implementation/Headless.h"
+#include "DBGL/Platform/RenderContext/RenderStateBlock.h"
+
+using namespace dbgl;
+using namespace std;
+
+namespace dbgl_test_ForwardRenderer
+{
+	/**
+	 * @brief Amount of calls to setupMaterial() since the last checked frame
+	 */
+	unsigned int materialSetups = 0;
+
+	class CameraStub: public ICameraEntity
+	{
+	public:
+		CameraStub()
+		{
+			m_view = Mat4f::makeView(m_position, m_direction, m_up);
+			m_projection = Mat4f::makeProjection(getFieldOfView(), getRatio(), getNear(), getFar());
+		}
+		virtual Mat4f const& getViewMatrix()
+		{
+			return m_view;
+		}
+		virtual Mat4f const& getProjectionMatrix()
+		{
+			return m_projection;
+		}
+		virtual Vec3f const& getPosition()
+		{
+			return m_position;
+		}
+		virtual Vec3f const& getDirection()
+		{
+			return m_direction;
+		}
+		virtual Vec3f const& getUp()
+		{
+			return m_up;
+		}
+		virtual float getNear()
+		{
+			return 0.1f;
+		}
+		virtual float getFar()
+		{
+			return 80;
+		}
+		virtual float getFieldOfView()
+		{
+			return 1;
+		}
+		virtual float getRatio()
+		{
+			return 4.0f / 3;
+		}
+
+		Vec3f m_position { 0, 0, 0 };
+		Vec3f m_direction { 0, 0, -1 };
+		Vec3f m_up { 0, 1, 0 };
+		Mat4f m_view;
+		Mat4f m_projection;
+	};
+
+	class EntityStub: public IRenderEntity
+	{
+	public:
+		EntityStub(Sphere<float> const& sphere, int material, bool translucent, bool dynamic,
+				std::vector<EntityStub*>* log)
+				: m_sphere { sphere }, m_material { material }, m_translucent { translucent }, m_dynamic { dynamic },
+						m_log { log }
+		{
+		}
+		virtual bool isTranslucent()
+		{
+			return m_translucent;
+		}
+		virtual bool isStatic()
+		{
+			return !m_dynamic;
+		}
+		virtual bool isInstanced()
+		{
+			return m_instanced;
+		}
+		virtual void setupUnique()
+		{
+			m_log->push_back(this);
+		}
+		virtual void setupMaterial()
+		{
+			materialSetups++;
+		}
+		virtual int getMaterialId()
+		{
+			return m_material;
+		}
+		virtual Sphere<float> const& getBoundingSphere()
+		{
+			return m_sphere;
+		}
+		virtual Mat4f const& getModelMatrix()
+		{
+			return m_model;
+		}
+		virtual IMesh* getMesh()
+		{
+			return m_pMesh;
+		}
+		virtual unsigned int getLodCount()
+		{
+			return static_cast<unsigned int>(m_lods.size()) + 1;
+		}
+		virtual IMesh* getLodMesh(unsigned int lod)
+		{
+			return lod == 0 ? m_pMesh : m_lods[lod - 1].first;
+		}
+		virtual float getLodError(unsigned int lod)
+		{
+			return lod == 0 ? 0 : m_lods[lod - 1].second;
+		}
+		float getDepth() const
+		{
+			return -m_sphere.getCenter()[2];
+		}
+
+		Sphere<float> m_sphere;
+		int m_material;
+		bool m_translucent;
+		bool m_dynamic;
+		std::vector<EntityStub*>* m_log;
+		Mat4f m_model;
+		bool m_instanced = false;
+		IMesh* m_pMesh = nullptr;
+		/**
+		 * @brief Mesh and error of all levels of detail but the first one
+		 */
+		std::vector<std::pair<IMesh*, float>> m_lods;
+	};
+
+	using Entities = std::vector<std::unique_ptr<EntityStub>>;
+
+	Entities randomEntities(unsigned int amount, unsigned int seed, std::vector<EntityStub*>* log)
+	{
+		std::mt19937 rng { seed };
+		std::uniform_real_distribution<float> pos { -100, 100 };
+		std::uniform_real_distribution<float> rad { 0.1f, 2 };
+		std::uniform_int_distribution<int> material { 0, 9 };
+		std::uniform_int_distribution<int> kind { 0, 19 };
+		Entities entities;
+		materialSetups = 0;
+		for (unsigned int i = 0; i < amount; i++)
+		{
+			Sphere<float> sphere { Vec3f { pos(rng), pos(rng), pos(rng) }, rad(rng) };
+			int k = kind(rng);
+			entities.emplace_back(new EntityStub { sphere, material(rng), k == 0, k % 2 == 1, log });
+		}
+		return entities;
+	}
+
+	/**
+	 * @brief Computes the depth of an entity the way it is quantized by the renderer
+	 */
+	float normalizedDepth(EntityStub const* entity, CameraStub& camera)
+	{
+		float depth = (entity->getDepth() - camera.getNear()) / (camera.getFar() - camera.getNear());
+		return std::min(std::max(depth, 0.0f), 1.0f);
+	}
+
+	/**
+	 * @brief Counts how often the material changes within a sequence of draws
+	 */
+	unsigned int countMaterialChanges(std::vector<EntityStub*> const& draws)
+	{
+		unsigned int changes = 0;
+		for (std::size_t i = 0; i < draws.size(); i++)
+			if (i == 0 || draws[i - 1]->m_material != draws[i]->m_material)
+				changes++;
+		return changes;
+	}
+
+	/**
+	 * @brief Checks that exactly the visible entities have been drawn, in the right order, and that materials have
+	 *        only been set up when they changed
+	 */
+	void checkFrame(Entities const& entities, std::vector<EntityStub*> const& log, CameraStub& camera)
+	{
+		FrustumCulling culling { };
+		culling.setCamera(&camera);
+		culling.update();
+		std::vector<EntityStub*> opaque, translucent;
+		for (auto const& e : entities)
+		{
+			if (culling.checkSphere(e->m_sphere.getCenter(), e->m_sphere.getRadius()))
+				(e->m_translucent ? translucent : opaque).push_back(e.get());
+		}
+		ASSERT_EQ(log.size(), opaque.size() + translucent.size());
+		// Opaque entities come first, ordered by material and front-to-back
+		std::vector<EntityStub*> drawnOpaque { log.begin(), log.begin() + opaque.size() };
+		for (std::size_t i = 1; i < drawnOpaque.size(); i++)
+		{
+			auto prev = drawnOpaque[i - 1];
+			auto cur = drawnOpaque[i];
+			ASSERT(!cur->m_translucent);
+			ASSERT(prev->m_material < cur->m_material
+					|| (prev->m_material == cur->m_material
+							&& normalizedDepth(prev, camera) <= normalizedDepth(cur, camera) + 1e-6f));
+		}
+		// Translucent entities come last, back-to-front
+		std::vector<EntityStub*> drawnTranslucent { log.begin() + opaque.size(), log.end() };
+		for (std::size_t i = 0; i < drawnTranslucent.size(); i++)
+		{
+			ASSERT(drawnTranslucent[i]->m_translucent);
+			if (i > 0)
+				ASSERT(normalizedDepth(drawnTranslucent[i - 1], camera) + 1e-6f
+						>= normalizedDepth(drawnTranslucent[i], camera));
+		}
+		ASSERT_EQ(materialSetups, countMaterialChanges(drawnOpaque) + countMaterialChanges(drawnTranslucent));
+		materialSetups = 0;
+		std::sort(opaque.begin(), opaque.end());
+		std::sort(drawnOpaque.begin(), drawnOpaque.end());
+		ASSERT(opaque == drawnOpaque);
+		std::sort(translucent.begin(), translucent.end());
+		std::sort(drawnTranslucent.begin(), drawnTranslucent.end());
+		ASSERT(translucent == drawnTranslucent);
+	}
+}
+
+using namespace dbgl_test_ForwardRenderer;
+
+TEST(ForwardRenderer,cull)
+{
+	Platform::init<Headless>();
+	{
+		std::vector<EntityStub*> log;
+		auto entities = randomEntities(20000, 1, &log);
+		CameraStub camera { };
+		std::unique_ptr<IRenderContext> rc { Platform::get()->createRenderContext(800, 600) };
+		CommandLog& commands = static_cast<Headless*>(Platform::get())->getLog();
+		ForwardRenderer renderer { };
+		renderer.setCameraEntity(&camera);
+		for (auto const& e : entities)
+			renderer.addEntity(e.get());
+		renderer.render(rc.get());
+		ASSERT(!log.empty());
+		ASSERT_EQ(commands.getCount(CommandLog::Type::DrawMesh), log.size());
+		checkFrame(entities, log, camera);
+
+		// Move the dynamic entities around
+		std::mt19937 rng { 2 };
+		std::uniform_real_distribution<float> offset { -10, 10 };
+		for (unsigned int frame = 0; frame < 3; frame++)
+		{
+			for (auto const& e : entities)
+				if (e->m_dynamic && !e->m_translucent)
+					e->m_sphere.center() += Vec3f { offset(rng), offset(rng), offset(rng) };
+			log.clear();
+			commands.clear();
+			renderer.render(rc.get());
+			checkFrame(entities, log, camera);
+		}
+
+		// Remove some entities
+		for (unsigned int i = 0; i < entities.size(); i += 3)
+			ASSERT(renderer.removeEntity(entities[i].get()));
+		Entities remaining;
+		for (unsigned int i = 0; i < entities.size(); i++)
+			if (i % 3 != 0)
+				remaining.push_back(std::move(entities[i]));
+		log.clear();
+		renderer.render(rc.get());
+		checkFrame(remaining, log, camera);
+	}
+	Platform::destroy();
+}
+
+TEST(ForwardRenderer,zPrePass)
+{
+	Platform::init<Headless>();
+	{
+		std::vector<EntityStub*> log;
+		auto entities = randomEntities(500, 3, &log);
+		CameraStub camera { };
+		std::unique_ptr<IRenderContext> rc { Platform::get()->createRenderContext(800, 600) };
+		CommandLog& commands = static_cast<Headless*>(Platform::get())->getLog();
+		ForwardRenderer renderer { true };
+		renderer.setCameraEntity(&camera);
+		for (auto const& e : entities)
+			renderer.addEntity(e.get());
+		renderer.render(rc.get());
+		checkFrame(entities, log, camera);
+		unsigned int opaque = std::count_if(log.begin(), log.end(), [](EntityStub* e)
+		{
+			return !e->m_translucent;
+		});
+		// Opaque entities are drawn twice, once per pass
+		ASSERT_EQ(commands.getCount(CommandLog::Type::DrawMesh), log.size() + opaque);
+		ASSERT_EQ(commands.getCount(CommandLog::Type::Uniform), opaque);
+	}
+	Platform::destroy();
+}
+
+TEST(ForwardRenderer,instanced)
+{
+	Platform::init<Headless>();
+	{
+		std::vector<EntityStub*> log;
+		auto entities = randomEntities(20000, 6, &log);
+		std::vector<std::unique_ptr<IMesh>> meshes;
+		for (unsigned int i = 0; i < 4; i++)
+			meshes.emplace_back(Platform::get()->createMesh());
+		for (unsigned int i = 0; i < entities.size(); i++)
+		{
+			entities[i]->m_instanced = true;
+			entities[i]->m_pMesh = meshes[i % meshes.size()].get();
+		}
+		CameraStub camera { };
+		FrustumCulling culling { };
+		culling.setCamera(&camera);
+		culling.update();
+		unsigned int opaque = 0, translucent = 0;
+		std::set<std::pair<int, IMesh*>> opaqueRuns;
+		for (auto const& e : entities)
+		{
+			if (!culling.checkSphere(e->m_sphere.getCenter(), e->m_sphere.getRadius()))
+				continue;
+			if (e->m_translucent)
+				translucent++;
+			else
+			{
+				opaque++;
+				opaqueRuns.emplace(e->m_material, e->m_pMesh);
+			}
+		}
+		std::unique_ptr<IRenderContext> rc { Platform::get()->createRenderContext(800, 600) };
+		CommandLog& commands = static_cast<Headless*>(Platform::get())->getLog();
+		for (bool zPrePass : { false, true })
+		{
+			ForwardRenderer renderer { zPrePass };
+			renderer.setCameraEntity(&camera);
+			for (auto const& e : entities)
+				renderer.addEntity(e.get());
+			commands.clear();
+			materialSetups = 0;
+			renderer.render(rc.get());
+			// Every visible entity is drawn once per pass, but setupUnique() is never called
+			unsigned int passes = zPrePass ? 2 : 1;
+			ASSERT(log.empty());
+			ASSERT_EQ(commands.getCount(CommandLog::Type::DrawMesh), 0u);
+			ASSERT_EQ(commands.getDrawnInstances(), opaque * passes + translucent);
+			// Opaque entities are drawn once per material and mesh, translucent ones can't be reordered
+			unsigned int draws = commands.getCount(CommandLog::Type::DrawMeshInstanced);
+			ASSERT(draws > opaqueRuns.size() * passes);
+			ASSERT(draws <= opaqueRuns.size() * passes + translucent);
+			ASSERT(materialSetups <= draws);
+		}
+	}
+	Platform::destroy();
+}
+
+TEST(ForwardRenderer,lod)
+{
+	Platform::init<Headless>();
+	{
+		std::vector<std::unique_ptr<IMesh>> meshes;
+		for (unsigned int i = 0; i < 3; i++)
+			meshes.emplace_back(Platform::get()->createMesh());
+		std::vector<EntityStub*> log;
+		Entities entities;
+		for (float depth : { 5.0f, 20.0f, 60.0f })
+		{
+			entities.emplace_back(new EntityStub { { Vec3f { 0, 0, -depth }, 1 }, 0, false, false, &log });
+			entities.back()->m_pMesh = meshes[0].get();
+			entities.back()->m_lods = { { meshes[1].get(), 0.01f }, { meshes[2].get(), 0.05f } };
+		}
+		CameraStub camera { };
+		std::unique_ptr<IRenderContext> rc { Platform::get()->createRenderContext(800, 600) };
+		CommandLog& commands = static_cast<Headless*>(Platform::get())->getLog();
+		ForwardRenderer renderer { };
+		renderer.setCameraEntity(&camera);
+		for (auto const& e : entities)
+			renderer.addEntity(e.get());
+		// Every entity is set up right before its draw
+		auto drawnLods = [&commands, &log, &entities, &meshes]()
+		{
+			std::vector<unsigned int> lods(entities.size());
+			std::size_t draw = 0;
+			for (auto const& c : commands.getCommands())
+			{
+				if (c.m_type != CommandLog::Type::DrawMesh)
+					continue;
+				auto entity = std::find_if(entities.begin(), entities.end(), [&](std::unique_ptr<EntityStub> const& e)
+				{
+					return e.get() == log[draw];
+				}) - entities.begin();
+				lods[entity] = std::find_if(meshes.begin(), meshes.end(), [&c](std::unique_ptr<IMesh> const& m)
+				{
+					return m.get() == c.m_object;
+				}) - meshes.begin();
+				draw++;
+			}
+			log.clear();
+			return lods;
+		};
+		// Errors of 0.01 and 0.05 relative to the radius are acceptable from a distance of 9.2 and 45.8 on
+		ASSERT_EQ(renderer.getLodTolerance(), 0.001f);
+		commands.clear();
+		renderer.render(rc.get());
+		ASSERT_EQ(log.size(), 3u);
+		ASSERT(drawnLods() == (std::vector<unsigned int> { 0, 1, 2 }));
+		// Without tolerance the most detailed level is always drawn
+		renderer.setLodTolerance(0);
+		commands.clear();
+		renderer.render(rc.get());
+		ASSERT(drawnLods() == (std::vector<unsigned int> { 0, 0, 0 }));
+	}
+	Platform::destroy();
+}
+
+TEST(ForwardRenderer,noCamera)
+{
+	Platform::init<Headless>();
+	{
+		std::vector<EntityStub*> log;
+		auto entities = randomEntities(10, 4, &log);
+		std::unique_ptr<IRenderContext> rc { Platform::get()->createRenderContext(800, 600) };
+		CommandLog& commands = static_cast<Headless*>(Platform::get())->getLog();
+		ForwardRenderer renderer { };
+		for (auto const& e : entities)
+			renderer.addEntity(e.get());
+		renderer.render(rc.get());
+		ASSERT_EQ(commands.getCount(CommandLog::Type::DrawMesh), 0u);
+		ASSERT_EQ(renderer.getFPS(), 0u);
+	}
+	Platform::destroy();
+}
@@ -17,6 +17,8 @@ namespace dbgl
 {
     /**
      * @brief Abstract base class for resources
+     * @details load() calls prepare() and finalize(), thus derived classes that support loading in the background
+     * 		override those two instead of load(). Memory costs default to 0.
      */
     class AbstractResource: public IResource
     {
@@ -30,7 +32,21 @@ namespace dbgl
 	    virtual ResourceHandle const& peekHandle() const;
 	    virtual bool isLoaded() const;
 	    virtual void load();
+	    virtual void prepare();
+	    virtual void finalize();
 	    virtual void unload();
+	    virtual std::size_t getCpuBytes() const;
+	    virtual std::size_t getGpuBytes() const;
+	    /**
+	     * @brief Lists the parameters this resource can be found by with ResourceManager::identify()
+	     * @details Derived classes hide this method with one that calls \p func once per set of identifying
+	     * 		parameters, e.g. func(m_filename). The parameters must not change while the resource is managed.
+	     * 		By default, a resource can only be retrieved by its handle.
+	     * @param func Callable that takes any parameters
+	     */
+	    template<typename Func> void forEachKey(Func const& func) const
+	    {
+	    }
 
 	protected:
 	    /**
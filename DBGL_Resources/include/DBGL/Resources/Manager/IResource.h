@@ -11,6 +11,7 @@
 #ifndef IRESOURCE_H_
 #define IRESOURCE_H_
 
+#include <cstddef>
 #include "DBGL/Core/Handle/HandleFactory.h"
 
 namespace dbgl
@@ -48,12 +49,36 @@ namespace dbgl
 	    virtual bool isLoaded() const = 0;
 	    /**
 	     * @brief Loads the resource
+	     * @details Equivalent to calling prepare() followed by finalize().
 	     */
 	    virtual void load() = 0;
+	    /**
+	     * @brief Runs the part of loading that doesn't need the graphics context, e.g. file I/O and decoding
+	     * @details May be called on a worker thread of the ResourceManager, thus it must not touch the graphics
+	     * 		context, the resource handle or any state shared with other resources.
+	     */
+	    virtual void prepare() = 0;
+	    /**
+	     * @brief Completes loading after prepare(), e.g. by uploading buffers and textures
+	     * @details Always called on the thread that owns the ResourceManager and the graphics context.
+	     */
+	    virtual void finalize() = 0;
 	    /**
 	     * @brief Unloads the resource
+	     * @details Also called to discard the results of prepare() if the resource isn't needed anymore before
+	     * 		finalize() ran.
 	     */
 	    virtual void unload() = 0;
+	    /**
+	     * @brief Provides the amount of main memory occupied by the loaded resource
+	     * @return Size in bytes, 0 if the resource is not loaded
+	     */
+	    virtual std::size_t getCpuBytes() const = 0;
+	    /**
+	     * @brief Provides the amount of graphics memory occupied by the loaded resource
+	     * @return Size in bytes, 0 if the resource is not loaded
+	     */
+	    virtual std::size_t getGpuBytes() const = 0;
     };
 }
 
@@ -0,0 +1,101 @@
+//////////////////////////////////////////////////////////////////////
+/// Dragon Blaze Game Library
+///
+/// Copyright (c) 2015 by Jan Moeller
+///
+/// This software is provided "as-is" and does not claim to be
+/// complete or free of bugs in any way. It should work, but
+/// it might also begin to hurt your kittens.
+//////////////////////////////////////////////////////////////////////
+
+#ifndef INCLUDE_DBGL_RESOURCES_MANAGER_RESOURCEKEYHASH_H_
+#define INCLUDE_DBGL_RESOURCES_MANAGER_RESOURCEKEYHASH_H_
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include "DBGL/Core/Hashing/FNVHasher.h"
+#include "DBGL/Platform/File/Filename.h"
+
+namespace dbgl
+{
+    /**
+     * @brief Hashes a parameter that identifies a resource
+     * @details Keys that compare equal have to produce the same hash, even if they are of different types that
+     * 		are used interchangeably: strings hash their characters, no matter if they are passed as std::string,
+     * 		C string or Filename, and integers hash their value, no matter their width. Types without
+     * 		indirection are hashed byte by byte, which also covers pointers. Specialize this struct for other
+     * 		key types.
+     * @tparam Type Decayed type of the key
+     */
+    template<typename Type, typename Enable = void> struct ResourceKeyHash
+    {
+	    static_assert(std::is_trivially_copyable<Type>::value,
+		    "Keys that refer to other memory need a specialization of ResourceKeyHash");
+
+	    static uint64_t hash(Type const& key)
+	    {
+		return FNVHasher::hash64(static_cast<void const*>(&key), sizeof(key));
+	    }
+    };
+
+    template<typename Type> struct ResourceKeyHash<Type, typename std::enable_if<std::is_integral<Type>::value>::type>
+    {
+	    static uint64_t hash(Type key)
+	    {
+		uint64_t value = static_cast<uint64_t>(key);
+		return FNVHasher::hash64(static_cast<void const*>(&value), sizeof(value));
+	    }
+    };
+
+    template<typename Type> struct ResourceKeyHash<Type, typename std::enable_if<std::is_enum<Type>::value>::type>
+    {
+	    static uint64_t hash(Type key)
+	    {
+		return ResourceKeyHash<typename std::underlying_type<Type>::type>::hash(
+			static_cast<typename std::underlying_type<Type>::type>(key));
+	    }
+    };
+
+    template<typename Type> struct ResourceKeyHash<Type,
+	    typename std::enable_if<std::is_floating_point<Type>::value>::type>
+    {
+	    static uint64_t hash(Type key)
+	    {
+		// Adding zero turns -0 into 0, which compare equal
+		double value = static_cast<double>(key) + 0.0;
+		return FNVHasher::hash64(static_cast<void const*>(&value), sizeof(value));
+	    }
+    };
+
+    template<> struct ResourceKeyHash<std::string>
+    {
+	    static uint64_t hash(std::string const& key)
+	    {
+		return FNVHasher::hash64(key);
+	    }
+    };
+
+    template<> struct ResourceKeyHash<char const*>
+    {
+	    static uint64_t hash(char const* key)
+	    {
+		return FNVHasher::hash64(key, std::strlen(key));
+	    }
+    };
+
+    template<> struct ResourceKeyHash<char*> : public ResourceKeyHash<char const*>
+    {
+    };
+
+    template<> struct ResourceKeyHash<Filename>
+    {
+	    static uint64_t hash(Filename const& key)
+	    {
+		return FNVHasher::hash64(key.get());
+	    }
+    };
+}
+
+#endif /* INCLUDE_DBGL_RESOURCES_MANAGER_RESOURCEKEYHASH_H_ */
@@ -11,13 +11,21 @@
 #ifndef INCLUDE_DBGL_RESOURCES_MANAGER_RESOURCEMANAGER_H_
 #define INCLUDE_DBGL_RESOURCES_MANAGER_RESOURCEMANAGER_H_
 
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <limits>
+#include <mutex>
+#include <thread>
 #include <vector>
-#include <set>
-#include <unordered_map>
 #include <utility>
 #include <type_traits>
 #include "DBGL/Resources/Manager/IResource.h"
-#include "DBGL/Core/Hashing/FNVHasher.h"
+#include "DBGL/Resources/Manager/ResourceKeyHash.h"
+#include "DBGL/Core/Collection/FlatHashMap.h"
 
 namespace dbgl
 {
@@ -30,17 +38,46 @@ namespace dbgl
      * 		will then load those resources. As long as other instances maintain a resource handle, this
      * 		resource will not be unloaded, however, as soon as no other references to this handle are held,
      * 		the manager is free to unload the resource at any time.
+     * 		Resources without outside references stay loaded until the resident memory of all loaded resources
+     * 		exceeds the memory budget, then the ones that have been unreferenced the longest are unloaded first.
+     * 		Thus, a resource that is dropped and requested again shortly after doesn't have to be reloaded.
+     * 		If the manager is constructed with worker threads, requested resources are prepared in the
+     * 		background (see IResource::prepare()) and finalize() completes them on the owning thread, as many
+     * 		as fit into a time budget. Resources with a higher priority are processed first. Resources that
+     * 		lose all outside references while waiting are dropped from the queue.
+     * 		Resources that should be found by identify() have to list the parameters that identify them, see
+     * 		AbstractResource::forEachKey(). Each parameter has to be hashable by ResourceKeyHash.
+     * @warning All methods have to be called from the same thread, usually the one that owns the graphics
+     * 		context. Only IResource::prepare() is run on the worker threads.
      */
     template<class T> class ResourceManager
     {
 	public:
+	    /**
+	     * @brief Memory usage and cache efficiency of a manager
+	     */
+	    struct Statistics
+	    {
+		    uint64_t m_hits = 0; //!< Requests of resources that were loaded already
+		    uint64_t m_misses = 0; //!< Requests that caused a resource to be loaded
+		    uint64_t m_evictions = 0; //!< Resources unloaded to stay within the memory budget
+		    std::size_t m_residentCount = 0; //!< Amount of loaded resources
+		    std::size_t m_residentCpuBytes = 0; //!< Main memory occupied by loaded resources
+		    std::size_t m_residentGpuBytes = 0; //!< Graphics memory occupied by loaded resources
+	    };
+
 	    /**
 	     * @brief Constructor
 	     * @param sizeHint Prediction of how many resources the manager will need to keep at once
+	     * @param workerCount Amount of threads that prepare resources in the background. If 0, resources are
+	     * 		      only loaded on the owning thread by loadNext() and finalize().
 	     */
-	    ResourceManager(unsigned int sizeHint = 0);
+	    ResourceManager(unsigned int sizeHint = 0, unsigned int workerCount = 0);
+	    ResourceManager(ResourceManager<T> const& other) = delete;
+	    ResourceManager<T>& operator=(ResourceManager<T> const& other) = delete;
 	    /**
 	     * @brief Destructor
+	     * @details Waits for the resources that are being prepared at the moment
 	     */
 	    ~ResourceManager();
 	    /**
@@ -62,24 +99,28 @@ namespace dbgl
 	    /**
 	     * @brief Retrieves a resource handle by other identifying parameters
 	     * @details The parameters depend on the resource implementation, but may be something like filename and path.
+	     * 		They have to equal one of the keys the resource lists in forEachKey(), the resource's identify()
+	     * 		method then confirms the match. If several resources share a key, the one added first is found.
 	     * @param params Parameters that identify the resource
 	     * @return Handle of the resource or invalid handle if resource not found
-	     * @note This operation generally has near-constant time complexity if the resource has been found using the same
-	     * 	     parameters before. On first identification it is linear in the amount of managed resources. This is also
-	     * 	     the worst-case.
+	     * @note This operation has a near-constant time complexity
 	     */
 	    template<typename ... Types> typename T::ResourceHandle identify(Types&&... params);
 	    /**
 	     * @brief Retrieve a resource by its handle
-	     * @details If the requested resource is not loaded yet, it will be placed in the load queue.
+	     * @details If the requested resource is not loaded yet, it will be placed in the load queue. Requesting a
+	     * 		queued resource again with a higher priority moves it up in the queue.
 	     * @param handle Resource handle
-	     * @param forceLoad Forces the resource to be returned loaded
+	     * @param forceLoad Forces the resource to be returned loaded. Waits for the resource if it is being
+	     * 		    prepared in the background at the moment.
+	     * @param priority Resources with higher priority are loaded first, resources of the same priority in the
+	     * 		   order they have been requested
 	     * @return Pointer to the resource or nullptr if handle invalid
 	     * @note This operation has a constant time complexity
 	     * @warning The returned pointer is not intended to be stored. In fact, the pointer can become invalid
 	     * 		after a time.
 	     */
-	    T* request(typename T::ResourceHandle const& handle, bool forceLoad = false);
+	    T* request(typename T::ResourceHandle const& handle, bool forceLoad = false, int priority = 0);
 	    /**
 	     * @brief Checks if there are any resources that need to be loaded
 	     * @return True in case there are resources to load, otherwise false
@@ -87,7 +128,8 @@ namespace dbgl
 	    bool needLoad() const;
 	    /**
 	     * @brief Provides the amount of resources that need loading
-	     * @return Amount of resources that need loading
+	     * @return Amount of resources that need loading, including the ones that are being prepared or wait for
+	     * 	       finalization
 	     */
 	    unsigned int getLoadQueueSize() const;
 	    /**
@@ -96,22 +138,235 @@ namespace dbgl
 	     */
 	    unsigned int size() const;
 	    /**
-	     * @brief Loads the next resource in the loading queue
+	     * @brief Loads the next resource in the loading queue on the calling thread
 	     */
 	    void loadNext();
+	    /**
+	     * @brief Finalizes the resources that have been prepared in the background
+	     * @details Resources that have lost all outside references in the meantime are unloaded instead. If the
+	     * 		manager doesn't have any worker threads, queued resources are prepared by this method as well.
+	     * 		At least one resource is processed per call, if there is any, even if that exceeds the budget.
+	     * @param budget Time after which no more resources are processed
+	     * @return Amount of resources that have been finalized
+	     * @throws Rethrows exceptions thrown by IResource::prepare() on a worker thread. The failed resource is
+	     * 	       removed from the queue and stays unloaded.
+	     */
+	    unsigned int finalize(std::chrono::microseconds budget = std::chrono::microseconds::max());
+	    /**
+	     * @brief Sets the amount of memory loaded resources may occupy before unreferenced ones are unloaded
+	     * @details Main and graphics memory are counted together. Referenced resources are never unloaded, thus
+	     * 		the budget may be exceeded. Unreferenced resources are unloaded by loadNext() and finalize(),
+	     * 		as well as whenever another resource has been loaded. Resources that lose their last outside
+	     * 		reference are noticed a few at a time by these calls.
+	     * @param bytes Budget in bytes. If 0, unreferenced resources are unloaded as soon as possible.
+	     */
+	    void setMemoryBudget(std::size_t bytes);
+	    /**
+	     * @return The memory budget in bytes
+	     */
+	    std::size_t getMemoryBudget() const;
+	    /**
+	     * @return Memory usage and cache efficiency since construction
+	     */
+	    Statistics const& getStatistics() const;
 
 	private:
-	    uint32_t computeHash();
-	    template<typename First, typename ... Last> uint32_t computeHash(First const& first, Last&&... last);
-	    void checkUnload();
+	    /**
+	     * @brief Index used to mark the ends of the resident list
+	     */
+	    static constexpr unsigned int s_noResource = std::numeric_limits<unsigned int>::max();
+	    /**
+	     * @brief Amount of referenced resources checked per call of evict()
+	     */
+	    static constexpr unsigned int s_sweepCount = 2;
+	    /**
+	     * @brief Progress of a resource through the loading pipeline
+	     */
+	    enum class LoadState : uint8_t
+	    {
+		Idle,      //!< Not queued
+		Queued,    //!< Waiting for a worker
+		Preparing, //!< IResource::prepare() running on a worker
+		Prepared,  //!< Waiting for IResource::finalize()
+	    };
+	    /**
+	     * @brief Book-keeping of the loading pipeline for a resource
+	     */
+	    struct LoadSlot
+	    {
+		    LoadState m_state = LoadState::Idle;
+		    int m_priority = 0;
+		    /**
+		     * @brief Sequence number of the last job queued for the resource
+		     */
+		    uint64_t m_sequence = 0;
+		    /**
+		     * @brief Exception thrown by IResource::prepare(), if any
+		     */
+		    std::exception_ptr m_error;
+	    };
+	    /**
+	     * @brief Book-keeping of the memory cache for a resource
+	     * @details Each resident resource is part of one of two doubly linked lists, depending on whether it
+	     * 		has been referenced the last time the manager checked.
+	     */
+	    struct CacheSlot
+	    {
+		    std::size_t m_cpuBytes = 0;
+		    std::size_t m_gpuBytes = 0;
+		    unsigned int m_prev = s_noResource;
+		    unsigned int m_next = s_noResource;
+		    bool m_resident = false;
+		    bool m_referenced = false;
+	    };
+	    /**
+	     * @brief Ends of a list of resident resources
+	     */
+	    struct CacheList
+	    {
+		    unsigned int m_head = s_noResource;
+		    unsigned int m_tail = s_noResource;
+	    };
+	    /**
+	     * @brief Entry of the queue and the prepared heap
+	     * @details Entries are removed lazily, an entry is only valid if its sequence number matches the one of
+	     * 		the resource.
+	     */
+	    struct Job
+	    {
+		    int m_priority;
+		    uint64_t m_sequence;
+		    unsigned int m_index;
+		    /**
+		     * @brief Heap order, highest priority first, then first come first served
+		     */
+		    bool operator<(Job const& other) const;
+	    };
+
+	    /**
+	     * @brief Entry of the key lookup
+	     * @details Each node belongs to two singly linked lists: the resources that share its key hash, in the
+	     * 		order they have been added, and the keys of its resource. Unused nodes are kept in a free list.
+	     */
+	    struct KeyNode
+	    {
+		    uint64_t m_hash = 0;
+		    unsigned int m_resource = s_noResource;
+		    unsigned int m_nextSameKey = s_noResource;
+		    unsigned int m_nextOfResource = s_noResource;
+	    };
+	    /**
+	     * @brief Passed to forEachKey() of a resource that has just been added, registers each key
+	     */
+	    struct KeyRegistrar
+	    {
+		    ResourceManager<T>* m_manager;
+		    unsigned int m_index;
+		    template<typename ... Types> void operator()(Types const&... key) const;
+	    };
+
+	    /**
+	     * @brief Combines the hashes of all parameters of a key
+	     */
+	    template<typename ... Types> static uint64_t hashKey(Types const&... key);
+	    /**
+	     * @brief Makes a resource findable by a key
+	     */
+	    void addKey(unsigned int index, uint64_t hash);
+	    /**
+	     * @brief Removes all keys of a resource from the lookup
+	     */
+	    void removeKeys(unsigned int index);
+	    /**
+	     * @brief Unloads the unreferenced resources that have been dropped first until the memory budget is met
+	     * @details Checks a few referenced resources whether they have been dropped in the meantime, and then
+	     * 		walks the unreferenced ones from the end. Thus, the cost is proportional to the amount of unloaded
+	     * 		resources, no matter how many referenced ones are resident.
+	     */
+	    void evict();
+	    /**
+	     * @brief Makes a resource that has just been loaded resident, storing its memory costs
+	     */
+	    void admit(unsigned int index);
+	    /**
+	     * @brief Marks a resident resource as referenced
+	     */
+	    void touch(unsigned int index);
+	    /**
+	     * @brief Removes a resource from the resident ones after it has been unloaded
+	     */
+	    void release(unsigned int index);
+	    /**
+	     * @brief Moves a resident resource to the front of the list that matches whether it is referenced
+	     */
+	    void relink(unsigned int index, bool referenced);
+	    void linkFront(CacheList& list, unsigned int index);
+	    void unlink(CacheList& list, unsigned int index);
+	    /**
+	     * @brief Worker thread main loop
+	     */
+	    void work();
+	    /**
+	     * @brief Queues a resource, or raises its priority if it is queued already
+	     * @return True if the resource hasn't been in the loading pipeline before, otherwise false
+	     * @note Requires m_mutex to be locked
+	     */
+	    bool enqueue(unsigned int index, int priority);
+	    /**
+	     * @brief Removes the first valid job of a heap
+	     * @param heap Heap to take from
+	     * @param state State valid jobs have to refer to
+	     * @param[out] job The job
+	     * @return True if there was a valid job, otherwise false
+	     * @note Requires m_mutex to be locked
+	     */
+	    bool take(std::vector<Job>& heap, LoadState state, Job& job);
+	    /**
+	     * @brief Removes a resource from the loading pipeline, waiting for a worker that prepares it
+	     * @param index Index of the resource
+	     * @param lock Lock of m_mutex
+	     * @param[out] error Exception thrown while the resource was prepared, if any
+	     * @return True if the resource has been prepared, otherwise false
+	     */
+	    bool withdraw(unsigned int index, std::unique_lock<std::mutex>& lock, std::exception_ptr& error);
+	    /**
+	     * @brief Drops queued resources that have lost all outside references
+	     */
+	    void cancelUnused();
+	    /**
+	     * @brief Finalizes a prepared resource, or unloads it if it isn't needed anymore
+	     * @param index Index of the resource
+	     * @param error Exception thrown while the resource was prepared, rethrown after unloading the resource
+	     * @return True if the resource has been finalized
+	     */
+	    bool complete(unsigned int index, std::exception_ptr const& error);
 
 	    HandleFactory<> m_handleFactory;
-	    std::vector<T> m_resources;
-	    std::set<uint32_t> m_needProcHandles;
-	    std::unordered_multimap<uint32_t, unsigned int> m_resLookup;
-	    std::unordered_multimap<unsigned int, uint32_t> m_hashLookup;
-	    unsigned int m_unloadIndex = 0; // Next resource to check for unload on loadNext()
-	    const unsigned int m_unloadNum = 2; // Amount of resources to check for unload per loadNext()
+	    /**
+	     * @brief All resources, indexed by handle value
+	     * @details Deque, because workers keep references to resources while new ones are added.
+	     */
+	    std::deque<T> m_resources;
+	    std::vector<LoadSlot> m_loadSlots;
+	    std::vector<Job> m_queue;
+	    std::vector<Job> m_prepared;
+	    uint64_t m_nextSequence = 0;
+	    unsigned int m_pending = 0; // Resources anywhere in the loading pipeline
+	    bool m_stop = false;
+	    mutable std::mutex m_mutex;
+	    std::condition_variable m_wakeUp; // Signaled when a job is queued or the manager is destroyed
+	    std::condition_variable m_done; // Signaled when a job has been prepared
+	    std::vector<std::thread> m_workers;
+	    FlatHashMap<uint64_t, unsigned int> m_keyLookup; // Key hash to first node of the resources with that key
+	    std::vector<KeyNode> m_keyNodes;
+	    std::vector<unsigned int> m_firstKeys; // First key node of each resource
+	    unsigned int m_freeKeyNode = s_noResource;
+	    std::vector<CacheSlot> m_cacheSlots;
+	    CacheList m_referenced; // Resident resources that had outside references when last checked
+	    CacheList m_unreferenced; // Resident resources without outside references, most recently dropped first
+	    unsigned int m_sweep = s_noResource; // Next referenced resource to check in evict()
+	    std::size_t m_memoryBudget = 0;
+	    Statistics m_statistics;
     };
 }
 
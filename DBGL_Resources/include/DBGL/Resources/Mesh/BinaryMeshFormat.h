@@ -0,0 +1,121 @@
+//////////////////////////////////////////////////////////////////////
+/// Dragon Blaze Game Library
+///
+/// Copyright (c) 2015 by Jan Moeller
+///
+/// This software is provided "as-is" and does not claim to be
+/// complete or free of bugs in any way. It should work, but
+/// it might also begin to hurt your kittens.
+//////////////////////////////////////////////////////////////////////
+
+#ifndef INCLUDE_DBGL_RESOURCES_MESH_BINARYMESHFORMAT_H_
+#define INCLUDE_DBGL_RESOURCES_MESH_BINARYMESHFORMAT_H_
+
+#include <cstdint>
+#include <type_traits>
+
+namespace dbgl
+{
+	/**
+	 * @brief Describes the binary mesh container (*.dbm) read and written by the DBM mesh plugin
+	 * @details The container stores a mesh exactly as it is sent to the graphics API, so loading it only needs to
+	 *          map the file and upload the blobs. All values are little endian. A file consists of:
+	 *          <table>
+	 *          <tr><th>Section</th><th>Contents</th></tr>
+	 *          <tr><td>Header</td><td>Counts, bounds and the offsets of all other sections</td></tr>
+	 *          <tr><td>Elements</td><td>Header::m_elementCount vertex layout elements, in vertex order</td></tr>
+	 *          <tr><td>LODs</td><td>Header::m_lodCount index ranges, the most detailed one first</td></tr>
+	 *          <tr><td>Vertices</td><td>Interleaved vertices as written by VertexLayout::pack()</td></tr>
+	 *          <tr><td>Indices</td><td>Indices of all LODs, Header::m_indexSize bytes each</td></tr>
+	 *          </table>
+	 *          Every section starts at a multiple of s_alignment bytes. Readers reject files with a different
+	 *          magic number or version.
+	 */
+	struct BinaryMeshFormat
+	{
+		/**
+		 * @brief Magic number at the start of every file, reads "DBGM"
+		 */
+		static constexpr std::uint32_t s_magic = 0x4D474244;
+		/**
+		 * @brief Current version of the format
+		 */
+		static constexpr std::uint32_t s_version = 1;
+		/**
+		 * @brief Alignment of all sections in bytes
+		 */
+		static constexpr std::uint32_t s_alignment = 16;
+
+		/**
+		 * @brief File header
+		 */
+		struct Header
+		{
+			std::uint32_t m_magic;
+			std::uint32_t m_version;
+			std::uint32_t m_vertexCount;
+			/**
+			 * @brief Total amount of indices of all LODs
+			 */
+			std::uint32_t m_indexCount;
+			/**
+			 * @brief Size of an index in bytes, either 2 or 4
+			 */
+			std::uint32_t m_indexSize;
+			/**
+			 * @brief Size of a vertex in bytes
+			 */
+			std::uint32_t m_stride;
+			std::uint32_t m_elementCount;
+			std::uint32_t m_lodCount;
+			/**
+			 * @brief Bounding sphere, center followed by radius
+			 */
+			float m_sphere[4];
+			float m_aabbMin[3];
+			float m_aabbMax[3];
+			std::uint64_t m_elementsOffset;
+			std::uint64_t m_lodsOffset;
+			std::uint64_t m_verticesOffset;
+			std::uint64_t m_indicesOffset;
+		};
+		/**
+		 * @brief Vertex layout element
+		 */
+		struct Element
+		{
+			/**
+			 * @brief Value of a VertexLayout::Attribute
+			 */
+			std::uint8_t m_attribute;
+			/**
+			 * @brief Value of a VertexLayout::Format
+			 */
+			std::uint8_t m_format;
+			std::uint16_t m_reserved;
+			/**
+			 * @brief Offset from the start of a vertex in bytes
+			 */
+			std::uint32_t m_offset;
+		};
+		/**
+		 * @brief Level of detail, a range of the index section
+		 */
+		struct Lod
+		{
+			std::uint32_t m_firstIndex;
+			std::uint32_t m_indexCount;
+			/**
+			 * @brief Geometric error of this level compared to the most detailed one
+			 */
+			float m_error;
+			std::uint32_t m_reserved;
+		};
+
+		static_assert(std::is_standard_layout<Header>::value && sizeof(Header) == 104, "Unexpected header layout");
+		static_assert(sizeof(Element) == 8, "Unexpected element layout");
+		static_assert(sizeof(Lod) == 16, "Unexpected LOD layout");
+	};
+}
+
+#endif /* INCLUDE_DBGL_RESOURCES_MESH_BINARYMESHFORMAT_H_ */
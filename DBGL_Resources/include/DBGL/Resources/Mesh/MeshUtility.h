@@ -11,6 +11,8 @@
 #ifndef INCLUDE_DBGL_CORE_UTILITY_MESHUTILITY_H_
 #define INCLUDE_DBGL_CORE_UTILITY_MESHUTILITY_H_
 
+#include <limits>
+#include <vector>
 #include "DBGL/Platform/Platform.h"
 #include "DBGL/Platform/Mesh/IMesh.h"
 
@@ -22,6 +24,46 @@ namespace dbgl
 	class MeshUtility
 	{
 	public:
+		/**
+		 * @brief Efficiency of a triangle order regarding the post-transform vertex cache
+		 */
+		struct CacheStatistics
+		{
+			/**
+			 * @brief Average cache miss ratio, i.e. transformed vertices per triangle. Ranges from 0.5 (ideal for
+			 * 		  regular grids) to 3 (no reuse at all).
+			 */
+			float m_acmr = 0;
+			/**
+			 * @brief Average transform to vertex ratio, i.e. how often each referenced vertex is transformed. The
+			 * 		  ideal value is 1.
+			 */
+			float m_atvr = 0;
+		};
+		/**
+		 * @brief Cache statistics of a mesh before and after an optimization
+		 */
+		struct OptimizationStatistics
+		{
+			CacheStatistics m_before;
+			CacheStatistics m_after;
+		};
+		/**
+		 * @brief Level of detail of a mesh
+		 */
+		struct LevelOfDetail
+		{
+			IMesh* m_mesh;
+			/**
+			 * @brief Error compared to the most detailed level, as returned by simplify()
+			 */
+			float m_error;
+		};
+		/**
+		 * @brief Default size of the simulated post-transform vertex cache
+		 */
+		static constexpr unsigned int s_defaultCacheSize = 16;
+
 		/**
 		 * @brief Creates a simple triangle mesh
 		 * @param sendToGPU Determines if buffers should be updated after creation
@@ -67,12 +109,20 @@ namespace dbgl
 		static IMesh* createIcoSphere(unsigned int refine, bool sendToGPU = true, IMesh::Usage usage = IMesh::Usage::StaticDraw);
 		/**
 		 * @brief Generates normals for a mesh
+		 * @details Every vertex gets the average of the normals of all triangles referencing it. Big meshes are
+		 * 			processed on multiple threads. The temporary buffers are kept per calling thread, thus
+		 * 			regenerating the normals of a mesh doesn't allocate any memory unless the mesh grew.
 		 * @param[in,out] mesh Mesh to generate normals for
+		 * @throws std::invalid_argument if the index list doesn't consist of triangles of existing vertices
 		 */
 		static void generateNormals(IMesh* mesh);
 		/**
 		 * @brief Generates the tangent base for a mesh
+		 * @details Normals are generated first if the mesh doesn't have one per vertex. Like generateNormals(),
+		 * 			big meshes are processed on multiple threads.
 		 * @param[in,out] mesh Mesh to generate tangent base for
+		 * @throws std::invalid_argument if the index list doesn't consist of triangles of existing vertices or
+		 * 		   the mesh doesn't have one uv coordinate per vertex
 		 */
 		static void generateTangentBase(IMesh* mesh);
 		/**
@@ -86,6 +136,89 @@ namespace dbgl
 		 * @param maxCompatibilityAngle Maximum angle in radians for normals to count as compatible
 		 */
 		static void optimize(IMesh* mesh, float maxCompatibilityAngle = 0);
+		/**
+		 * @brief Simulates a FIFO post-transform vertex cache on the index list of a mesh
+		 * @param mesh Mesh to analyze
+		 * @param cacheSize Amount of vertices the cache holds
+		 * @throws std::invalid_argument if the index list doesn't consist of triangles of existing vertices
+		 * @return The cache statistics
+		 */
+		static CacheStatistics analyzeVertexCache(IMesh* mesh, unsigned int cacheSize = s_defaultCacheSize);
+		/**
+		 * @brief Reorders the triangles of a mesh for better post-transform vertex cache reuse
+		 * @details Uses the Tipsify algorithm, which runs in linear time and doesn't depend on the exact cache size
+		 * 			or replacement policy of the hardware.
+		 * @param[in,out] mesh Mesh to optimize
+		 * @param cacheSize Amount of vertices the cache is assumed to hold
+		 * @throws std::invalid_argument if the index list doesn't consist of triangles of existing vertices
+		 */
+		static void optimizeVertexCache(IMesh* mesh, unsigned int cacheSize = s_defaultCacheSize);
+		/**
+		 * @brief Reorders the triangles of a mesh to reduce overdraw while mostly keeping the vertex cache reuse
+		 * @details The triangles are split into clusters that don't share the cache with each other. Clusters are
+		 * 			then sorted such that those facing away from the center of the mesh, which are likely to occlude
+		 * 			the others, are drawn first. Expects the mesh to be optimized with optimizeVertexCache() first.
+		 * @param[in,out] mesh Mesh to optimize
+		 * @param threshold Factor applied to the cache miss ratio of each cache-coherent run of triangles. A run is
+		 * 					split as soon as the ratio of its leading triangles drops below the scaled one. Greater
+		 * 					values produce more, smaller clusters and thus less overdraw at the cost of more cache
+		 * 					misses.
+		 * @param cacheSize Amount of vertices the cache is assumed to hold
+		 * @throws std::invalid_argument if the index list doesn't consist of triangles of existing vertices
+		 */
+		static void optimizeOverdraw(IMesh* mesh, float threshold = 1.05f, unsigned int cacheSize = s_defaultCacheSize);
+		/**
+		 * @brief Reorders the vertices of a mesh in the order the index list first references them
+		 * @details All attribute lists of the same size as the vertex list are reordered. Unreferenced vertices are
+		 * 			moved to the end.
+		 * @param[in,out] mesh Mesh to optimize
+		 * @throws std::invalid_argument if the index list doesn't consist of triangles of existing vertices
+		 */
+		static void optimizeVertexFetch(IMesh* mesh);
+		/**
+		 * @brief Runs all triangle and vertex order optimizations on a mesh
+		 * @param[in,out] mesh Mesh to optimize
+		 * @param overdrawThreshold Threshold passed to optimizeOverdraw()
+		 * @param cacheSize Amount of vertices the cache is assumed to hold
+		 * @throws std::invalid_argument if the index list doesn't consist of triangles of existing vertices
+		 * @return Cache statistics before and after the optimization
+		 */
+		static OptimizationStatistics optimizeRendering(IMesh* mesh, float overdrawThreshold = 1.05f,
+				unsigned int cacheSize = s_defaultCacheSize);
+		/**
+		 * @brief Reduces the amount of triangles of a mesh by collapsing edges
+		 * @details Edges are collapsed in the order of their quadric error. Only the index list is changed: an edge is
+		 * 			collapsed by moving the triangles of one of its vertices to the other one, thus the remaining
+		 * 			vertices keep all of their attributes and several levels of detail can share one vertex list.
+		 * 			Borders and seams, i.e. edges along which vertices share their position but not their normals or
+		 * 			uv coordinates, only collapse along themselves. Vertices that are no longer referenced are kept.
+		 * @param[in,out] mesh Mesh to simplify
+		 * @param targetTriangleCount Amount of triangles to stop at
+		 * @param targetError Maximum error to accept. The simplification stops before the first collapse with a
+		 * 					  greater error, even if the target triangle count hasn't been reached yet.
+		 * @throws std::invalid_argument if the index list doesn't consist of triangles of existing vertices
+		 * @return Error of the simplified mesh, i.e. the approximate distance of its surface to the original one,
+		 * 		   relative to the radius of the mesh. That is the radius of the sphere around the center of its
+		 * 		   bounding box that contains all vertices.
+		 */
+		static float simplify(IMesh* mesh, unsigned int targetTriangleCount,
+				float targetError = std::numeric_limits<float>::max());
+		/**
+		 * @brief Generates coarser versions of a mesh
+		 * @details Every level is simplified from \p mesh by simplify(), aiming for \p reduction times the
+		 * 			triangles of the previous level. Unused vertices are removed and the triangle and vertex order of
+		 * 			the generated levels are optimized for rendering. The generation stops early once a level can't be
+		 * 			simplified noticeably further.
+		 * @param mesh Most detailed mesh
+		 * @param levelCount Maximum amount of levels, including \p mesh
+		 * @param reduction Triangle count of each level relative to the previous one
+		 * @param sendToGPU Determines if buffers of the generated levels should be updated after creation
+		 * @throws std::invalid_argument if the index list doesn't consist of triangles of existing vertices
+		 * @return All levels, ordered by decreasing detail. The first one is \p mesh with an error of 0, all
+		 * 		   others are created by this method and have to be deleted by the caller.
+		 */
+		static std::vector<LevelOfDetail> generateLODChain(IMesh* mesh, unsigned int levelCount,
+				float reduction = 0.5f, bool sendToGPU = true);
 	};
 }
 
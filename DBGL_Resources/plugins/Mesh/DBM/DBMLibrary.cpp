@@ -0,0 +1,292 @@
+//////////////////////////////////////////////////////////////////////
+/// Dragon Blaze Game Library
+///
+/// Copyright (c) 2015 by Jan Moeller
+///
+/// This software is provided "as-is" and does not claim to be
+/// complete or free of bugs in any way. It should work, but
+/// it might also begin to hurt your kittens.
+//////////////////////////////////////////////////////////////////////
+
+#include <cstdint>
+#include <cstring>
+#include <cmath>
+#include <string>
+#include <algorithm>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+#include "DBGL/Resources/Mesh/IMeshFormatLibrary.h"
+#include "DBGL/Resources/Mesh/BinaryMeshFormat.h"
+#include "DBGL/Core/Math/Vector3.h"
+#include "DBGL/Platform/File/MappedFile.h"
+#include "DBGL/Platform/Platform.h"
+
+namespace dbgl
+{
+	/**
+	 * @brief Reads and writes the binary mesh container described by BinaryMeshFormat
+	 * @details Loaded meshes have their hardware buffers filled straight from the file mapping, their lists stay
+	 * 			empty. Only the most detailed LOD is loaded.
+	 */
+	class DBMModule : public IMeshFormatLibrary
+	{
+	private:
+		using Format = BinaryMeshFormat;
+
+		/**
+		 * @brief Rounds an offset up to the section alignment
+		 */
+		static std::uint64_t align(std::uint64_t offset)
+		{
+			return (offset + Format::s_alignment - 1) / Format::s_alignment * Format::s_alignment;
+		}
+
+		/**
+		 * @brief Checks if a section lies within the file
+		 */
+		static bool contains(std::size_t fileSize, std::uint64_t offset, std::uint64_t size)
+		{
+			return offset <= fileSize && size <= fileSize - offset;
+		}
+
+		/**
+		 * @brief Checks that all indices of a section refer to existing vertices
+		 * @param indices First index, may be unaligned
+		 * @param count Amount of indices
+		 * @param vertexCount Amount of vertices
+		 */
+		template<typename Index> static bool checkIndices(char const* indices, std::uint32_t count,
+				std::uint32_t vertexCount)
+		{
+			for (std::uint32_t i = 0; i < count; i++)
+			{
+				Index index;
+				std::memcpy(&index, indices + std::size_t { i } * sizeof(index), sizeof(index));
+				if (index >= vertexCount)
+					return false;
+			}
+			return true;
+		}
+
+		/**
+		 * @brief Writes zeros until the stream reaches the section alignment
+		 */
+		static void pad(std::ofstream& file)
+		{
+			static char const s_zeros[Format::s_alignment] = { };
+			auto position = static_cast<std::uint64_t>(file.tellp());
+			file.write(s_zeros, align(position) - position);
+		}
+
+		/**
+		 * @brief Interprets the mapped file
+		 * @param data Contents of the file
+		 * @param size Size of the contents
+		 * @return The mesh, or nullptr if the contents are malformed
+		 */
+		static IMesh* analyze(char const* data, std::size_t size)
+		{
+			Format::Header header;
+			if (size < sizeof(header))
+				return nullptr;
+			std::memcpy(&header, data, sizeof(header));
+			if (header.m_magic != Format::s_magic || header.m_version != Format::s_version)
+				return nullptr;
+			if ((header.m_indexSize != 2 && header.m_indexSize != 4) || header.m_lodCount == 0)
+				return nullptr;
+			std::uint64_t const vertexBytes = std::uint64_t { header.m_vertexCount } * header.m_stride;
+			std::uint64_t const indexBytes = std::uint64_t { header.m_indexCount } * header.m_indexSize;
+			if (!contains(size, header.m_elementsOffset, header.m_elementCount * sizeof(Format::Element))
+					|| !contains(size, header.m_lodsOffset, header.m_lodCount * sizeof(Format::Lod))
+					|| !contains(size, header.m_verticesOffset, vertexBytes)
+					|| !contains(size, header.m_indicesOffset, indexBytes))
+				return nullptr;
+
+			// Rebuild the layout, it has to match the stored offsets exactly
+			VertexLayout layout { };
+			for (std::uint32_t i = 0; i < header.m_elementCount; i++)
+			{
+				Format::Element element;
+				std::memcpy(&element, data + header.m_elementsOffset + i * sizeof(element), sizeof(element));
+				if (element.m_attribute >= VertexLayout::s_attributeCount
+						|| element.m_format > static_cast<std::uint8_t>(VertexLayout::Format::Octahedral))
+					return nullptr;
+				try
+				{
+					layout.add(static_cast<VertexLayout::Attribute>(element.m_attribute),
+							static_cast<VertexLayout::Format>(element.m_format));
+				}
+				catch (std::invalid_argument const&)
+				{
+					return nullptr;
+				}
+				if (layout.getElements().back().m_offset != element.m_offset)
+					return nullptr;
+			}
+			if (layout.getStride() != header.m_stride)
+				return nullptr;
+
+			Format::Lod lod;
+			std::memcpy(&lod, data + header.m_lodsOffset, sizeof(lod));
+			if (lod.m_firstIndex > header.m_indexCount || lod.m_indexCount > header.m_indexCount - lod.m_firstIndex)
+				return nullptr;
+			// Indices past the vertex buffer would make the graphics API read out of bounds
+			char const* indices = data + header.m_indicesOffset;
+			if (header.m_indexSize == sizeof(std::uint16_t)
+					? !checkIndices<std::uint16_t>(indices, header.m_indexCount, header.m_vertexCount)
+					: !checkIndices<std::uint32_t>(indices, header.m_indexCount, header.m_vertexCount))
+				return nullptr;
+
+			IMesh* mesh = Platform::get()->createMesh();
+			mesh->uploadBuffers(layout, data + header.m_verticesOffset, header.m_vertexCount,
+					indices + std::uint64_t { lod.m_firstIndex } * header.m_indexSize,
+					lod.m_indexCount, header.m_indexSize);
+			return mesh;
+		}
+
+		/**
+		 * @brief Computes the bounding volumes of a mesh
+		 * @param mesh Mesh with at least one vertex
+		 * @param[out] header Header to store the bounds to
+		 */
+		static void computeBounds(IMesh* mesh, Format::Header& header)
+		{
+			Vec3f min = mesh->vertices()[0];
+			Vec3f max = min;
+			for (auto const& v : mesh->vertices())
+			{
+				for (unsigned int i = 0; i < 3; i++)
+				{
+					min[i] = std::min(min[i], v[i]);
+					max[i] = std::max(max[i], v[i]);
+				}
+			}
+			Vec3f const center = (min + max) * 0.5f;
+			float radius = 0;
+			for (auto const& v : mesh->vertices())
+				radius = std::max(radius, (v - center).getSquaredLength());
+			for (unsigned int i = 0; i < 3; i++)
+			{
+				header.m_aabbMin[i] = min[i];
+				header.m_aabbMax[i] = max[i];
+				header.m_sphere[i] = center[i];
+			}
+			header.m_sphere[3] = std::sqrt(radius);
+		}
+
+	public:
+		virtual ~DBMModule() = default;
+
+		virtual bool canLoad() const
+		{
+			return true;
+		}
+
+		virtual bool canWrite() const
+		{
+			return true;
+		}
+
+		virtual bool matchExtension(std::string const& extension) const
+		{
+			std::string lowercaseExt { };
+			std::transform(extension.begin(), extension.end(), std::back_inserter(lowercaseExt), ::tolower);
+			return lowercaseExt == ".dbm" || lowercaseExt == "dbm";
+		}
+
+		virtual IMesh* load(std::string const& path) const
+		{
+			return load(Filename { path });
+		}
+
+		virtual IMesh* load(Filename const& path) const
+		{
+			MappedFile file { path };
+			if (!file.open())
+				return nullptr;
+			return analyze(file.getData(), file.getSize());
+		}
+
+		virtual bool write(IMesh* mesh, std::string const& path) const
+		{
+			return write(mesh, Filename { path });
+		}
+
+		virtual bool write(IMesh* mesh, Filename const& path) const
+		{
+			if (mesh == nullptr || mesh->vertices().empty()
+					|| mesh->vertices().size() > std::numeric_limits<std::uint32_t>::max()
+					|| mesh->indices().size() > std::numeric_limits<std::uint32_t>::max())
+				return false;
+			VertexLayout layout { };
+			try
+			{
+				layout = mesh->getLayout().select(*mesh);
+			}
+			catch (std::invalid_argument const&)
+			{
+				return false;
+			}
+			auto const& indices = mesh->indices();
+			bool const shortIndices = indices.empty()
+					|| *std::max_element(indices.begin(), indices.end()) <= std::numeric_limits<std::uint16_t>::max();
+
+			Format::Header header { };
+			header.m_magic = Format::s_magic;
+			header.m_version = Format::s_version;
+			header.m_vertexCount = mesh->vertices().size();
+			header.m_indexCount = indices.size();
+			header.m_indexSize = shortIndices ? sizeof(std::uint16_t) : sizeof(std::uint32_t);
+			header.m_stride = layout.getStride();
+			header.m_elementCount = layout.getElements().size();
+			header.m_lodCount = 1;
+			computeBounds(mesh, header);
+			header.m_elementsOffset = align(sizeof(header));
+			header.m_lodsOffset = align(header.m_elementsOffset + header.m_elementCount * sizeof(Format::Element));
+			header.m_verticesOffset = align(header.m_lodsOffset + header.m_lodCount * sizeof(Format::Lod));
+			header.m_indicesOffset = align(header.m_verticesOffset
+					+ std::uint64_t { header.m_vertexCount } * header.m_stride);
+
+			std::ofstream file { path.get(), std::ios::binary | std::ios::trunc };
+			if (!file.is_open())
+				return false;
+			file.write(reinterpret_cast<char const*>(&header), sizeof(header));
+			pad(file);
+			for (auto const& e : layout.getElements())
+			{
+				Format::Element element { static_cast<std::uint8_t>(e.m_attribute),
+						static_cast<std::uint8_t>(e.m_format), 0, e.m_offset };
+				file.write(reinterpret_cast<char const*>(&element), sizeof(element));
+			}
+			pad(file);
+			Format::Lod lod { 0, header.m_indexCount, 0, 0 };
+			file.write(reinterpret_cast<char const*>(&lod), sizeof(lod));
+			pad(file);
+			std::vector<char> vertices(std::size_t { header.m_vertexCount } * header.m_stride);
+			layout.pack(*mesh, 0, header.m_vertexCount, vertices.data());
+			file.write(vertices.data(), vertices.size());
+			pad(file);
+			if (shortIndices)
+			{
+				std::vector<std::uint16_t> packed(indices.begin(), indices.end());
+				file.write(reinterpret_cast<char const*>(packed.data()), packed.size() * sizeof(std::uint16_t));
+			}
+			else
+				file.write(reinterpret_cast<char const*>(indices.data()), indices.size() * sizeof(std::uint32_t));
+			return file.good();
+		}
+	};
+}
+
+extern "C" dbgl::IMeshFormatLibrary* create()
+{
+	return new dbgl::DBMModule { };
+}
+
+extern "C" void destroy(dbgl::IMeshFormatLibrary* mod)
+{
+	delete mod;
+}
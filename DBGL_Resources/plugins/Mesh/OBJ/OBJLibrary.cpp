@@ -8,312 +8,651 @@
 /// it might also begin to hurt your kittens.
 //////////////////////////////////////////////////////////////////////
 
+#include <cstdint>
+#include <cstdlib>
 #include <cstring>
+#include <cmath>
 #include <string>
 #include <algorithm>
-#include <fstream>
-#include <sstream>
+#include <limits>
+#include <unordered_map>
+#include <vector>
 
 #include "DBGL/Resources/Mesh/IMeshFormatLibrary.h"
 #include "DBGL/Core/Math/Vector3.h"
 #include "DBGL/Core/Math/Vector2.h"
-#include "DBGL/Core/Math/Utility.h"
+#include "DBGL/Core/Utility/Parallel.h"
+#include "DBGL/Platform/File/MappedFile.h"
 #include "DBGL/Platform/Platform.h"
 
 namespace dbgl
 {
-    class OBJModule : public IMeshFormatLibrary
-    {
+	class OBJModule : public IMeshFormatLibrary
+	{
 	private:
-	    /**
-	     * @brief Every OBJ face consists of three vertices having a position and (possibly)
-	     * 	      a UV and/or normal.
-	     */
-	    struct FaceComponent
-	    {
-		public:
-		    /**
-		     * @brief Index of the vertex (coordinate)
-		     */
-		    unsigned short vertexIndex = std::numeric_limits<unsigned short>::max();
-		    /**
-		     * @brief Index of the UV
-		     */
-		    unsigned short uvIndex = std::numeric_limits<unsigned short>::max();
-		    /**
-		     * @brief Index of the normal
-		     */
-		    unsigned short normalIndex = std::numeric_limits<unsigned short>::max();
-	    };
-	    /**
-	     * @brief One face (i.e. polygon)
-	     */
-	    struct Face
-	    {
-		public:
-		    /**
-		     * @brief Components of a face. Currently only polygons with 3 vertices are allowed.
-		     */
-		    FaceComponent components[3]{};
-	    };
-
-	    template <typename T> T to(std::string const& val) const
-	    {
-		std::istringstream lineStream {};
-		lineStream.str(val);
-		T ret = 0;
-		lineStream >> ret;
-		return ret;
-	    }
-	    /**
-	     * @brief Extracts data a string
-	     * @param line String to tokenize
-	     * @param[out] first First token as string
-	     * @param[out] container Other tokens as T
-	     */
-	    template <typename T> void extract(std::string const& line, std::string& first, std::vector<T>& container) const
-	    {
-		std::istringstream lineStream{};
-		lineStream.str(line);
-		lineStream >> first;
-		T curCoord{};
-		while (lineStream >> curCoord)
-		    container.push_back(curCoord);
-	    }
-	    /**
-	     * @brief Tokenizes as string
-	     * @param line Line to tokenize
-	     * @param delim Delimiter
-	     * @param container Container to append tokens to
-	     */
-	    void tokenize(std::string const& line, char delim, std::vector<std::string>& container) const
-	    {
-		std::string curElement{};
-		std::stringstream tokenStream{};
-		tokenStream.str(line);
-		while (std::getline(tokenStream, curElement, delim))
+		/**
+		 * @brief Files are only split up into chunks of at least this many bytes
+		 */
+		static constexpr std::size_t s_minChunkSize = 1 << 20;
+		/**
+		 * @brief Index value of UVs and normals not specified by a face
+		 */
+		static constexpr std::int64_t s_missing = std::numeric_limits<std::int64_t>::min();
+		/**
+		 * @brief Flags marking the indices of a corner that are relative to the chunk it was parsed from
+		 */
+		enum Relative : unsigned char
 		{
-		    if(curElement.empty())
-			continue;
-		    container.push_back(curElement);
+			RelativeVertex = 1 << 0,
+			RelativeUV = 1 << 1,
+			RelativeNormal = 1 << 2,
+		};
+		/**
+		 * @brief Every corner of a face has a position and (possibly) a UV and/or normal.
+		 * @details Indices are 0-based. Negative OBJ indices refer back from the current end of the lists, so they
+		 * 			can only be resolved once the amount of elements in all previous chunks is known. Until then
+		 * 			they are stored relative to the start of the chunk and flagged in Chunk::m_relative.
+		 */
+		struct Corner
+		{
+			std::int64_t m_vertex;
+			std::int64_t m_uv;
+			std::int64_t m_normal;
+		};
+		/**
+		 * @brief Contents of a line-aligned part of a file
+		 */
+		struct Chunk
+		{
+			std::vector<Vec3f> m_vertices;
+			std::vector<Vec2f> m_uvs;
+			std::vector<Vec3f> m_normals;
+			/**
+			 * @brief Corners of all faces, three per triangle
+			 */
+			std::vector<Corner> m_corners;
+			/**
+			 * @brief Relative flags of each corner, empty if no corner has relative indices
+			 */
+			std::vector<unsigned char> m_relative;
+			/**
+			 * @brief Amount of corners with a UV
+			 */
+			std::size_t m_uvCorners = 0;
+			/**
+			 * @brief Amount of corners with a normal
+			 */
+			std::size_t m_normalCorners = 0;
+			bool m_failed = false;
+		};
+		/**
+		 * @brief Resolved indices of a corner into the merged lists, unused attributes are 0
+		 */
+		struct Key
+		{
+			IMesh::Index m_vertex = 0;
+			IMesh::Index m_uv = 0;
+			IMesh::Index m_normal = 0;
+
+			bool operator==(Key const& other) const
+			{
+				return m_vertex == other.m_vertex && m_uv == other.m_uv && m_normal == other.m_normal;
+			}
+		};
+		/**
+		 * @brief Hashes the indices of a corner
+		 */
+		struct KeyHasher
+		{
+			std::size_t operator()(Key const& key) const
+			{
+				std::uint64_t hash = key.m_vertex;
+				hash = hash * 0x9E3779B97F4A7C15ull ^ key.m_uv;
+				hash = hash * 0x9E3779B97F4A7C15ull ^ key.m_normal;
+				return static_cast<std::size_t>(hash ^ (hash >> 32));
+			}
+		};
+
+		static bool isSpace(char c)
+		{
+			return c == ' ' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
 		}
-	    }
-	    /**
-	     * @brief Merges the raw data into a single index
-	     * @param[out] mesh Mesh to store to
-	     * @param faces Original faces
-	     * @param vertices Original vertices
-	     * @param normals Original normals
-	     * @param uvs Original uvs
-	     */
-	    void interpret(IMesh* mesh, std::vector<Face> const& faces, std::vector<Vec3f> const& vertices,
-		    std::vector<Vec3f> const& normals, std::vector<Vec2f> const& uvs) const
-	    {
-		// Iterate over all faces
-		for(unsigned int i = 0; i < faces.size(); i++)
+
+		static bool isDigit(char c)
 		{
-		    auto curFace = faces[i];
-		    // Iterate over all 3 vertices in a face
-		    for(unsigned int j = 0; j < 3; j++)
-		    {
-			Vec3f vertex, normal;
-			Vec2f uv;
-			// Get vertex
-			if(vertices.size() > curFace.components[j].vertexIndex)
-			    vertex = vertices[curFace.components[j].vertexIndex];
-			else
+			return c >= '0' && c <= '9';
+		}
+
+		static void skipSpace(char const*& cur, char const* end)
+		{
+			while (cur < end && isSpace(*cur))
+				cur++;
+		}
+
+		/**
+		 * @brief Checks if there is another token in the line
+		 * @param[in,out] cur Current position, moved to the start of the next token
+		 * @param end End of the line
+		 * @return True if there is another token before the end of the line or a comment
+		 */
+		static bool hasToken(char const*& cur, char const* end)
+		{
+			skipSpace(cur, end);
+			return cur < end && *cur != '#';
+		}
+
+		/**
+		 * @brief Parses a floating point number
+		 * @details Decimal numbers whose mantissa and power of ten are both exact in single precision (mantissa
+		 * 			below 2^24, exponent within +-10) are computed with a single, correctly rounded float operation.
+		 * 			Everything else (long mantissas, larger exponents, inf, nan) goes through std::strtof.
+		 * @param[in,out] cur Start of the number, moved past it on success
+		 * @param end End of the line
+		 * @param[out] out Parsed value
+		 * @return True if a number followed by whitespace or the end of the line was parsed
+		 */
+		static bool parseFloat(char const*& cur, char const* end, float& out)
+		{
+			static float const s_powersOf10[] = { 1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f, 1e10f };
+			skipSpace(cur, end);
+			char const* p = cur;
+			bool negative = false;
+			if (p < end && (*p == '-' || *p == '+'))
+				negative = *p++ == '-';
+			char const* digits = p;
+			std::uint64_t mantissa = 0;
+			int significant = 0;
+			int exponent = 0;
+			bool exact = true;
+			bool anyDigit = false;
+			for (; p < end && isDigit(*p); p++, anyDigit = true)
 			{
-			    // This should never happen TODO: Error handling
-			    return;
+				if (significant < 19)
+				{
+					mantissa = mantissa * 10 + static_cast<unsigned int>(*p - '0');
+					if (mantissa > 0)
+						significant++;
+				}
+				else
+				{
+					exponent++;
+					exact = false;
+				}
+			}
+			if (p < end && *p == '.')
+			{
+				for (p++; p < end && isDigit(*p); p++, anyDigit = true)
+				{
+					if (significant < 19)
+					{
+						mantissa = mantissa * 10 + static_cast<unsigned int>(*p - '0');
+						if (mantissa > 0)
+							significant++;
+						exponent--;
+					}
+					else
+						exact = false;
+				}
+			}
+			if (anyDigit && p < end && (*p == 'e' || *p == 'E'))
+			{
+				char const* q = p + 1;
+				bool negativeExponent = false;
+				if (q < end && (*q == '-' || *q == '+'))
+					negativeExponent = *q++ == '-';
+				if (q < end && isDigit(*q))
+				{
+					int value = 0;
+					for (; q < end && isDigit(*q); q++)
+						if (value < 100000)
+							value = value * 10 + (*q - '0');
+					exponent += negativeExponent ? -value : value;
+					p = q;
+				}
+			}
+			if (!anyDigit || (p < end && !isSpace(*p) && *p != '#'))
+				return parseFloatFallback(cur, end, out);
+			float value = static_cast<float>(mantissa);
+			if (exact && mantissa < (std::uint64_t { 1 } << 24) && exponent >= -10 && exponent <= 10)
+				value = exponent < 0 ? value / s_powersOf10[-exponent] : value * s_powersOf10[exponent];
+			else if (mantissa != 0)
+				value = std::strtof(std::string(digits, p).c_str(), nullptr);
+			out = negative ? -value : value;
+			cur = p;
+			return true;
+		}
+
+		/**
+		 * @brief Parses tokens the fast path doesn't understand, like inf and nan
+		 */
+		static bool parseFloatFallback(char const*& cur, char const* end, float& out)
+		{
+			char const* tokenEnd = cur;
+			while (tokenEnd < end && !isSpace(*tokenEnd))
+				tokenEnd++;
+			std::string token { cur, tokenEnd };
+			char* parsedEnd = nullptr;
+			float value = std::strtof(token.c_str(), &parsedEnd);
+			if (token.empty() || parsedEnd != token.c_str() + token.size())
+				return false;
+			out = value;
+			cur = tokenEnd;
+			return true;
+		}
+
+		/**
+		 * @brief Parses a signed integer
+		 * @param[in,out] cur Start of the integer, moved past it on success
+		 * @param end End of the line
+		 * @param[out] out Parsed value
+		 * @return True if an integer was parsed
+		 */
+		static bool parseInt(char const*& cur, char const* end, std::int64_t& out)
+		{
+			char const* p = cur;
+			bool negative = false;
+			if (p < end && (*p == '-' || *p == '+'))
+				negative = *p++ == '-';
+			std::int64_t value = 0;
+			char const* digits = p;
+			for (; p < end && isDigit(*p); p++)
+			{
+				if (p - digits >= 18)
+					return false;
+				value = value * 10 + (*p - '0');
+			}
+			if (p == digits)
+				return false;
+			out = negative ? -value : value;
+			cur = p;
+			return true;
+		}
+
+		/**
+		 * @brief Converts an OBJ index into a 0-based index
+		 * @param index 1-based index, or negative index relative to the end of the list
+		 * @param count Amount of elements parsed so far in this chunk
+		 * @param flag Flag to set in \p relative if the resulting index is relative to the chunk
+		 * @param[out] relative Relative flags of the corner
+		 * @param[out] out Converted index
+		 * @return False if \p index is 0, which is invalid
+		 */
+		static bool convertIndex(std::int64_t index, std::size_t count, unsigned char flag, unsigned char& relative,
+				std::int64_t& out)
+		{
+			if (index > 0)
+				out = index - 1;
+			else if (index < 0)
+			{
+				out = static_cast<std::int64_t>(count) + index;
+				relative |= flag;
 			}
-			// Get UV
-			bool useUv = true;
-			if(uvs.size() > curFace.components[j].uvIndex)
-			    uv = uvs[curFace.components[j].uvIndex];
-			else
-			    useUv = false;
-			// Get normal
-			bool useNormal = true;
-			if (normals.size() > curFace.components[j].normalIndex)
-			    normal = normals[curFace.components[j].normalIndex];
 			else
-			    useNormal = false;
-			// Add new vertex, normal and uv.
-			auto vertIndex = mesh->vertices().size();
-			mesh->vertices().push_back(vertex);
-			if (useUv)
-			    mesh->uvs().push_back(uv);
-			if(useNormal)
-			    mesh->normals().push_back(normal);
-			// Add the index
-			mesh->indices().push_back(vertIndex);
-		    }
+				return false;
+			return true;
+		}
+
+		/**
+		 * @brief Parses one corner of a face, e.g. "1", "1/2", "1//3" or "1/2/3"
+		 */
+		static bool parseCorner(char const*& cur, char const* end, Chunk const& chunk, Corner& corner,
+				unsigned char& relative)
+		{
+			corner = { s_missing, s_missing, s_missing };
+			relative = 0;
+			std::int64_t index = 0;
+			if (!parseInt(cur, end, index)
+					|| !convertIndex(index, chunk.m_vertices.size(), RelativeVertex, relative, corner.m_vertex))
+				return false;
+			if (cur < end && *cur == '/')
+			{
+				cur++;
+				if (cur < end && *cur != '/')
+				{
+					if (!parseInt(cur, end, index)
+							|| !convertIndex(index, chunk.m_uvs.size(), RelativeUV, relative, corner.m_uv))
+						return false;
+				}
+				if (cur < end && *cur == '/')
+				{
+					cur++;
+					if (!parseInt(cur, end, index)
+							|| !convertIndex(index, chunk.m_normals.size(), RelativeNormal, relative,
+									corner.m_normal))
+						return false;
+				}
+			}
+			return cur == end || isSpace(*cur) || *cur == '#';
+		}
+
+		/**
+		 * @brief Appends a triangle fan of a polygon to a chunk
+		 */
+		static void triangulate(std::vector<Corner> const& polygon, std::vector<unsigned char> const& relative,
+				Chunk& chunk)
+		{
+			bool anyRelative = std::any_of(relative.begin(), relative.end(), [](unsigned char r)
+			{	return r != 0;});
+			if (anyRelative && chunk.m_relative.empty())
+				chunk.m_relative.resize(chunk.m_corners.size(), 0);
+			for (std::size_t i = 1; i + 1 < polygon.size(); i++)
+			{
+				for (std::size_t j : { std::size_t { 0 }, i, i + 1 })
+				{
+					chunk.m_corners.push_back(polygon[j]);
+					if (!chunk.m_relative.empty())
+						chunk.m_relative.push_back(relative[j]);
+					if (polygon[j].m_uv != s_missing)
+						chunk.m_uvCorners++;
+					if (polygon[j].m_normal != s_missing)
+						chunk.m_normalCorners++;
+				}
+			}
+		}
+
+		/**
+		 * @brief Parses a single line
+		 * @param cur Start of the line
+		 * @param end End of the line, excluding the line break
+		 * @param[out] chunk Chunk to append to
+		 * @param polygon Scratch space for the corners of a face
+		 * @param relative Scratch space for the relative flags of a face
+		 * @return False if the line is malformed
+		 */
+		static bool parseLine(char const* cur, char const* end, Chunk& chunk, std::vector<Corner>& polygon,
+				std::vector<unsigned char>& relative)
+		{
+			if (!hasToken(cur, end))
+				return true;
+			char const* keyword = cur;
+			while (cur < end && !isSpace(*cur))
+				cur++;
+			std::size_t const length = cur - keyword;
+			if (length == 1 && keyword[0] == 'v') // Vertex, there may be a w coordinate or a color (ignored here)
+			{
+				Vec3f vertex { };
+				for (unsigned int i = 0; i < 3; i++)
+					if (!parseFloat(cur, end, vertex[i]))
+						return false;
+				chunk.m_vertices.push_back(vertex);
+			}
+			else if (length == 2 && keyword[0] == 'v' && keyword[1] == 't') // UV, w coordinate is ignored
+			{
+				Vec2f uv { };
+				if (!parseFloat(cur, end, uv[0]))
+					return false;
+				if (hasToken(cur, end) && !parseFloat(cur, end, uv[1]))
+					return false;
+				chunk.m_uvs.push_back(uv);
+			}
+			else if (length == 2 && keyword[0] == 'v' && keyword[1] == 'n') // Normal
+			{
+				Vec3f normal { };
+				for (unsigned int i = 0; i < 3; i++)
+					if (!parseFloat(cur, end, normal[i]))
+						return false;
+				chunk.m_normals.push_back(normal);
+			}
+			else if (length == 1 && keyword[0] == 'f') // Face, polygons are split into triangles
+			{
+				polygon.clear();
+				relative.clear();
+				while (hasToken(cur, end))
+				{
+					Corner corner;
+					unsigned char flags;
+					if (!parseCorner(cur, end, chunk, corner, flags))
+						return false;
+					polygon.push_back(corner);
+					relative.push_back(flags);
+				}
+				if (polygon.size() < 3)
+					return false;
+				triangulate(polygon, relative, chunk);
+			}
+			// Everything else might be a group, material or some other line we can skip
+			return true;
+		}
+
+		/**
+		 * @brief Parses all lines in a range
+		 * @param begin Start of the first line
+		 * @param end End of the range, directly after a line break or the end of the file
+		 * @param[out] chunk Chunk to store to
+		 */
+		static void parseChunk(char const* begin, char const* end, Chunk& chunk)
+		{
+			std::vector<Corner> polygon;
+			std::vector<unsigned char> relative;
+			while (begin < end)
+			{
+				auto lineEnd = static_cast<char const*>(std::memchr(begin, '\n', end - begin));
+				if (lineEnd == nullptr)
+					lineEnd = end;
+				if (!parseLine(begin, lineEnd, chunk, polygon, relative))
+				{
+					chunk.m_failed = true;
+					return;
+				}
+				begin = lineEnd + 1;
+			}
+		}
+
+		/**
+		 * @brief Resolves an index of a chunk to an index into the merged list
+		 * @param index Index as stored in the chunk
+		 * @param relative Whether \p index is relative to the chunk
+		 * @param offset Amount of elements in all previous chunks
+		 * @param count Total amount of elements
+		 * @param[out] out Resolved index
+		 * @return False if the index is out of range
+		 */
+		static bool resolve(std::int64_t index, bool relative, std::size_t offset, std::size_t count,
+				IMesh::Index& out)
+		{
+			if (relative)
+				index += static_cast<std::int64_t>(offset);
+			if (index < 0 || static_cast<std::uint64_t>(index) >= count)
+				return false;
+			out = static_cast<IMesh::Index>(index);
+			return true;
+		}
+
+		/**
+		 * @brief Concatenates the lists of all chunks
+		 * @param chunks Chunks in file order
+		 * @param list Member pointer to the list to concatenate
+		 * @param offsets Offsets of every chunk into the merged list
+		 * @return The merged list
+		 */
+		template<typename T> static std::vector<T> concatenate(std::vector<Chunk> const& chunks,
+				std::vector<T> Chunk::* list, std::vector<std::size_t> const& offsets)
+		{
+			std::vector<T> merged(offsets.back());
+			Parallel::forRange(chunks.size(), 1, [&](std::size_t begin, std::size_t end)
+			{
+				for (std::size_t c = begin; c < end; c++)
+				std::copy((chunks[c].*list).begin(), (chunks[c].*list).end(), merged.begin() + offsets[c]);
+			});
+			return merged;
 		}
-	    }
-	    /**
-	     * @brief Analyzes the obj code
-	     * @param contents
-	     * @return
-	     */
-	    IMesh* analyze(std::string const& contents) const
-	    {
-		std::vector<Face> origFaces{};
-		std::vector<Vec3f> origVertices{};
-		std::vector<Vec3f> origNormals{};
-		std::vector<Vec2f> origUvs{};
-		std::istringstream lineStream{};
-		lineStream.str(contents);
-		std::string line{};
-		std::string type{};
-		std::vector<std::string> params;
-		while(std::getline(lineStream, line))
+
+		/**
+		 * @brief Merges the parsed chunks into a mesh
+		 * @details Corners referring to the same combination of position, UV and normal share a vertex, so the mesh
+		 * 			is indexed right away.
+		 * @param chunks Chunks in file order
+		 * @return The mesh, or nullptr if a face refers to an element that doesn't exist
+		 */
+		static IMesh* interpret(std::vector<Chunk> const& chunks)
 		{
-		    if (line.length() == 0) // Skip empty lines
-			continue;
-		    params.clear();
-		    type.clear();
-		    extract(line, type, params);
-		    if (type == "v") // Vertex
-		    {
-			if (params.size() < 3)
-			    return nullptr; // TODO: Better handling of misformatted files
-			if (params.size() > 3)
-			    return nullptr;
-			origVertices.push_back( { to<float>(params[0]), to<float>(params[1]), to<float>(params[2]) });
-		    }
-		    else if (type == "vt") // UV
-		    {
-			if (params.size() < 2)
-			    return nullptr;
-			if (params.size() > 3) // There may be a w coordinate (ignored here)
-			    return nullptr;
-			origUvs.push_back( { to<float>(params[0]), to<float>(params[1]) });
-		    }
-		    else if (type == "vn") // Normal
-		    {
-			if (params.size() < 3)
-			    return nullptr;
-			if (params.size() > 3)
-			    return nullptr;
-			origNormals.push_back( { to<float>(params[0]), to<float>(params[1]), to<float>(params[2]) });
-		    }
-		    else if (type == "f") // Face
-		    {
-			Face curFace {};
-			for (unsigned int i = 0; i < params.size(); i++)
+			// Offsets of every chunk into the merged lists
+			std::vector<std::size_t> vertexOffsets { 0 }, uvOffsets { 0 }, normalOffsets { 0 }, cornerOffsets { 0 };
+			std::size_t uvCorners = 0, normalCorners = 0;
+			for (auto const& chunk : chunks)
+			{
+				vertexOffsets.push_back(vertexOffsets.back() + chunk.m_vertices.size());
+				uvOffsets.push_back(uvOffsets.back() + chunk.m_uvs.size());
+				normalOffsets.push_back(normalOffsets.back() + chunk.m_normals.size());
+				cornerOffsets.push_back(cornerOffsets.back() + chunk.m_corners.size());
+				uvCorners += chunk.m_uvCorners;
+				normalCorners += chunk.m_normalCorners;
+			}
+			std::size_t const corners = cornerOffsets.back();
+			std::size_t const maxIndex = std::numeric_limits<IMesh::Index>::max();
+			if (vertexOffsets.back() > maxIndex || uvOffsets.back() > maxIndex || normalOffsets.back() > maxIndex)
+				return nullptr;
+			// Faces only have UVs or normals if all of them do
+			bool const useUvs = corners > 0 && uvCorners == corners;
+			bool const useNormals = corners > 0 && normalCorners == corners;
+
+			// Resolve the indices of all corners into the merged lists
+			std::vector<Key> keys(corners);
+			std::vector<char> failed(chunks.size(), false);
+			Parallel::forRange(chunks.size(), 1, [&](std::size_t begin, std::size_t end)
 			{
-			    FaceComponent curFaceComponent {};
-			    std::vector<std::string> tokens {};
-			    tokenize(params[i], '/', tokens);
-			    for (unsigned int j = 0; j < tokens.size(); j++)
-			    {
-				unsigned int curIndex = to<unsigned int>(tokens[j]);
-				switch (j)
+				for (std::size_t c = begin; c < end; c++)
 				{
-				    case 0:
-					curFaceComponent.vertexIndex = curIndex - 1; // OBJ indices start with 1
-					break;
-				    case 1:
-					curFaceComponent.uvIndex = curIndex - 1;
-					break;
-				    case 2:
-					curFaceComponent.normalIndex = curIndex - 1;
-					break;
-				    default:
-					// TODO: Issue warning
-					break;
+					auto const& chunk = chunks[c];
+					for (std::size_t i = 0; i < chunk.m_corners.size(); i++)
+					{
+						auto const& corner = chunk.m_corners[i];
+						unsigned char relative = chunk.m_relative.empty() ? 0 : chunk.m_relative[i];
+						Key& key = keys[cornerOffsets[c] + i];
+						if (!resolve(corner.m_vertex, relative & RelativeVertex, vertexOffsets[c],
+										vertexOffsets.back(), key.m_vertex)
+								|| (useUvs && !resolve(corner.m_uv, relative & RelativeUV, uvOffsets[c],
+												uvOffsets.back(), key.m_uv))
+								|| (useNormals && !resolve(corner.m_normal, relative & RelativeNormal,
+												normalOffsets[c], normalOffsets.back(), key.m_normal)))
+						{
+							failed[c] = true;
+							return;
+						}
+					}
 				}
-			    }
-			    curFace.components[i] = curFaceComponent;
+			});
+			if (std::find(failed.begin(), failed.end(), true) != failed.end())
+				return nullptr;
+
+			std::vector<Vec3f> const vertices = concatenate(chunks, &Chunk::m_vertices, vertexOffsets);
+			std::vector<Vec2f> const uvs =
+					useUvs ? concatenate(chunks, &Chunk::m_uvs, uvOffsets) : std::vector<Vec2f> { };
+			std::vector<Vec3f> const normals =
+					useNormals ? concatenate(chunks, &Chunk::m_normals, normalOffsets) : std::vector<Vec3f> { };
+
+			// Create one vertex per distinct combination
+			IMesh* mesh = Platform::get()->createMesh();
+			std::unordered_map<Key, IMesh::Index, KeyHasher> lookup { };
+			lookup.reserve(std::max(vertices.size(), corners / 6));
+			mesh->vertices().reserve(vertices.size());
+			if (useUvs)
+				mesh->uvs().reserve(vertices.size());
+			if (useNormals)
+				mesh->normals().reserve(vertices.size());
+			mesh->indices().resize(corners);
+			for (std::size_t i = 0; i < corners; i++)
+			{
+				auto const& key = keys[i];
+				auto inserted = lookup.emplace(key, static_cast<IMesh::Index>(mesh->vertices().size()));
+				if (inserted.second)
+				{
+					mesh->vertices().push_back(vertices[key.m_vertex]);
+					if (useUvs)
+						mesh->uvs().push_back(uvs[key.m_uv]);
+					if (useNormals)
+						mesh->normals().push_back(normals[key.m_normal]);
+				}
+				mesh->indices()[i] = inserted.first->second;
 			}
-			origFaces.push_back(curFace);
-		    }
-		    else
-			// Might be a comment or some other line we can skip
-			continue;
+			return mesh;
 		}
-		if(lineStream.bad())
+
+		/**
+		 * @brief Analyzes the obj code
+		 * @details The contents are split into line-aligned chunks which are parsed in parallel.
+		 * @param data Contents of the file
+		 * @param size Size of the contents
+		 * @return The mesh, or nullptr if the contents are malformed
+		 */
+		static IMesh* analyze(char const* data, std::size_t size)
 		{
-			// TODO: Error handling
-			return nullptr;
+			std::size_t const chunkCount = std::max<std::size_t>(1,
+					std::min<std::size_t>(Parallel::getThreadCount(), size / s_minChunkSize));
+			std::vector<char const*> bounds(chunkCount + 1, data + size);
+			bounds[0] = data;
+			for (std::size_t i = 1; i < chunkCount; i++)
+			{
+				char const* start = std::max(data + size / chunkCount * i, bounds[i - 1]);
+				auto lineEnd = static_cast<char const*>(std::memchr(start, '\n', data + size - start));
+				bounds[i] = lineEnd ? lineEnd + 1 : data + size;
+			}
+			std::vector<Chunk> chunks(chunkCount);
+			Parallel::forRange(chunkCount, 1, [&](std::size_t begin, std::size_t end)
+			{
+				for (std::size_t c = begin; c < end; c++)
+				parseChunk(bounds[c], bounds[c + 1], chunks[c]);
+			});
+			for (auto const& chunk : chunks)
+				if (chunk.m_failed)
+					return nullptr;
+			return interpret(chunks);
 		}
-		// Create mesh
-		auto mesh = Platform::get()->createMesh();
-		interpret(mesh, origFaces, origVertices, origNormals, origUvs);
-		return mesh;
-	    }
 
 	public:
-	    virtual ~OBJModule() = default;
-
-	    virtual bool canLoad() const
-	    {
-		return true;
-	    }
-
-	    virtual bool canWrite() const
-	    {
-		return false;
-	    }
-
-	    virtual bool matchExtension(std::string const& extension) const
-	    {
-		std::string lowercaseExt{};
-		std::transform(extension.begin(), extension.end(), std::back_inserter(lowercaseExt), ::tolower);
-		return lowercaseExt == ".obj" || lowercaseExt == "obj";
-	    }
-
-	    virtual IMesh* load(std::string const& path) const
-	    {
-		return load(Filename{path});
-	    }
-
-	    virtual IMesh* load(Filename const& path) const
-	    {
-		// Read file
-		std::ifstream file;
-		file.open(path.get().c_str(), std::ios::in);
-		std::string contents;
-		if (file.is_open())
+		virtual ~OBJModule() = default;
+
+		virtual bool canLoad() const
 		{
-		    file.seekg(0, std::ios::end);
-		    unsigned int size = file.tellg();
-		    contents.resize(size);
-		    file.seekg(0, std::ios::beg);
-//		    file.read(&contents[0], size);
-
-		    char buffer[4096];
-		    while (file.read(buffer, sizeof(buffer)))
-		    	contents.append(buffer, sizeof(buffer));
-		    contents.append(buffer, file.gcount());
+			return true;
 		}
-		// Close file
-		file.close();
 
-		// Analyze contents
-		auto mesh = analyze(contents);
+		virtual bool canWrite() const
+		{
+			return false;
+		}
+
+		virtual bool matchExtension(std::string const& extension) const
+		{
+			std::string lowercaseExt { };
+			std::transform(extension.begin(), extension.end(), std::back_inserter(lowercaseExt), ::tolower);
+			return lowercaseExt == ".obj" || lowercaseExt == "obj";
+		}
 
-		return mesh;
-	    }
+		virtual IMesh* load(std::string const& path) const
+		{
+			return load(Filename { path });
+		}
 
-	    virtual bool write(IMesh* mesh, std::string const& path) const
-	    {
-		return write(mesh, Filename{path});
-	    }
+		virtual IMesh* load(Filename const& path) const
+		{
+			MappedFile file { path };
+			if (!file.open())
+				return nullptr;
+			return analyze(file.getData(), file.getSize());
+		}
+
+		virtual bool write(IMesh* mesh, std::string const& path) const
+		{
+			return write(mesh, Filename { path });
+		}
+
+		virtual bool write(IMesh* /* mesh */, Filename const& /* path */) const
+		{
+			return false;
+		}
+	};
 
-	    virtual bool write(IMesh* /* mesh */, Filename const& /* path */) const
-	    {
-		return false;
-	    }
-    };
+	constexpr std::size_t OBJModule::s_minChunkSize;
+	constexpr std::int64_t OBJModule::s_missing;
 }
 
 extern "C" dbgl::IMeshFormatLibrary* create()
 {
-    return new dbgl::OBJModule{};
+	return new dbgl::OBJModule { };
 }
 
 extern "C" void destroy(dbgl::IMeshFormatLibrary* mod)
 {
-    delete mod;
+	delete mod;
 }
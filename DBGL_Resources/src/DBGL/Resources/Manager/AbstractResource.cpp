@@ -32,6 +32,16 @@ namespace dbgl
     }
 
     void AbstractResource::load()
+    {
+	prepare();
+	finalize();
+    }
+
+    void AbstractResource::prepare()
+    {
+    }
+
+    void AbstractResource::finalize()
     {
 	m_loaded = true;
     }
@@ -41,4 +51,14 @@ namespace dbgl
 	m_loaded = false;
     }
 
+    std::size_t AbstractResource::getCpuBytes() const
+    {
+	return 0;
+    }
+
+    std::size_t AbstractResource::getGpuBytes() const
+    {
+	return 0;
+    }
+
 }
@@ -8,17 +8,736 @@
 /// it might also begin to hurt your kittens.
 //////////////////////////////////////////////////////////////////////
 
+#include <cmath>
 #include <cstring>
+#include <limits>
 #include <array>
-#include <map>
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+#include <tuple>
 #include <type_traits>
 #include "DBGL/Core/Math/Vector3.h"
 #include "DBGL/Core/Math/Vector2.h"
-#include "DBGL/Core/Collection/Tree/KdTree.h"
+#include "DBGL/Core/Collection/FlatHashMap.h"
+#include "DBGL/Core/Collection/Tree/StaticKdTree.h"
+#include "DBGL/Core/Math/SIMD.h"
+#include "DBGL/Core/Utility/Parallel.h"
 #include "DBGL/Resources/Mesh/MeshUtility.h"
 
 namespace dbgl
 {
+	namespace
+	{
+		using Index = IMesh::Index;
+
+		/**
+		 * @brief Makes sure the index list of a mesh consists of triangles of existing vertices
+		 */
+		void checkTriangles(IMesh* mesh)
+		{
+			auto const& indices = mesh->indices();
+			if (indices.size() % 3 != 0)
+				throw std::invalid_argument { "Index count is not a multiple of three" };
+			auto const vertexCount = mesh->vertices().size();
+			for (auto i : indices)
+			{
+				if (i >= vertexCount)
+					throw std::invalid_argument { "Index out of range" };
+			}
+		}
+
+		/**
+		 * @brief Simulates a FIFO post-transform vertex cache
+		 * @details Instead of storing the cached vertices, the time of the last miss of every vertex is tracked. A
+		 * 			vertex is cached as long as less than cache size misses happened since its own one.
+		 */
+		class FifoCache
+		{
+		public:
+			FifoCache(std::size_t vertexCount, unsigned int size)
+					: m_stamps(vertexCount, 0), m_time { std::size_t { size } + 1 }, m_size { size }
+			{
+			}
+			/**
+			 * @return Amount of vertices that missed the cache since \p vertex did
+			 */
+			std::size_t getAge(Index vertex) const
+			{
+				return m_time - m_stamps[vertex];
+			}
+			/**
+			 * @brief Transforms a vertex if it's not in the cache
+			 * @return True in case of a cache miss
+			 */
+			bool access(Index vertex)
+			{
+				if (getAge(vertex) <= m_size)
+					return false;
+				m_stamps[vertex] = m_time++;
+				return true;
+			}
+			/**
+			 * @brief Transforms all vertices of a triangle that are not in the cache
+			 * @return Amount of cache misses
+			 */
+			unsigned int access(Index const* triangle)
+			{
+				return access(triangle[0]) + access(triangle[1]) + access(triangle[2]);
+			}
+			/**
+			 * @brief Evicts all vertices
+			 */
+			void flush()
+			{
+				m_time += m_size + 1;
+			}
+		private:
+			std::vector<std::size_t> m_stamps;
+			std::size_t m_time;
+			unsigned int m_size;
+		};
+
+		/**
+		 * @brief Triangles referencing each vertex, stored as one list with a range per vertex
+		 */
+		struct Adjacency
+		{
+			Adjacency() = default;
+			Adjacency(std::vector<Index> const& indices, std::size_t vertexCount)
+			{
+				build(indices, vertexCount);
+			}
+			/**
+			 * @brief Rebuilds the adjacency, reusing the memory of the previous one
+			 */
+			void build(std::vector<Index> const& indices, std::size_t vertexCount)
+			{
+				m_offsets.assign(vertexCount + 1, 0);
+				m_triangles.resize(indices.size());
+				for (auto i : indices)
+					m_offsets[i]++;
+				// Offsets point to the end of every range now, filling from the back moves them to the start
+				std::partial_sum(m_offsets.begin(), m_offsets.end(), m_offsets.begin());
+				for (std::size_t i = indices.size(); i-- > 0;)
+					m_triangles[--m_offsets[indices[i]]] = i / 3;
+			}
+			std::vector<std::size_t> m_offsets;
+			std::vector<std::size_t> m_triangles;
+		};
+
+		/**
+		 * @brief Minimum amount of triangles or vertices worth a thread of their own
+		 */
+		constexpr std::size_t s_minParallelChunk = 4096;
+
+		/**
+		 * @brief Temporary buffers of the normal and tangent generation
+		 * @details Per-triangle and per-vertex values are stored as structure of arrays, one channel after another.
+		 * 			The buffers are kept per calling thread, so regenerating the normals of a mesh over and over
+		 * 			doesn't allocate once they have grown large enough.
+		 */
+		struct AttributeScratch
+		{
+			Adjacency m_adjacency;
+			std::vector<float> m_triangles;
+			std::vector<float> m_vertices;
+		};
+
+		AttributeScratch& getAttributeScratch()
+		{
+			static thread_local AttributeScratch s_scratch { };
+			return s_scratch;
+		}
+
+		/**
+		 * @brief Sums up the per-triangle values of all triangles adjacent to each vertex of a range
+		 * @tparam Channels Amount of channels
+		 * @param adjacency Triangles referencing each vertex
+		 * @param triangles Per-triangle values, \p Channels channels of \p triangleCount floats each
+		 * @param triangleCount Amount of triangles
+		 * @param[out] vertices Per-vertex sums, \p Channels channels of \p vertexCount floats each
+		 * @param vertexCount Amount of vertices
+		 * @param begin First vertex of the range
+		 * @param end One past the last vertex of the range
+		 */
+		template<unsigned int Channels> void gather(Adjacency const& adjacency, float const* triangles,
+				std::size_t triangleCount, float* vertices, std::size_t vertexCount, std::size_t begin, std::size_t end)
+		{
+			for (std::size_t v = begin; v < end; v++)
+			{
+				float sum[Channels] = { };
+				for (std::size_t i = adjacency.m_offsets[v]; i < adjacency.m_offsets[v + 1]; i++)
+				{
+					std::size_t t = adjacency.m_triangles[i];
+					for (unsigned int c = 0; c < Channels; c++)
+						sum[c] += triangles[c * triangleCount + t];
+				}
+				for (unsigned int c = 0; c < Channels; c++)
+					vertices[c * vertexCount + v] = sum[c];
+			}
+		}
+
+		/**
+		 * @brief Moves every element of an attribute list to its remapped position
+		 * @details Lists that don't have one element per vertex are left alone.
+		 */
+		template<typename T> void reorder(std::vector<T>& list, std::vector<Index> const& remap)
+		{
+			if (list.size() != remap.size())
+				return;
+			std::vector<T> sorted(list.size());
+			for (std::size_t i = 0; i < list.size(); i++)
+				sorted[remap[i]] = list[i];
+			list.swap(sorted);
+		}
+
+		/**
+		 * @brief Removes the elements of an attribute list that have been replaced by other ones
+		 * @details Lists that don't have one element per vertex are left alone.
+		 */
+		template<typename T> void compact(std::vector<T>& list, std::vector<Index> const& replace)
+		{
+			if (list.size() != replace.size())
+				return;
+			std::size_t kept = 0;
+			for (std::size_t i = 0; i < list.size(); i++)
+			{
+				if (replace[i] == i)
+					list[kept++] = list[i];
+			}
+			list.resize(kept);
+		}
+
+		/**
+		 * @brief Computes the positions in a triangle list at which the cache is most likely flushed
+		 * @details A triangle that misses the cache with all of its vertices most likely starts a disjoint patch.
+		 * @return Indices of the first triangle of every cluster, always starting with 0
+		 */
+		std::vector<std::size_t> findHardBoundaries(std::vector<Index> const& indices, std::size_t vertexCount,
+				unsigned int cacheSize)
+		{
+			std::vector<std::size_t> boundaries { };
+			FifoCache cache { vertexCount, cacheSize };
+			for (std::size_t i = 0; i < indices.size() / 3; i++)
+			{
+				if (cache.access(&indices[i * 3]) == 3 || i == 0)
+					boundaries.push_back(i);
+			}
+			return boundaries;
+		}
+
+		/**
+		 * @brief Splits the clusters found by findHardBoundaries() at positions with a good enough local cache miss
+		 * 		  ratio
+		 * @return Indices of the first triangle of every cluster, always starting with 0
+		 */
+		std::vector<std::size_t> findSoftBoundaries(std::vector<Index> const& indices, std::size_t vertexCount,
+				std::vector<std::size_t> const& hardBoundaries, float threshold, unsigned int cacheSize)
+		{
+			std::vector<std::size_t> boundaries { };
+			FifoCache cache { vertexCount, cacheSize };
+			for (std::size_t c = 0; c < hardBoundaries.size(); c++)
+			{
+				auto const start = hardBoundaries[c];
+				auto const end = c + 1 < hardBoundaries.size() ? hardBoundaries[c + 1] : indices.size() / 3;
+				cache.flush();
+				std::size_t misses = 0;
+				for (auto i = start; i < end; i++)
+					misses += cache.access(&indices[i * 3]);
+				float const clusterThreshold = threshold * misses / (end - start);
+
+				// Start a new cluster right after the local miss ratio reached the one of the whole run
+				boundaries.push_back(start);
+				cache.flush();
+				std::size_t runningMisses = 0;
+				std::size_t runningTriangles = 0;
+				for (auto i = start; i + 1 < end; i++)
+				{
+					runningMisses += cache.access(&indices[i * 3]);
+					runningTriangles++;
+					if (static_cast<float>(runningMisses) / runningTriangles <= clusterThreshold)
+					{
+						boundaries.push_back(i + 1);
+						cache.flush();
+						runningMisses = 0;
+						runningTriangles = 0;
+					}
+				}
+			}
+			return boundaries;
+		}
+
+		/**
+		 * @brief Removes all vertices that aren't referenced by the index list
+		 */
+		void removeUnusedVertices(IMesh* mesh)
+		{
+			std::vector<bool> used(mesh->vertices().size(), false);
+			for (auto i : mesh->indices())
+				used[i] = true;
+			auto const usedCount = static_cast<std::size_t>(std::count(used.begin(), used.end(), true));
+			MeshUtility::optimizeVertexFetch(mesh);
+			auto const truncate = [usedCount](std::size_t size)
+			{
+				return std::min(size, usedCount);
+			};
+			mesh->vertices().resize(truncate(mesh->vertices().size()));
+			mesh->normals().resize(truncate(mesh->normals().size()));
+			mesh->uvs().resize(truncate(mesh->uvs().size()));
+			mesh->tangents().resize(truncate(mesh->tangents().size()));
+			mesh->bitangents().resize(truncate(mesh->bitangents().size()));
+		}
+
+		/**
+		 * @brief Symmetric 4x4 matrix that measures the weighted squared distance of a point to a set of planes
+		 */
+		struct Quadric
+		{
+			double m_a00 = 0, m_a11 = 0, m_a22 = 0, m_a01 = 0, m_a02 = 0, m_a12 = 0;
+			double m_b0 = 0, m_b1 = 0, m_b2 = 0;
+			double m_c = 0;
+			double m_weight = 0;
+
+			/**
+			 * @brief Creates the quadric of a single plane
+			 * @param normal Normal of the plane, has to be of unit length
+			 * @param point Any point on the plane
+			 * @param weight Weight of the plane
+			 */
+			static Quadric fromPlane(Vec3f const& normal, Vec3f const& point, double weight)
+			{
+				double const a = normal.x();
+				double const b = normal.y();
+				double const c = normal.z();
+				double const d = -normal.dot(point);
+				Quadric q { };
+				q.m_a00 = weight * a * a;
+				q.m_a11 = weight * b * b;
+				q.m_a22 = weight * c * c;
+				q.m_a01 = weight * a * b;
+				q.m_a02 = weight * a * c;
+				q.m_a12 = weight * b * c;
+				q.m_b0 = weight * a * d;
+				q.m_b1 = weight * b * d;
+				q.m_b2 = weight * c * d;
+				q.m_c = weight * d * d;
+				q.m_weight = weight;
+				return q;
+			}
+			Quadric& operator+=(Quadric const& other)
+			{
+				m_a00 += other.m_a00;
+				m_a11 += other.m_a11;
+				m_a22 += other.m_a22;
+				m_a01 += other.m_a01;
+				m_a02 += other.m_a02;
+				m_a12 += other.m_a12;
+				m_b0 += other.m_b0;
+				m_b1 += other.m_b1;
+				m_b2 += other.m_b2;
+				m_c += other.m_c;
+				m_weight += other.m_weight;
+				return *this;
+			}
+			/**
+			 * @return Weighted mean of the squared distances of \p p to all planes
+			 */
+			double evaluate(Vec3f const& p) const
+			{
+				double const x = p.x();
+				double const y = p.y();
+				double const z = p.z();
+				double const r = m_a00 * x * x + m_a11 * y * y + m_a22 * z * z
+						+ 2 * (m_a01 * x * y + m_a02 * x * z + m_a12 * y * z + m_b0 * x + m_b1 * y + m_b2 * z) + m_c;
+				return m_weight > 0 ? std::abs(r) / m_weight : 0;
+			}
+		};
+
+		/**
+		 * @brief Directed triangle edges leaving each vertex, stored as one list with a range per vertex
+		 */
+		struct EdgeAdjacency
+		{
+			EdgeAdjacency(std::vector<Index> const& indices, std::size_t vertexCount)
+					: m_offsets(vertexCount + 1, 0), m_targets(indices.size())
+			{
+				for (auto i : indices)
+					m_offsets[i + 1]++;
+				std::partial_sum(m_offsets.begin(), m_offsets.end(), m_offsets.begin());
+				std::vector<std::size_t> fill(m_offsets.begin(), m_offsets.end() - 1);
+				for (std::size_t i = 0; i < indices.size(); i++)
+					m_targets[fill[indices[i]]++] = indices[i - i % 3 + (i + 1) % 3];
+			}
+			bool hasEdge(Index from, Index to) const
+			{
+				auto const end = m_targets.begin() + m_offsets[from + 1];
+				return std::find(m_targets.begin() + m_offsets[from], end, to) != end;
+			}
+			std::vector<std::size_t> m_offsets;
+			std::vector<Index> m_targets;
+		};
+
+		/**
+		 * @brief Simplifies the index list of a mesh by collapsing the edges with the least quadric error first
+		 * @details Every vertex is classified by its neighborhood. Manifold vertices may collapse into any neighbor.
+		 * 			Border vertices only collapse along their border. Seam vertices are pairs of vertices that share
+		 * 			their position; they only collapse along the seam, together with their partner. All other vertices
+		 * 			are locked. Collapses are done in passes, within a pass every position takes part in one collapse
+		 * 			at most. The quadrics are kept between runs, so the error of successive runs is measured against
+		 * 			the original mesh.
+		 */
+		class Simplifier
+		{
+		public:
+			explicit Simplifier(IMesh* mesh)
+					: m_indices(mesh->indices()), m_positions(mesh->vertices())
+			{
+				auto const vertexCount = m_positions.size();
+				// Normalize positions, so that errors are relative to the size of the mesh
+				if (vertexCount > 0)
+				{
+					Vec3f min = m_positions[0];
+					Vec3f max = min;
+					for (auto const& p : m_positions)
+					{
+						for (unsigned int i = 0; i < 3; i++)
+						{
+							min[i] = std::min(min[i], p[i]);
+							max[i] = std::max(max[i], p[i]);
+						}
+					}
+					Vec3f const center = (min + max) / 2;
+					float radius = 0;
+					for (auto const& p : m_positions)
+						radius = std::max(radius, (p - center).getSquaredLength());
+					radius = std::sqrt(radius);
+					float const scale = radius > 0 ? 1 / radius : 1;
+					for (auto& p : m_positions)
+						p = (p - center) * scale;
+				}
+				findWedges();
+				EdgeAdjacency edges { m_indices, vertexCount };
+				classify(edges);
+				computeQuadrics(edges);
+			}
+
+			/**
+			 * @brief Collapses edges until the target triangle count or error is reached
+			 * @return The resulting error
+			 */
+			float run(std::size_t targetTriangleCount, float targetError)
+			{
+				double const errorLimit = static_cast<double>(targetError) * targetError;
+				while (m_indices.size() / 3 > targetTriangleCount)
+				{
+					EdgeAdjacency edges { m_indices, m_positions.size() };
+					Adjacency triangles { m_indices, m_positions.size() };
+					auto collapses = pickCollapses(edges);
+					std::sort(collapses.begin(), collapses.end(), [](Collapse const& lhs, Collapse const& rhs)
+					{
+						return lhs.m_error < rhs.m_error;
+					});
+
+					// Collapses that share positions with earlier ones are skipped, so the error may grow a bit
+					// beyond the one of the last collapse that would be needed to reach the target
+					std::size_t const goal = m_indices.size() / 3 - targetTriangleCount;
+					double const errorGoal = goal / 2 < collapses.size() ? 1.5 * collapses[goal / 2].m_error :
+							std::numeric_limits<double>::max();
+					std::vector<Index> remap(m_positions.size());
+					std::iota(remap.begin(), remap.end(), 0);
+					std::vector<bool> locked(m_positionCount, false);
+					std::size_t removed = 0;
+					for (auto const& c : collapses)
+					{
+						if (c.m_error > errorLimit || (c.m_error > errorGoal && removed > 0) || removed >= goal)
+							break;
+						if (locked[m_positionIds[c.m_from]] || locked[m_positionIds[c.m_to]])
+							continue;
+						bool const seam = m_kinds[c.m_from] == VertexKind::Seam;
+						if (flips(triangles, remap, c.m_from, c.m_to)
+								|| (seam && flips(triangles, remap, m_wedges[c.m_from], m_wedges[c.m_to])))
+							continue;
+						remap[c.m_from] = c.m_to;
+						if (seam)
+							remap[m_wedges[c.m_from]] = m_wedges[c.m_to];
+						locked[m_positionIds[c.m_from]] = true;
+						locked[m_positionIds[c.m_to]] = true;
+						m_quadrics[m_positionIds[c.m_to]] += m_quadrics[m_positionIds[c.m_from]];
+						removed += m_kinds[c.m_from] == VertexKind::Border ? 1 : 2;
+						m_error = std::max(m_error, c.m_error);
+					}
+					if (removed == 0)
+						break;
+
+					// Drop all triangles that lost their area
+					std::size_t kept = 0;
+					for (std::size_t i = 0; i < m_indices.size(); i += 3)
+					{
+						Index const a = remap[m_indices[i]];
+						Index const b = remap[m_indices[i + 1]];
+						Index const c = remap[m_indices[i + 2]];
+						if (a == b || b == c || c == a)
+							continue;
+						m_indices[kept++] = a;
+						m_indices[kept++] = b;
+						m_indices[kept++] = c;
+					}
+					m_indices.resize(kept);
+				}
+				return static_cast<float>(std::sqrt(m_error));
+			}
+			/**
+			 * @return The simplified index list
+			 */
+			std::vector<Index> const& getIndices() const
+			{
+				return m_indices;
+			}
+		private:
+			enum class VertexKind : unsigned char
+			{
+				Manifold, Border, Seam, Locked
+			};
+			struct Collapse
+			{
+				Index m_from;
+				Index m_to;
+				double m_error;
+			};
+			/**
+			 * @brief Weight of border and seam planes relative to the triangle planes
+			 */
+			static constexpr double s_borderWeight = 2;
+
+			/**
+			 * @brief Links all vertices of the same position to rings
+			 */
+			void findWedges()
+			{
+				auto const vertexCount = m_positions.size();
+				std::vector<Index> sorted(vertexCount);
+				std::iota(sorted.begin(), sorted.end(), 0);
+				auto const less = [this](Index lhs, Index rhs)
+				{
+					auto const& l = m_positions[lhs];
+					auto const& r = m_positions[rhs];
+					return std::make_tuple(l.x(), l.y(), l.z()) < std::make_tuple(r.x(), r.y(), r.z());
+				};
+				std::sort(sorted.begin(), sorted.end(), less);
+				m_positionIds.resize(vertexCount);
+				m_wedges.resize(vertexCount);
+				m_positionCount = 0;
+				for (std::size_t i = 0; i < vertexCount;)
+				{
+					auto end = i + 1;
+					while (end < vertexCount && !less(sorted[i], sorted[end]))
+						end++;
+					for (auto j = i; j < end; j++)
+					{
+						m_positionIds[sorted[j]] = m_positionCount;
+						m_wedges[sorted[j]] = sorted[j + 1 < end ? j + 1 : i];
+					}
+					m_positionCount++;
+					i = end;
+				}
+			}
+
+			/**
+			 * @brief Determines the kind of every vertex
+			 */
+			void classify(EdgeAdjacency const& edges)
+			{
+				auto const vertexCount = m_positions.size();
+				// Vertex of the single open edge leaving and entering each vertex, the vertex itself if there are
+				// several of them
+				Index const none = std::numeric_limits<Index>::max();
+				std::vector<Index> openOut(vertexCount, none);
+				std::vector<Index> openIn(vertexCount, none);
+				for (std::size_t i = 0; i < m_indices.size(); i++)
+				{
+					Index const a = m_indices[i];
+					Index const b = m_indices[i - i % 3 + (i + 1) % 3];
+					if (edges.hasEdge(b, a))
+						continue;
+					openOut[a] = openOut[a] == none ? b : a;
+					openIn[b] = openIn[b] == none ? a : b;
+				}
+				auto const isSingle = [none](Index open, Index vertex)
+				{
+					return open != none && open != vertex;
+				};
+				m_kinds.resize(vertexCount);
+				for (Index v = 0; v < vertexCount; v++)
+				{
+					Index const w = m_wedges[v];
+					m_kinds[v] = VertexKind::Locked;
+					if (w == v)
+					{
+						if (openOut[v] == none && openIn[v] == none)
+							m_kinds[v] = VertexKind::Manifold;
+						else if (isSingle(openOut[v], v) && isSingle(openIn[v], v))
+							m_kinds[v] = VertexKind::Border;
+					}
+					else if (m_wedges[w] == v && isSingle(openOut[v], v) && isSingle(openIn[v], v)
+							&& isSingle(openOut[w], w) && isSingle(openIn[w], w))
+					{
+						// Both sides of a seam run along the same positions in opposite directions
+						if (m_positionIds[openOut[v]] == m_positionIds[openIn[w]]
+								&& m_positionIds[openIn[v]] == m_positionIds[openOut[w]])
+							m_kinds[v] = VertexKind::Seam;
+					}
+				}
+			}
+
+			/**
+			 * @brief Accumulates the quadrics of all triangles, borders and seams at their positions
+			 */
+			void computeQuadrics(EdgeAdjacency const& edges)
+			{
+				m_quadrics.assign(m_positionCount, Quadric { });
+				for (std::size_t t = 0; t < m_indices.size(); t += 3)
+				{
+					Vec3f const& p0 = m_positions[m_indices[t]];
+					Vec3f const& p1 = m_positions[m_indices[t + 1]];
+					Vec3f const& p2 = m_positions[m_indices[t + 2]];
+					Vec3f normal = (p1 - p0).cross(p2 - p0);
+					float const area = normal.getLength();
+					if (area > 0)
+					{
+						auto const q = Quadric::fromPlane(normal / area, p0, area);
+						for (std::size_t i = t; i < t + 3; i++)
+							m_quadrics[m_positionIds[m_indices[i]]] += q;
+					}
+					// Open edges get a plane perpendicular to the triangle that keeps them in place
+					for (std::size_t i = t; i < t + 3; i++)
+					{
+						Index const a = m_indices[i];
+						Index const b = m_indices[t + (i - t + 1) % 3];
+						Index const c = m_indices[t + (i - t + 2) % 3];
+						if (edges.hasEdge(b, a))
+							continue;
+						// Both sides of a seam share the same plane, only add it once
+						bool const seam = m_wedges[a] != a && m_wedges[b] != b
+								&& edges.hasEdge(m_wedges[b], m_wedges[a]);
+						if (seam && m_positionIds[a] > m_positionIds[b])
+							continue;
+						Vec3f edge = m_positions[b] - m_positions[a];
+						float const length = edge.getLength();
+						if (length == 0)
+							continue;
+						edge /= length;
+						Vec3f perpendicular = m_positions[c] - m_positions[a];
+						perpendicular -= edge * perpendicular.dot(edge);
+						if (perpendicular.isZero())
+							continue;
+						perpendicular.normalize();
+						auto const q = Quadric::fromPlane(perpendicular, m_positions[a], length * s_borderWeight);
+						m_quadrics[m_positionIds[a]] += q;
+						m_quadrics[m_positionIds[b]] += q;
+					}
+				}
+			}
+
+			/**
+			 * @brief Checks if the triangles of a vertex may be moved to another vertex
+			 */
+			bool canCollapse(EdgeAdjacency const& edges, Index from, Index to) const
+			{
+				bool const open = !edges.hasEdge(from, to) || !edges.hasEdge(to, from);
+				switch (m_kinds[from])
+				{
+					case VertexKind::Manifold:
+						return true;
+					case VertexKind::Border:
+						return m_kinds[to] == VertexKind::Border && open;
+					case VertexKind::Seam:
+						return m_kinds[to] == VertexKind::Seam && open
+								&& (edges.hasEdge(m_wedges[from], m_wedges[to])
+										|| edges.hasEdge(m_wedges[to], m_wedges[from]));
+					default:
+						return false;
+				}
+			}
+
+			/**
+			 * @brief Finds the cheaper direction of all edges that can be collapsed
+			 */
+			std::vector<Collapse> pickCollapses(EdgeAdjacency const& edges) const
+			{
+				std::vector<Collapse> collapses { };
+				for (std::size_t i = 0; i < m_indices.size(); i++)
+				{
+					Index const a = m_indices[i];
+					Index const b = m_indices[i - i % 3 + (i + 1) % 3];
+					// Inner edges belong to two triangles, only take them once
+					if (a > b && edges.hasEdge(b, a))
+						continue;
+					bool const ab = canCollapse(edges, a, b);
+					bool const ba = canCollapse(edges, b, a);
+					double const errorAB = ab ? m_quadrics[m_positionIds[a]].evaluate(m_positions[b]) : 0;
+					double const errorBA = ba ? m_quadrics[m_positionIds[b]].evaluate(m_positions[a]) : 0;
+					if (ab && (!ba || errorAB <= errorBA))
+						collapses.push_back( { a, b, errorAB });
+					else if (ba)
+						collapses.push_back( { b, a, errorBA });
+				}
+				return collapses;
+			}
+
+			/**
+			 * @brief Checks if moving a vertex to another one would flip any of its remaining triangles
+			 * @param triangles Triangles of every vertex
+			 * @param remap Collapses already done in the current pass
+			 * @param from Vertex to move
+			 * @param to Vertex to move to
+			 */
+			bool flips(Adjacency const& triangles, std::vector<Index> const& remap, Index from, Index to) const
+			{
+				Vec3f const& source = m_positions[from];
+				Vec3f const& target = m_positions[to];
+				for (auto i = triangles.m_offsets[from]; i < triangles.m_offsets[from + 1]; i++)
+				{
+					auto const t = triangles.m_triangles[i] * 3;
+					Index const corners[3] = { remap[m_indices[t]], remap[m_indices[t + 1]], remap[m_indices[t + 2]] };
+					// Triangles along the collapsed edge vanish
+					if (corners[0] == to || corners[1] == to || corners[2] == to)
+						continue;
+					unsigned int const k = corners[0] == from ? 0 : corners[1] == from ? 1 : 2;
+					Vec3f const& p1 = m_positions[corners[(k + 1) % 3]];
+					Vec3f const& p2 = m_positions[corners[(k + 2) % 3]];
+					if ((p1 - source).cross(p2 - source).dot((p1 - target).cross(p2 - target)) <= 0)
+						return true;
+				}
+				return false;
+			}
+
+			std::vector<Index> m_indices;
+			/**
+			 * @brief Vertex positions, normalized to the unit sphere
+			 */
+			std::vector<Vec3f> m_positions;
+			/**
+			 * @brief Id of the position of every vertex, vertices with equal positions share it
+			 */
+			std::vector<Index> m_positionIds;
+			std::size_t m_positionCount = 0;
+			/**
+			 * @brief Next vertex with the same position, forming a ring
+			 */
+			std::vector<Index> m_wedges;
+			std::vector<VertexKind> m_kinds;
+			/**
+			 * @brief Quadric of every position
+			 */
+			std::vector<Quadric> m_quadrics;
+			/**
+			 * @brief Greatest squared error of all collapses so far
+			 */
+			double m_error = 0;
+		};
+	}
+
 	IMesh* MeshUtility::createTriangle(bool sendToGPU, IMesh::Usage usage)
 	{
 		auto mesh = Platform::get()->createMesh();
@@ -425,27 +1144,24 @@ namespace dbgl
 		};
 		// Refine by subdividing the basic triangles
 		std::remove_reference<decltype(mesh->indices())>::type newIndices;
-		std::map<uint64_t, unsigned int> subdivisionIndices;
+		// Every refinement step adds one vertex per edge, that's 10 * (4^refine - 1) vertices in total
+		FlatHashMap<uint64_t, unsigned int> subdivisionIndices { 10 * ((std::size_t { 1 } << (2 * refine)) - 1) };
 		// Computes the vertex in-between two other vertices by their index and inserts it into vertices
 		auto subdivideEdge = [&](unsigned int i, unsigned int j)
 		{
 			// Compute hash
 			uint64_t key = (static_cast<uint64_t>(std::min(i, j)) << 32) + std::max(i, j);
 			// Check if vertex already exists
-			auto vertIter = subdivisionIndices.find(key);
-			if(vertIter != subdivisionIndices.end())
-				return vertIter->second;
-			else
+			auto inserted = subdivisionIndices.insert(key, mesh->vertices().size());
+			if (inserted.second)
 			{
 				// Otherwise compute vertex between the passed vertices
 				auto& v1 = mesh->vertices()[i];
 				auto& v2 = mesh->vertices()[j];
 				Vec3f middle = (v1 + v2).normalize();// On unit sphere
-				unsigned int index = mesh->vertices().size();
-				subdivisionIndices.insert({key, index});
 				mesh->vertices().push_back(middle);
-				return index;
 			}
+			return *inserted.first;
 		};
 		for (unsigned int i = 0; i < refine; i++)
 		{
@@ -511,9 +1227,7 @@ namespace dbgl
 		for (auto vertex : mesh->vertices())
 			mesh->uvs().push_back(computeUV(vertex));
 		// Repair texture seams by duplicating the vertices that need to wrap around the texture border
-		newIndices.clear();
-		std::map<uint64_t, unsigned int> correctionList;
-		for (int i = mesh->indices().size() - 3; i >= 0; i -= 3)
+		auto isSeam = [&](std::size_t i)
 		{
 			Vec2f& uv1 = mesh->uvs()[mesh->indices()[i + 0]];
 			Vec2f& uv2 = mesh->uvs()[mesh->indices()[i + 1]];
@@ -522,34 +1236,43 @@ namespace dbgl
 			Vec3f uv2_3d { uv2.x(), uv2.y(), 0 };
 			Vec3f uv3_3d { uv3.x(), uv3.y(), 0 };
 			Vec3f cross = ((uv1_3d - uv2_3d).cross(uv3_3d - uv2_3d));
-			if (cross.z() <= 0)
-			{ // UVs are mapped in counter-clockwise order, thus there is a seam
-				for (int j = i; j < i + 3; j++)
+			// UVs are mapped in counter-clockwise order, thus there is a seam
+			return cross.z() <= 0;
+		};
+		// Triangles without a seam stay in front in their original order, the repaired ones follow
+		newIndices.clear();
+		for (std::size_t i = 0; i < mesh->indices().size(); i += 3)
+		{
+			if (!isSeam(i))
+				newIndices.insert(newIndices.end(), mesh->indices().begin() + i, mesh->indices().begin() + i + 3);
+		}
+		FlatHashMap<unsigned int, unsigned int> correctionList;
+		for (int i = mesh->indices().size() - 3; i >= 0; i -= 3)
+		{
+			if (!isSeam(i))
+				continue;
+			for (int j = i; j < i + 3; j++)
+			{
+				unsigned int index = mesh->indices()[j];
+				Vec2f& uv = mesh->uvs()[index];
+				if (uv.x() >= 0.9f)
 				{
-					unsigned int index = mesh->indices()[j];
-					Vec3f& vertex = mesh->vertices()[index];
-					Vec2f& uv = mesh->uvs()[index];
-					if (uv.x() >= 0.9f)
+					if (auto corrected = correctionList.find(index))
+						newIndices.push_back(*corrected);
+					else
 					{
-						if (correctionList.count(index) > 0)
-							newIndices.push_back(correctionList[index]);
-						else
-						{
-							Vec2f newUV = uv;
-							newUV.x() -= 1;
-							mesh->uvs().push_back(newUV);
-							mesh->vertices().push_back(mesh->vertices()[index]);
-							unsigned int correctedVertexIndex = mesh->vertices().size() - 1;
-							correctionList.insert( { index, correctedVertexIndex });
-							newIndices.push_back(correctedVertexIndex);
-						}
+						Vec2f newUV = uv;
+						newUV.x() -= 1;
+						mesh->uvs().push_back(newUV);
+						mesh->vertices().push_back(mesh->vertices()[index]);
+						unsigned int correctedVertexIndex = mesh->vertices().size() - 1;
+						correctionList.insert(index, correctedVertexIndex);
+						newIndices.push_back(correctedVertexIndex);
 					}
-					else
-						newIndices.push_back(index);
 				}
+				else
+					newIndices.push_back(index);
 			}
-			else
-				newIndices.insert(newIndices.begin(), mesh->indices().begin() + i, mesh->indices().begin() + i + 3);
 		}
 		mesh->indices().clear();
 		mesh->indices().insert(mesh->indices().begin(), newIndices.begin(), newIndices.end());
@@ -564,88 +1287,130 @@ namespace dbgl
 
 	void MeshUtility::generateNormals(IMesh* mesh)
 	{
-		mesh->normals().clear();
-		mesh->normals().resize(mesh->vertices().size());
-		for (unsigned int i = 0; i < mesh->indices().size(); i += 3)
-		{
-			// Shortcuts
-			Vec3f& v0 = mesh->vertices()[mesh->indices()[i + 0]];
-			Vec3f& v1 = mesh->vertices()[mesh->indices()[i + 1]];
-			Vec3f& v2 = mesh->vertices()[mesh->indices()[i + 2]];
-			Vec3f newNormal = ((v0 - v1).cross(v0 - v2)).normalize();
-			for (unsigned int j = 0; j < 3; j++)
-			{
-				if (mesh->normals()[mesh->indices()[i + j]].getSquaredLength() == 0)
-					mesh->normals()[mesh->indices()[i + j]] = newNormal;
-				else
-				{
-					mesh->normals()[mesh->indices()[i + j]] += newNormal;
-					mesh->normals()[mesh->indices()[i + j]].normalize();
-				}
+		checkTriangles(mesh);
+		auto const& vertices = mesh->vertices();
+		auto const& indices = mesh->indices();
+		std::size_t const vertexCount = vertices.size();
+		std::size_t const triangleCount = indices.size() / 3;
+		auto& scratch = getAttributeScratch();
+		scratch.m_adjacency.build(indices, vertexCount);
+
+		// Face normals, each triangle contributes the same weight to its vertices
+		scratch.m_triangles.resize(triangleCount * 3);
+		float* fx = scratch.m_triangles.data();
+		float* fy = fx + triangleCount;
+		float* fz = fy + triangleCount;
+		Parallel::forRange(triangleCount, s_minParallelChunk, [&](std::size_t begin, std::size_t end)
+		{
+			for (std::size_t t = begin; t < end; t++)
+			{
+				Vec3f const& v0 = vertices[indices[t * 3 + 0]];
+				Vec3f normal = (vertices[indices[t * 3 + 1]] - v0).cross(vertices[indices[t * 3 + 2]] - v0);
+				fx[t] = normal.x();
+				fy[t] = normal.y();
+				fz[t] = normal.z();
 			}
-		}
+			MathKernel::normalizeVec3SoA(fx + begin, fy + begin, fz + begin, end - begin);
+		});
+
+		// Every vertex sums up its own triangles, so the threads never write to the same memory
+		auto& normals = mesh->normals();
+		normals.resize(vertexCount);
+		scratch.m_vertices.resize(vertexCount * 3);
+		float* nx = scratch.m_vertices.data();
+		float* ny = nx + vertexCount;
+		float* nz = ny + vertexCount;
+		Parallel::forRange(vertexCount, s_minParallelChunk, [&](std::size_t begin, std::size_t end)
+		{
+			gather<3>(scratch.m_adjacency, fx, triangleCount, nx, vertexCount, begin, end);
+			MathKernel::normalizeVec3SoA(nx + begin, ny + begin, nz + begin, end - begin);
+			for (std::size_t v = begin; v < end; v++)
+				normals[v] = Vec3f { nx[v], ny[v], nz[v] };
+		});
 	}
 
 	void MeshUtility::generateTangentBase(IMesh* mesh)
 	{
-		// Allocate sufficient memory
-		mesh->tangents().resize(mesh->vertices().size());
-		mesh->bitangents().resize(mesh->vertices().size());
-
-		for (unsigned int i = 0; i < mesh->indices().size(); i += 3)
-		{
-			// Shortcuts
-			Vec3f& v0 = mesh->vertices()[mesh->indices()[i + 0]];
-			Vec3f& v1 = mesh->vertices()[mesh->indices()[i + 1]];
-			Vec3f& v2 = mesh->vertices()[mesh->indices()[i + 2]];
-			Vec2f& uv0 = mesh->uvs()[mesh->indices()[i + 0]];
-			Vec2f& uv1 = mesh->uvs()[mesh->indices()[i + 1]];
-			Vec2f& uv2 = mesh->uvs()[mesh->indices()[i + 2]];
-
-			// Position delta
-			Vec3f deltaPos1 = v1 - v0;
-			Vec3f deltaPos2 = v2 - v0;
-
-			// UV delta
-			Vec2f deltaUV1 = uv1 - uv0;
-			Vec2f deltaUV2 = uv2 - uv0;
-
-			// Calculate tangent and bitangent
-			float r = 1 / (deltaUV1.x() * deltaUV2.y() - deltaUV1.y() * deltaUV2.x());
-			Vec3f tangent = (deltaPos1 * deltaUV2.y() - deltaPos2 * deltaUV1.y()) * r;
-			Vec3f bitangent = (deltaPos2 * deltaUV1.x() - deltaPos1 * deltaUV2.x()) * r;
-
-			// Average tangents and bitangents if already present
-			mesh->tangents()[mesh->indices()[i + 0]] += tangent;
-			mesh->tangents()[mesh->indices()[i + 1]] += tangent;
-			mesh->tangents()[mesh->indices()[i + 2]] += tangent;
-			mesh->bitangents()[mesh->indices()[i + 0]] += bitangent;
-			mesh->bitangents()[mesh->indices()[i + 1]] += bitangent;
-			mesh->bitangents()[mesh->indices()[i + 2]] += bitangent;
-		}
-		// Normalize tangents & bitangents
-		for (unsigned int i = 0; i < mesh->tangents().size(); i++)
-		{
-			mesh->tangents()[i].normalize();
-			mesh->bitangents()[i].normalize();
-		}
-		// Orthogonalize normal/tangent/bitangent system
-		for (unsigned int i = 0; i < mesh->vertices().size(); i++)
+		checkTriangles(mesh);
+		if (mesh->uvs().size() != mesh->vertices().size())
+			throw std::invalid_argument { "Mesh doesn't have one uv coordinate per vertex" };
+		auto& scratch = getAttributeScratch();
+		if (mesh->normals().size() != mesh->vertices().size())
+			generateNormals(mesh);
+		else
+			scratch.m_adjacency.build(mesh->indices(), mesh->vertices().size());
+		auto const& vertices = mesh->vertices();
+		auto const& uvs = mesh->uvs();
+		auto const& normals = mesh->normals();
+		auto const& indices = mesh->indices();
+		std::size_t const vertexCount = vertices.size();
+		std::size_t const triangleCount = indices.size() / 3;
+
+		// Tangent and bitangent of every triangle, weighted by the area of the triangle
+		scratch.m_triangles.resize(triangleCount * 6);
+		float* faces = scratch.m_triangles.data();
+		Parallel::forRange(triangleCount, s_minParallelChunk, [&](std::size_t begin, std::size_t end)
 		{
-			Vec3f& n = mesh->normals()[i];
-			Vec3f& t = mesh->tangents()[i];
-			Vec3f& b = mesh->bitangents()[i];
+			for (std::size_t t = begin; t < end; t++)
+			{
+				Index i0 = indices[t * 3 + 0];
+				Index i1 = indices[t * 3 + 1];
+				Index i2 = indices[t * 3 + 2];
+				Vec3f deltaPos1 = vertices[i1] - vertices[i0];
+				Vec3f deltaPos2 = vertices[i2] - vertices[i0];
+				Vec2f deltaUV1 = uvs[i1] - uvs[i0];
+				Vec2f deltaUV2 = uvs[i2] - uvs[i0];
+				float det = deltaUV1.x() * deltaUV2.y() - deltaUV1.y() * deltaUV2.x();
+				// Triangles with degenerate uv coordinates don't contribute
+				float r = det != 0 ? 1 / det : 0;
+				Vec3f tangent = (deltaPos1 * deltaUV2.y() - deltaPos2 * deltaUV1.y()) * r;
+				Vec3f bitangent = (deltaPos2 * deltaUV1.x() - deltaPos1 * deltaUV2.x()) * r;
+				for (unsigned int c = 0; c < 3; c++)
+				{
+					faces[c * triangleCount + t] = tangent[c];
+					faces[(c + 3) * triangleCount + t] = bitangent[c];
+				}
+			}
+		});
 
+		auto& tangents = mesh->tangents();
+		auto& bitangents = mesh->bitangents();
+		tangents.resize(vertexCount);
+		bitangents.resize(vertexCount);
+		scratch.m_vertices.resize(vertexCount * 6);
+		float* tx = scratch.m_vertices.data();
+		float* ty = tx + vertexCount;
+		float* tz = ty + vertexCount;
+		float* bx = tz + vertexCount;
+		float* by = bx + vertexCount;
+		float* bz = by + vertexCount;
+		Parallel::forRange(vertexCount, s_minParallelChunk, [&](std::size_t begin, std::size_t end)
+		{
+			std::size_t const count = end - begin;
+			gather<6>(scratch.m_adjacency, faces, triangleCount, tx, vertexCount, begin, end);
+			MathKernel::normalizeVec3SoA(tx + begin, ty + begin, tz + begin, count);
+			MathKernel::normalizeVec3SoA(bx + begin, by + begin, bz + begin, count);
 			// Gram-Schmidt orthogonalize
-			t = t - n * n.dot(t);
-			t.normalize();
-
-			// Calculate handedness
-			if (n.cross(t).dot(b) < 0.0f)
+			for (std::size_t v = begin; v < end; v++)
 			{
-				t = t * -1.0f;
+				Vec3f const& n = normals[v];
+				float d = n.x() * tx[v] + n.y() * ty[v] + n.z() * tz[v];
+				tx[v] -= n.x() * d;
+				ty[v] -= n.y() * d;
+				tz[v] -= n.z() * d;
 			}
-		}
+			MathKernel::normalizeVec3SoA(tx + begin, ty + begin, tz + begin, count);
+			for (std::size_t v = begin; v < end; v++)
+			{
+				Vec3f t { tx[v], ty[v], tz[v] };
+				Vec3f b { bx[v], by[v], bz[v] };
+				// Calculate handedness
+				if (normals[v].cross(t).dot(b) < 0.0f)
+					t = t * -1.0f;
+				tangents[v] = t;
+				bitangents[v] = b;
+			}
+		});
 	}
 
 	void MeshUtility::reverseNormals(IMesh* mesh)
@@ -659,18 +1424,22 @@ namespace dbgl
 
 	void MeshUtility::optimize(IMesh* mesh, float maxCompatibilityAngle)
 	{
-		// Vertices into kd-tree for better performance
-		std::vector<unsigned int> indices(mesh->vertices().size());
+		auto const vertexCount = mesh->vertices().size();
+		// Vertices into kd-tree for better performance. The tree is only queried, never modified, thus a
+		// static tree can be used.
+		std::vector<unsigned int> indices(vertexCount);
 		std::iota(std::begin(indices), std::end(indices), 0); // Fill with increasing values, starting with 0
-		KdTree<unsigned int, Vec3f> vertexTree { mesh->vertices().begin(), mesh->vertices().end(), indices.begin(),
+		StaticKdTree<unsigned int, Vec3f> vertexTree { mesh->vertices().begin(), mesh->vertices().end(), indices.begin(),
 				indices.end() };
 
-		std::map<unsigned int, unsigned int> replace { };
+		// Vertex every vertex is replaced with, vertices that are kept are replaced with themselves
+		std::vector<Index> replace(vertexCount);
+		std::iota(replace.begin(), replace.end(), 0);
 
 		// Method to check normal compatibility
 		auto checkNormalCompat = [&maxCompatibilityAngle, &mesh](unsigned int id1, unsigned int id2) -> bool
 		{
-			if(mesh->normals().size() < std::max(id1, id2))
+			if(mesh->normals().size() <= std::max(id1, id2))
 			return true;
 			auto theta = mesh->normals()[id1].getNormalized().dot(mesh->normals()[id2].getNormalized());
 			if (theta < -1.0)
@@ -683,38 +1452,38 @@ namespace dbgl
 		// Method to check uv compatibility
 		auto checkUvCompat = [&mesh](unsigned int id1, unsigned int id2) -> bool
 		{
-			if(mesh->uvs().size() < std::max(id1, id2))
+			if(mesh->uvs().size() <= std::max(id1, id2))
 			return true;
 			return (mesh->uvs()[id1].isSimilar(mesh->uvs()[id2], 0.000001f));
 		};
-		auto mergeVertices = [&mesh, &replace](unsigned int id1, unsigned int id2)
+		auto mergeVertices = [&mesh, &replace](unsigned int kept, unsigned int removed)
 		{
 			// Average coordinates
-				mesh->vertices()[id1] = (mesh->vertices()[id1] + mesh->vertices()[id2]) / 2;
+				mesh->vertices()[kept] = (mesh->vertices()[kept] + mesh->vertices()[removed]) / 2;
 				// Average normals
-				if(mesh->normals().size() > std::max(id1, id2))
+				if(mesh->normals().size() > std::max(kept, removed))
 				{
-					mesh->normals()[id1] += mesh->normals()[id2];
-					mesh->normals()[id1].normalize();
+					mesh->normals()[kept] += mesh->normals()[removed];
+					mesh->normals()[kept].normalize();
 				}
 				// Average uvs
-				if(mesh->uvs().size() > std::max(id1, id2))
+				if(mesh->uvs().size() > std::max(kept, removed))
 				{
-					mesh->uvs()[id1] = (mesh->uvs()[id1] + mesh->uvs()[id2]) / 2;
+					mesh->uvs()[kept] = (mesh->uvs()[kept] + mesh->uvs()[removed]) / 2;
 				}
 				// Memorize index to replace
-				replace.insert(
-						{	id1, id2});
+				replace[removed] = kept;
 			};
 
 		// Iterate over all vertices
-		for (unsigned int i = 0; i < mesh->vertices().size(); i++)
+		std::vector<StaticKdTree<unsigned int, Vec3f>::Container> possible { };
+		for (unsigned int i = 0; i < vertexCount; i++)
 		{
-			if (replace.find(i) != replace.end())
+			if (replace[i] != i)
 				continue;
-			auto& vert = mesh->vertices()[i];
+			auto vert = mesh->vertices()[i];
 			// Find all similar vertices
-			std::vector<KdTree<unsigned int, Vec3f>::Container> possible { };
+			possible.clear();
 			Box<float> range { vert - Vec3f { 0.0001f, 0.0001f, 0.0001f }, Vec3f { 0.0002f, 0.0002f, 0.0002f } };
 			vertexTree.findRange(range, possible);
 			for (auto c : possible)
@@ -722,56 +1491,271 @@ namespace dbgl
 				auto curId = c.data;
 				if (curId == i)
 					continue;
-				if (replace.find(curId) != replace.end())
+				if (replace[curId] != curId)
 					continue;
 				bool normalCompat = checkNormalCompat(i, curId);
 				bool uvCompat = checkUvCompat(i, curId);
 				// If everything is compatible -> merge vertices
 				if (normalCompat && uvCompat)
-					mergeVertices(curId, i);
+					mergeVertices(i, curId);
 			}
 		}
-		// Replace merged vertices
-		for (unsigned int i = 0; i < mesh->indices().size(); i++)
+		// Close the gaps left by the merged vertices in a single pass
+		std::vector<Index> remap(vertexCount);
+		Index kept = 0;
+		for (std::size_t i = 0; i < vertexCount; i++)
+		{
+			if (replace[i] == i)
+				remap[i] = kept++;
+		}
+		for (auto& i : mesh->indices())
+			i = remap[replace[i]];
+		compact(mesh->vertices(), replace);
+		compact(mesh->normals(), replace);
+		compact(mesh->uvs(), replace);
+		// If there are tangents and bitangents, recalculate them
+		if (mesh->tangents().size() > 0 || mesh->bitangents().size() > 0)
 		{
-			auto it = replace.find(mesh->indices()[i]);
-			if (it != replace.end())
+			mesh->tangents().clear();
+			mesh->bitangents().clear();
+			generateTangentBase(mesh);
+		}
+	}
+
+	constexpr unsigned int MeshUtility::s_defaultCacheSize;
+
+	MeshUtility::CacheStatistics MeshUtility::analyzeVertexCache(IMesh* mesh, unsigned int cacheSize)
+	{
+		checkTriangles(mesh);
+		auto const& indices = mesh->indices();
+		CacheStatistics statistics { };
+		if (indices.empty())
+			return statistics;
+		FifoCache cache { mesh->vertices().size(), cacheSize };
+		std::vector<bool> referenced(mesh->vertices().size(), false);
+		std::size_t misses = 0;
+		std::size_t referencedCount = 0;
+		for (std::size_t i = 0; i < indices.size(); i += 3)
+		{
+			misses += cache.access(&indices[i]);
+			for (std::size_t j = i; j < i + 3; j++)
 			{
-				mesh->indices()[i] = it->second;
+				if (!referenced[indices[j]])
+				{
+					referenced[indices[j]] = true;
+					referencedCount++;
+				}
 			}
 		}
-		// Remove unused vertices
-		std::vector<unsigned int> replaceIndices { };
-		replaceIndices.reserve(replace.size());
-		for (auto it = replace.begin(); it != replace.end(); ++it)
+		statistics.m_acmr = static_cast<float>(misses) / (indices.size() / 3);
+		statistics.m_atvr = static_cast<float>(misses) / referencedCount;
+		return statistics;
+	}
+
+	void MeshUtility::optimizeVertexCache(IMesh* mesh, unsigned int cacheSize)
+	{
+		checkTriangles(mesh);
+		auto& indices = mesh->indices();
+		auto const vertexCount = mesh->vertices().size();
+		auto const triangleCount = indices.size() / 3;
+		Adjacency adjacency { indices, vertexCount };
+		// Amount of not yet emitted triangles per vertex
+		std::vector<std::size_t> live(vertexCount);
+		for (std::size_t v = 0; v < vertexCount; v++)
+			live[v] = adjacency.m_offsets[v + 1] - adjacency.m_offsets[v];
+		std::vector<bool> emitted(triangleCount, false);
+		FifoCache cache { vertexCount, cacheSize };
+		// Recently referenced vertices, used to continue locally once the fanned vertex has no triangles left
+		std::vector<Index> deadEnds { };
+		std::vector<Index> candidates { };
+		std::vector<Index> sorted { };
+		sorted.reserve(indices.size());
+		std::size_t cursor = 0;
+
+		auto const skipDeadEnd = [&]() -> std::size_t
+		{
+			while (!deadEnds.empty())
+			{
+				auto vertex = deadEnds.back();
+				deadEnds.pop_back();
+				if (live[vertex] > 0)
+					return vertex;
+			}
+			while (cursor < vertexCount && live[cursor] == 0)
+				cursor++;
+			return cursor;
+		};
+
+		// Fan around one vertex at a time, the next one is the oldest candidate that will still be cached after
+		// all of its remaining triangles have been emitted
+		auto fanning = skipDeadEnd();
+		while (fanning < vertexCount)
 		{
-			replaceIndices.push_back(it->first);
+			candidates.clear();
+			for (auto i = adjacency.m_offsets[fanning]; i < adjacency.m_offsets[fanning + 1]; i++)
+			{
+				auto const triangle = adjacency.m_triangles[i];
+				if (emitted[triangle])
+					continue;
+				emitted[triangle] = true;
+				for (std::size_t j = triangle * 3; j < triangle * 3 + 3; j++)
+				{
+					auto const vertex = indices[j];
+					sorted.push_back(vertex);
+					deadEnds.push_back(vertex);
+					candidates.push_back(vertex);
+					live[vertex]--;
+					cache.access(vertex);
+				}
+			}
+			std::size_t next = vertexCount;
+			std::size_t bestPriority = 0;
+			for (auto vertex : candidates)
+			{
+				if (live[vertex] == 0)
+					continue;
+				std::size_t priority = 1;
+				if (cache.getAge(vertex) + 2 * live[vertex] <= cacheSize)
+					priority += cache.getAge(vertex);
+				if (priority > bestPriority)
+				{
+					bestPriority = priority;
+					next = vertex;
+				}
+			}
+			fanning = next < vertexCount ? next : skipDeadEnd();
 		}
-		std::sort(replaceIndices.begin(), replaceIndices.end());
-		unsigned int offset = 0;
-		for (auto it = replaceIndices.begin(); it != replaceIndices.end(); ++it)
-		{
-			unsigned int rIndex = *it - offset;
-			mesh->vertices().erase(mesh->vertices().begin() + rIndex);
-			if (mesh->normals().size() > rIndex)
-				mesh->normals().erase(mesh->normals().begin() + rIndex);
-			if (mesh->uvs().size() > rIndex)
-				mesh->uvs().erase(mesh->uvs().begin() + rIndex);
-			offset++;
-			// Decrement all indices higher than that by 1
-			for (unsigned int i = 0; i < mesh->indices().size(); i++)
-			{
-				if (mesh->indices()[i] > rIndex)
-					mesh->indices()[i] = mesh->indices()[i] - 1;
+		indices.swap(sorted);
+	}
+
+	void MeshUtility::optimizeOverdraw(IMesh* mesh, float threshold, unsigned int cacheSize)
+	{
+		checkTriangles(mesh);
+		auto& indices = mesh->indices();
+		auto const& vertices = mesh->vertices();
+		if (indices.empty())
+			return;
+		auto const hardBoundaries = findHardBoundaries(indices, vertices.size(), cacheSize);
+		auto const boundaries = findSoftBoundaries(indices, vertices.size(), hardBoundaries, threshold, cacheSize);
+
+		// Clusters facing away from the center of the mesh are drawn first as they are the most likely to occlude
+		Vec3f meshCenter { };
+		for (auto i : indices)
+			meshCenter += vertices[i];
+		meshCenter /= static_cast<float>(indices.size());
+		std::vector<float> occlusion(boundaries.size());
+		for (std::size_t c = 0; c < boundaries.size(); c++)
+		{
+			auto const end = c + 1 < boundaries.size() ? boundaries[c + 1] : indices.size() / 3;
+			Vec3f center { };
+			Vec3f normal { };
+			float area = 0;
+			for (auto t = boundaries[c]; t < end; t++)
+			{
+				auto const& v0 = vertices[indices[t * 3 + 0]];
+				auto const& v1 = vertices[indices[t * 3 + 1]];
+				auto const& v2 = vertices[indices[t * 3 + 2]];
+				// Length of the cross product is twice the triangle area, weighting with it doesn't matter
+				auto const cross = (v1 - v0).cross(v2 - v0);
+				auto const weight = cross.getLength();
+				center += (v0 + v1 + v2) * (weight / 3);
+				normal += cross;
+				area += weight;
 			}
+			if (area > 0)
+				center /= area;
+			if (!normal.isZero())
+				normal.normalize();
+			occlusion[c] = (center - meshCenter).dot(normal);
 		}
-		// If there are tangents and bitangents, recalculate them
-		if (mesh->tangents().size() > 0 || mesh->bitangents().size() > 0)
+		std::vector<std::size_t> order(boundaries.size());
+		std::iota(order.begin(), order.end(), 0);
+		std::stable_sort(order.begin(), order.end(), [&occlusion](std::size_t a, std::size_t b)
 		{
-			mesh->tangents().clear();
-			mesh->bitangents().clear();
-			generateTangentBase(mesh);
+			return occlusion[a] > occlusion[b];
+		});
+
+		std::vector<Index> sorted { };
+		sorted.reserve(indices.size());
+		for (auto c : order)
+		{
+			auto const end = c + 1 < boundaries.size() ? boundaries[c + 1] : indices.size() / 3;
+			sorted.insert(sorted.end(), indices.begin() + boundaries[c] * 3, indices.begin() + end * 3);
 		}
+		indices.swap(sorted);
 	}
 
+	void MeshUtility::optimizeVertexFetch(IMesh* mesh)
+	{
+		checkTriangles(mesh);
+		auto const vertexCount = mesh->vertices().size();
+		Index const unused = std::numeric_limits<Index>::max();
+		std::vector<Index> remap(vertexCount, unused);
+		Index next = 0;
+		for (auto& i : mesh->indices())
+		{
+			if (remap[i] == unused)
+				remap[i] = next++;
+			i = remap[i];
+		}
+		for (auto& r : remap)
+		{
+			if (r == unused)
+				r = next++;
+		}
+
+		reorder(mesh->vertices(), remap);
+		reorder(mesh->normals(), remap);
+		reorder(mesh->uvs(), remap);
+		reorder(mesh->tangents(), remap);
+		reorder(mesh->bitangents(), remap);
+	}
+
+	MeshUtility::OptimizationStatistics MeshUtility::optimizeRendering(IMesh* mesh, float overdrawThreshold,
+			unsigned int cacheSize)
+	{
+		OptimizationStatistics statistics { };
+		statistics.m_before = analyzeVertexCache(mesh, cacheSize);
+		optimizeVertexCache(mesh, cacheSize);
+		optimizeOverdraw(mesh, overdrawThreshold, cacheSize);
+		optimizeVertexFetch(mesh);
+		statistics.m_after = analyzeVertexCache(mesh, cacheSize);
+		return statistics;
+	}
+
+	float MeshUtility::simplify(IMesh* mesh, unsigned int targetTriangleCount, float targetError)
+	{
+		checkTriangles(mesh);
+		Simplifier simplifier { mesh };
+		float const error = simplifier.run(targetTriangleCount, targetError);
+		mesh->indices() = simplifier.getIndices();
+		return error;
+	}
+
+	std::vector<MeshUtility::LevelOfDetail> MeshUtility::generateLODChain(IMesh* mesh, unsigned int levelCount,
+			float reduction, bool sendToGPU)
+	{
+		checkTriangles(mesh);
+		std::vector<LevelOfDetail> levels { { mesh, 0 } };
+		// All levels are simplified by one simplifier, thus each one continues where the previous one stopped
+		Simplifier simplifier { mesh };
+		float target = static_cast<float>(mesh->indices().size() / 3);
+		while (levels.size() < levelCount)
+		{
+			target *= reduction;
+			float const error = simplifier.run(static_cast<std::size_t>(target), std::numeric_limits<float>::max());
+			// Stop once a level doesn't get at least halfway to its target
+			float const previous = static_cast<float>(levels.back().m_mesh->indices().size() / 3);
+			if (simplifier.getIndices().size() / 3 > (previous + target) / 2)
+				break;
+			IMesh* level = mesh->clone();
+			level->indices() = simplifier.getIndices();
+			optimizeVertexCache(level);
+			removeUnusedVertices(level);
+			if (sendToGPU)
+				level->updateBuffers();
+			levels.push_back( { level, error });
+		}
+		return levels;
+	}
 }
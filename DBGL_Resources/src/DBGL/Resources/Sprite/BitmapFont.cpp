@@ -10,6 +10,7 @@
 
 #include "DBGL/Resources/Sprite/BitmapFont.h"
 #include "DBGL/Platform/Platform.h"
+#include "DBGL/Platform/RenderContext/RenderStateBlock.h"
 
 namespace dbgl
 {
@@ -87,51 +88,55 @@ namespace dbgl
 	void BitmapFont::drawText(IRenderContext* rc, IShaderProgram* shader, std::string const& text, unsigned int x,
 			unsigned int y)
 	{
+		// Check for uniforms
+		auto transformId = shader->getUniformHandle("TRANSFORM_2D");
+		auto screenResId = shader->getUniformHandle("v2_screenRes");
+		auto diffuseId = shader->getUniformHandle("tex_diffuse");
+		if (screenResId == IShaderProgram::InvalidUniformHandle || transformId == IShaderProgram::InvalidUniformHandle
+				|| diffuseId == IShaderProgram::InvalidUniformHandle)
+			return;
+
 		shader->use();
+
+		// Set blend mode once for all glyphs
+		RenderStateBlock const previousState = rc->getStateBlock();
+		switch (m_header.bpp)
+		{
+		case 8:
+			rc->apply(previousState.withAlphaBlend(IRenderContext::AlphaBlendValue::SrcAlpha,
+					IRenderContext::AlphaBlendValue::SrcAlpha));
+			break;
+		case 24:
+			rc->apply(previousState.withAlphaBlend(IRenderContext::AlphaBlendValue::Zero,
+					IRenderContext::AlphaBlendValue::Zero));
+			break;
+		case 32:
+			rc->apply(previousState.withAlphaBlend(IRenderContext::AlphaBlendValue::One,
+					IRenderContext::AlphaBlendValue::OneMinusSrcAlpha));
+			break;
+		}
+
+		// All glyphs share texture and screen resolution
+		m_pTexture->bind();
+		Platform::get()->curTexture()->activateUnit(0);
+		Platform::get()->curShaderProgram()->setUniformSampler(diffuseId, 0);
+		Vec2f const screenRes { static_cast<float>(rc->getWidth()), static_cast<float>(rc->getHeight()) };
+		Platform::get()->curShaderProgram()->setUniformFloat2(screenResId, screenRes.getDataPointer());
+
 		unsigned int cursor = 0;
 		for (char const& c : text)
 		{
-			// Check for uniforms
-			auto transformId = shader->getUniformHandle("TRANSFORM_2D");
-			auto screenResId = shader->getUniformHandle("v2_screenRes");
-			auto diffuseId = shader->getUniformHandle("tex_diffuse");
-			if (screenResId == IShaderProgram::InvalidUniformHandle
-					|| transformId == IShaderProgram::InvalidUniformHandle
-					|| diffuseId == IShaderProgram::InvalidUniformHandle)
-				return;
-
-			// Bind diffuse texture to unit 0
-			m_pTexture->bind();
-			Platform::get()->curTexture()->activateUnit(0);
-			Platform::get()->curShaderProgram()->setUniformSampler(diffuseId, 0);
-
-			// Set blend mode
-			auto srcBlend = rc->getSrcAlphaBlend();
-			auto destBlend = rc->getDestAlphaBlend();
-			switch (m_header.bpp)
-			{
-			case 8:
-				rc->setAlphaBlend(IRenderContext::AlphaBlendValue::SrcAlpha, IRenderContext::AlphaBlendValue::SrcAlpha);
-				break;
-			case 24:
-				rc->setAlphaBlend(IRenderContext::AlphaBlendValue::Zero, IRenderContext::AlphaBlendValue::Zero);
-				break;
-			case 32:
-				rc->setAlphaBlend(IRenderContext::AlphaBlendValue::One, IRenderContext::AlphaBlendValue::OneMinusSrcAlpha);
-				break;
-			}
-
 			// Send to shader
 			Mat3f transform = Mat3f::make2DTranslation(x + cursor, y);
-			Platform::get()->curShaderProgram()->setUniformFloat2(screenResId, Vec2f { static_cast<float>(rc->getWidth()), static_cast<float>(rc->getHeight()) }.getDataPointer());
 			Platform::get()->curShaderProgram()->setUniformFloatMatrix3Array(transformId, 1, false, transform.getDataPointer());
 			rc->drawMesh(getSprite(c).getMesh());
 
-			// Return to previous alpha blend values
-			rc->setAlphaBlend(srcBlend, destBlend);
 			// Move cursor right
 			cursor += m_widths[static_cast<int>(c)];
 		}
+
+		// Return to previous alpha blend values
+		rc->apply(previousState);
 	}
 
 	bool BitmapFont::load(std::string const& filename)
@@ -8,6 +8,12 @@
 /// it might also begin to hurt your kittens.
 //////////////////////////////////////////////////////////////////////
 
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
 #include "DBGL/Core/Test/Test.h"
 #include "DBGL/Resources/Manager/ResourceManager.h"
 #include "DBGL/Resources/Manager/AbstractResource.h"
@@ -37,18 +43,62 @@ namespace dbgl_test_ResourceManager
 	    }
 	    bool identify(void(*func)(void)) const
 	    {
-		return func == dbgl_test_ResourceManager::noop;
+		return func == dbgl_test_ResourceManager::noop && m_int == 0;
 	    }
-	    bool identify(void(TestResource::*func)(void)) const
+	    template<typename Func> void forEachKey(Func const& func) const
 	    {
-		return func == &TestResource::noop;
+		func(m_int, m_string);
+		func(m_string);
+		if (m_int == 0)
+		    func(&dbgl_test_ResourceManager::noop);
 	    }
-	    void noop()
+	    int m_int = 0;
+	    std::string m_string = "";
+    };
+
+    /**
+     * @brief Remembers the threads and order it has been loaded in, occupies memory depending on its number
+     */
+    class AsyncResource : public AbstractResource
+    {
+	public:
+	    AsyncResource(ResourceHandle h, int i) : AbstractResource(h), m_int{i}
+	    {
+	    }
+	    bool identify(int i) const
+	    {
+		return m_int == i;
+	    }
+	    template<typename Func> void forEachKey(Func const& func) const
+	    {
+		func(m_int);
+	    }
+	    virtual void prepare()
 	    {
+		if (m_int < 0)
+		    throw std::runtime_error("Failed to prepare");
+		m_prepareThread = std::this_thread::get_id();
+	    }
+	    virtual void finalize()
+	    {
+		AbstractResource::finalize();
+		m_finalizeThread = std::this_thread::get_id();
+		s_order.push_back(m_int);
+	    }
+	    virtual std::size_t getCpuBytes() const
+	    {
+		return m_loaded ? m_int * 100 : 0;
+	    }
+	    virtual std::size_t getGpuBytes() const
+	    {
+		return m_loaded ? 10 : 0;
 	    }
 	    int m_int = 0;
-	    std::string m_string = "";
+	    std::thread::id m_prepareThread;
+	    std::thread::id m_finalizeThread;
+	    static std::vector<int> s_order;
     };
+    std::vector<int> AsyncResource::s_order;
 }
 
 using namespace dbgl_test_ResourceManager;
@@ -88,16 +138,31 @@ TEST(ResourceManager,identify)
     auto handle1_o22 = manager.identify(42, "Hello World");
     ASSERT(handle1_o22.isValid());
     ASSERT_EQ(handle1_o22, handle1);
-    auto handle1_o23 = manager.identify(&noop);
-    ASSERT(handle1_o23.isValid());
-    auto handle1_o24 = manager.identify(&noop);
-    ASSERT_EQ(handle1_o23, handle1_o24);
-    auto handle2 = manager.identify(&TestResource::noop);
-    ASSERT(handle2.isValid());
+    auto handle0 = manager.identify(&noop);
+    ASSERT(handle0.isValid());
+    ASSERT_EQ(handle0, manager.identify(0, ""));
+    // Keys are compared by content, not by type
+    std::string key = "Hello ";
+    key += "World";
+    ASSERT_EQ(manager.identify(key), handle1);
+    ASSERT_EQ(manager.identify(42L, key), handle1);
+    ASSERT_EQ(manager.identify(static_cast<unsigned char>(42), "Hello World"), handle1);
 
     auto handle2_o = manager.identify("Hello");
     ASSERT(!handle2_o.isValid());
     ASSERT_NEQ(handle2_o, handle1);
+    ASSERT(!manager.identify(23, "Hello World").isValid());
+
+    // Once removed, the next resource with the same key is found
+    auto handle3 = manager.identify(1, "Hello World");
+    ASSERT(manager.remove(handle1, true));
+    ASSERT_EQ(manager.identify("Hello World"), handle3);
+    ASSERT(!manager.identify(42, "Hello World").isValid());
+    ASSERT(manager.remove(handle3, true));
+    ASSERT(!manager.identify("Hello World").isValid());
+    auto handle4 = manager.add(42, "Hello World");
+    ASSERT_EQ(manager.identify(42, "Hello World"), handle4);
+    ASSERT_EQ(manager.identify("Hello World"), handle4);
 }
 
 TEST(ResourceManager,request)
@@ -215,3 +280,151 @@ TEST(ResourceManager,loadNext)
     ASSERT_EQ(manager.request(manager.identify(1, "1"), false)->isLoaded(), false);
     ASSERT_EQ(manager.request(manager.identify(2, "2"), false)->isLoaded(), false);
 }
+
+TEST(ResourceManager,finalize)
+{
+    ResourceManager<AsyncResource> manager { 0, 2 };
+    vector<AsyncResource::ResourceHandle> handles;
+    for (int i = 0; i < 20; i++)
+    {
+	handles.push_back(manager.add(i));
+	manager.request(handles.back(), false, i % 3);
+    }
+    ASSERT(manager.needLoad());
+    unsigned int finalized = 0;
+    while (manager.needLoad())
+    {
+	finalized += manager.finalize(std::chrono::microseconds { 100 });
+	std::this_thread::yield();
+    }
+    ASSERT_EQ(finalized, 20u);
+    for (auto const& h : handles)
+    {
+	auto pRes = manager.request(h);
+	ASSERT(pRes->isLoaded());
+	// Prepared in the background, finalized on the owning thread
+	ASSERT(pRes->m_prepareThread != std::this_thread::get_id());
+	ASSERT(pRes->m_finalizeThread == std::this_thread::get_id());
+    }
+    // Waits for the workers
+    auto handle = manager.add(100);
+    auto pRes = manager.request(handle, true);
+    ASSERT(pRes->isLoaded());
+    ASSERT_EQ(manager.getLoadQueueSize(), 0u);
+}
+
+TEST(ResourceManager,forceLoad)
+{
+    ResourceManager<AsyncResource> manager { 0, 1 };
+    auto handle1 = manager.add(1);
+    manager.request(handle1);
+    // Give the worker a chance to prepare the resource, either way it has to be loaded afterwards
+    std::this_thread::sleep_for(std::chrono::milliseconds { 10 });
+    auto pRes = manager.request(handle1, true);
+    ASSERT(pRes->isLoaded());
+    ASSERT_EQ(manager.getLoadQueueSize(), 0u);
+    ASSERT_EQ(manager.getStatistics().m_misses, 1u);
+    ASSERT_EQ(manager.getStatistics().m_residentCount, 1u);
+    auto handle2 = manager.add(2);
+    ASSERT(manager.request(handle2, true)->isLoaded());
+    ASSERT_EQ(manager.getStatistics().m_misses, 2u);
+    ASSERT(manager.request(handle2, true)->isLoaded());
+    ASSERT_EQ(manager.getStatistics().m_hits, 1u);
+}
+
+TEST(ResourceManager,priority)
+{
+    AsyncResource::s_order.clear();
+    ResourceManager<AsyncResource> manager;
+    auto handle0 = manager.add(0);
+    auto handle1 = manager.add(1);
+    auto handle2 = manager.add(2);
+    auto handle3 = manager.add(3);
+    manager.request(handle0, false, 0);
+    manager.request(handle1, false, 5);
+    manager.request(handle2, false, 1);
+    manager.request(handle3, false, 1);
+    // Raising the priority moves a resource up, lowering it doesn't do anything
+    manager.request(handle0, false, 3);
+    manager.request(handle1, false, -1);
+    ASSERT_EQ(manager.getLoadQueueSize(), 4u);
+    // Without workers, every call loads at least one resource on the calling thread
+    for (unsigned int i = 0; i < 4; i++)
+	ASSERT_EQ(manager.finalize(std::chrono::microseconds::zero()), 1u);
+    ASSERT_EQ(manager.finalize(), 0u);
+    ASSERT((AsyncResource::s_order == vector<int> { 1, 0, 2, 3 }));
+    ASSERT_EQ(manager.request(handle2)->m_prepareThread, std::this_thread::get_id());
+}
+
+TEST(ResourceManager,cancel)
+{
+    ResourceManager<AsyncResource> manager;
+    auto handle0 = manager.add(0);
+    auto handle1 = manager.add(1);
+    {
+	auto handle0Copy = manager.identify(0);
+	auto handle1Copy = handle1;
+	manager.request(handle0Copy);
+	manager.request(handle1Copy);
+	ASSERT_EQ(manager.getLoadQueueSize(), 2u);
+    }
+    // Nobody but the manager holds a reference to resource 0 anymore
+    handle0 = AsyncResource::ResourceHandle { };
+    ASSERT_EQ(manager.finalize(), 1u);
+    ASSERT(!manager.needLoad());
+    ASSERT(manager.request(handle1)->isLoaded());
+    ASSERT(!manager.request(manager.identify(0))->isLoaded());
+}
+
+TEST(ResourceManager,prepareFails)
+{
+    ResourceManager<AsyncResource> manager { 0, 1 };
+    auto handle = manager.add(-1);
+    manager.request(handle);
+    ASSERT_THROWS(while (manager.needLoad()) manager.finalize(), std::runtime_error);
+    ASSERT(!manager.needLoad());
+    ASSERT(!manager.request(handle, false)->isLoaded());
+}
+
+TEST(ResourceManager,memoryBudget)
+{
+    ResourceManager<AsyncResource> manager;
+    manager.setMemoryBudget(1000);
+    ASSERT_EQ(manager.getMemoryBudget(), 1000u);
+    auto handle1 = manager.add(4);
+    auto handle2 = manager.add(3);
+    auto handle3 = manager.add(5);
+    manager.request(handle1, true);
+    manager.request(handle2, true);
+    ASSERT_EQ(manager.getStatistics().m_misses, 2u);
+    ASSERT_EQ(manager.getStatistics().m_residentCount, 2u);
+    ASSERT_EQ(manager.getStatistics().m_residentCpuBytes, 700u);
+    ASSERT_EQ(manager.getStatistics().m_residentGpuBytes, 20u);
+    // Unreferenced resources stay loaded while they fit into the budget
+    handle1 = AsyncResource::ResourceHandle { };
+    handle2 = AsyncResource::ResourceHandle { };
+    manager.finalize();
+    ASSERT_EQ(manager.getStatistics().m_evictions, 0u);
+    handle1 = manager.identify(4);
+    ASSERT(manager.request(handle1)->isLoaded());
+    ASSERT_EQ(manager.getStatistics().m_hits, 1u);
+    handle1 = AsyncResource::ResourceHandle { };
+    // Loading another one exceeds the budget, the least recently requested resource goes first
+    manager.request(handle3, true);
+    ASSERT_EQ(manager.getStatistics().m_evictions, 1u);
+    ASSERT(!manager.request(manager.identify(3))->isLoaded());
+    ASSERT(manager.request(manager.identify(4))->isLoaded());
+    ASSERT_EQ(manager.getStatistics().m_residentCount, 2u);
+    ASSERT_EQ(manager.getStatistics().m_residentCpuBytes, 900u);
+    // A cache that is exactly at its budget is kept
+    manager.setMemoryBudget(920);
+    ASSERT_EQ(manager.getStatistics().m_evictions, 1u);
+    // Referenced resources are never evicted, even if they exceed the budget
+    manager.setMemoryBudget(1);
+    ASSERT_EQ(manager.getStatistics().m_evictions, 2u);
+    ASSERT(manager.request(handle3)->isLoaded());
+    ASSERT_EQ(manager.getStatistics().m_residentCpuBytes, 500u);
+    manager.remove(handle3);
+    ASSERT_EQ(manager.getStatistics().m_residentCount, 0u);
+    ASSERT_EQ(manager.getStatistics().m_residentGpuBytes, 0u);
+}
@@ -8,6 +8,9 @@
 /// it might also begin to hurt your kittens.
 //////////////////////////////////////////////////////////////////////
 
+#include <cstdio>
+#include <fstream>
+#include <memory>
 #include "DBGL/Platform/Mesh/IMesh.h"
 #include "DBGL/Platform/Platform.h"
 #include "DBGL/Platform/Implementation/OpenGL33.h"
@@ -15,6 +18,7 @@
 #include "DBGL/Core/Math/Utility.h"
 #include "DBGL/Resources/Mesh/MeshUtility.h"
 #include "DBGL/Resources/Mesh/MeshIO.h"
+#include "DBGL/Resources/Mesh/BinaryMeshFormat.h"
 
 using namespace dbgl;
 using namespace std;
@@ -47,12 +51,90 @@ TEST(MeshIO,obj)
 	{
 		auto mesh = io.load("Assets/Meshes/Cube.obj");
 		ASSERT(mesh);
-		ASSERT(mesh->vertices().size() == 6 * 6);
+		ASSERT(mesh->vertices().size() == 20);
 		ASSERT(mesh->normals().size() == 0);
-		ASSERT(mesh->uvs().size() == 6 * 6);
+		ASSERT(mesh->uvs().size() == 20);
 		ASSERT(mesh->tangents().size() == 0);
 		ASSERT(mesh->bitangents().size() == 0);
 		ASSERT(mesh->indices().size() == 6 * 6);
 	}
 }
 
+TEST(MeshIO,objPolygons)
+{
+	MeshIO io { };
+	if (!io.addFormat("plugins/Mesh/OBJ/libDBGL_OBJ." + Library::getFileExtension()))
+		FAIL();
+	else
+	{
+		// Quad and triangle with negative indices, windows line breaks and trailing comments
+		{
+			std::ofstream file { "objPolygons.obj" };
+			file << "# Test\r\nv 0 0 0\r\nv 1 0 0\r\nv 1 1 0\r\nv 0 1.5e0 -0.25 1\r\nvt 0 0\r\nvt 1 1\r\n"
+					<< "f 1/1 2/1 3/2 4/2\r\nv 2 0 0\r\nf -1/-1 -4/-2 -3/-1 # Triangle\r\n";
+		}
+		std::unique_ptr<IMesh> mesh { io.load("objPolygons.obj") };
+		ASSERT(mesh);
+		ASSERT_EQ(mesh->indices().size(), 3 * 3u);
+		ASSERT_EQ(mesh->vertices().size(), 5u);
+		ASSERT_EQ(mesh->uvs().size(), mesh->vertices().size());
+		ASSERT(mesh->normals().empty());
+		auto vertex = [&mesh](unsigned int corner)
+		{
+			return mesh->vertices()[mesh->indices()[corner]];
+		};
+		ASSERT(vertex(3) == Vec3f(0, 0, 0));
+		ASSERT(vertex(5) == Vec3f(0, 1.5f, -0.25f));
+		ASSERT(vertex(6) == Vec3f(2, 0, 0));
+		ASSERT(vertex(7) == Vec3f(1, 0, 0));
+		ASSERT(mesh->uvs()[mesh->indices()[8]] == Vec2f(1, 1));
+		// Indices out of range
+		{
+			std::ofstream file { "objPolygons.obj" };
+			file << "v 0 0 0\nv 1 0 0\nv 1 1 0\nf 1 2 4\n";
+		}
+		ASSERT(io.load("objPolygons.obj") == nullptr);
+		std::remove("objPolygons.obj");
+	}
+}
+
+TEST(MeshIO,dbm)
+{
+	MeshIO io { };
+	if (!io.addFormat("plugins/Mesh/OBJ/libDBGL_OBJ." + Library::getFileExtension())
+			|| !io.addFormat("plugins/Mesh/DBM/libDBGL_DBM." + Library::getFileExtension()))
+		FAIL();
+	else
+	{
+		std::unique_ptr<IMesh> source { io.load("Assets/Meshes/Cube.obj") };
+		ASSERT(source);
+		source->setLayout(VertexLayout::makePacked());
+		ASSERT(io.write(source.get(), "dbm.dbm"));
+		// Buffers are filled from the file, the lists stay empty
+		std::unique_ptr<IMesh> mesh { io.load("dbm.dbm") };
+		ASSERT(mesh);
+		ASSERT(mesh->vertices().empty());
+		ASSERT_EQ(mesh->getVertexCount(), 20u);
+		ASSERT_EQ(mesh->getUVCount(), 20u);
+		ASSERT_EQ(mesh->getNormalCount(), 0u);
+		ASSERT_EQ(mesh->getIndexCount(), 36u);
+		ASSERT(mesh->getLayout() == VertexLayout::makePacked().select(*source));
+		std::unique_ptr<IMesh> clone { mesh->clone() };
+		ASSERT_EQ(clone->getIndexCount(), 36u);
+		// Meshes without lists can't be written
+		ASSERT(!io.write(mesh.get(), "dbm.dbm"));
+		// Files with indices past the vertices are rejected
+		ASSERT(io.write(source.get(), "dbm.dbm"));
+		{
+			std::fstream file { "dbm.dbm", std::ios::binary | std::ios::in | std::ios::out };
+			BinaryMeshFormat::Header header;
+			file.read(reinterpret_cast<char*>(&header), sizeof(header));
+			ASSERT_EQ(header.m_indexSize, sizeof(uint16_t));
+			uint16_t const index = header.m_vertexCount;
+			file.seekp(header.m_indicesOffset + 5 * sizeof(index));
+			file.write(reinterpret_cast<char const*>(&index), sizeof(index));
+		}
+		ASSERT(io.load("dbm.dbm") == nullptr);
+		std::remove("dbm.dbm");
+	}
+}
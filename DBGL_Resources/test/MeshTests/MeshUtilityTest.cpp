@@ -8,6 +8,10 @@
 /// it might also begin to hurt your kittens.
 //////////////////////////////////////////////////////////////////////
 
+#include <algorithm>
+#include <array>
+#include <set>
+#include <stdexcept>
 #include "DBGL/Platform/Platform.h"
 #include "DBGL/Platform/Implementation/OpenGL33.h"
 #include "DBGL/Core/Test/Test.h"
@@ -64,6 +68,40 @@ TEST(MeshUtility,generateTangentBase)
     }
 }
 
+TEST(MeshUtility,generateNormalsParallel)
+{
+    // Big enough to be split up over multiple threads, the exact normals of a unit sphere are its positions
+    auto sphere = MeshUtility::createIcoSphere(5, false);
+    auto const exact = sphere->normals();
+    MeshUtility::generateNormals(sphere);
+    ASSERT_EQ(sphere->normals().size(), exact.size());
+    for(unsigned int i = 0; i < exact.size(); i++)
+    {
+	ASSERT_APPROX(sphere->normals()[i].getLength(), 1.0f, 0.0001f);
+	ASSERT(sphere->normals()[i] * exact[i] > 0.99f);
+    }
+    MeshUtility::generateTangentBase(sphere);
+    ASSERT_EQ(sphere->tangents().size(), exact.size());
+    ASSERT_EQ(sphere->bitangents().size(), exact.size());
+    for(unsigned int i = 0; i < exact.size(); i++)
+    {
+	ASSERT_APPROX(sphere->tangents()[i].getLength(), 1.0f, 0.0001f);
+	ASSERT_APPROX(sphere->tangents()[i] * sphere->normals()[i], 0.0f, 0.0001f);
+    }
+    // Regenerating reuses the buffers and has to yield the same result
+    auto const normals = sphere->normals();
+    auto const tangents = sphere->tangents();
+    MeshUtility::generateNormals(sphere);
+    MeshUtility::generateTangentBase(sphere);
+    ASSERT(sphere->normals() == normals);
+    ASSERT(sphere->tangents() == tangents);
+    sphere->uvs().pop_back();
+    ASSERT_THROWS(MeshUtility::generateTangentBase(sphere), std::invalid_argument);
+    sphere->indices().pop_back();
+    ASSERT_THROWS(MeshUtility::generateNormals(sphere), std::invalid_argument);
+    delete sphere;
+}
+
 TEST(MeshUtility,reverseNormals)
 {
     auto mesh = MeshUtility::createTriangle(false);
@@ -104,3 +142,177 @@ TEST(MeshUtility,optimizeMesh)
     ASSERT_EQ(copy->normals().size(), 8);
     ASSERT_EQ(copy->uvs().size(), 0);
 }
+
+TEST(MeshUtility,optimizeVertexCache)
+{
+    // Grid with its triangles in a scrambled order
+    unsigned int const size = 32;
+    auto grid = Platform::get()->createMesh();
+    for(unsigned int y = 0; y <= size; y++)
+	for(unsigned int x = 0; x <= size; x++)
+	    grid->vertices().push_back(Vec3f{static_cast<float>(x), static_cast<float>(y), 0});
+    vector<array<IMesh::Index, 3>> triangles{};
+    for(unsigned int y = 0; y < size; y++)
+    {
+	for(unsigned int x = 0; x < size; x++)
+	{
+	    IMesh::Index i = y * (size + 1) + x;
+	    triangles.push_back({i, i + 1, i + size + 1});
+	    triangles.push_back({i + 1, i + size + 2, i + size + 1});
+	}
+    }
+    for(unsigned int i = 0; i < triangles.size(); i++)
+	swap(triangles[i], triangles[(i * 7919) % triangles.size()]);
+    for(auto const& t : triangles)
+	grid->indices().insert(grid->indices().end(), t.begin(), t.end());
+
+    auto before = MeshUtility::analyzeVertexCache(grid);
+    ASSERT(before.m_acmr > 2);
+    MeshUtility::optimizeVertexCache(grid);
+    auto after = MeshUtility::analyzeVertexCache(grid);
+    ASSERT(after.m_acmr < 0.75f);
+    ASSERT(after.m_atvr >= 1 && after.m_atvr < 1.5f);
+
+    // Same triangles with the same winding
+    ASSERT_EQ(grid->indices().size(), triangles.size() * 3);
+    auto canonical = [](IMesh::Index const* t)
+    {
+	auto first = min_element(t, t + 3) - t;
+	return array<IMesh::Index, 3>{t[first], t[(first + 1) % 3], t[(first + 2) % 3]};
+    };
+    vector<array<IMesh::Index, 3>> expected{}, actual{};
+    for(unsigned int i = 0; i < triangles.size(); i++)
+    {
+	expected.push_back(canonical(triangles[i].data()));
+	actual.push_back(canonical(&grid->indices()[i * 3]));
+    }
+    sort(expected.begin(), expected.end());
+    sort(actual.begin(), actual.end());
+    ASSERT(expected == actual);
+
+    grid->indices().push_back(0);
+    ASSERT_THROWS(MeshUtility::optimizeVertexCache(grid), std::invalid_argument);
+    grid->indices().back() = 1;
+    grid->indices().push_back(2);
+    grid->indices().push_back(static_cast<IMesh::Index>(grid->vertices().size()));
+    ASSERT_THROWS(MeshUtility::analyzeVertexCache(grid), std::invalid_argument);
+    delete grid;
+}
+
+TEST(MeshUtility,optimizeRendering)
+{
+    auto sphere = MeshUtility::createIcoSphere(3, false);
+    MeshUtility::generateTangentBase(sphere);
+    auto const vertexCount = sphere->vertices().size();
+    auto const indexCount = sphere->indices().size();
+    // Positions of all triangle corners, independent of vertex and triangle order
+    auto corners = [](IMesh* mesh)
+    {
+	vector<array<float, 8>> result{};
+	for(auto i : mesh->indices())
+	{
+	    auto const& v = mesh->vertices()[i];
+	    auto const& n = mesh->normals()[i];
+	    auto const& uv = mesh->uvs()[i];
+	    result.push_back({v.x(), v.y(), v.z(), n.x(), n.y(), n.z(), uv.x(), uv.y()});
+	}
+	sort(result.begin(), result.end());
+	return result;
+    };
+    auto original = corners(sphere);
+
+    auto statistics = MeshUtility::optimizeRendering(sphere);
+    ASSERT(statistics.m_after.m_acmr < statistics.m_before.m_acmr);
+    ASSERT(statistics.m_after.m_atvr < statistics.m_before.m_atvr);
+    ASSERT_EQ(sphere->vertices().size(), vertexCount);
+    ASSERT_EQ(sphere->tangents().size(), vertexCount);
+    ASSERT_EQ(sphere->indices().size(), indexCount);
+    ASSERT(corners(sphere) == original);
+
+    // Vertices are in order of first use
+    IMesh::Index next = 0;
+    for(auto i : sphere->indices())
+    {
+	ASSERT(i <= next);
+	if(i == next)
+	    next++;
+    }
+    delete sphere;
+}
+
+TEST(MeshUtility,simplify)
+{
+    auto sphere = MeshUtility::createIcoSphere(4, false);
+    auto const vertexCount = sphere->vertices().size();
+    ASSERT_EQ(sphere->indices().size(), 5120 * 3);
+    float error = MeshUtility::simplify(sphere, 1000);
+    ASSERT(sphere->indices().size() <= 1000 * 3);
+    ASSERT(sphere->indices().size() > 500 * 3);
+    ASSERT(error > 0 && error < 0.05f);
+    // Vertices are kept as they are
+    ASSERT_EQ(sphere->vertices().size(), vertexCount);
+    for(auto i : sphere->indices())
+	ASSERT(i < vertexCount);
+    delete sphere;
+
+    // Stops at the target error
+    sphere = MeshUtility::createIcoSphere(4, false);
+    error = MeshUtility::simplify(sphere, 0, 0.01f);
+    ASSERT(error <= 0.01f);
+    ASSERT(sphere->indices().size() < 5120 * 3);
+    ASSERT(sphere->indices().size() > 100 * 3);
+    delete sphere;
+
+    // A flat grid collapses without error, its border keeps its shape
+    unsigned int const size = 8;
+    auto grid = Platform::get()->createMesh();
+    for(unsigned int y = 0; y <= size; y++)
+	for(unsigned int x = 0; x <= size; x++)
+	    grid->vertices().push_back(Vec3f{static_cast<float>(x), static_cast<float>(y), 0});
+    for(unsigned int y = 0; y < size; y++)
+    {
+	for(unsigned int x = 0; x < size; x++)
+	{
+	    IMesh::Index i = y * (size + 1) + x;
+	    grid->indices().insert(grid->indices().end(), {i, i + 1, i + size + 1, i + 1, i + size + 2, i + size + 1});
+	}
+    }
+    error = MeshUtility::simplify(grid, 2);
+    ASSERT(error < 1e-4f);
+    ASSERT_EQ(grid->indices().size(), 2 * 3);
+    set<IMesh::Index> corners(grid->indices().begin(), grid->indices().end());
+    ASSERT(corners == (set<IMesh::Index>{0, size, size * (size + 1), (size + 1) * (size + 1) - 1}));
+    delete grid;
+
+    // All vertices of the cube are shared by three seams and can't be collapsed
+    auto cube = MeshUtility::createCube(false);
+    ASSERT_EQ(MeshUtility::simplify(cube, 0), 0);
+    ASSERT_EQ(cube->indices().size(), 6 * 6);
+    delete cube;
+}
+
+TEST(MeshUtility,generateLODChain)
+{
+    auto sphere = MeshUtility::createIcoSphere(4, false);
+    auto levels = MeshUtility::generateLODChain(sphere, 4, 0.5f, false);
+    ASSERT_EQ(levels.size(), 4);
+    ASSERT(levels[0].m_mesh == sphere);
+    ASSERT_EQ(levels[0].m_error, 0);
+    for(unsigned int i = 1; i < levels.size(); i++)
+    {
+	auto mesh = levels[i].m_mesh;
+	auto previous = levels[i - 1].m_mesh;
+	ASSERT(mesh->indices().size() <= previous->indices().size() * 3 / 4);
+	ASSERT(mesh->vertices().size() < previous->vertices().size());
+	ASSERT(levels[i].m_error > levels[i - 1].m_error);
+	// Unused vertices have been removed
+	ASSERT_EQ(mesh->normals().size(), mesh->vertices().size());
+	ASSERT_EQ(mesh->uvs().size(), mesh->vertices().size());
+	set<IMesh::Index> used(mesh->indices().begin(), mesh->indices().end());
+	ASSERT_EQ(used.size(), mesh->vertices().size());
+	ASSERT_EQ(*used.rbegin(), mesh->vertices().size() - 1);
+    }
+    for(unsigned int i = 1; i < levels.size(); i++)
+	delete levels[i].m_mesh;
+    delete sphere;
+}
@@ -0,0 +1,113 @@
+//////////////////////////////////////////////////////////////////////
+/// Dragon Blaze Game Library
+///
+/// Copyright (c) 2015 by Jan Moeller
+///
+/// This software is provided "as-is" and does not claim to be
+/// complete or free of bugs in any way. It should work, but
+/// it might also begin to hurt your kittens.
+//////////////////////////////////////////////////////////////////////
+
+#include <memory>
+#include "DBGL/Platform/Platform.h"
+#include "DBGL/Platform/Implementation/Headless.h"
+#include "DBGL/Core/Test/Test.h"
+#include "DBGL/Resources/Sprite/Sprite.h"
+#include "DBGL/Resources/Sprite/BitmapFont.h"
+
+using namespace dbgl;
+using namespace std;
+
+namespace dbgl_test_Sprite
+{
+	CommandLog& getLog()
+	{
+		return static_cast<Headless*>(Platform::get())->getLog();
+	}
+
+	IShaderProgram* createSpriteShader()
+	{
+		std::unique_ptr<IShader> vertex { Platform::get()->createShader(IShader::Type::VERTEX,
+				"#version 330 core\n"
+				"in vec3 v_position;\n"
+				"uniform mat3 TRANSFORM_2D;\n"
+				"uniform vec2 v2_screenRes;\n"
+				"void main() { gl_Position = vec4(TRANSFORM_2D * v_position / vec3(v2_screenRes, 1), 1); }") };
+		std::unique_ptr<IShader> fragment { Platform::get()->createShader(IShader::Type::FRAGMENT,
+				"#version 330 core\n"
+				"uniform sampler2D tex_diffuse;\n"
+				"out vec4 color;\n"
+				"void main() { color = vec4(1); }") };
+		vertex->compile();
+		fragment->compile();
+		auto program = Platform::get()->createShaderProgram();
+		program->attach(vertex.get());
+		program->attach(fragment.get());
+		program->link();
+		return program;
+	}
+}
+
+using namespace dbgl_test_Sprite;
+
+TEST_INITIALIZE(Sprite)
+{
+	Platform::init<Headless>();
+}
+
+TEST_TERMINATE(Sprite)
+{
+	Platform::destroy();
+}
+
+TEST(Sprite,rect)
+{
+	std::unique_ptr<ITexture> tex { Platform::get()->createTexture(ITexture::Type::TEX2D) };
+	tex->bind();
+	Platform::get()->curTexture()->write(0, 64, 32, ITextureCommands::PixelFormat::RGBA,
+			ITextureCommands::PixelType::UBYTE, nullptr);
+	Sprite sprite { tex.get() };
+	ASSERT_EQ(sprite.getWidth(), 64u);
+	ASSERT_EQ(sprite.getHeight(), 32u);
+	ASSERT_EQ(sprite.getMesh()->getVertexCount(), 4u);
+	Rectangle<unsigned int> rect { };
+	rect.pos() = Vector2<unsigned int> { 16, 8 };
+	rect.extent() = Vector2<unsigned int> { 16, 16 };
+	sprite.setRect(rect);
+	ASSERT_EQ(sprite.getWidth(), 16u);
+	ASSERT_APPROX(sprite.getMesh()->uvs()[0][0], 0.25f, 1e-6f);
+	ASSERT_APPROX(sprite.getMesh()->uvs()[0][1], 0.25f, 1e-6f);
+	ASSERT_APPROX(sprite.getMesh()->vertices()[3][0], 16.0f, 1e-6f);
+	// Rectangle is cropped to the texture
+	rect.extent() = Vector2<unsigned int> { 100, 100 };
+	sprite.setRect(rect);
+	ASSERT_EQ(sprite.getWidth(), 48u);
+	ASSERT_EQ(sprite.getHeight(), 24u);
+}
+
+TEST(Sprite,drawText)
+{
+	BitmapFont font { };
+	std::unique_ptr<IShaderProgram> shader { createSpriteShader() };
+	std::unique_ptr<IRenderContext> rc { Platform::get()->createRenderContext(800, 600) };
+	rc->setAlphaBlend(IRenderContext::AlphaBlendValue::SrcAlpha, IRenderContext::AlphaBlendValue::OneMinusSrcAlpha);
+	getLog().clear();
+	font.drawText(rc.get(), shader.get(), "Hello World", 10, 20);
+	ASSERT_EQ(getLog().getCount(CommandLog::Type::DrawMesh), 11u);
+	ASSERT_EQ(getLog().getDrawnIndices(), 11u * 6);
+	ASSERT_EQ(getLog().getCount(CommandLog::Type::UseProgram), 1u);
+	// Sampler and screen resolution are set once, the transform once per glyph
+	ASSERT_EQ(getLog().getCount(CommandLog::Type::Uniform), 2 + 11u);
+	// Blend mode is only set once for the whole text
+	ASSERT_EQ(getLog().getCount(CommandLog::Type::AlphaBlend), 2u);
+	// Previous blend mode is restored
+	ASSERT(rc->getSrcAlphaBlend() == IRenderContext::AlphaBlendValue::SrcAlpha);
+	ASSERT(rc->getDestAlphaBlend() == IRenderContext::AlphaBlendValue::OneMinusSrcAlpha);
+	// Shaders lacking the expected uniforms don't draw anything
+	std::unique_ptr<IShaderProgram> empty { Platform::get()->createShaderProgram() };
+	empty->link();
+	getLog().clear();
+	font.drawText(rc.get(), empty.get(), "Hello World", 10, 20);
+	ASSERT_EQ(getLog().getCount(CommandLog::Type::DrawMesh), 0u);
+	ASSERT_EQ(getLog().getCount(CommandLog::Type::AlphaBlend), 0u);
+}